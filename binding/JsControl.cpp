@@ -16,6 +16,16 @@ static Value getClass(CControlUI* pThis, Context& context, ArgList& args) {
 	return toValue(context, pThis->GetClass());
 }
 
+static Value getStyleClass(CControlUI* pThis, Context& context, ArgList& args) {
+	return toValue(context, pThis->GetStyleClass());
+}
+
+static Value setStyleClass(CControlUI* pThis, Context& context, ArgList& args) {
+	auto str = args[0].ToString();
+	pThis->SetStyleClass(CDuiString(str.str(), str.len()));
+	return undefined_value;
+}
+
 static Value getControlFlags(CControlUI* pThis, Context& context, ArgList& args) {
 	return toValue(context,pThis->GetControlFlags());
 }
@@ -592,6 +602,8 @@ void RegisterControl(qjs::Module* module) {
 	ADD_FUNCTION(getName);
 	ADD_FUNCTION(setName);
 	ADD_FUNCTION(getClass);
+	ADD_FUNCTION(getStyleClass);
+	ADD_FUNCTION(setStyleClass);
 	ADD_FUNCTION(getControlFlags);
 	ADD_FUNCTION(activate);
 	ADD_FUNCTION(getParent);
@@ -96,6 +96,57 @@ static Value cancel(JsFileDownload* pThis, Context& context, ArgList& args) {
     return undefined_value;
 }
 
+//ֶ1ʱRangeزֶ֧ϵ
+static Value setSegments(JsFileDownload* pThis, Context& context, ArgList& args) {
+    pThis->setSegments(args[0].ToInt32());
+    return undefined_value;
+}
+
+//зֶκϼƵ(ֽ/)
+static Value getDownloadRate(JsFileDownload* pThis, Context& context, ArgList& args) {
+    return context.NewFloat64(pThis->getDownloadRate());
+}
+
+//ȼ0 1ͨ 2ߣŶеذȼ
+static Value setPriority(JsFileDownload* pThis, Context& context, ArgList& args) {
+    pThis->setPriority((network::DownloadPriority)args[0].ToInt32());
+    return undefined_value;
+}
+
+static Value getPriority(JsFileDownload* pThis, Context& context, ArgList& args) {
+    return context.NewInt32((int)pThis->getPriority());
+}
+
+//(ֽ/)0Ϊ
+static Value setMaxRecvSpeed(JsFileDownload* pThis, Context& context, ArgList& args) {
+    pThis->setMaxRecvSpeed(args[0].ToInt64());
+    return undefined_value;
+}
+
+//ӹԴȡƵĿ·ȵenableAssetCache
+static Value setUseAssetCache(JsFileDownload* pThis, Context& context, ArgList& args) {
+    pThis->setUseAssetCache(args[0].ToBool());
+    return undefined_value;
+}
+
+//ͬʱе
+static Value setDownloadMaxConcurrency(Context& context, ArgList& args) {
+    network::CurlDownload::getDownloadManager().setMaxConcurrency(args[0].ToInt32());
+    return undefined_value;
+}
+
+//ͬһͬʱе
+static Value setDownloadMaxPerHost(Context& context, ArgList& args) {
+    network::CurlDownload::getDownloadManager().setMaxPerHost(args[0].ToInt32());
+    return undefined_value;
+}
+
+//غϼƵ(ֽ/)0Ϊ
+static Value setDownloadMaxRecvSpeed(Context& context, ArgList& args) {
+    network::CurlDownload::getDownloadManager().setMaxRecvSpeed(args[0].ToInt64());
+    return undefined_value;
+}
+
 
 void RegisterFileDownload(qjs::Module* module) {
     auto cls = module->ExportClass<JsFileDownload>("FileDownload");
@@ -103,6 +154,16 @@ void RegisterFileDownload(qjs::Module* module) {
     cls.AddCtor2<createFileDownload>();
     cls.AddFunc<start>("start");
     cls.AddFunc<cancel>("cancel");
+    cls.AddFunc<setSegments>("setSegments");
+    cls.AddFunc<getDownloadRate>("getDownloadRate");
+    cls.AddFunc<setPriority>("setPriority");
+    cls.AddFunc<getPriority>("getPriority");
+    cls.AddFunc<setMaxRecvSpeed>("setMaxRecvSpeed");
+    cls.AddFunc<setUseAssetCache>("setUseAssetCache");
+
+    module->ExportFunc<setDownloadMaxConcurrency>("setDownloadMaxConcurrency");
+    module->ExportFunc<setDownloadMaxPerHost>("setDownloadMaxPerHost");
+    module->ExportFunc<setDownloadMaxRecvSpeed>("setDownloadMaxRecvSpeed");
 }
 
 
@@ -1,4 +1,6 @@
 #include "network/HttpClient.h"
+#include "network/AssetCache.h"
+#include "async/image_loader.h"
 #include "Util.h"
 #include "JsEngine.h"
 
@@ -52,6 +54,56 @@ static Value getTimeoutForRead(HttpClient* pThis, Context& context, ArgList& arg
 	return context.NewInt32(pThis->getTimeoutForRead());
 }
 
+static Value setMaxConcurrency(HttpClient* pThis, Context& context, ArgList& args) {
+	pThis->setMaxConcurrency(args[0].ToInt32());
+	return undefined_value;
+}
+
+static Value getMaxConcurrency(HttpClient* pThis, Context& context, ArgList& args) {
+	return context.NewInt32(pThis->getMaxConcurrency());
+}
+
+static Value setMaxPerHost(HttpClient* pThis, Context& context, ArgList& args) {
+	pThis->setMaxPerHost(args[0].ToInt32());
+	return undefined_value;
+}
+
+static Value getMaxPerHost(HttpClient* pThis, Context& context, ArgList& args) {
+	return context.NewInt32(pThis->getMaxPerHost());
+}
+
+//enableCache(dir, memoryLimit, diskLimit)dirΪʱֻڴ
+static Value enableCache(HttpClient* pThis, Context& context, ArgList& args) {
+	std::string dir = args.size() > 0 && args[0].IsString() ? args[0].ToStdString() : std::string();
+	size_t memory = args.size() > 1 && args[1].IsNumber() ? (size_t)args[1].ToFloat64() : 8 * 1024 * 1024;
+	size_t disk = args.size() > 2 && args[2].IsNumber() ? (size_t)args[2].ToFloat64() : 64 * 1024 * 1024;
+	pThis->enableCache(dir, memory, disk);
+	return undefined_value;
+}
+
+static Value disableCache(HttpClient* pThis, Context& context, ArgList& args) {
+	pThis->disableCache();
+	return undefined_value;
+}
+
+static Value clearCache(HttpClient* pThis, Context& context, ArgList& args) {
+	pThis->clearCache();
+	return undefined_value;
+}
+
+static Value getCacheStats(HttpClient* pThis, Context& context, ArgList& args) {
+	HttpCacheStats stats = pThis->getCacheStats();
+	Value obj = context.NewObject();
+	obj.SetProperty("hits", context.NewFloat64((double)stats.hits));
+	obj.SetProperty("revalidated", context.NewFloat64((double)stats.revalidated));
+	obj.SetProperty("misses", context.NewFloat64((double)stats.misses));
+	obj.SetProperty("bytesSaved", context.NewFloat64((double)stats.bytesSaved));
+	obj.SetProperty("memoryBytes", context.NewFloat64((double)stats.memoryBytes));
+	obj.SetProperty("diskBytes", context.NewFloat64((double)stats.diskBytes));
+	obj.SetPropertyInt32("entries", stats.entries);
+	return obj;
+}
+
 
 //HttpResponse
 static void deleteResponce(HttpResponse* rep) {
@@ -71,11 +123,27 @@ static Value succeed(HttpResponse* pThis, Context& context, ArgList& args) {
 	return context.NewInt32(pThis->isSucceed());
 }
 
+static void freeBuffer(JSRuntime* rt, void* opaque, void* ptr) {
+	delete (std::vector<char>*)opaque;
+}
+
+//ݵȨתArrayBuffer
+static Value toArrayBuffer(Context& context, std::vector<char>* data) {
+	std::vector<char>* buffer = new std::vector<char>();
+	buffer->swap(*data);
+	return context.NewArrayBuffer((uint8_t*)buffer->data(), buffer->size(), freeBuffer, buffer);
+}
+
 static Value body(HttpResponse* pThis, Context& context, ArgList& args) {
 	std::vector<char>* data = pThis->getResponseData();
 	return context.NewString(data->data(),data->size());
 }
 
+//ӦתƵArrayBufferУ֮body()Ϊ
+static Value arrayBuffer(HttpResponse* pThis, Context& context, ArgList& args) {
+	return toArrayBuffer(context, pThis->getResponseData());
+}
+
 static Value headers(HttpResponse* pThis, Context& context, ArgList& args) {
 	std::vector<char>* data = pThis->getResponseHeader();
 	return context.NewString(data->data(), data->size());
@@ -107,8 +175,19 @@ public:
 		}
 	}
 
+	void OnData(HttpClient* client, HttpResponse* response, std::vector<char>* chunk) {
+		if (data_callback_.IsFunction()) {
+			Context* context = data_callback_.context();
+			data_callback_.Call(toArrayBuffer(*context, chunk), ToValue(*context, response));
+		}
+	}
+
 	void Mark(JS_MarkFunc* mark_func) {
-		callback_.Mark(mark_func);
+		//δõĻصûcontextҪ
+		if (callback_.IsFunction())
+			callback_.Mark(mark_func);
+		if (data_callback_.IsFunction())
+			data_callback_.Mark(mark_func);
 	}
 
 	void SetCallback(Value callback) {
@@ -116,8 +195,15 @@ public:
 		setResponseCallback(std::bind(&JsRequest::OnFinish, 
 			this, std::placeholders::_1, std::placeholders::_2));
 	}
+
+	void SetDataCallback(Value callback) {
+		data_callback_ = callback;
+		setDataCallback(std::bind(&JsRequest::OnData, this,
+			std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
+	}
 private:
 	Value callback_;
+	Value data_callback_;
 };
 
 static void deleteRequest(JsRequest* req) {
@@ -163,6 +249,21 @@ static Value setCallback(JsRequest* pThis, Context& context, ArgList& args) {
 	return undefined_value;
 }
 
+//ʽӦݣÿArrayBufferصӦвٱ
+static Value onData(JsRequest* pThis, Context& context, ArgList& args) {
+	if (!args[0].IsFunction()) {
+		return context.ThrowTypeError("args 0 needs function");
+	}
+
+	pThis->SetDataCallback(args[0]);
+	return undefined_value;
+}
+
+//GETӹԴȡȵenableAssetCache
+static Value setUseAssetCache(JsRequest* pThis, Context& context, ArgList& args) {
+	pThis->setUseAssetCache(args[0].ToBool());
+	return undefined_value;
+}
 
 static Value setHeaders(JsRequest* pThis, Context& context, ArgList& args) {
 	if (!args[0].IsObject()) {
@@ -219,6 +320,59 @@ static Value sendImmediate(HttpClient* pThis, Context& context, ArgList& args) {
 	return undefined_value;
 }
 
+//ͼƬͼƬԴ
+static void fetchImage(const std::string& url, std::function<void(const std::string&)> done) {
+	AssetCachePtr cache = AssetCache::getDefault();
+	if (!cache) {
+		done(std::string());
+		return;
+	}
+	cache->fetch(url, [done](AssetPtr asset) {
+		done(asset ? asset->path : std::string());
+	});
+}
+
+//Դ棺enableAssetCache(dir, limit)HttpClientFileDownloadͼƬ
+static Value enableAssetCache(Context& context, ArgList& args) {
+	if (!args[0].IsString()) {
+		return context.ThrowTypeError("args 0 needs string");
+	}
+	int64_t limit = args.size() > 1 && args[1].IsNumber() ? (int64_t)args[1].ToFloat64() : 256 * 1024 * 1024;
+	AssetCache::setDefault(AssetCache::create(args[0].ToStdString(), limit));
+	ImageLoader::SetFetcher(fetchImage);
+	return undefined_value;
+}
+
+static Value disableAssetCache(Context& context, ArgList& args) {
+	AssetCache::setDefault(nullptr);
+	ImageLoader::SetFetcher(nullptr);
+	return undefined_value;
+}
+
+static Value clearAssetCache(Context& context, ArgList& args) {
+	AssetCachePtr cache = AssetCache::getDefault();
+	if (cache)
+		cache->clear();
+	return undefined_value;
+}
+
+static Value getAssetCacheStats(Context& context, ArgList& args) {
+	AssetCachePtr cache = AssetCache::getDefault();
+	if (!cache)
+		return undefined_value;
+
+	AssetCacheStats stats = cache->getStats();
+	Value obj = context.NewObject();
+	obj.SetProperty("hits", context.NewFloat64((double)stats.hits));
+	obj.SetProperty("misses", context.NewFloat64((double)stats.misses));
+	obj.SetProperty("coalesced", context.NewFloat64((double)stats.coalesced));
+	obj.SetProperty("deduplicated", context.NewFloat64((double)stats.deduplicated));
+	obj.SetProperty("bytes", context.NewFloat64((double)stats.bytes));
+	obj.SetPropertyInt32("urls", stats.urls);
+	obj.SetPropertyInt32("files", stats.files);
+	return obj;
+}
+
 void RegisterHttpClient(Module* module) {
 
 	{
@@ -234,6 +388,14 @@ void RegisterHttpClient(Module* module) {
 		ADD_FUNCTION(getTimeoutForConnect);
 		ADD_FUNCTION(setTimeoutForRead);
 		ADD_FUNCTION(getTimeoutForRead);
+		ADD_FUNCTION(setMaxConcurrency);
+		ADD_FUNCTION(getMaxConcurrency);
+		ADD_FUNCTION(setMaxPerHost);
+		ADD_FUNCTION(getMaxPerHost);
+		ADD_FUNCTION(enableCache);
+		ADD_FUNCTION(disableCache);
+		ADD_FUNCTION(clearCache);
+		ADD_FUNCTION(getCacheStats);
 		ADD_FUNCTION(send);
 		ADD_FUNCTION(sendImmediate);
 		ADD_FUNCTION(get);
@@ -246,6 +408,7 @@ void RegisterHttpClient(Module* module) {
 
 		ADD_FUNCTION(succeed);
 		ADD_FUNCTION(body);
+		ADD_FUNCTION(arrayBuffer);
 		ADD_FUNCTION(headers);
 		ADD_FUNCTION(code);
 		ADD_FUNCTION(error);
@@ -260,7 +423,14 @@ void RegisterHttpClient(Module* module) {
 		ADD_FUNCTION(setHeaders);
 		ADD_FUNCTION(setBody);
 		ADD_FUNCTION(setCallback);
+		ADD_FUNCTION(onData);
+		ADD_FUNCTION(setUseAssetCache);
 	}
+
+	module->ExportFunc<enableAssetCache>("enableAssetCache");
+	module->ExportFunc<disableAssetCache>("disableAssetCache");
+	module->ExportFunc<clearAssetCache>("clearAssetCache");
+	module->ExportFunc<getAssetCacheStats>("getAssetCacheStats");
 }
 
 
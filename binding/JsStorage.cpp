@@ -2,6 +2,7 @@
 #include "async/storage.h"
 #include "sqlite3/sqlite3.h"
 #include "JsEngine.h"
+#include <cmath>
 
 namespace duijs {
 
@@ -16,11 +17,43 @@ static void deleteStorage(Storage* w) {
 }
 
 
+//options: {wal, synchronous, batchSize, flushLatency, readers}
+static StorageOptions toStorageOptions(const Value& value) {
+	StorageOptions options;
+	if (!value.IsObject())
+		return options;
+
+	if (value.HasProperty("wal"))
+		options.wal = value.GetProperty("wal").ToBool();
+
+	if (value.HasProperty("synchronous")) {
+		Value synchronous = value.GetProperty("synchronous");
+		if (synchronous.IsString()) {
+			const char* modes[] = { "off","normal","full","extra" };
+			std::string mode = synchronous.ToStdString();
+			for (int i = 0; i < 4; ++i) {
+				if (mode == modes[i])
+					options.synchronous = i;
+			}
+		} else {
+			options.synchronous = synchronous.ToInt32();
+		}
+	}
+
+	if (value.HasProperty("batchSize"))
+		options.batch_size = value.GetProperty("batchSize").ToUint32();
+	if (value.HasProperty("flushLatency"))
+		options.flush_latency = value.GetProperty("flushLatency").ToUint32();
+	if (value.HasProperty("readers"))
+		options.readers = value.GetProperty("readers").ToUint32();
+	return options;
+}
+
 static Value open(Storage* pThis, Context& context, ArgList& args) {
 	JsEngine* engine = JsEngine::get(context);
 	Promise* promise = new Promise(context);
 
-	pThis->Open(args[0].ToStdString(), [engine, promise](int code) {
+	pThis->Open(args[0].ToStdString(), toStorageOptions(args[1]), [engine, promise](int code) {
 		engine->PostTask([code, promise]() {
 			Context* context = Context::get(promise->context());
 			promise->Resolve(context->NewInt32(code));
@@ -80,6 +113,518 @@ static Value escape(Storage* pThis, Context& context, ArgList& args) {
 	return rslt;
 }
 
+//Ԥ䣬sqlڴ洢̰߳ӻ
+struct JsStatement {
+	WeakPtr<Storage> storage;
+	std::string sql;
+	Value bound;
+	bool raw;
+};
+
+static void deleteStatement(JsStatement* w) {
+	delete w;
+}
+
+static void markStatement(JsStatement* w, JS_MarkFunc* mark_func) {
+	w->bound.Mark(mark_func);
+}
+
+static bool toStorageValue(Context& context, const Value& value, StorageValue* out) {
+	if (value.IsNull() || value.IsUndefined()) {
+		out->type = StorageValue::kNull;
+	} else if (value.IsBool()) {
+		out->type = StorageValue::kInteger;
+		out->i = value.ToBool() ? 1 : 0;
+	} else if (value.IsBigInt()) {
+		out->type = StorageValue::kInteger;
+		out->i = value.ToBigInt64();
+	} else if (value.IsNumber()) {
+		double f = value.ToFloat64();
+		//NaNInfͳint64ΧֵתΪ
+		bool integer = std::isfinite(f) && f >= -9223372036854775808.0 && f < 9223372036854775808.0
+			&& f == std::trunc(f);
+		if (integer) {
+			out->type = StorageValue::kInteger;
+			out->i = (int64_t)f;
+		} else {
+			out->type = StorageValue::kFloat;
+			out->f = f;
+		}
+	} else if (value.IsString()) {
+		out->type = StorageValue::kText;
+		out->data = value.ToStdString();
+	} else if (value.IsObject()) {
+		Value ctor = context.Global().GetProperty("ArrayBuffer");
+		size_t size = 0;
+		uint8_t* buf = nullptr;
+		if (JS_IsInstanceOf(context.context(), value, ctor) == 1) {
+			buf = JS_GetArrayBuffer(context.context(), &size, value);
+		} else if (ctor.Invoke("isView", value).ToBool()) {
+			buf = value.ToBuffer(&size);
+		} else {
+			return false;
+		}
+		out->type = StorageValue::kBlob;
+		if (buf && size > 0)
+			out->data.assign((const char*)buf, size);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+//鰴λð󶨣ư
+static bool toStorageParams(Context& context, const Value& value, StorageParams* params) {
+	if (value.IsUndefined() || value.IsNull())
+		return true;
+
+	if (value.IsArray()) {
+		size_t len = value.length();
+		params->resize(len);
+		for (size_t i = 0; i < len; ++i) {
+			if (!toStorageValue(context, value.GetProperty((uint32_t)i), &(*params)[i].value))
+				return false;
+		}
+		return true;
+	}
+
+	if (!value.IsObject())
+		return false;
+
+	auto properties = const_cast<Value&>(value).GetProperties(JS_GPN_STRING_MASK | JS_GPN_ENUM_ONLY);
+	for (auto& item : properties) {
+		StorageParam param;
+		param.name = item.first;
+		if (!toStorageValue(context, item.second, &param.value))
+			return false;
+		params->push_back(std::move(param));
+	}
+	return true;
+}
+
+static Value toJsValue(Context& context, const StorageValue& value) {
+	switch (value.type) {
+	case StorageValue::kInteger:
+		return context.NewInt64(value.i);
+	case StorageValue::kFloat:
+		return context.NewFloat64(value.f);
+	case StorageValue::kText:
+		return context.NewString(value.data.c_str(), value.data.size());
+	case StorageValue::kBlob:
+		return context.NewArrayBuffer((const uint8_t*)value.data.data(), value.data.size());
+	default:
+		return null_value;
+	}
+}
+
+static Value toJsRow(Context& context, const StorageResult& result, const StorageRow& row, bool raw) {
+	if (raw) {
+		Value arr = context.NewArray();
+		for (size_t i = 0; i < row.size(); ++i) {
+			arr.SetProperty((uint32_t)i, toJsValue(context, row[i]));
+		}
+		return arr;
+	}
+
+	Value obj = context.NewObject();
+	for (size_t i = 0; i < row.size(); ++i) {
+		obj.SetProperty(result.columns[i].c_str(), toJsValue(context, row[i]));
+	}
+	return obj;
+}
+
+static Value toJsError(Context& context, const StorageResult& result) {
+	Value rslt = context.NewObject();
+	rslt.SetPropertyInt32("code", result.code);
+	rslt.SetPropertyString("error", result.error.c_str());
+	return rslt;
+}
+
+static Value toJsRows(Context& context, const StorageResult& result, bool raw) {
+	if (result.code != 0)
+		return toJsError(context, result);
+
+	Value data = context.NewArray();
+	for (size_t i = 0; i < result.rows.size(); ++i) {
+		data.SetProperty((uint32_t)i, toJsRow(context, result, result.rows[i], raw));
+	}
+
+	Value rslt = context.NewObject();
+	rslt.SetPropertyInt32("code", result.code);
+	rslt.SetProperty("data", data);
+	return rslt;
+}
+
+static Value toJsChanges(Context& context, const StorageResult& result) {
+	if (result.code != 0)
+		return toJsError(context, result);
+
+	Value rslt = context.NewObject();
+	rslt.SetPropertyInt32("code", result.code);
+	rslt.SetPropertyInt32("changes", result.changes);
+	rslt.SetProperty("lastInsertRowid", context.NewInt64(result.last_insert_rowid));
+	return rslt;
+}
+
+//Ϊundefinedʱʹbind󶨵Ĳ
+static bool getParams(JsStatement* pThis, Context& context, const Value& params, StorageParams* out) {
+	return toStorageParams(context, params.IsUndefined() ? pThis->bound : params, out);
+}
+
+static Value queryStatement(JsStatement* pThis, Context& context, StorageParams params, bool fetch_rows,
+	std::function<Value(Context*, StorageResultPtr)> resolve) {
+	Storage* storage = pThis->storage.Lock();
+	if (!storage) {
+		pThis->storage.Unlock();
+		return context.ThrowReferenceError("storage destroyed");
+	}
+
+	JsEngine* engine = JsEngine::get(context);
+	Promise* promise = new Promise(context);
+	storage->Query(pThis->sql, std::move(params), fetch_rows, [engine, promise, resolve](StorageResultPtr result) {
+		engine->PostTask([promise, resolve, result]() {
+			Context* context = Context::get(promise->context());
+			promise->Resolve(resolve(context, result));
+			delete promise;
+		});
+	});
+	pThis->storage.Unlock();
+	return promise->promise();
+}
+
+static Value prepare(Storage* pThis, Context& context, ArgList& args) {
+	if (!args[0].IsString()) {
+		return context.ThrowTypeError("sql must be string");
+	}
+
+	JsStatement* stmt = new JsStatement();
+	stmt->storage = pThis->weak_ptr();
+	stmt->sql = args[0].ToStdString();
+	stmt->bound = Value(context.context());
+	stmt->raw = false;
+	return Class<JsStatement>::ToJs(context, stmt);
+}
+
+static Value bindStatement(JsStatement* pThis, Context& context, ArgList& args) {
+	StorageParams params;
+	if (!toStorageParams(context, args[0], &params)) {
+		return context.ThrowTypeError("invalid sql params");
+	}
+	pThis->bound = args[0];
+	return undefined_value;
+}
+
+static Value rawStatement(JsStatement* pThis, Context& context, ArgList& args) {
+	pThis->raw = args.size() == 0 || args[0].ToBool();
+	return undefined_value;
+}
+
+static Value runStatement(JsStatement* pThis, Context& context, ArgList& args) {
+	StorageParams params;
+	if (!getParams(pThis, context, args[0], &params)) {
+		return context.ThrowTypeError("invalid sql params");
+	}
+
+	return queryStatement(pThis, context, std::move(params), false, [](Context* context, StorageResultPtr result) {
+		return toJsChanges(*context, *result);
+	});
+}
+
+static Value allStatement(JsStatement* pThis, Context& context, ArgList& args) {
+	StorageParams params;
+	if (!getParams(pThis, context, args[0], &params)) {
+		return context.ThrowTypeError("invalid sql params");
+	}
+
+	bool raw = pThis->raw;
+	return queryStatement(pThis, context, std::move(params), true, [raw](Context* context, StorageResultPtr result) {
+		return toJsRows(*context, *result, raw);
+	});
+}
+
+//iterateÿδαȡ
+static const size_t kIterateChunk = 256;
+
+//iterate״̬߳ʱͶݵ߳ͷjs
+//ȡݵûִ(Storage)ʱصpromiseҲй©
+struct JsIterate {
+	JsEngine* engine;
+	StorageCursorPtr cursor;
+	Value* callback;
+	Promise* promise;
+	bool raw;
+	int count;
+
+	~JsIterate() {
+		Value* callback_ = callback;
+		Promise* promise_ = promise;
+		engine->PostTask([callback_, promise_]() {
+			delete callback_;
+			delete promise_;
+		});
+	}
+};
+
+static void fetchIterate(std::shared_ptr<JsIterate> state) {
+	state->cursor->Fetch([state](StorageResultPtr result, bool done) {
+		state->engine->PostTask([state, result, done]() {
+			Context* context = Context::get(state->promise->context());
+			Value rslt(context->context());
+			if (result->code != 0) {
+				rslt = toJsError(*context, *result);
+			} else {
+				bool stop = done;
+				for (auto& row : result->rows) {
+					++state->count;
+					Value ret = state->callback->Call(toJsRow(*context, *result, row, state->raw));
+					if (ret.IsException()) {
+						context->DumpError();
+						stop = true;
+						break;
+					}
+					if (ret.IsBool() && !ret.ToBool()) {
+						stop = true;
+						break;
+					}
+				}
+
+				//صһȡһ飬һΰѽȫڴ
+				if (!stop) {
+					fetchIterate(state);
+					return;
+				}
+
+				rslt = context->NewObject();
+				rslt.SetPropertyInt32("code", result->code);
+				rslt.SetPropertyInt32("count", state->count);
+			}
+
+			state->cursor->Close();
+			state->promise->Resolve(rslt);
+			delete state->promise;
+			state->promise = nullptr;
+		});
+	});
+}
+
+//лصصfalseʱֹͣαȡ
+static Value iterateStatement(JsStatement* pThis, Context& context, ArgList& args) {
+	Value func = args.size() > 1 ? args[1] : args[0];
+	if (!func.IsFunction()) {
+		return context.ThrowTypeError("callback must be function");
+	}
+
+	StorageParams params;
+	if (!getParams(pThis, context, args.size() > 1 ? args[0] : undefined_value, &params)) {
+		return context.ThrowTypeError("invalid sql params");
+	}
+
+	Storage* storage = pThis->storage.Lock();
+	if (!storage) {
+		pThis->storage.Unlock();
+		return context.ThrowReferenceError("storage destroyed");
+	}
+
+	auto state = std::make_shared<JsIterate>();
+	state->engine = JsEngine::get(context);
+	state->cursor = storage->OpenCursor(pThis->sql, std::move(params), kIterateChunk);
+	state->callback = new Value(func);
+	state->promise = new Promise(context);
+	state->raw = pThis->raw;
+	state->count = 0;
+	pThis->storage.Unlock();
+
+	Value promise = state->promise->promise();
+	fetchIterate(state);
+	return promise;
+}
+
+//statements: [sql | [sql, params] | {sql, params}]
+static Value batch(Storage* pThis, Context& context, ArgList& args) {
+	if (!args[0].IsArray()) {
+		return context.ThrowTypeError("statements must be array");
+	}
+
+	std::vector<StorageStatement> statements;
+	size_t len = args[0].length();
+	for (size_t i = 0; i < len; ++i) {
+		Value item = args[0].GetProperty((uint32_t)i);
+		Value sql = item;
+		Value params = undefined_value;
+		if (item.IsArray()) {
+			sql = item.GetProperty((uint32_t)0);
+			params = item.GetProperty((uint32_t)1);
+		} else if (item.IsObject()) {
+			sql = item.GetProperty("sql");
+			params = item.GetProperty("params");
+		}
+
+		StorageStatement statement;
+		if (!sql.IsString() || !toStorageParams(context, params, &statement.params)) {
+			return context.ThrowTypeError("invalid statement at %d", (int)i);
+		}
+		statement.sql = sql.ToStdString();
+		statements.push_back(std::move(statement));
+	}
+
+	JsEngine* engine = JsEngine::get(context);
+	Promise* promise = new Promise(context);
+	pThis->Batch(std::move(statements), [engine, promise](int code, std::vector<StorageResultPtr> results) {
+		engine->PostTask([code, promise, results]() {
+			Context* context = Context::get(promise->context());
+			Value rslt = context->NewObject();
+			rslt.SetPropertyInt32("code", code);
+			if (code == 0) {
+				Value data = context->NewArray();
+				for (size_t i = 0; i < results.size(); ++i) {
+					data.SetProperty((uint32_t)i, toJsChanges(*context, *results[i]));
+				}
+				rslt.SetProperty("results", data);
+			} else {
+				rslt.SetPropertyInt32("index", (int32_t)results.size() - 1);
+				if (!results.empty() && results.back()->code != 0)
+					rslt.SetPropertyString("error", results.back()->error.c_str());
+			}
+			promise->Resolve(rslt);
+			delete promise;
+		});
+	});
+	return promise->promise();
+}
+
+//дУдϲͬһύ
+static Value write(Storage* pThis, Context& context, ArgList& args) {
+	StorageParams params;
+	if (!args[0].IsString() || !toStorageParams(context, args[1], &params)) {
+		return context.ThrowTypeError("invalid sql params");
+	}
+
+	JsEngine* engine = JsEngine::get(context);
+	Promise* promise = new Promise(context);
+	pThis->Write(args[0].ToStdString(), std::move(params), [engine, promise](StorageResultPtr result) {
+		engine->PostTask([promise, result]() {
+			Context* context = Context::get(promise->context());
+			promise->Resolve(toJsChanges(*context, *result));
+			delete promise;
+		});
+	});
+	return promise->promise();
+}
+
+//ֻϲѯд
+static Value read(Storage* pThis, Context& context, ArgList& args) {
+	StorageParams params;
+	if (!args[0].IsString() || !toStorageParams(context, args[1], &params)) {
+		return context.ThrowTypeError("invalid sql params");
+	}
+
+	JsEngine* engine = JsEngine::get(context);
+	Promise* promise = new Promise(context);
+	pThis->Read(args[0].ToStdString(), std::move(params), [engine, promise](StorageResultPtr result) {
+		engine->PostTask([promise, result]() {
+			Context* context = Context::get(promise->context());
+			promise->Resolve(toJsRows(*context, *result, false));
+			delete promise;
+		});
+	});
+	return promise->promise();
+}
+
+//ֿȡα֧꣬for await (const rows of db.query(sql, {chunk: 1000}))
+struct JsCursor {
+	StorageCursorPtr cursor;
+	std::shared_ptr<bool> busy;	//ȡʱjsѱ
+	bool raw;
+};
+
+static void deleteCursor(JsCursor* w) {
+	w->cursor->Close();
+	delete w;
+}
+
+static Value toIteratorResult(Context& context, const Value& value, bool done) {
+	Value rslt = context.NewObject();
+	rslt.SetProperty("value", value);
+	rslt.SetProperty("done", context.NewBool(done));
+	return rslt;
+}
+
+//ÿȡһ飬һδǰٴε
+static Value nextCursor(JsCursor* pThis, Context& context, ArgList& args) {
+	if (*pThis->busy) {
+		return context.ThrowInternalError("cursor is fetching");
+	}
+
+	*pThis->busy = true;
+	JsEngine* engine = JsEngine::get(context);
+	Promise* promise = new Promise(context);
+	std::shared_ptr<bool> busy = pThis->busy;
+	bool raw = pThis->raw;
+	pThis->cursor->Fetch([engine, promise, busy, raw](StorageResultPtr result, bool done) {
+		engine->PostTask([promise, busy, raw, result, done]() {
+			Context* context = Context::get(promise->context());
+			*busy = false;
+			if (result->code != 0) {
+				promise->Reject(context->NewString(result->error.c_str()));
+			} else if (result->rows.empty() && done) {
+				promise->Resolve(toIteratorResult(*context, undefined_value, true));
+			} else {
+				Value rows = context->NewArray();
+				for (size_t i = 0; i < result->rows.size(); ++i) {
+					rows.SetProperty((uint32_t)i, toJsRow(*context, *result, result->rows[i], raw));
+				}
+				promise->Resolve(toIteratorResult(*context, rows, false));
+			}
+			delete promise;
+		});
+	});
+	return promise->promise();
+}
+
+//break쳣˳ѭʱãǰ
+static Value returnCursor(JsCursor* pThis, Context& context, ArgList& args) {
+	pThis->cursor->Close();
+	Promise promise(context);
+	promise.Resolve(toIteratorResult(context, undefined_value, true));
+	return promise.promise();
+}
+
+static JSValue asyncIterator(JSContext* ctx, JSValueConst this_val, int argc, JSValueConst* argv) {
+	return JS_DupValue(ctx, this_val);
+}
+
+//options: {chunk, params, raw}
+static Value query(Storage* pThis, Context& context, ArgList& args) {
+	StorageParams params;
+	Value options = args[1];
+	if (!args[0].IsString() || !toStorageParams(context, options.IsObject() ? options.GetProperty("params") : undefined_value, &params)) {
+		return context.ThrowTypeError("invalid sql params");
+	}
+
+	size_t chunk = 1000;
+	bool raw = false;
+	if (options.IsObject()) {
+		if (options.HasProperty("chunk"))
+			chunk = options.GetProperty("chunk").ToUint32();
+		raw = options.GetProperty("raw").ToBool();
+	}
+
+	JSContext* ctx = context.context();
+	Value proto(ctx, JS_GetClassProto(ctx, Class<JsCursor>::class_id()));
+	Value symbol = context.Global().GetProperty("Symbol").GetProperty("asyncIterator");
+	JSAtom atom = JS_ValueToAtom(ctx, symbol);
+	if (!JS_HasProperty(ctx, proto, atom)) {
+		JS_DefinePropertyValue(ctx, proto, atom, JS_NewCFunction(ctx, asyncIterator, "[Symbol.asyncIterator]", 0), 0);
+	}
+	JS_FreeAtom(ctx, atom);
+
+	JsCursor* cursor = new JsCursor();
+	cursor->cursor = pThis->OpenCursor(args[0].ToStdString(), std::move(params), chunk);
+	cursor->busy = std::make_shared<bool>(false);
+	cursor->raw = raw;
+	return Class<JsCursor>::ToJs(context, cursor);
+}
+
 void RegisterStorage(qjs::Module* module) {
 	auto cls = module->ExportClass<Storage>("Storage");
 	cls.Init<deleteStorage>();
@@ -88,6 +633,24 @@ void RegisterStorage(qjs::Module* module) {
 	cls.AddFunc<close>("close");
 	cls.AddFunc<exec>("exec");
 	cls.AddFunc<escape>("escape");
+	cls.AddFunc<prepare>("prepare");
+	cls.AddFunc<batch>("batch");
+	cls.AddFunc<write>("write");
+	cls.AddFunc<read>("read");
+	cls.AddFunc<query>("query");
+
+	auto stmt = module->ExportClass<JsStatement>("Statement");
+	stmt.Init2<deleteStatement, markStatement>();
+	stmt.AddFunc<bindStatement>("bind");
+	stmt.AddFunc<rawStatement>("raw");
+	stmt.AddFunc<runStatement>("run");
+	stmt.AddFunc<allStatement>("all");
+	stmt.AddFunc<iterateStatement>("iterate");
+
+	auto cursor = module->ExportClass<JsCursor>("Cursor");
+	cursor.Init<deleteCursor>();
+	cursor.AddFunc<nextCursor>("next");
+	cursor.AddFunc<returnCursor>("return");
 }
 
 
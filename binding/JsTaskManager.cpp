@@ -7,6 +7,10 @@ using namespace DuiLib;
 
 #define WM_THREAD_MSG_ACTIVE WM_USER+0x92
 
+//ʱֵϵͳʱidtick()
+static const UINT_PTR kWheelTimerId = 1;
+static const uint32_t kWheelTick = 10;
+
 
 class TaskWindow :public CWindowWnd
 {
@@ -48,7 +52,9 @@ TaskManager* TaskManager::GetCurrent() {
 
 
 TaskManager::TaskManager()
-	:last_timer_id_(0)
+	:last_timer_id_(0), active_posted_(false),
+	timer_wheel_(kWheelTick, ::GetTickCount64()),
+	wheel_timer_set_(false), wheel_timer_due_(0)
 {
 	TlsSetValue(tls, this);
 	task_window_ = new TaskWindow(this);
@@ -62,77 +68,80 @@ TaskManager::~TaskManager() {
 }
 
 void TaskManager::PostTask(js_task_t task) {
-	std::lock_guard<std::mutex> locker(lock_);
-	tasks_.push(task);
-	task_window_->PostMessage(WM_THREAD_MSG_ACTIVE, 0, 0);
+	{
+		std::lock_guard<std::mutex> locker(lock_);
+		tasks_.push(std::move(task));
+	}
+	//ϢδǰֻͶһΣExcuteTasksִ
+	if (!active_posted_.exchange(true))
+		task_window_->PostMessage(WM_THREAD_MSG_ACTIVE, 0, 0);
 }
 
 uint32_t TaskManager::PostDelayTask(js_task_t task, uint32_t delay, bool repeat) {
-	uint32_t id = ::SetTimer(*task_window_, ++last_timer_id_, delay, nullptr);
-	std::lock_guard<std::mutex> locker(lock_);
-	timer_tasks_.insert(std::make_pair(id, std::make_shared<TimerTask>(task,repeat)));
+	uint32_t id = ++last_timer_id_;
+	if (id == 0)
+		id = ++last_timer_id_;
+	ResetDelayTask(id, std::move(task), delay, repeat);
 	return id;
 }
 
 void TaskManager::ResetDelayTask(uint32_t id, js_task_t task, uint32_t delay, bool repeat) {
 	assert(id > 0);
-	::SetTimer(*task_window_, id, delay, nullptr);
-
-	std::lock_guard<std::mutex> locker(lock_);
-	timer_tasks_.insert(std::make_pair(id, std::make_shared<TimerTask>(task, repeat)));
+	timer_wheel_.Schedule(id, ::GetTickCount64(), delay, repeat ? (delay > 0 ? delay : 1) : 0, std::move(task));
+	UpdateWheelTimer(false);
 }
 
 bool TaskManager::CancelDelayTask(uint32_t id) {
-	std::lock_guard<std::mutex> locker(lock_);
-	auto find = timer_tasks_.find(id);
-	if (find != timer_tasks_.end()) {
-		timer_tasks_.erase(find);
-		::KillTimer(*task_window_, id);
-		return true;
-	}
-	return false;
+	//ϵͳʱ޸ģںûԶֹͣ
+	return timer_wheel_.Cancel(id);
 }
 
 void TaskManager::ExcuteTasks() {
-	auto task = PopTask();
-	while (task) {
-		task();
-		task = PopTask();
+	//ǣִڼͶݵٴδϢ
+	active_posted_.exchange(false);
+
+	//һȡͶݵȫִڼ䲻
+	std::queue<js_task_t> tasks;
+	{
+		std::lock_guard<std::mutex> locker(lock_);
+		tasks.swap(tasks_);
+	}
+	while (!tasks.empty()) {
+		tasks.front()();
+		tasks.pop();
 	}
 }
 
 void TaskManager::OnTimer(uint32_t id) {
-	auto task = PopTimerTask(id);
-	if (task) {
-		task->task();
-	}
+	if (id != kWheelTimerId)
+		return;
 
-	if (!task->repeat)
-		::KillTimer(*task_window_, id);
+	timer_wheel_.Advance(::GetTickCount64());
+	UpdateWheelTimer(true);
 }
 
-js_task_t TaskManager::PopTask() {
-	std::lock_guard<std::mutex> locker(lock_);
-	if (tasks_.empty()) {
-		return nullptr;
+void TaskManager::UpdateWheelTimer(bool force) {
+	uint64_t now = ::GetTickCount64();
+	int64_t timeout = timer_wheel_.NextTimeout(now);
+	if (timeout < 0) {
+		if (wheel_timer_set_) {
+			::KillTimer(*task_window_, kWheelTimerId);
+			wheel_timer_set_ = false;
+		}
+		return;
 	}
-	auto task = tasks_.front();
-	tasks_.pop();
-	return std::move(task);
-}
 
-std::shared_ptr<TaskManager::TimerTask> TaskManager::PopTimerTask(uint32_t id) {
-	std::lock_guard<std::mutex> locker(lock_);
-	auto find = timer_tasks_.find(id);
-	if (find != timer_tasks_.end()) {
-		std::shared_ptr<TimerTask> task = find->second;
-		if(!task->repeat)
-			timer_tasks_.erase(find);
-		return task;
-	}
-	return nullptr;
-}
+	uint64_t due = now + timeout;
+	//õĶʱ絽ʱ
+	if (!force && wheel_timer_set_ && wheel_timer_due_ <= due)
+		return;
 
+	if (timeout < USER_TIMER_MINIMUM)
+		timeout = USER_TIMER_MINIMUM;
+	::SetTimer(*task_window_, kWheelTimerId, (UINT)timeout, nullptr);
+	wheel_timer_set_ = true;
+	wheel_timer_due_ = due;
+}
 
 
 }//namespace
@@ -4,6 +4,8 @@
 #include <mutex>
 #include <unordered_map>
 #include <memory>
+#include <atomic>
+#include "async/timer_wheel.h"
 
 namespace duijs {
 
@@ -20,30 +22,27 @@ public:
 
 	void PostTask(js_task_t task);
 
+	//ʱֻjs̵߳
 	uint32_t PostDelayTask(js_task_t task,uint32_t delay,bool repeat);
 	void ResetDelayTask(uint32_t id,js_task_t task, uint32_t delay, bool repeat);
 	bool CancelDelayTask(uint32_t id);
 private:
-	struct TimerTask {
-		TimerTask(js_task_t t, bool r)
-			:task(t),repeat(r)
-		{
-		}
-		js_task_t task;
-		bool repeat;
-	};
-
 	friend class TaskWindow;
 	void ExcuteTasks();
 	void OnTimer(uint32_t id);
-	js_task_t PopTask();
-	std::shared_ptr<TimerTask> PopTimerTask(uint32_t id);
+	//ʱһεʱΨһϵͳʱ
+	void UpdateWheelTimer(bool force);
 
 	TaskWindow* task_window_;
 	uint32_t last_timer_id_;
 	std::mutex lock_;
 	std::queue<js_task_t> tasks_;
-	std::unordered_map<uint32_t, std::shared_ptr<TimerTask> > timer_tasks_;
+	//ǷͶWM_THREAD_MSG_ACTIVEϢδ
+	std::atomic<bool> active_posted_;
+
+	TimerWheel timer_wheel_;
+	bool wheel_timer_set_;
+	uint64_t wheel_timer_due_;
 };
 
 
@@ -65,7 +65,11 @@ project "duijs"
 project "test"
 	language "C++"
 	kind "ConsoleApp"
+	defines{
+		"CURL_STATICLIB"
+	}
 	includedirs{
+		"third_party/libcurl/include",
 	}
 	files{
 		"test/*.h",
@@ -0,0 +1,238 @@
+#include "network/AssetCache.h"
+#include "network/FileDownload.h"
+#include "network/HttpClient.h"
+#include "async/image_loader.h"
+#include "stbimage/stb_image_write.h"
+#include "http_stub_server.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace network;
+
+static const char* kCacheDir = "asset_cache_test";
+
+static void waitFor(const std::atomic<int>& value, int expect) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (value < expect && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+//ͬȡصִ߳
+static AssetPtr fetch(const AssetCachePtr& cache, const std::string& url) {
+	std::atomic<int> done(0);
+	AssetPtr result;
+	cache->fetch(url, [&](AssetPtr asset) {
+		result = asset;
+		++done;
+	});
+	waitFor(done, 1);
+	return result;
+}
+
+static std::string readFile(const std::string& file) {
+	std::string content;
+	FILE* fp = fopen(file.c_str(), "rb");
+	if (fp) {
+		char buffer[4096];
+		size_t read = 0;
+		while ((read = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+			content.append(buffer, read);
+		fclose(fp);
+	}
+	return content;
+}
+
+static AssetCachePtr createCache(int64_t limit) {
+	AssetCachePtr cache = AssetCache::create(kCacheDir, limit);
+	cache->clear();
+	return cache;
+}
+
+//ͬһַĲϲΪһδ䣬ֱ֮д
+TEST(AssetCache, Coalesce) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest&, StubResponse& response) {
+		response.body = std::string(20000, 'c');
+		response.delay_ms = 100;
+	});
+
+	AssetCachePtr cache = createCache(1 << 20);
+	const int kCount = 8;
+	std::atomic<int> done(0);
+	std::atomic<int> succeed(0);
+	for (int i = 0; i < kCount; ++i) {
+		cache->fetch(server.Url("/avatar"), [&](AssetPtr asset) {
+			if (asset && readFile(asset->path) == std::string(20000, 'c'))
+				++succeed;
+			++done;
+		});
+	}
+	waitFor(done, kCount);
+	EXPECT_EQ(succeed, kCount);
+	EXPECT_EQ(server.requests(), 1);
+
+	AssetPtr asset = fetch(cache, server.Url("/avatar"));
+	ASSERT_TRUE(asset != nullptr);
+	EXPECT_EQ(asset->size, 20000);
+	EXPECT_EQ(server.requests(), 1);
+
+	AssetCacheStats stats = cache->getStats();
+	EXPECT_EQ(stats.misses, 1);
+	EXPECT_EQ(stats.coalesced, kCount - 1);
+	EXPECT_EQ(stats.hits, 1);
+	EXPECT_EQ(stats.bytes, 20000);
+	cache->clear();
+}
+
+//ͬĲַֻͬһļʧܵ󲻻
+TEST(AssetCache, Deduplicate) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest& request, StubResponse& response) {
+		if (request.path == "/missing") {
+			response.status = 404;
+			response.body = "not found";
+			return;
+		}
+		response.body = request.path == "/other" ? "other" : "same content";
+	});
+
+	AssetCachePtr cache = createCache(1 << 20);
+	AssetPtr a = fetch(cache, server.Url("/a"));
+	AssetPtr b = fetch(cache, server.Url("/b?size=64"));
+	AssetPtr other = fetch(cache, server.Url("/other"));
+	ASSERT_TRUE(a && b && other);
+	EXPECT_EQ(a->path, b->path);
+	EXPECT_NE(a->path, other->path);
+	EXPECT_EQ(readFile(b->path), "same content");
+
+	EXPECT_TRUE(fetch(cache, server.Url("/missing")) == nullptr);
+	EXPECT_TRUE(cache->find(server.Url("/missing")) == nullptr);
+
+	AssetCacheStats stats = cache->getStats();
+	EXPECT_EQ(stats.urls, 3);
+	EXPECT_EQ(stats.files, 2);
+	EXPECT_EQ(stats.deduplicated, 1);
+	EXPECT_EQ(stats.bytes, 17);
+
+	//һַƳļɾ
+	cache->remove(server.Url("/a"));
+	EXPECT_EQ(readFile(b->path), "same content");
+	cache->remove(server.Url("/b?size=64"));
+	EXPECT_EQ(cache->getStats().files, 1);
+	EXPECT_EQ(readFile(b->path), "");
+	cache->clear();
+}
+
+//ֽLRṶ
+TEST(AssetCache, LruAndIndex) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest& request, StubResponse& response) {
+		response.body = std::string(10000, request.path[1]);
+	});
+
+	{
+		AssetCachePtr cache = createCache(25000);
+		fetch(cache, server.Url("/a"));
+		fetch(cache, server.Url("/b"));
+		fetch(cache, server.Url("/a"));
+		fetch(cache, server.Url("/c"));
+		EXPECT_EQ(server.requests(), 3);
+		EXPECT_TRUE(cache->find(server.Url("/b")) == nullptr);
+		EXPECT_EQ(cache->getStats().bytes, 20000);
+	}
+
+	AssetCachePtr cache = AssetCache::create(kCacheDir, 25000);
+	AssetPtr a = cache->find(server.Url("/a"));
+	ASSERT_TRUE(a != nullptr);
+	EXPECT_EQ(readFile(a->path), std::string(10000, 'a'));
+	EXPECT_TRUE(cache->find(server.Url("/c")) != nullptr);
+	EXPECT_TRUE(cache->find(server.Url("/b")) == nullptr);
+	EXPECT_EQ(cache->getStats().urls, 2);
+	cache->clear();
+	EXPECT_EQ(cache->getStats().files, 0);
+}
+
+class CacheListener : public CurlDownloadListener {
+public:
+	void didFinish() override { ++finished; }
+	void didFail() override { ++failed; }
+
+	std::atomic<int> finished{ 0 };
+	std::atomic<int> failed{ 0 };
+};
+
+static void writePng(void* context, void* data, int size) {
+	((std::string*)context)->append((const char*)data, size);
+}
+
+//HttpClientCurlDownloadImageLoaderȡͬһַʱֻһ
+TEST(AssetCache, SharedBySubsystems) {
+	unsigned char pixels[4 * 4 * 3];
+	for (size_t i = 0; i < sizeof(pixels); ++i)
+		pixels[i] = (unsigned char)(i * 7);
+	std::string png;
+	ASSERT_TRUE(stbi_write_png_to_func(writePng, &png, 4, 4, 3, pixels, 0) != 0);
+
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([&](const StubRequest&, StubResponse& response) {
+		response.body = png;
+		response.delay_ms = 50;
+	});
+	const std::string url = server.Url("/avatar.png");
+
+	AssetCachePtr cache = createCache(1 << 20);
+	AssetCache::setDefault(cache);
+	ImageLoader::SetFetcher([cache](const std::string& url, std::function<void(const std::string&)> done) {
+		cache->fetch(url, [done](AssetPtr asset) {
+			done(asset ? asset->path : std::string());
+		});
+	});
+
+	std::atomic<int> done(0);
+	std::string body;
+	HttpClient* client = HttpClient::Create([](task_t task) { task(); });
+	HttpRequestPtr request = new HttpRequest();
+	request->setUrl(url);
+	request->setUseAssetCache(true);
+	request->setResponseCallback([&](HttpClient*, HttpResponse* response) {
+		EXPECT_TRUE(response->isSucceed());
+		body.assign(response->getResponseData()->begin(), response->getResponseData()->end());
+		++done;
+	});
+	client->send(request);
+
+	CacheListener listener;
+	RefCountedPtr<CurlDownload> download = CurlDownload::create(&listener, url, "asset_cache_download.png");
+	download->setUseAssetCache(true);
+	EXPECT_TRUE(download->start());
+
+	int width = 0;
+	ImageLoader loader;
+	loader.Load(url, [&](RefPtr<ImageData> image) {
+		if (image)
+			width = image->x();
+		++done;
+	});
+
+	waitFor(done, 2);
+	waitFor(listener.finished, 1);
+	EXPECT_EQ(body, png);
+	EXPECT_EQ(listener.finished, 1);
+	EXPECT_EQ(readFile("asset_cache_download.png"), png);
+	EXPECT_EQ(download->getResponseCode(), 200);
+	EXPECT_EQ(width, 4);
+	EXPECT_EQ(server.requests(), 1);
+
+	AssetCache::setDefault(nullptr);
+	ImageLoader::SetFetcher(nullptr);
+	HttpClient::Destroy(client);
+	remove("asset_cache_download.png");
+	cache->clear();
+}
@@ -0,0 +1,138 @@
+#include "duilib/UIlib.h"
+#include "duilib/Utils/AttributeTable.h"
+#include "gtest/gtest.h"
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace DuiLib;
+using Clock = std::chrono::steady_clock;
+
+//ؼIMPLEMENT_DUIATTRIBUTESÿԶܲ鵽idkAttr_öִֵСд
+template<class T>
+static void ExpectDeclaredAttributes(const char* cls) {
+	int count = 0;
+	const LPCTSTR* names = T::GetAttributeNames(count);
+	ASSERT_GT(count, 0) << cls;
+	for (int i = 0; i < count; ++i) {
+		EXPECT_EQ(i, T::GetAttributeId(names[i])) << cls << " " << names[i];
+		CDuiString upper = names[i];
+		upper.MakeUpper();
+		EXPECT_EQ(i, T::GetAttributeId(upper)) << cls << " " << names[i];
+	}
+	EXPECT_EQ(-1, T::GetAttributeId(_T("unknownattr"))) << cls;
+	EXPECT_EQ(-1, T::GetAttributeId(_T(""))) << cls;
+	EXPECT_EQ(-1, T::GetAttributeId(NULL)) << cls;
+}
+
+#define EXPECT_DECLARED_ATTRIBUTES(class_name) ExpectDeclaredAttributes<class_name>(#class_name)
+
+TEST(AttributeTable, Lookup) {
+	EXPECT_DECLARED_ATTRIBUTES(CControlUI);
+	EXPECT_DECLARED_ATTRIBUTES(CContainerUI);
+	EXPECT_DECLARED_ATTRIBUTES(CLabelUI);
+	EXPECT_DECLARED_ATTRIBUTES(CButtonUI);
+	EXPECT_DECLARED_ATTRIBUTES(COptionUI);
+	EXPECT_DECLARED_ATTRIBUTES(CEditUI);
+	EXPECT_DECLARED_ATTRIBUTES(CComboUI);
+	EXPECT_DECLARED_ATTRIBUTES(CListUI);
+	EXPECT_DECLARED_ATTRIBUTES(CListHeaderItemUI);
+	EXPECT_DECLARED_ATTRIBUTES(CListContainerHeaderItemUI);
+	EXPECT_DECLARED_ATTRIBUTES(CListTextExtElementUI);
+	EXPECT_DECLARED_ATTRIBUTES(CProgressUI);
+	EXPECT_DECLARED_ATTRIBUTES(CSliderUI);
+	EXPECT_DECLARED_ATTRIBUTES(CScrollBarUI);
+	EXPECT_DECLARED_ATTRIBUTES(CRichEditUI);
+	EXPECT_DECLARED_ATTRIBUTES(CHotKeyUI);
+	EXPECT_DECLARED_ATTRIBUTES(CActiveXUI);
+	EXPECT_DECLARED_ATTRIBUTES(CColorPaletteUI);
+	EXPECT_DECLARED_ATTRIBUTES(CGroupBoxUI);
+	EXPECT_DECLARED_ATTRIBUTES(CGifAnimUI);
+	EXPECT_DECLARED_ATTRIBUTES(CMenuElementUI);
+	EXPECT_DECLARED_ATTRIBUTES(CWaterfallListUI);
+}
+
+TEST(AttributeTable, WideAndSmall) {
+	static const wchar_t* const names[] = { L"selected" };
+	CAttributeTableT<wchar_t> one(names, 1);
+	EXPECT_EQ(0, one.GetId(L"Selected"));
+	EXPECT_EQ(-1, one.GetId(L"select"));
+
+	CAttributeTableT<wchar_t> empty(names, 0);
+	EXPECT_EQ(-1, empty.GetId(L"selected"));
+
+	//ظȡһ
+	static const char* const dup[] = { "a", "b", "A", "c" };
+	CAttributeTableT<char> table(dup, 4);
+	EXPECT_EQ(0, table.GetId("a"));
+	EXPECT_EQ(1, table.GetId("b"));
+	EXPECT_EQ(3, table.GetId("c"));
+}
+
+//ֹģ¶ܽ
+TEST(AttributeTable, Sizes) {
+	std::vector<std::string> storage;
+	for (int i = 0; i < 300; ++i)
+		storage.push_back("attr" + std::to_string(i * 7919));
+	std::vector<const char*> names;
+	for (size_t i = 0; i < storage.size(); ++i)
+		names.push_back(storage[i].c_str());
+	for (int n = 1; n <= 300; n += 13) {
+		CAttributeTableT<char> table(names.data(), n);
+		for (int i = 0; i < n; ++i) {
+			ASSERT_EQ(i, table.GetId(names[i])) << n;
+		}
+		if (n < 300) {
+			EXPECT_EQ(-1, table.GetId(names[n]));
+		}
+	}
+}
+
+//XMLгԷֲλĺ󲿡ԭCComboUICContainerUICControlUIȽ֣ÿһα
+TEST(AttributeTable, Benchmark) {
+	int counts[3] = { 0 };
+	const LPCTSTR* levels[3] = { CComboUI::GetAttributeNames(counts[0]), CContainerUI::GetAttributeNames(counts[1]),
+		CControlUI::GetAttributeNames(counts[2]) };
+	std::vector<LPCTSTR> chain;
+	for (int i = 0; i < 3; ++i)
+		chain.insert(chain.end(), levels[i], levels[i] + counts[i]);
+
+	static const LPCTSTR kLookups[] = { _T("name"), _T("width"), _T("height"), _T("bkcolor"), _T("text"), _T("font"),
+		_T("textcolor"), _T("normalimage"), _T("hotimage"), _T("pushedimage"), _T("padding"), _T("visible"),
+		_T("tooltip"), _T("align"), _T("unknownattr") };
+	const int kLookupCount = sizeof(kLookups) / sizeof(kLookups[0]);
+	const int kRounds = 20000;
+
+	long long sum = 0;
+	auto start = Clock::now();
+	for (int round = 0; round < kRounds; ++round) {
+		for (int i = 0; i < kLookupCount; ++i) {
+			int id = -1;
+			for (size_t j = 0; j < chain.size() && id < 0; ++j) {
+				if (_tcsicmp(kLookups[i], chain[j]) == 0)
+					id = (int)j;
+			}
+			sum += id;
+		}
+	}
+	double linear_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+	long long check = 0;
+	start = Clock::now();
+	for (int round = 0; round < kRounds; ++round) {
+		for (int i = 0; i < kLookupCount; ++i) {
+			int id = CComboUI::GetAttributeId(kLookups[i]);
+			if (id < 0 && (id = CContainerUI::GetAttributeId(kLookups[i])) >= 0)
+				id += counts[0];
+			else if (id < 0 && (id = CControlUI::GetAttributeId(kLookups[i])) >= 0)
+				id += counts[0] + counts[1];
+			check += id;
+		}
+	}
+	double hash_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+	printf("%d attributes: linear compare %.1f ns, perfect hash %.1f ns per lookup\n",
+		(int)chain.size(), linear_ns / (kRounds * kLookupCount), hash_ns / (kRounds * kLookupCount));
+	EXPECT_EQ(sum, check);
+}
@@ -0,0 +1,637 @@
+#include "duilib/Utils/CssSheet.h"
+#include "gtest/gtest.h"
+#include <stdlib.h>
+#include <ctype.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static css_string cssText(const char* text) {
+	std::string s(text);
+	return css_string(s.begin(), s.end());
+}
+
+static CssValue parseValue(const char* text) {
+	CssValue value;
+	value.Parse(cssText(text));
+	return value;
+}
+
+TEST(CssValue, Parse) {
+	CssValue value = parseValue("1,-2,30,400");
+	EXPECT_EQ(4, value.count);
+	EXPECT_TRUE(value.list);
+	EXPECT_EQ(1, value.numbers[0]);
+	EXPECT_EQ(-2, value.numbers[1]);
+	EXPECT_EQ(30, value.numbers[2]);
+	EXPECT_EQ(400, value.numbers[3]);
+
+	value = parseValue("12");
+	EXPECT_EQ(1, value.count);
+	EXPECT_FALSE(value.list);
+	EXPECT_EQ(12, value.numbers[0]);
+	EXPECT_EQ(0, value.numbers[3]);
+
+	//ɫSetAttributeһհ׺#
+	EXPECT_EQ(0xFF00FF00ul, parseValue(" #FF00FF00").color);
+	EXPECT_EQ(0xFFFFFFFFul, parseValue("FFFFFFFF").color);
+
+	EXPECT_TRUE(parseValue("true").boolean);
+	EXPECT_TRUE(parseValue("TRUE").boolean);
+	EXPECT_FALSE(parseValue("false").boolean);
+	EXPECT_FALSE(parseValue("trueish").boolean);
+	EXPECT_FALSE(parseValue("").boolean);
+}
+
+TEST(CssSheet, Compile) {
+	CssSheet sheet;
+	ASSERT_TRUE(sheet.Parse(cssText(".row, #first { height: 24; bkcolor: #FF202020; padding: 1,2,3,4 } Button { width: 80 }")));
+
+	auto row = sheet.GetStylesByClass(cssText("row"));
+	ASSERT_TRUE(row != nullptr);
+	//ѡͬһĹ
+	EXPECT_EQ(row, sheet.GetStylesById(cssText("first")));
+	ASSERT_EQ(3u, row->declarations.size());
+	//ԭCssStyles˳һ
+	EXPECT_EQ(cssText("bkcolor"), row->declarations[0].name);
+	EXPECT_EQ(0xFF202020ul, row->declarations[0].parsed.color);
+	EXPECT_EQ(cssText("height"), row->declarations[1].name);
+	EXPECT_EQ(24, row->declarations[1].parsed.numbers[0]);
+	EXPECT_EQ(cssText("padding"), row->declarations[2].name);
+	EXPECT_EQ(4, row->declarations[2].parsed.numbers[3]);
+
+	auto button = sheet.GetStylesByElement(cssText("Button"));
+	ASSERT_TRUE(button != nullptr);
+	ASSERT_EQ(1u, button->declarations.size());
+	EXPECT_EQ(80, button->declarations[0].parsed.numbers[0]);
+
+	//ͬѡֵĹ滻ǰ
+	ASSERT_TRUE(sheet.Parse(cssText(".row { width: 10 }")));
+	row = sheet.GetStylesByClass(cssText("row"));
+	ASSERT_EQ(1u, row->declarations.size());
+	EXPECT_EQ(10, row->declarations[0].parsed.numbers[0]);
+}
+
+static CssElement element(const char* tag, const char* id = "", const char* classes = "") {
+	CssElement e;
+	e.tag = cssText(tag);
+	e.id = cssText(id);
+	e.SetClasses(cssText(classes));
+	return e;
+}
+
+//˳ȡheightֵжƥЩ
+static std::vector<long> heights(const CssRuleList& rules) {
+	std::vector<long> result;
+	for (size_t i = 0; i < rules.size(); ++i)
+		result.push_back(rules[i]->declarations[0].parsed.numbers[0]);
+	return result;
+}
+
+TEST(CssSelector, Parse) {
+	CssSelector selector;
+	ASSERT_TRUE(selector.Parse(cssText("List  .row Button#ok.btn.primary")));
+	ASSERT_EQ(3u, selector.compounds.size());
+	EXPECT_EQ(cssText("List"), selector.compounds[0].tag);
+	EXPECT_EQ(cssText("row"), selector.compounds[1].classes[0]);
+	EXPECT_EQ(cssText("Button"), selector.compounds[2].tag);
+	EXPECT_EQ(cssText("ok"), selector.compounds[2].id);
+	EXPECT_EQ(2u, selector.compounds[2].classes.size());
+	EXPECT_EQ((1u << 20) | (3u << 10) | 2u, selector.specificity);
+
+	ASSERT_TRUE(selector.Parse(cssText("* .row")));
+	EXPECT_TRUE(selector.compounds[0].tag.empty());
+
+	//ֵ֧Ϸα
+	EXPECT_FALSE(selector.Parse(cssText("List > .row")));
+	EXPECT_FALSE(selector.Parse(cssText("Button:hover")));
+	EXPECT_FALSE(selector.Parse(cssText(".")));
+	EXPECT_FALSE(selector.Parse(cssText("")));
+}
+
+TEST(CssSheet, MatchCompound) {
+	CssSheet sheet;
+	ASSERT_TRUE(sheet.Parse(cssText(
+		"#ok { height: 5 } .primary.btn { height: 4 } Button { height: 1 } .btn { height: 2 }"
+		".primary { height: 3 } Button.btn { height: 6 } * { height: 0 } .other { height: 9 }")));
+	EXPECT_FALSE(sheet.HasDescendantSelectors());
+
+	//ȼӵ͵ߣͬȼ˳
+	std::vector<CssElement> none;
+	auto rules = sheet.Match(element("Button", "ok", " btn  primary "), none);
+	EXPECT_EQ((std::vector<long>{ 0, 1, 2, 3, 6, 4, 5 }), heights(*rules));
+
+	rules = sheet.Match(element("Label", "", "btn"), none);
+	EXPECT_EQ((std::vector<long>{ 0, 2 }), heights(*rules));
+	rules = sheet.Match(element("Label"), none);
+	EXPECT_EQ((std::vector<long>{ 0 }), heights(*rules));
+
+	//ѡԿֱӰȡ
+	EXPECT_TRUE(sheet.GetStylesByClass(cssText("btn")) != nullptr);
+	EXPECT_TRUE(sheet.GetStylesByClass(cssText("primary.btn")) == nullptr);
+}
+
+TEST(CssSheet, MatchDescendant) {
+	CssSheet sheet;
+	ASSERT_TRUE(sheet.Parse(cssText(
+		".row { height: 1 } List .row { height: 2 } #main List .row { height: 3 }"
+		".dark .row, .row.hot { height: 4 } Menu * .row { height: 5 }")));
+	EXPECT_TRUE(sheet.HasDescendantSelectors());
+
+	std::vector<CssElement> ancestors;
+	ancestors.push_back(element("HorizontalLayout"));
+	ancestors.push_back(element("List", "list1"));
+	ancestors.push_back(element("VerticalLayout", "main", "dark"));
+	auto rules = sheet.Match(element("Label", "", "row"), ancestors);
+	EXPECT_EQ((std::vector<long>{ 1, 2, 4, 3 }), heights(*rules));
+
+	//һѡƥʱֻӦһ
+	rules = sheet.Match(element("Label", "", "row hot"), ancestors);
+	EXPECT_EQ((std::vector<long>{ 1, 2, 4, 3 }), heights(*rules));
+
+	//˳򲻶Բƥ
+	std::vector<CssElement> reversed(ancestors.rbegin(), ancestors.rend());
+	reversed[0].classes.clear();
+	rules = sheet.Match(element("Label", "", "row"), reversed);
+	EXPECT_EQ((std::vector<long>{ 1, 2 }), heights(*rules));
+
+	//*Ҫһм
+	std::vector<CssElement> menu;
+	menu.push_back(element("Menu"));
+	EXPECT_EQ((std::vector<long>{ 1 }), heights(*sheet.Match(element("Label", "", "row"), menu)));
+	menu.insert(menu.begin(), element("MenuElement"));
+	EXPECT_EQ((std::vector<long>{ 1, 5 }), heights(*sheet.Match(element("Label", "", "row"), menu)));
+}
+
+//беĸֻnameͬͬһƥ
+TEST(CssSheet, MatchMemoized) {
+	CssSheet sheet;
+	ASSERT_TRUE(sheet.Parse(cssText("List .row { height: 2 } #item7 { height: 7 } .row { height: 1 }")));
+	std::vector<CssElement> ancestors;
+	ancestors.push_back(element("ListBody"));
+	ancestors.push_back(element("List", "list", "big"));
+
+	auto first = sheet.Match(element("ListContainerElement", "item1", "row"), ancestors);
+	auto second = sheet.Match(element("ListContainerElement", "item2", "row unused"), ancestors);
+	EXPECT_EQ(first, second);
+	EXPECT_EQ((std::vector<long>{ 1, 2 }), heights(*first));
+
+	auto seventh = sheet.Match(element("ListContainerElement", "item7", "row"), ancestors);
+	EXPECT_NE(first, seventh);
+	EXPECT_EQ((std::vector<long>{ 1, 2, 7 }), heights(*seventh));
+
+	//½󻺴ʧЧ
+	ASSERT_TRUE(sheet.Parse(cssText(".row { height: 3 }")));
+	auto reparsed = sheet.Match(element("ListContainerElement", "item1", "row"), ancestors);
+	EXPECT_EQ((std::vector<long>{ 3, 2 }), heights(*reparsed));
+}
+
+static bool iequals(const char* a, const char* b) {
+	for (; *a && *b; ++a, ++b) {
+		if (tolower((unsigned char)*a) != tolower((unsigned char)*b))
+			return false;
+	}
+	return *a == *b;
+}
+
+//õĿؼģCControlUI÷ʽ
+struct FakeControl {
+	long height = 0;
+	long width = 0;
+	unsigned long bkcolor = 0;
+	long padding[4] = { 0 };
+	bool visible = false;
+	css_string tooltip;
+	int fallbacks = 0;
+
+	//SetAttributeһȽ֣ÿ½ַ
+	void SetAttribute(const css_string& name, const css_string& value) {
+		std::string n(name.begin(), name.end());
+		std::string v(value.begin(), value.end());
+		const char* s = v.c_str();
+		char* end = nullptr;
+		if (iequals(n.c_str(), "pos")) {}
+		else if (iequals(n.c_str(), "padding")) {
+			padding[0] = strtol(s, &end, 10);
+			padding[1] = strtol(end + 1, &end, 10);
+			padding[2] = strtol(end + 1, &end, 10);
+			padding[3] = strtol(end + 1, &end, 10);
+		}
+		else if (iequals(n.c_str(), "bkcolor")) {
+			while (*s > 0 && *s <= ' ') ++s;
+			if (*s == '#') ++s;
+			bkcolor = strtoul(s, nullptr, 16);
+		}
+		else if (iequals(n.c_str(), "bordercolor")) {}
+		else if (iequals(n.c_str(), "width")) width = atoi(s);
+		else if (iequals(n.c_str(), "height")) height = atoi(s);
+		else if (iequals(n.c_str(), "minwidth")) {}
+		else if (iequals(n.c_str(), "maxwidth")) {}
+		else if (iequals(n.c_str(), "tooltip")) tooltip = value;
+		else if (iequals(n.c_str(), "enabled")) {}
+		else if (iequals(n.c_str(), "visible")) visible = iequals(s, "true");
+		else ++fallbacks;
+	}
+
+	static CssSetter GetCssSetter(const css_string& name) {
+		std::string n(name.begin(), name.end());
+		if (n == "height")
+			return [](void* target, const CssDeclaration& d) { static_cast<FakeControl*>(target)->height = d.parsed.numbers[0]; };
+		if (n == "width")
+			return [](void* target, const CssDeclaration& d) { static_cast<FakeControl*>(target)->width = d.parsed.numbers[0]; };
+		if (n == "bkcolor")
+			return [](void* target, const CssDeclaration& d) { static_cast<FakeControl*>(target)->bkcolor = d.parsed.color; };
+		if (n == "padding")
+			return [](void* target, const CssDeclaration& d) { memcpy(static_cast<FakeControl*>(target)->padding, d.parsed.numbers, sizeof(d.parsed.numbers)); };
+		if (n == "visible")
+			return [](void* target, const CssDeclaration& d) { static_cast<FakeControl*>(target)->visible = d.parsed.boolean; };
+		if (n == "tooltip")
+			return [](void* target, const CssDeclaration& d) { static_cast<FakeControl*>(target)->tooltip = d.value; };
+		return nullptr;
+	}
+
+	//CPaintManagerUI::ApplyCssͬӦ
+	void ApplyCompiled(const CssRule& rule, int* resolves = nullptr) {
+		static const int kType = 0;
+		const std::vector<CssSetter>& setters = rule.Resolve(&kType, [resolves](const CssDeclaration& d) {
+			if (resolves)
+				++*resolves;
+			return GetCssSetter(d.name);
+		});
+		for (size_t i = 0; i < setters.size(); ++i) {
+			if (setters[i])
+				setters[i](this, rule.declarations[i]);
+			else
+				SetAttribute(rule.declarations[i].name, rule.declarations[i].value);
+		}
+	}
+
+	void ApplyStrings(const CssRule& rule) {
+		for (auto itr = rule.styles.begin(); itr != rule.styles.end(); ++itr)
+			SetAttribute(itr->first, itr->second);
+	}
+};
+
+static const char kRowCss[] = ".row { height: 24; width: 300; bkcolor: #FF202020; padding: 4,2,4,2; visible: true; tooltip: row; cursor: hand }";
+
+TEST(CssRule, ResolveOncePerType) {
+	CssSheet sheet;
+	ASSERT_TRUE(sheet.Parse(cssText(kRowCss)));
+	auto row = sheet.GetStylesByClass(cssText("row"));
+	ASSERT_TRUE(row != nullptr);
+
+	int resolves = 0;
+	FakeControl compiled[3];
+	for (int i = 0; i < 3; ++i)
+		compiled[i].ApplyCompiled(*row, &resolves);
+	EXPECT_EQ((int)row->declarations.size(), resolves);
+
+	//ַʽͬûsetterԻ˵SetAttribute
+	FakeControl strings;
+	strings.ApplyStrings(*row);
+	for (int i = 0; i < 3; ++i) {
+		EXPECT_EQ(strings.height, compiled[i].height);
+		EXPECT_EQ(strings.width, compiled[i].width);
+		EXPECT_EQ(strings.bkcolor, compiled[i].bkcolor);
+		EXPECT_EQ(0, memcmp(strings.padding, compiled[i].padding, sizeof(strings.padding)));
+		EXPECT_EQ(strings.visible, compiled[i].visible);
+		EXPECT_EQ(strings.tooltip, compiled[i].tooltip);
+		EXPECT_EQ(1, compiled[i].fallbacks);
+	}
+	EXPECT_EQ(24, strings.height);
+	EXPECT_EQ(0xFF202020ul, strings.bkcolor);
+
+	//ͬͷֱ
+	static const int kOtherType = 0;
+	int others = 0;
+	row->Resolve(&kOtherType, [&others](const CssDeclaration&) { ++others; return (CssSetter)nullptr; });
+	row->Resolve(&kOtherType, [&others](const CssDeclaration&) { ++others; return (CssSetter)nullptr; });
+	EXPECT_EQ((int)row->declarations.size(), others);
+}
+
+//2000Ӧͬһ򣬶Աַͱsetter
+TEST(CssRule, Benchmark) {
+	const int kRows = 2000;
+	const int kRounds = 20;
+	CssSheet sheet;
+	ASSERT_TRUE(sheet.Parse(cssText(kRowCss)));
+	auto row = sheet.GetStylesByClass(cssText("row"));
+	ASSERT_TRUE(row != nullptr);
+
+	std::vector<FakeControl> controls(kRows);
+	auto start = Clock::now();
+	for (int round = 0; round < kRounds; ++round) {
+		for (int i = 0; i < kRows; ++i)
+			controls[i].ApplyStrings(*row);
+	}
+	double strings_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for (int round = 0; round < kRounds; ++round) {
+		for (int i = 0; i < kRows; ++i)
+			controls[i].ApplyCompiled(*row);
+	}
+	double compiled_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	printf("%d rows x %d declarations: strings %.3f ms, compiled %.3f ms per pass\n",
+		kRows, (int)row->declarations.size(), strings_ms / kRounds, compiled_ms / kRounds);
+	EXPECT_EQ(24, controls[kRows - 1].height);
+}
+
+//1000бÿƥһΣԱƥʹ뻺
+TEST(CssSheet, MatchBenchmark) {
+	std::string css;
+	for (int i = 0; i < 200; ++i) {
+		char rule[128];
+		snprintf(rule, sizeof(rule), ".c%d { height: %d } List .c%d Label { width: %d } #n%d { height: 1 }", i, i, i, i, i);
+		css += rule;
+	}
+	css += ".row { height: 24 } List .row { width: 300 }";
+	CssSheet sheet;
+	ASSERT_TRUE(sheet.Parse(cssText(css.c_str())));
+
+	std::vector<CssSelector> selectors;
+	std::string text(css);
+	for (size_t pos = 0; pos < text.size();) {
+		size_t open = text.find('{', pos);
+		CssSelector selector;
+		if (selector.Parse(cssText(text.substr(pos, open - pos).c_str())))
+			selectors.push_back(selector);
+		pos = text.find('}', open) + 1;
+	}
+
+	std::vector<CssElement> ancestors;
+	ancestors.push_back(element("ListBody"));
+	ancestors.push_back(element("List", "list", "c3"));
+	ancestors.push_back(element("VerticalLayout", "root"));
+	const int kRows = 1000;
+	std::vector<CssElement> rows;
+	for (int i = 0; i < kRows; ++i) {
+		char name[32];
+		snprintf(name, sizeof(name), "item%d", i);
+		rows.push_back(element("ListContainerElement", name, "row"));
+	}
+
+	int linear = 0;
+	auto start = Clock::now();
+	for (int i = 0; i < kRows; ++i) {
+		for (size_t j = 0; j < selectors.size(); ++j)
+			linear += selectors[j].Matches(rows[i], ancestors);
+	}
+	double linear_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	int indexed = 0;
+	start = Clock::now();
+	for (int i = 0; i < kRows; ++i)
+		indexed += (int)sheet.Match(rows[i], ancestors)->size();
+	double indexed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	printf("%d rows x %d selectors: linear %.3f ms, indexed %.3f ms\n",
+		kRows, (int)selectors.size(), linear_ms, indexed_ms);
+	EXPECT_EQ(2 * kRows, linear);
+	EXPECT_EQ(linear, indexed);
+}
+
+static std::shared_ptr<const CssSheet> parseSheet(const char* text) {
+	auto sheet = std::make_shared<CssSheet>();
+	sheet->Parse(cssText(text));
+	return sheet;
+}
+
+//ڵʽŶȼȽϣͬʱصں
+TEST(CssSheetView, Layers) {
+	auto common = parseSheet("#ok { height: 5 } Button { height: 1 } .btn { height: 2 }");
+	auto window = parseSheet("Button { height: 11 } .btn { height: 12 }");
+	CssSheetView view;
+	EXPECT_TRUE(view.Add(cssText("common.css"), common));
+	EXPECT_TRUE(view.Add(cssText(""), window));
+
+	//Ӳظͬһļͬһʽٵ
+	EXPECT_FALSE(view.Add(cssText("common.css"), common));
+	EXPECT_FALSE(view.Add(cssText(""), window));
+	std::vector<CssElement> none;
+	auto rules = view.Match(element("Button", "ok", "btn"), none);
+	EXPECT_EQ((std::vector<long>{ 1, 11, 2, 12, 5 }), heights(*rules));
+	//ֻò
+	EXPECT_EQ(common->GetStylesById(cssText("ok")), rules->back());
+	EXPECT_EQ(rules, view.Match(element("Button", "ok", "btn"), none));
+	EXPECT_EQ(window->GetStylesByElement(cssText("Button")), view.GetStylesByElement(cssText("Button")));
+	EXPECT_EQ(common->GetStylesById(cssText("ok")), view.Match(element("Label", "ok"), none)->back());
+
+	//ȸֻ滻ӦĲ
+	auto updated = parseSheet("Button { height: 21 }");
+	EXPECT_TRUE(view.Update(cssText("common.css"), updated));
+	EXPECT_FALSE(view.Update(cssText("common.css"), updated));
+	EXPECT_EQ((std::vector<long>{ 21, 11, 12 }), heights(*view.Match(element("Button", "ok", "btn"), none)));
+	EXPECT_EQ(1u, view.GetPaths().size());
+}
+
+TEST(CssSheetCache, ShareAndReload) {
+	CssSheetCache cache;
+	int converts = 0;
+	CssSheetCache::Converter convert = [&converts](const uint8_t* data, size_t size) {
+		++converts;
+		return css_string(data, data + size);
+	};
+
+	std::string v1 = ".row { height: 24 }";
+	bool result = false;
+	auto first = cache.Load(cssText("skin/common.css"), (const uint8_t*)v1.data(), v1.size(), convert, &result);
+	EXPECT_TRUE(result);
+	//ڼͬһļõͬһݱתͽ
+	for (int i = 0; i < 10; ++i) {
+		auto again = cache.Load(cssText("skin/common.css"), (const uint8_t*)v1.data(), v1.size(), convert);
+		EXPECT_EQ(first, again);
+	}
+	EXPECT_EQ(1, converts);
+
+	//ݱ仯ʱ°汾ɰ汾ԳĴȻЧ
+	std::string v2 = ".row { height: 30 }";
+	auto second = cache.Load(cssText("skin/common.css"), (const uint8_t*)v2.data(), v2.size(), convert);
+	EXPECT_NE(first, second);
+	EXPECT_EQ(second, cache.Get(cssText("skin/common.css")));
+	EXPECT_EQ(24, first->GetStylesByClass(cssText("row"))->declarations[0].parsed.numbers[0]);
+	EXPECT_EQ(30, second->GetStylesByClass(cssText("row"))->declarations[0].parsed.numbers[0]);
+	EXPECT_TRUE(cache.Get(cssText("skin/other.css")) == nullptr);
+
+	//ʽݹ
+	auto inline1 = cache.Parse(cssText("Button { width: 80 }"));
+	EXPECT_EQ(inline1, cache.Parse(cssText("Button { width: 80 }")));
+	EXPECT_NE(inline1, cache.Parse(cssText("Button { width: 81 }")));
+	cache.Parse(cssText("Button { width 80 }"), &result);
+	EXPECT_FALSE(result);
+
+	CssSheetCacheStats stats = cache.GetStats();
+	EXPECT_EQ(5, stats.parses);
+	EXPECT_EQ(11, stats.hits);
+	EXPECT_EQ(4u, stats.sheets);
+
+	cache.Clear();
+	EXPECT_EQ(0u, cache.GetStats().sheets);
+}
+
+//ڼͬһʽÿνʹû
+TEST(CssSheetCache, Benchmark) {
+	std::string css;
+	for (int i = 0; i < 300; ++i) {
+		char rule[160];
+		snprintf(rule, sizeof(rule), ".c%d { height: %d; bkcolor: #FF2020%02X; padding: 1,2,3,4 } List .c%d Label { width: %d }", i, i, i & 0xFF, i, i);
+		css += rule;
+	}
+	const int kWindows = 30;
+	CssSheetCache::Converter convert = [](const uint8_t* data, size_t size) { return css_string(data, data + size); };
+
+	auto start = Clock::now();
+	for (int i = 0; i < kWindows; ++i) {
+		CssSheet sheet;
+		sheet.Parse(convert((const uint8_t*)css.data(), css.size()));
+	}
+	double parse_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	CssSheetCache cache;
+	start = Clock::now();
+	for (int i = 0; i < kWindows; ++i)
+		cache.Load(cssText("common.css"), (const uint8_t*)css.data(), css.size(), convert);
+	double cached_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	printf("%d windows, %d bytes css: parse %.3f ms, cached %.3f ms per window\n",
+		kWindows, (int)css.size(), parse_ms / kWindows, cached_ms / kWindows);
+	EXPECT_EQ(1, cache.GetStats().parses);
+}
+
+//ֻѡõб仯ֲҪƥ
+TEST(CssSheet, Invalidation) {
+	CssSheet sheet;
+	ASSERT_TRUE(sheet.Parse(cssText(".row { height: 1 } .dark Label { height: 2 } #title { height: 3 } .dark { height: 4 }")));
+	EXPECT_EQ(kCssInvalidateSelf, sheet.GetInvalidation(element("Label"), element("Label", "", "row")));
+	EXPECT_EQ(kCssInvalidateSelf, sheet.GetInvalidation(element("Label", "", "row big"), element("Label", "", "big")));
+	EXPECT_EQ(0, sheet.GetInvalidation(element("Label", "", "row"), element("Label", "", "big row")));
+	EXPECT_EQ(0, sheet.GetInvalidation(element("Label", "", "row"), element("Label", "", "row")));
+	EXPECT_EQ(kCssInvalidateSelf | kCssInvalidateDescendants,
+		sheet.GetInvalidation(element("VerticalLayout", "", "dark"), element("VerticalLayout", "", "light")));
+	EXPECT_EQ(kCssInvalidateSelf, sheet.GetInvalidation(element("Label", "name"), element("Label", "title")));
+	EXPECT_EQ(0, sheet.GetInvalidation(element("Label", "name"), element("Label", "other")));
+
+	CssSheetView view;
+	EXPECT_EQ(0, view.GetInvalidation(element("Label"), element("Label", "", "row")));
+	view.Add(cssText(""), parseSheet(".row Option { height: 5 }"));
+	EXPECT_EQ(kCssInvalidateDescendants, view.GetInvalidation(element("Label"), element("Label", "", "row")));
+	view.Add(cssText("theme.css"), parseSheet(".row { height: 6 }"));
+	EXPECT_EQ(kCssInvalidateSelf | kCssInvalidateDescendants, view.GetInvalidation(element("Label"), element("Label", "", "row")));
+}
+
+static std::vector<css_string> declarationNames(const std::vector<CssStyleState::Declaration>& declarations) {
+	std::vector<css_string> names;
+	for (size_t i = 0; i < declarations.size(); ++i)
+		names.push_back(declarations[i].first->declarations[declarations[i].second].name);
+	return names;
+}
+
+TEST(CssStyleState, Update) {
+	CssSheetView view;
+	view.Add(cssText("theme.css"), parseSheet(".row { height: 24; width: 300; tooltip: a } .row.sel { height: 30 }"));
+	std::vector<CssElement> none;
+	CssStyleState state;
+
+	//һӦȫ
+	auto changes = state.Update(view.Match(element("Label", "", "row"), none));
+	EXPECT_EQ(3u, changes.size());
+	EXPECT_TRUE(state.Update(view.Match(element("Label", "", "row"), none)).empty());
+
+	//ֵֻ仯
+	changes = state.Update(view.Match(element("Label", "", "row sel"), none));
+	ASSERT_EQ(1u, changes.size());
+	EXPECT_EQ(30, changes[0].first->declarations[changes[0].second].parsed.numbers[0]);
+	changes = state.Update(view.Match(element("Label", "", "row"), none));
+	ASSERT_EQ(1u, changes.size());
+	EXPECT_EQ(24, changes[0].first->declarations[changes[0].second].parsed.numbers[0]);
+
+	//⣺ֵͬ裬Բ
+	state.SetInline(cssText("width"));
+	EXPECT_TRUE(state.IsInline(cssText("width")));
+	EXPECT_TRUE(view.Update(cssText("theme.css"), parseSheet(".row { width: 200; height: 24; bkcolor: #FF000000; tooltip: b }")));
+	changes = state.Update(view.Match(element("Label", "", "row"), none));
+	EXPECT_EQ((std::vector<css_string>{ cssText("bkcolor"), cssText("tooltip") }), declarationNames(changes));
+
+	//ƥκιʱԭֵ
+	EXPECT_TRUE(state.Update(view.Match(element("Label"), none)).empty());
+	EXPECT_TRUE(state.GetRules()->empty());
+
+	//ؼżʽһҲ
+	CssStyleState created;
+	created.SetInline(cssText("height"));
+	changes = created.Update(view.Match(element("Label", "", "row"), none));
+	EXPECT_EQ((std::vector<css_string>{ cssText("bkcolor"), cssText("tooltip"), cssText("width") }), declarationNames(changes));
+}
+
+//лʱӦֻӦñ仯ĶԱ
+TEST(CssStyleState, ThemeSwitchBenchmark) {
+	const char kLight[] = ".row { height: 24; width: 300; bkcolor: #FFFFFFFF; padding: 4,2,4,2; tooltip: row } "
+		".title { height: 32; bkcolor: #FFF0F0F0 } List .row { bordercolor: #FFCCCCCC }";
+	const char kDark[] = ".row { height: 24; width: 300; bkcolor: #FF202020; padding: 4,2,4,2; tooltip: row } "
+		".title { height: 32; bkcolor: #FF303030 } List .row { bordercolor: #FF444444 }";
+	const int kRows = 1000;
+	std::vector<CssElement> ancestors;
+	ancestors.push_back(element("ListBody"));
+	ancestors.push_back(element("List", "list"));
+	std::vector<CssElement> rows;
+	for (int i = 0; i < kRows; ++i)
+		rows.push_back(element("ListContainerElement", "", i % 10 ? "row" : "row title"));
+
+	CssSheetView view;
+	view.Add(cssText("theme.css"), parseSheet(kLight));
+	std::vector<FakeControl> controls(kRows);
+	std::vector<CssStyleState> states(kRows);
+	for (int i = 0; i < kRows; ++i)
+		states[i].Update(view.Match(rows[i], ancestors));
+
+	//ÿл½ıƥܸ
+	int full = 0;
+	double full_ms = 0;
+	for (int round = 0; round < 2; ++round) {
+		view.Update(cssText("theme.css"), parseSheet(round ? kLight : kDark));
+		auto start = Clock::now();
+		for (int i = 0; i < kRows; ++i) {
+			auto rules = view.Match(rows[i], ancestors);
+			for (size_t j = 0; j < rules->size(); ++j) {
+				controls[i].ApplyCompiled(*(*rules)[j]);
+				full += (int)(*rules)[j]->declarations.size();
+			}
+		}
+		full_ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	int applied = 0;
+	double incremental_ms = 0;
+	for (int round = 0; round < 2; ++round) {
+		view.Update(cssText("theme.css"), parseSheet(round ? kLight : kDark));
+		auto start = Clock::now();
+		for (int i = 0; i < kRows; ++i) {
+			auto changes = states[i].Update(view.Match(rows[i], ancestors));
+			//CPaintManagerUI::ApplyCssһʹÿͻsetter
+			for (size_t j = 0; j < changes.size(); ++j) {
+				static const int kType = 0;
+				const CssRule* rule = changes[j].first;
+				const std::vector<CssSetter>& setters = rule->Resolve(&kType, [](const CssDeclaration& d) {
+					return FakeControl::GetCssSetter(d.name);
+				});
+				const CssDeclaration& declaration = rule->declarations[changes[j].second];
+				if (setters[changes[j].second])
+					setters[changes[j].second](&controls[i], declaration);
+				else
+					controls[i].SetAttribute(declaration.name, declaration.value);
+			}
+			applied += (int)changes.size();
+		}
+		incremental_ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	printf("theme switch %d rows: full %d declarations %.3f ms, incremental %d declarations %.3f ms\n",
+		kRows, full / 2, full_ms / 2, applied / 2, incremental_ms / 2);
+	EXPECT_EQ(kRows * 2 * 2, applied);
+	EXPECT_LT(applied, full);
+	EXPECT_EQ(0xFFFFFFFFul, controls[1].bkcolor);
+}
@@ -0,0 +1,420 @@
+#include "network/FileDownload.h"
+#include "http_stub_server.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <time.h>
+
+using namespace network;
+
+static const char* kDownloadPath = "file_download_test.bin";
+
+class TestListener : public CurlDownloadListener {
+public:
+	void didFinish() override { ++finished; }
+	void didFail() override { ++failed; }
+
+	void wait() {
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+		while (finished + failed == 0 && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	}
+
+	std::atomic<int> finished{ 0 };
+	std::atomic<int> failed{ 0 };
+};
+
+//Rangeظ206ͳƷֶʵʷ͵ֽ
+struct FileServer {
+	std::string content;
+	bool accept_ranges = true;
+	int64_t fail_offset = -1;	//Ӹƫƿʼķֶλظ500
+	int delay_ms = 0;
+	std::atomic<int> ranges{ 0 };
+	std::atomic<int64_t> sent{ 0 };
+
+	void Serve(const StubRequest& request, StubResponse& response) {
+		response.headers.push_back(std::make_pair("ETag", "\"v1\""));
+		if (accept_ranges)
+			response.headers.push_back(std::make_pair("Accept-Ranges", "bytes"));
+
+		long long begin = 0, end = 0;
+		std::string range = request.header("range");
+		if (request.method == "GET" && accept_ranges
+			&& sscanf(range.c_str(), "bytes=%lld-%lld", &begin, &end) == 2) {
+			++ranges;
+			if (begin == fail_offset) {
+				response.status = 500;
+				response.delay_ms = 300;
+				return;
+			}
+			response.status = 206;
+			response.delay_ms = delay_ms;
+			response.headers.push_back(std::make_pair("Content-Range", "bytes " + std::to_string(begin)
+				+ "-" + std::to_string(end) + "/" + std::to_string(content.size())));
+			response.body = content.substr((size_t)begin, (size_t)(end - begin + 1));
+		} else {
+			response.body = content;
+		}
+		if (request.method == "GET")
+			sent += response.body.size();
+	}
+};
+
+static std::string makeContent(size_t size) {
+	std::string content(size, 0);
+	for (size_t i = 0; i < size; ++i)
+		content[i] = (char)(i * 31 % 251);
+	return content;
+}
+
+static std::string readFile(const std::string& path) {
+	std::string data;
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file)
+		return data;
+	char buffer[64 * 1024];
+	size_t size;
+	while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		data.append(buffer, size);
+	fclose(file);
+	return data;
+}
+
+static bool fileExists(const std::string& path) {
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file)
+		fclose(file);
+	return file != nullptr;
+}
+
+static void removeFiles() {
+	std::string path = kDownloadPath;
+	deleteFile(path.c_str());
+	deleteFile((path + ".part").c_str());
+	deleteFile((path + ".journal").c_str());
+}
+
+TEST(FileDownload, Segmented) {
+	removeFiles();
+	FileServer files;
+	files.content = makeContent(3 * 1024 * 1024 + 123);
+	files.delay_ms = 50;
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([&](const StubRequest& request, StubResponse& response) {
+		files.Serve(request, response);
+	});
+
+	TestListener listener;
+	RefCountedPtr<CurlDownload> download = CurlDownload::create(&listener, server.Url("/update.pkg"), kDownloadPath);
+	download->setSegments(4);
+	ASSERT_TRUE(download->start());
+	listener.wait();
+
+	EXPECT_EQ(listener.finished, 1);
+	EXPECT_EQ(files.ranges, 4);
+	EXPECT_EQ(files.sent, (int64_t)files.content.size());
+	EXPECT_EQ(server.max_in_flight(), 4);
+	//ͳҪһ100msͰ
+	std::this_thread::sleep_for(std::chrono::milliseconds(150));
+	EXPECT_GT(download->getDownloadRate(), 0);
+	EXPECT_TRUE(readFile(kDownloadPath) == files.content);
+	EXPECT_FALSE(fileExists(std::string(kDownloadPath) + ".part"));
+	EXPECT_FALSE(fileExists(std::string(kDownloadPath) + ".journal"));
+	removeFiles();
+}
+
+//һֶʧܺ־ɵķֶΣstart()ֻȱʧķΧ
+TEST(FileDownload, ResumeMissingRanges) {
+	removeFiles();
+	FileServer files;
+	files.content = makeContent(2 * 1024 * 1024);
+	int64_t size = (int64_t)files.content.size();
+	files.fail_offset = size * 2 / 4;
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([&](const StubRequest& request, StubResponse& response) {
+		files.Serve(request, response);
+	});
+
+	{
+		TestListener listener;
+		RefCountedPtr<CurlDownload> download = CurlDownload::create(&listener, server.Url("/update.pkg"), kDownloadPath);
+		download->setSegments(4);
+		ASSERT_TRUE(download->start());
+		listener.wait();
+		EXPECT_EQ(listener.failed, 1);
+		EXPECT_TRUE(fileExists(std::string(kDownloadPath) + ".journal"));
+		EXPECT_FALSE(fileExists(kDownloadPath));
+	}
+
+	//ģµĶ
+	files.fail_offset = -1;
+	files.ranges = 0;
+	files.sent = 0;
+	TestListener listener;
+	RefCountedPtr<CurlDownload> download = CurlDownload::create(&listener, server.Url("/update.pkg"), kDownloadPath);
+	download->setSegments(4);
+	ASSERT_TRUE(download->start());
+	listener.wait();
+
+	EXPECT_EQ(listener.finished, 1);
+	EXPECT_EQ(files.ranges, 1);
+	EXPECT_EQ(files.sent, size * 3 / 4 - size * 2 / 4);
+	EXPECT_TRUE(readFile(kDownloadPath) == files.content);
+	EXPECT_FALSE(fileExists(std::string(kDownloadPath) + ".journal"));
+	removeFiles();
+}
+
+//˲֧Rangeʱ˻ص
+TEST(FileDownload, FallbackWithoutRanges) {
+	removeFiles();
+	FileServer files;
+	files.content = makeContent(1024 * 1024);
+	files.accept_ranges = false;
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([&](const StubRequest& request, StubResponse& response) {
+		files.Serve(request, response);
+	});
+
+	TestListener listener;
+	RefCountedPtr<CurlDownload> download = CurlDownload::create(&listener, server.Url("/plain.bin"), kDownloadPath);
+	download->setSegments(4);
+	ASSERT_TRUE(download->start());
+	listener.wait();
+
+	EXPECT_EQ(listener.finished, 1);
+	EXPECT_EQ(files.ranges, 0);
+	EXPECT_TRUE(readFile(kDownloadPath) == files.content);
+	EXPECT_FALSE(fileExists(std::string(kDownloadPath) + ".part"));
+	removeFiles();
+}
+
+//CPUʱ()
+static double cpuSeconds() {
+#ifdef _WIN32
+	FILETIME create, exit, kernel, user;
+	GetProcessTimes(GetCurrentProcess(), &create, &exit, &kernel, &user);
+	ULARGE_INTEGER k, u;
+	k.LowPart = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+	return (k.QuadPart + u.QuadPart) / 1e7;
+#else
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+//ȴ߳ѯCPUʱ
+class CountListener : public CurlDownloadListener {
+public:
+	void didFinish() override { std::lock_guard<std::mutex> locker(lock); ++finished; cv.notify_one(); }
+	void didFail() override { std::lock_guard<std::mutex> locker(lock); ++failed; cv.notify_one(); }
+
+	void wait(int count) {
+		std::unique_lock<std::mutex> locker(lock);
+		cv.wait_for(locker, std::chrono::seconds(60), [&]() { return finished + failed >= count; });
+	}
+
+	int finished = 0;
+	int failed = 0;
+	std::mutex lock;
+	std::condition_variable cv;
+};
+
+//ػϷ1000СļأͬһͬʱǽʱCPUʱ
+TEST(FileDownload, LoopbackThroughput) {
+	const int kCount = 1000;
+	const int kBurst = 50;
+	const std::string dir = "file_download_bench";
+	createDirectory(dir.c_str());
+
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest&, StubResponse& response) {
+		response.body.assign(1024, 'd');
+	});
+
+	CountListener listener;
+	std::vector<RefCountedPtr<CurlDownload>> downloads;
+	for (int i = 0; i < kCount; ++i) {
+		std::string path = dir + "/" + std::to_string(i) + ".bin";
+		downloads.push_back(CurlDownload::create(&listener, server.Url("/small"), path));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	double cpuStart = cpuSeconds();
+	for (int i = 0; i < kCount; i += kBurst) {
+		for (int j = i; j < i + kBurst; ++j)
+			downloads[j]->start();
+		listener.wait(i + kBurst);
+	}
+	double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double cpu = cpuSeconds() - cpuStart;
+	printf("%d downloads: wall %.3f s, cpu %.3f s, %d connections\n", kCount, wall, cpu, server.connections());
+	EXPECT_EQ(listener.finished, kCount);
+	EXPECT_EQ(readFile(dir + "/0.bin"), std::string(1024, 'd'));
+
+	//˳ٳٲظʱ̲߳Ӧת
+	server.SetHandler([](const StubRequest&, StubResponse& response) {
+		response.body = "late";
+		response.delay_ms = 1000;
+	});
+	CountListener idle;
+	std::vector<RefCountedPtr<CurlDownload>> late;
+	for (int i = 0; i < 8; ++i)
+		late.push_back(CurlDownload::create(&idle, server.Url("/late"), dir + "/late" + std::to_string(i) + ".bin"));
+	cpuStart = cpuSeconds();
+	for (auto& download : late)
+		download->start();
+	idle.wait(8);
+	printf("waiting 1 s on 8 downloads: cpu %.3f s\n", cpuSeconds() - cpuStart);
+	EXPECT_EQ(idle.finished, 8);
+
+	for (int i = 0; i < kCount; ++i)
+		deleteFile((dir + "/" + std::to_string(i) + ".bin").c_str());
+	for (int i = 0; i < 8; ++i)
+		deleteFile((dir + "/late" + std::to_string(i) + ".bin").c_str());
+}
+
+//ȫֵģԽʱָ
+class SchedulerScope {
+public:
+	SchedulerScope()
+		:manager_(CurlDownload::getDownloadManager()) {
+		concurrency_ = manager_.getMaxConcurrency();
+		per_host_ = manager_.getMaxPerHost();
+		speed_ = manager_.getMaxRecvSpeed();
+	}
+
+	~SchedulerScope() {
+		manager_.setMaxConcurrency(concurrency_);
+		manager_.setMaxPerHost(per_host_);
+		manager_.setMaxRecvSpeed(speed_);
+	}
+
+	CurlDownloadManager* operator->() { return &manager_; }
+private:
+	CurlDownloadManager& manager_;
+	int concurrency_;
+	int per_host_;
+	int64_t speed_;
+};
+
+static void waitRequests(HttpStubServer& server, int count) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (server.requests() < count && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+//ŶӵذȼȼƵ¶ĩβ
+TEST(FileDownload, Priority) {
+	SchedulerScope scheduler;
+	scheduler->setMaxConcurrency(1);
+
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	std::mutex lock;
+	std::vector<std::string> order;
+	server.SetHandler([&](const StubRequest& request, StubResponse& response) {
+		{
+			std::lock_guard<std::mutex> locker(lock);
+			order.push_back(request.path);
+		}
+		response.body = "ok";
+		response.delay_ms = request.path == "/first" ? 200 : 0;
+	});
+
+	CountListener listener;
+	auto create = [&](const char* path, DownloadPriority priority) {
+		RefCountedPtr<CurlDownload> download = CurlDownload::create(&listener, server.Url(path),
+			std::string("file_download_priority") + (path + 1));
+		download->setPriority(priority);
+		download->start();
+		return download;
+	};
+
+	auto first = create("/first", DownloadPriority::kNormal);
+	waitRequests(server, 1);
+	auto low1 = create("/low1", DownloadPriority::kLow);
+	auto low2 = create("/low2", DownloadPriority::kLow);
+	auto low3 = create("/low3", DownloadPriority::kLow);
+	auto high = create("/high", DownloadPriority::kHigh);
+	low3->setPriority(DownloadPriority::kHigh);
+	listener.wait(5);
+
+	std::vector<std::string> expect = { "/first", "/high", "/low3", "/low1", "/low2" };
+	EXPECT_EQ(order, expect);
+	EXPECT_EQ(server.max_in_flight(), 1);
+	for (auto path : { "first", "low1", "low2", "low3", "high" })
+		deleteFile((std::string("file_download_priority") + path).c_str());
+}
+
+TEST(FileDownload, PerHostLimit) {
+	SchedulerScope scheduler;
+	scheduler->setMaxPerHost(2);
+
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest&, StubResponse& response) {
+		response.body = "ok";
+		response.delay_ms = 20;
+	});
+
+	const int kCount = 10;
+	CountListener listener;
+	std::vector<RefCountedPtr<CurlDownload>> downloads;
+	for (int i = 0; i < kCount; ++i) {
+		downloads.push_back(CurlDownload::create(&listener, server.Url("/host"), "file_download_host" + std::to_string(i)));
+		downloads.back()->start();
+	}
+	listener.wait(kCount);
+
+	EXPECT_EQ(listener.finished, kCount);
+	EXPECT_EQ(server.max_in_flight(), 2);
+	for (int i = 0; i < kCount; ++i)
+		deleteFile(("file_download_host" + std::to_string(i)).c_str());
+}
+
+//ȫֺ͵صٶͨMAX_RECV_SPEEDЧcurlʼʱȶһ
+TEST(FileDownload, BandwidthCap) {
+	SchedulerScope scheduler;
+	const int64_t kSpeed = 4 * 1024 * 1024;
+
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([&](const StubRequest&, StubResponse& response) {
+		response.body.assign((size_t)kSpeed, 'b');
+	});
+
+	auto measure = [&](int64_t downloadSpeed) {
+		CountListener listener;
+		RefCountedPtr<CurlDownload> download = CurlDownload::create(&listener, server.Url("/capped"), kDownloadPath);
+		download->setMaxRecvSpeed(downloadSpeed);
+		auto start = std::chrono::steady_clock::now();
+		download->start();
+		listener.wait(1);
+		EXPECT_EQ(listener.finished, 1);
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	EXPECT_LT(measure(0), 0.5);
+
+	scheduler->setMaxRecvSpeed(kSpeed);
+	double global = measure(0);
+	scheduler->setMaxRecvSpeed(0);
+	double single = measure(kSpeed);
+	printf("4 MB at 4 MB/s: global cap %.2f s, download cap %.2f s\n", global, single);
+	EXPECT_GT(global, 0.5);
+	EXPECT_GT(single, 0.5);
+	EXPECT_LT(global, 3.0);
+	EXPECT_LT(single, 3.0);
+	removeFiles();
+}
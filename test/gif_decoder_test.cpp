@@ -0,0 +1,432 @@
+#include "duilib/Utils/GifDecoder.h"
+#include "duilib/Utils/PixelKernel.h"
+#include "stbimage/stb_image.h"
+#include "gtest/gtest.h"
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace DuiLib;
+using Clock = std::chrono::steady_clock;
+
+struct GifFrame {
+	int x = 0, y = 0, w = 0, h = 0;
+	std::vector<uint8_t> indices;		//дţɨʱд뷽
+	std::vector<uint32_t> palette;		//ֲɫ0xRRGGBBΪʱʹȫֵɫ
+	int dispose = 0;
+	int transparent = -1;
+	int delay = 0;
+	bool interlace = false;
+};
+
+static void put16(std::vector<uint8_t>& out, int value) {
+	out.push_back((uint8_t)value);
+	out.push_back((uint8_t)(value >> 8));
+}
+
+//ɫ岹뵽2ݣеĴСֶ
+static int putPalette(std::vector<uint8_t>& out, const std::vector<uint32_t>& palette) {
+	int bits = 0;
+	while ((2u << bits) < palette.size())
+		bits++;
+	for (int i = 0; i < (2 << bits); ++i) {
+		uint32_t color = i < (int)palette.size() ? palette[i] : 0;
+		out.push_back((uint8_t)(color >> 16));
+		out.push_back((uint8_t)(color >> 8));
+		out.push_back((uint8_t)color);
+	}
+	return bits;
+}
+
+//LZW룬˵Ĺ볤ֵ佫ʱ
+static void putLzw(std::vector<uint8_t>& out, const std::vector<uint8_t>& indices, int min_size) {
+	std::vector<uint8_t> bytes;
+	uint32_t acc = 0;
+	int valid = 0;
+	const int clear = 1 << min_size;
+	int code_size = min_size + 1;
+	int next = clear + 2;
+	int avail = clear + 2;
+	int emitted = 0;
+	std::map<uint32_t, int> dict;
+
+	auto put = [&](int code) {
+		acc |= (uint32_t)code << valid;
+		valid += code_size;
+		while (valid >= 8) {
+			bytes.push_back((uint8_t)acc);
+			acc >>= 8;
+			valid -= 8;
+		}
+	};
+	auto emit = [&](int code) {
+		put(code);
+		if (emitted++ > 0 && ++avail == (1 << code_size) && code_size < 12)
+			code_size++;
+	};
+	auto reset = [&]() {
+		put(clear);
+		code_size = min_size + 1;
+		next = avail = clear + 2;
+		emitted = 0;
+		dict.clear();
+	};
+
+	reset();
+	int cur = indices[0];
+	for (size_t i = 1; i < indices.size(); ++i) {
+		uint32_t key = ((uint32_t)cur << 8) | indices[i];
+		auto find = dict.find(key);
+		if (find != dict.end()) {
+			cur = find->second;
+			continue;
+		}
+		emit(cur);
+		dict[key] = next++;
+		cur = indices[i];
+		if (next == 4095)
+			reset();
+	}
+	emit(cur);
+	put(clear + 1);
+	if (valid > 0)
+		bytes.push_back((uint8_t)acc);
+
+	out.push_back((uint8_t)min_size);
+	for (size_t i = 0; i < bytes.size(); i += 255) {
+		size_t n = std::min<size_t>(255, bytes.size() - i);
+		out.push_back((uint8_t)n);
+		out.insert(out.end(), bytes.begin() + i, bytes.begin() + i + n);
+	}
+	out.push_back(0);
+}
+
+//loopС0ʱдNETSCAPE2.0չ
+static std::vector<uint8_t> makeGif(int w, int h, const std::vector<uint32_t>& palette, int background,
+	const std::vector<GifFrame>& frames, int loop = -1) {
+	std::vector<uint8_t> out = { 'G', 'I', 'F', '8', '9', 'a' };
+	put16(out, w);
+	put16(out, h);
+	size_t flags = out.size();
+	out.push_back(0);
+	out.push_back((uint8_t)background);
+	out.push_back(0);
+	if (!palette.empty())
+		out[flags] = (uint8_t)(0x80 | putPalette(out, palette));
+
+	if (loop >= 0) {
+		const char app[] = "NETSCAPE2.0";
+		out.push_back(0x21);
+		out.push_back(0xFF);
+		out.push_back(11);
+		out.insert(out.end(), app, app + 11);
+		out.push_back(3);
+		out.push_back(1);
+		put16(out, loop);
+		out.push_back(0);
+	}
+
+	for (const GifFrame& frame : frames) {
+		out.push_back(0x21);
+		out.push_back(0xF9);
+		out.push_back(4);
+		out.push_back((uint8_t)((frame.dispose << 2) | (frame.transparent >= 0 ? 1 : 0)));
+		put16(out, frame.delay);
+		out.push_back((uint8_t)(frame.transparent >= 0 ? frame.transparent : 0));
+		out.push_back(0);
+
+		out.push_back(0x2C);
+		put16(out, frame.x);
+		put16(out, frame.y);
+		put16(out, frame.w);
+		put16(out, frame.h);
+		size_t lflags = out.size();
+		out.push_back(frame.interlace ? 0x40 : 0);
+		int colors = (int)(frame.palette.empty() ? palette.size() : frame.palette.size());
+		if (!frame.palette.empty())
+			out[lflags] |= (uint8_t)(0x80 | putPalette(out, frame.palette));
+
+		std::vector<uint8_t> indices;
+		if (frame.interlace) {
+			const int passes[4][2] = { { 0, 8 }, { 4, 8 }, { 2, 4 }, { 1, 2 } };
+			for (auto& pass : passes) {
+				for (int y = pass[0]; y < frame.h; y += pass[1])
+					indices.insert(indices.end(), frame.indices.begin() + y * frame.w, frame.indices.begin() + (y + 1) * frame.w);
+			}
+		}
+		else {
+			indices = frame.indices;
+		}
+		int min_size = 2;
+		while ((1 << min_size) < colors)
+			min_size++;
+		putLzw(out, indices, min_size);
+	}
+	out.push_back(0x3B);
+	return out;
+}
+
+static std::vector<uint32_t> makePalette(int count, unsigned seed) {
+	std::mt19937 rand(seed);
+	std::vector<uint32_t> palette(count);
+	for (auto& color : palette)
+		color = rand() & 0xFFFFFF;
+	return palette;
+}
+
+//гɶظLZWֵõʹ
+static GifFrame makeFrame(int x, int y, int w, int h, int colors, unsigned seed) {
+	std::mt19937 rand(seed);
+	GifFrame frame;
+	frame.x = x;
+	frame.y = y;
+	frame.w = w;
+	frame.h = h;
+	frame.indices.resize((size_t)w * h);
+	for (size_t i = 0; i < frame.indices.size();) {
+		uint8_t index = (uint8_t)(rand() % colors);
+		size_t run = rand() % 6 + 1;
+		for (; run > 0 && i < frame.indices.size(); --run)
+			frame.indices[i++] = index;
+	}
+	return frame;
+}
+
+//stbi_load_gif_from_memory֡
+struct StbFrames {
+	int x = 0, y = 0, count = 0;
+	std::vector<std::vector<uint8_t>> frames;
+	std::vector<int> delays;
+};
+
+static StbFrames stbDecode(const std::vector<uint8_t>& gif) {
+	StbFrames result;
+	int* delays = nullptr;
+	int comp;
+	uint8_t* pixels = stbi_load_gif_from_memory(gif.data(), (int)gif.size(), &delays, &result.x, &result.y, &result.count, &comp, 4);
+	if (!pixels)
+		return result;
+	size_t size = (size_t)result.x * result.y * 4;
+	for (int i = 0; i < result.count; ++i) {
+		result.frames.emplace_back(pixels + size * i, pixels + size * (i + 1));
+		result.delays.push_back(delays[i]);
+	}
+	stbi_image_free(pixels);
+	stbi_image_free(delays);
+	return result;
+}
+
+static std::vector<uint8_t> canvas(const CGifDecoder& decoder) {
+	return std::vector<uint8_t>(decoder.GetPixels(), decoder.GetPixels() + (size_t)decoder.GetWidth() * decoder.GetHeight() * 4);
+}
+
+static void expectSameAsStb(const std::vector<uint8_t>& gif) {
+	StbFrames expected = stbDecode(gif);
+	ASSERT_GT(expected.count, 0);
+
+	CGifDecoder decoder;
+	ASSERT_TRUE(decoder.Open(gif.data(), gif.size()));
+	ASSERT_EQ(expected.x, decoder.GetWidth());
+	ASSERT_EQ(expected.y, decoder.GetHeight());
+	ASSERT_EQ(expected.count, decoder.GetFrameCount());
+	for (int i = 0; i < expected.count; ++i) {
+		ASSERT_EQ(i, decoder.DecodeNext());
+		EXPECT_EQ(expected.delays[i], decoder.GetDelay(i)) << "frame " << i;
+		EXPECT_TRUE(canvas(decoder) == expected.frames[i]) << "frame " << i;
+	}
+	//ѭصһ֡
+	ASSERT_EQ(0, decoder.DecodeNext());
+	EXPECT_TRUE(canvas(decoder) == expected.frames[0]);
+}
+
+//÷ʽ0/1ֲɫ塢ɨ衢͸ɫ򣬵һ֡бɫ
+TEST(GifDecoder, MatchesStb) {
+	const int kWidth = 61, kHeight = 47;
+	std::vector<uint32_t> palette = makePalette(16, 1);
+	//stbBGR˳ɫûɫܿ
+	palette[3] = 0x5A5A5A;
+	std::vector<GifFrame> frames;
+
+	GifFrame frame = makeFrame(5, 3, 40, 30, 16, 2);
+	frame.transparent = 7;
+	frame.delay = 4;
+	frames.push_back(frame);
+
+	frame = makeFrame(0, 0, kWidth, kHeight, 32, 3);
+	frame.palette = makePalette(32, 4);
+	frame.interlace = true;
+	frame.dispose = 1;
+	frame.delay = 12;
+	frames.push_back(frame);
+
+	frame = makeFrame(10, 20, 51, 27, 16, 5);
+	frame.transparent = 0;
+	frame.interlace = true;
+	frames.push_back(frame);
+
+	frame = makeFrame(60, 46, 1, 1, 16, 6);
+	frames.push_back(frame);
+
+	frame = makeFrame(0, 0, kWidth, 5, 4, 7);
+	frame.palette = makePalette(3, 8);
+	frame.transparent = 2;
+	frames.push_back(frame);
+
+	expectSameAsStb(makeGif(kWidth, kHeight, palette, 3, frames));
+	expectSameAsStb(makeGif(kWidth, kHeight, palette, 0, frames));
+}
+
+//256ɫֵд
+TEST(GifDecoder, LargeDictionary) {
+	const int kWidth = 300, kHeight = 200;
+	std::mt19937 rand(9);
+	GifFrame frame;
+	frame.w = kWidth;
+	frame.h = kHeight;
+	frame.indices.resize((size_t)kWidth * kHeight);
+	for (auto& index : frame.indices)
+		index = (uint8_t)(rand() % 256);
+	GifFrame smooth = makeFrame(0, 0, kWidth, kHeight, 3, 10);
+	expectSameAsStb(makeGif(kWidth, kHeight, makePalette(256, 11), 0, { frame, smooth }));
+}
+
+//stbԴ÷ʽ2/3Ĵ淶ͬ淶֤
+TEST(GifDecoder, Dispose) {
+	std::vector<uint32_t> palette = { 0xFF0000, 0x00FF00, 0x0000FF, 0xFFFFFF };
+	auto pixel = [](const CGifDecoder& decoder, int x, int y) {
+		uint32_t color;
+		memcpy(&color, decoder.GetPixels() + (y * decoder.GetWidth() + x) * 4, 4);
+		return color;
+	};
+	const uint32_t kRed = 0xFF0000FF, kGreen = 0xFF00FF00, kBlue = 0xFFFF0000;
+
+	for (int dispose : { 2, 3 }) {
+		GifFrame red;
+		red.w = red.h = 4;
+		red.indices.assign(16, 0);
+		GifFrame green;
+		green.x = green.y = 1;
+		green.w = green.h = 2;
+		green.indices.assign(4, 1);
+		green.dispose = dispose;
+		GifFrame blue;
+		blue.w = blue.h = 1;
+		blue.indices.assign(1, 2);
+		std::vector<uint8_t> gif = makeGif(4, 4, palette, 0, { red, green, blue });
+
+		CGifDecoder decoder;
+		ASSERT_TRUE(decoder.Open(gif.data(), gif.size()));
+		ASSERT_EQ(0, decoder.DecodeNext());
+		ASSERT_EQ(1, decoder.DecodeNext());
+		EXPECT_EQ(kGreen, pixel(decoder, 1, 1));
+		EXPECT_EQ(kRed, pixel(decoder, 0, 1));
+		ASSERT_EQ(2, decoder.DecodeNext());
+		EXPECT_EQ(kBlue, pixel(decoder, 0, 0));
+		EXPECT_EQ(kRed, pixel(decoder, 3, 3));
+		//2Ϊ͸3ָΪǰĺɫ
+		uint32_t restored = dispose == 2 ? 0 : kRed;
+		EXPECT_EQ(restored, pixel(decoder, 1, 1));
+		EXPECT_EQ(restored, pixel(decoder, 2, 2));
+	}
+}
+
+TEST(GifDecoder, LoopCount) {
+	std::vector<uint32_t> palette = makePalette(4, 12);
+	GifFrame frame = makeFrame(0, 0, 8, 8, 4, 13);
+	frame.delay = 7;
+
+	std::vector<uint8_t> gif = makeGif(8, 8, palette, 0, { frame }, 3);
+	CGifDecoder decoder;
+	ASSERT_TRUE(decoder.Open(gif.data(), gif.size()));
+	EXPECT_EQ(3, decoder.GetLoopCount());
+	EXPECT_EQ(70, decoder.GetDelay(0));
+
+	gif = makeGif(8, 8, palette, 0, { frame });
+	ASSERT_TRUE(decoder.Open(gif.data(), gif.size()));
+	EXPECT_EQ(0, decoder.GetLoopCount());
+}
+
+TEST(GifDecoder, Invalid) {
+	CGifDecoder decoder;
+	const uint8_t junk[] = "GIF89a\x01";
+	EXPECT_FALSE(decoder.Open(junk, sizeof(junk)));
+	EXPECT_EQ(-1, decoder.DecodeNext());
+
+	//ضϵݽеĲ
+	std::vector<uint8_t> gif = makeGif(32, 32, makePalette(8, 14), 0, { makeFrame(0, 0, 32, 32, 8, 15) });
+	gif.resize(gif.size() / 2);
+	ASSERT_TRUE(decoder.Open(gif.data(), gif.size()));
+	EXPECT_EQ(0, decoder.DecodeNext());
+}
+
+//ԤĽͬתĽͬ
+TEST(GifFrameQueue, MatchesDecoder) {
+	std::vector<GifFrame> frames;
+	for (int i = 0; i < 6; ++i) {
+		GifFrame frame = makeFrame(i * 3, i * 2, 30, 20, 8, 20 + i);
+		frame.transparent = 1;
+		frame.dispose = i % 4;
+		frames.push_back(frame);
+	}
+	std::vector<uint8_t> gif = makeGif(48, 32, makePalette(8, 16), 0, frames);
+
+	CGifDecoder decoder;
+	ASSERT_TRUE(decoder.Open(gif.data(), gif.size()));
+	CGifFrameQueue queue;
+	ASSERT_TRUE(queue.Open(gif.data(), gif.size()));
+	ASSERT_EQ(6, queue.GetFrameCount());
+
+	size_t count = 48 * 32;
+	std::vector<uint8_t> expected(count * 4), actual(count * 4);
+	for (int i = 0; i < 14; ++i) {
+		if (i == 9) {
+			queue.Rewind();
+			decoder.Rewind();
+		}
+		int frame = decoder.DecodeNext();
+		CPixelKernel::RgbaToPremultipliedBgra(decoder.GetPixels(), expected.data(), count, 0, CPixelKernel::kScalar);
+		ASSERT_EQ(frame, queue.NextFrame(actual.data()));
+		EXPECT_TRUE(actual == expected) << "step " << i;
+	}
+
+	//Ԥͷ
+	CGifFrameQueue* pending = new CGifFrameQueue;
+	ASSERT_TRUE(pending->Open(gif.data(), gif.size()));
+	EXPECT_EQ(0, pending->NextFrame(actual.data()));
+	delete pending;
+
+	CGifFrameQueue empty;
+	EXPECT_FALSE(empty.Open(gif.data(), 10));
+	EXPECT_EQ(-1, empty.NextFrame(actual.data()));
+}
+
+//stbһνȫ֡֡ڴͺʱ
+TEST(GifDecoder, Benchmark) {
+	const int kWidth = 320, kHeight = 240, kFrames = 60;
+	std::vector<GifFrame> frames;
+	for (int i = 0; i < kFrames; ++i)
+		frames.push_back(makeFrame(0, 0, kWidth, kHeight, 64, 100 + i));
+	std::vector<uint8_t> gif = makeGif(kWidth, kHeight, makePalette(64, 17), 0, frames);
+
+	auto start = Clock::now();
+	StbFrames stb = stbDecode(gif);
+	double stb_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	ASSERT_EQ(kFrames, stb.count);
+	//stbÿ֡һDIB
+	size_t stb_bytes = (size_t)kWidth * kHeight * 4 * kFrames * 2;
+
+	CGifDecoder decoder;
+	ASSERT_TRUE(decoder.Open(gif.data(), gif.size()));
+	start = Clock::now();
+	for (int i = 0; i < kFrames; ++i)
+		ASSERT_EQ(i, decoder.DecodeNext());
+	double frame_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kFrames;
+	//Ԥ뻺һDIB
+	size_t stream_bytes = decoder.GetMemoryUsage() + (size_t)kWidth * kHeight * 4 * 2;
+
+	printf("%d frames %dx%d (%zu KB gif): stb %.1f ms, %zu KB; streaming %.2f ms/frame, %zu KB\n",
+		kFrames, kWidth, kHeight, gif.size() / 1024, stb_ms, stb_bytes / 1024, frame_ms, stream_bytes / 1024);
+	EXPECT_LT(stream_bytes * 10, stb_bytes);
+}
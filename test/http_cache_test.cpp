@@ -0,0 +1,219 @@
+#include "network/HttpClient.h"
+#include "http_stub_server.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace network;
+
+static const char* kCacheDir = "http_cache_test";
+
+struct FetchResult {
+	bool succeed = false;
+	long code = 0;
+	std::string body;
+};
+
+//ͬGET󣬻صִ߳
+static FetchResult fetch(HttpClient* client, const std::string& url,
+	const std::vector<std::string>& headers = std::vector<std::string>(),
+	HttpRequest::Type type = HttpRequest::Type::kGET) {
+	std::atomic<int> done(0);
+	FetchResult result;
+
+	HttpRequestPtr request = new HttpRequest();
+	request->setUrl(url);
+	request->setRequestType(type);
+	request->setHeaders(headers);
+	request->setResponseCallback([&](HttpClient*, HttpResponse* response) {
+		result.succeed = response->isSucceed();
+		result.code = response->getResponseCode();
+		result.body.assign(response->getResponseData()->begin(), response->getResponseData()->end());
+		++done;
+	});
+	client->send(request);
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (done == 0 && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return result;
+}
+
+static HttpClient* createClient(const std::string& dir, size_t memory, size_t disk) {
+	HttpClient* client = HttpClient::Create([](task_t task) { task(); });
+	client->enableCache(dir, memory, disk);
+	return client;
+}
+
+TEST(HttpCache, MaxAge) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest&, StubResponse& response) {
+		response.headers.push_back(std::make_pair("Cache-Control", "max-age=60"));
+		response.body = "fresh body";
+	});
+
+	HttpClient* client = createClient("", 1 << 20, 0);
+	FetchResult first = fetch(client, server.Url("/a"));
+	FetchResult second = fetch(client, server.Url("/a"));
+
+	EXPECT_TRUE(second.succeed);
+	EXPECT_EQ(second.code, 200);
+	EXPECT_EQ(second.body, first.body);
+	EXPECT_EQ(server.requests(), 1);
+
+	//Ҫ֤ʱʷ
+	fetch(client, server.Url("/a"), { "Cache-Control: no-cache" });
+	EXPECT_EQ(server.requests(), 2);
+
+	HttpCacheStats stats = client->getCacheStats();
+	EXPECT_EQ(stats.hits, 1);
+	EXPECT_EQ(stats.misses, 2);
+	EXPECT_GE(stats.bytesSaved, (int64_t)first.body.size());
+	EXPECT_EQ(stats.entries, 1);
+	HttpClient::Destroy(client);
+}
+
+//ڵӦЯETag/Last-Modified֤304ʱӻ淵
+TEST(HttpCache, Revalidate) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	std::atomic<int> version(1);
+	std::atomic<int> conditional(0);
+	server.SetHandler([&](const StubRequest& request, StubResponse& response) {
+		std::string etag = "\"v" + std::to_string(version) + "\"";
+		response.headers.push_back(std::make_pair("Cache-Control", "no-cache"));
+		response.headers.push_back(std::make_pair("ETag", etag));
+		response.headers.push_back(std::make_pair("Last-Modified", "Mon, 05 Oct 2026 10:00:00 GMT"));
+		if (!request.header("if-none-match").empty())
+			++conditional;
+		if (request.header("if-none-match") == etag) {
+			response.status = 304;
+			return;
+		}
+		response.body = std::string(4096, 'a' + version);
+	});
+
+	HttpClient* client = createClient("", 1 << 20, 0);
+	FetchResult first = fetch(client, server.Url("/etag"));
+	FetchResult second = fetch(client, server.Url("/etag"));
+	EXPECT_EQ(server.requests(), 2);
+	EXPECT_EQ(conditional, 1);
+	EXPECT_TRUE(second.succeed);
+	EXPECT_EQ(second.code, 200);
+	EXPECT_EQ(second.body, first.body);
+
+	version = 2;
+	FetchResult third = fetch(client, server.Url("/etag"));
+	EXPECT_EQ(third.body, std::string(4096, 'c'));
+
+	HttpCacheStats stats = client->getCacheStats();
+	EXPECT_EQ(stats.hits, 0);
+	EXPECT_EQ(stats.revalidated, 1);
+	EXPECT_EQ(stats.misses, 2);
+	EXPECT_EQ(stats.bytesSaved, 4096);
+	HttpClient::Destroy(client);
+}
+
+TEST(HttpCache, NoStoreAndVary) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest& request, StubResponse& response) {
+		if (request.path == "/private") {
+			response.headers.push_back(std::make_pair("Cache-Control", "no-store"));
+		} else {
+			response.headers.push_back(std::make_pair("Cache-Control", "max-age=60"));
+			response.headers.push_back(std::make_pair("Vary", "Accept-Language"));
+		}
+		response.body = request.header("accept-language");
+	});
+
+	HttpClient* client = createClient("", 1 << 20, 0);
+	fetch(client, server.Url("/private"));
+	fetch(client, server.Url("/private"));
+	EXPECT_EQ(server.requests(), 2);
+
+	EXPECT_EQ(fetch(client, server.Url("/vary"), { "Accept-Language: en" }).body, "en");
+	EXPECT_EQ(fetch(client, server.Url("/vary"), { "Accept-Language: fr" }).body, "fr");
+	EXPECT_EQ(fetch(client, server.Url("/vary"), { "Accept-Language: fr" }).body, "fr");
+	EXPECT_EQ(server.requests(), 4);
+
+	//ɹPOSTʹͬһַĻʧЧ
+	fetch(client, server.Url("/vary"), { "Accept-Language: fr" }, HttpRequest::Type::kPOST);
+	fetch(client, server.Url("/vary"), { "Accept-Language: fr" });
+	EXPECT_EQ(server.requests(), 6);
+	HttpClient::Destroy(client);
+}
+
+//̻水LRṶȻ
+TEST(HttpCache, DiskLru) {
+	HttpCache(kCacheDir, 0, 1 << 20).clear();
+
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest& request, StubResponse& response) {
+		response.headers.push_back(std::make_pair("Cache-Control", "max-age=600"));
+		response.body = std::string(10000, request.path[1]);
+	});
+
+	//ֻӦڴֻһ
+	HttpClient* client = createClient(kCacheDir, 15000, 25000);
+	fetch(client, server.Url("/a"));
+	fetch(client, server.Url("/b"));
+	fetch(client, server.Url("/a"));
+	fetch(client, server.Url("/c"));
+	EXPECT_EQ(server.requests(), 3);
+
+	HttpCacheStats stats = client->getCacheStats();
+	EXPECT_EQ(stats.entries, 2);
+	EXPECT_LE(stats.diskBytes, 25000);
+	EXPECT_LE(stats.memoryBytes, 15000);
+	HttpClient::Destroy(client);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	client = createClient(kCacheDir, 15000, 25000);
+	EXPECT_EQ(fetch(client, server.Url("/a")).body, std::string(10000, 'a'));
+	EXPECT_EQ(fetch(client, server.Url("/c")).body, std::string(10000, 'c'));
+	EXPECT_EQ(server.requests(), 3);
+	fetch(client, server.Url("/b"));
+	EXPECT_EQ(server.requests(), 4);
+	EXPECT_EQ(client->getCacheStats().hits, 2);
+
+	client->clearCache();
+	EXPECT_EQ(client->getCacheStats().entries, 0);
+	HttpClient::Destroy(client);
+}
+
+//ûرʱ׷ӵ־ָ̻Ĵ洢ɾ
+TEST(HttpCache, JournalReplay) {
+	HttpCache(kCacheDir, 0, 1 << 20).clear();
+
+	std::vector<char> header;
+	std::string text = "HTTP/1.1 200 OK\r\nCache-Control: max-age=600\r\n\r\n";
+	header.assign(text.begin(), text.end());
+	std::vector<char> body(100, 'x');
+
+	//ģ쳣˳
+	HttpCache* cache = new HttpCache(kCacheDir, 0, 1 << 20);
+	for (int i = 0; i < 200; ++i) {
+		HttpRequestPtr request = new HttpRequest();
+		request->setUrl("http://localhost/" + std::to_string(i));
+		cache->store(request.get(), 200, header, body);
+	}
+	cache->invalidate("http://localhost/0");
+	EXPECT_EQ(cache->getStats().entries, 199);
+
+	HttpCache reopened(kCacheDir, 0, 1 << 20);
+	EXPECT_EQ(reopened.getStats().entries, 199);
+	for (int i = 0; i < 200; ++i) {
+		HttpRequestPtr request = new HttpRequest();
+		request->setUrl("http://localhost/" + std::to_string(i));
+		bool fresh = false;
+		HttpCacheEntryPtr entry = reopened.find(request.get(), &fresh);
+		EXPECT_EQ(entry != nullptr, i != 0);
+		EXPECT_EQ(fresh, i != 0);
+	}
+	reopened.clear();
+}
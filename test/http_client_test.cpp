@@ -0,0 +1,277 @@
+#include "network/HttpClient.h"
+#include "http_stub_server.h"
+#include "gtest/gtest.h"
+#include <curl/curl.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace network;
+using Clock = std::chrono::steady_clock;
+
+//صֱִ߳
+static HttpClient* createClient() {
+	return HttpClient::Create([](task_t task) { task(); });
+}
+
+static void waitFor(const std::atomic<int>& value, int expect) {
+	auto deadline = Clock::now() + std::chrono::seconds(30);
+	while (value < expect && Clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+static HttpRequestPtr makeRequest(const std::string& url, ccHttpRequestCallback callback) {
+	HttpRequestPtr request = new HttpRequest();
+	request->setUrl(url);
+	request->setRequestType(HttpRequest::Type::kGET);
+	request->setResponseCallback(callback);
+	return request;
+}
+
+static void printStats(const char* name, std::vector<double>& latency, double seconds, int connections) {
+	std::sort(latency.begin(), latency.end());
+	double p50 = latency[latency.size() / 2];
+	double p99 = latency[latency.size() * 99 / 100];
+	printf("%-20s %8.0f req/s, p50 %.2f ms, p99 %.2f ms, %d connections\n", name,
+		latency.size() / seconds, p50, p99, connections);
+}
+
+TEST(HttpClient, Get) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest& request, StubResponse& response) {
+		if (request.path == "/missing") {
+			response.status = 404;
+			return;
+		}
+		response.headers.push_back(std::make_pair("X-Stub", "1"));
+		response.body = request.method + " " + request.path;
+	});
+
+	HttpClient* client = createClient();
+	std::atomic<int> done(0);
+	std::string body;
+	std::string headers;
+	long missingCode = 0;
+	bool missingSucceed = true;
+
+	client->send(makeRequest(server.Url("/hello"), [&](HttpClient*, HttpResponse* response) {
+		EXPECT_TRUE(response->isSucceed());
+		EXPECT_EQ(response->getResponseCode(), 200);
+		body.assign(response->getResponseData()->begin(), response->getResponseData()->end());
+		headers.assign(response->getResponseHeader()->begin(), response->getResponseHeader()->end());
+		++done;
+	}));
+	client->send(makeRequest(server.Url("/missing"), [&](HttpClient*, HttpResponse* response) {
+		missingSucceed = response->isSucceed();
+		missingCode = response->getResponseCode();
+		++done;
+	}));
+	waitFor(done, 2);
+
+	EXPECT_EQ(body, "GET /hello");
+	EXPECT_NE(headers.find("X-Stub: 1"), std::string::npos);
+	EXPECT_FALSE(missingSucceed);
+	EXPECT_EQ(missingCode, 404);
+	HttpClient::Destroy(client);
+}
+
+//ͬʱеȫޣӱ
+TEST(HttpClient, ConcurrencyLimit) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest&, StubResponse& response) {
+		response.body = "ok";
+		response.delay_ms = 20;
+	});
+
+	const int kCount = 24;
+	HttpClient* client = createClient();
+	client->setMaxPerHost(2);
+	std::atomic<int> done(0);
+	std::atomic<int> succeed(0);
+	auto callback = [&](HttpClient*, HttpResponse* response) {
+		if (response->isSucceed())
+			++succeed;
+		++done;
+	};
+
+	for (int i = 0; i < kCount; ++i) {
+		client->send(makeRequest(server.Url("/slow"), callback));
+	}
+	waitFor(done, kCount);
+	EXPECT_EQ(succeed, kCount);
+	EXPECT_EQ(server.max_in_flight(), 2);
+	EXPECT_LE(server.connections(), 2);
+
+	server.ResetCounters();
+	client->setMaxPerHost(0);
+	client->setMaxConcurrency(3);
+	for (int i = 0; i < kCount; ++i) {
+		client->send(makeRequest(server.Url("/slow"), callback));
+	}
+	waitFor(done, kCount * 2);
+	EXPECT_EQ(succeed, kCount * 2);
+	EXPECT_EQ(server.max_in_flight(), 3);
+	HttpClient::Destroy(client);
+}
+
+//sendImmediateܲƣصȴŶӵ
+TEST(HttpClient, SendImmediate) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest& request, StubResponse& response) {
+		response.body = "ok";
+		response.delay_ms = request.path == "/slow" ? 200 : 0;
+	});
+
+	HttpClient* client = createClient();
+	client->setMaxConcurrency(1);
+	std::atomic<int> done(0);
+	std::vector<std::string> order;
+	std::mutex lock;
+	auto record = [&](HttpClient*, HttpResponse* response) {
+		std::lock_guard<std::mutex> locker(lock);
+		order.push_back(response->getHttpRequest()->getUrl());
+		++done;
+	};
+
+	client->send(makeRequest(server.Url("/slow"), record));
+	client->send(makeRequest(server.Url("/slow"), record));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	client->sendImmediate(makeRequest(server.Url("/fast"), record));
+	waitFor(done, 3);
+
+	ASSERT_EQ(order.size(), 3u);
+	EXPECT_EQ(order[0], server.Url("/fast"));
+	HttpClient::Destroy(client);
+}
+
+//Content-LengthһԤֻдһ
+TEST(HttpClient, ReserveContentLength) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	const size_t kSize = 3 * 1024 * 1024 + 17;
+	server.SetHandler([&](const StubRequest&, StubResponse& response) {
+		response.body.assign(kSize, 'r');
+	});
+
+	HttpClient* client = createClient();
+	std::atomic<int> done(0);
+	size_t size = 0;
+	size_t capacity = 0;
+	client->send(makeRequest(server.Url("/big"), [&](HttpClient*, HttpResponse* response) {
+		size = response->getResponseData()->size();
+		capacity = response->getResponseData()->capacity();
+		++done;
+	}));
+	waitFor(done, 1);
+
+	EXPECT_EQ(size, kSize);
+	EXPECT_EQ(capacity, kSize);
+	HttpClient::Destroy(client);
+}
+
+//ݻص˳յȫݣɻصӦв
+TEST(HttpClient, StreamingBody) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	std::string body;
+	for (int i = 0; body.size() < 1024 * 1024; ++i)
+		body += std::to_string(i) + ",";
+	server.SetHandler([&](const StubRequest&, StubResponse& response) {
+		response.body = body;
+	});
+
+	HttpClient* client = createClient();
+	std::atomic<int> done(0);
+	std::string received;
+	int chunks = 0;
+	long codeOnFirstChunk = 0;
+	bool finishedEarly = false;
+	size_t kept = 1;
+
+	HttpRequestPtr request = makeRequest(server.Url("/stream"), [&](HttpClient*, HttpResponse* response) {
+		kept = response->getResponseData()->size();
+		++done;
+	});
+	request->setDataCallback([&](HttpClient*, HttpResponse* response, std::vector<char>* chunk) {
+		if (chunks++ == 0)
+			codeOnFirstChunk = response->getResponseCode();
+		if (done > 0)
+			finishedEarly = true;
+		received.append(chunk->begin(), chunk->end());
+	});
+	client->send(request);
+	waitFor(done, 1);
+
+	EXPECT_EQ(received, body);
+	EXPECT_GT(chunks, 1);
+	EXPECT_EQ(codeOnFirstChunk, 200);
+	EXPECT_FALSE(finishedEarly);
+	EXPECT_EQ(kept, 0u);
+	HttpClient::Destroy(client);
+}
+
+//ػ׮϶Աȣÿ½easyִ(ʵ)  multi
+TEST(HttpClient, LoopbackBenchmark) {
+	HttpStubServer server;
+	ASSERT_TRUE(server.Start());
+	server.SetHandler([](const StubRequest&, StubResponse& response) {
+		response.body.assign(1024, 'x');
+		response.delay_ms = 1;
+	});
+
+	const int kCount = 1000;
+	const std::string url = server.Url("/bench");
+
+	{
+		std::vector<double> latency;
+		latency.reserve(kCount);
+		auto start = Clock::now();
+		for (int i = 0; i < kCount; ++i) {
+			std::vector<char> data;
+			CURL* curl = curl_easy_init();
+			curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+			curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+			curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](char* ptr, size_t size, size_t nmemb, void* stream) {
+				auto buffer = (std::vector<char>*)stream;
+				buffer->insert(buffer->end(), ptr, ptr + size * nmemb);
+				return size * nmemb;
+			});
+			curl_easy_setopt(curl, CURLOPT_WRITEDATA, &data);
+			EXPECT_EQ(curl_easy_perform(curl), CURLE_OK);
+			curl_easy_cleanup(curl);
+			//Ŷӵʱ
+			latency.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		}
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		printStats("easy per request", latency, seconds, server.connections());
+	}
+
+	server.ResetCounters();
+	{
+		HttpClient* client = createClient();
+		std::vector<double> latency(kCount);
+		std::atomic<int> done(0);
+		std::atomic<int> succeed(0);
+		auto start = Clock::now();
+		for (int i = 0; i < kCount; ++i) {
+			client->send(makeRequest(url, [&, i](HttpClient*, HttpResponse* response) {
+				latency[i] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+				if (response->isSucceed())
+					++succeed;
+				++done;
+			}));
+		}
+		waitFor(done, kCount);
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		EXPECT_EQ(succeed, kCount);
+		printStats("multi engine", latency, seconds, server.connections());
+		EXPECT_LE(server.connections(), client->getMaxPerHost());
+		HttpClient::Destroy(client);
+	}
+}
@@ -0,0 +1,281 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET stub_socket_t;
+#define STUB_INVALID_SOCKET INVALID_SOCKET
+#define stub_close_socket closesocket
+#define STUB_SHUT_RDWR SD_BOTH
+#define STUB_SEND_FLAGS 0
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+typedef int stub_socket_t;
+#define STUB_INVALID_SOCKET (-1)
+#define stub_close_socket close
+#define STUB_SHUT_RDWR SHUT_RDWR
+#define STUB_SEND_FLAGS MSG_NOSIGNAL
+#endif
+
+struct StubRequest {
+	std::string method;
+	std::string path;
+	std::map<std::string, std::string> headers;	//keyΪСд
+	std::string body;
+
+	std::string header(const std::string& name) const {
+		auto find = headers.find(name);
+		return find != headers.end() ? find->second : std::string();
+	}
+};
+
+struct StubResponse {
+	int status = 200;
+	std::vector<std::pair<std::string, std::string>> headers;
+	std::string body;
+	int delay_ms = 0;	//ظǰȴģ˴ʱ
+};
+
+//ػػHTTP/1.1׮ÿһ̣֧߳keep-alive
+class HttpStubServer {
+public:
+	using Handler = std::function<void(const StubRequest&, StubResponse&)>;
+
+	HttpStubServer()
+		:listen_(STUB_INVALID_SOCKET), port_(0), running_(false), connections_(0),
+		requests_(0), in_flight_(0), max_in_flight_(0)
+	{
+		handler_ = [](const StubRequest&, StubResponse& response) {
+			response.body = "ok";
+		};
+	}
+
+	~HttpStubServer() {
+		Stop();
+	}
+
+	void SetHandler(Handler handler) {
+		std::lock_guard<std::mutex> locker(lock_);
+		handler_ = handler;
+	}
+
+	bool Start() {
+#ifdef _WIN32
+		WSADATA data;
+		WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+		listen_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (listen_ == STUB_INVALID_SOCKET)
+			return false;
+
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+		socklen_t len = sizeof(addr);
+		if (bind(listen_, (sockaddr*)&addr, sizeof(addr)) != 0
+			|| listen(listen_, 128) != 0
+			|| getsockname(listen_, (sockaddr*)&addr, &len) != 0) {
+			stub_close_socket(listen_);
+			listen_ = STUB_INVALID_SOCKET;
+			return false;
+		}
+		port_ = ntohs(addr.sin_port);
+		running_ = true;
+		accept_thread_ = std::thread(&HttpStubServer::AcceptLoop, this);
+		return true;
+	}
+
+	void Stop() {
+		if (!running_.exchange(false))
+			return;
+
+		shutdown(listen_, STUB_SHUT_RDWR);
+		stub_close_socket(listen_);
+		accept_thread_.join();
+
+		std::vector<std::thread> threads;
+		{
+			std::lock_guard<std::mutex> locker(lock_);
+			for (auto sock : sockets_)
+				shutdown(sock, STUB_SHUT_RDWR);
+			threads.swap(threads_);
+		}
+		for (auto& t : threads)
+			t.join();
+	}
+
+	std::string Url(const std::string& path) const {
+		return "http://127.0.0.1:" + std::to_string(port_) + path;
+	}
+
+	int port() const { return port_; }
+	int connections() const { return connections_; }
+	int requests() const { return requests_; }
+	int max_in_flight() const { return max_in_flight_; }
+
+	void ResetCounters() {
+		connections_ = 0;
+		requests_ = 0;
+		max_in_flight_ = 0;
+	}
+private:
+	void AcceptLoop() {
+		while (running_) {
+			stub_socket_t sock = accept(listen_, nullptr, nullptr);
+			if (sock == STUB_INVALID_SOCKET)
+				continue;
+
+			int flag = 1;
+			setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char*)&flag, sizeof(flag));
+			++connections_;
+
+			std::lock_guard<std::mutex> locker(lock_);
+			if (!running_) {
+				stub_close_socket(sock);
+				break;
+			}
+			sockets_.push_back(sock);
+			threads_.emplace_back(&HttpStubServer::Serve, this, sock);
+		}
+	}
+
+	void Serve(stub_socket_t sock) {
+		std::string buffer;
+		StubRequest request;
+		while (ReadRequest(sock, buffer, request)) {
+			int in_flight = ++in_flight_;
+			int max = max_in_flight_;
+			while (in_flight > max && !max_in_flight_.compare_exchange_weak(max, in_flight)) {
+			}
+			++requests_;
+
+			StubResponse response;
+			Handler handler;
+			{
+				std::lock_guard<std::mutex> locker(lock_);
+				handler = handler_;
+			}
+			handler(request, response);
+			if (response.delay_ms > 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(response.delay_ms));
+			--in_flight_;
+
+			if (!WriteResponse(sock, response, request.method == "HEAD") || request.header("connection") == "close")
+				break;
+		}
+
+		std::lock_guard<std::mutex> locker(lock_);
+		for (auto it = sockets_.begin(); it != sockets_.end(); ++it) {
+			if (*it == sock) {
+				sockets_.erase(it);
+				break;
+			}
+		}
+		stub_close_socket(sock);
+	}
+
+	static bool ReadRequest(stub_socket_t sock, std::string& buffer, StubRequest& request) {
+		size_t end;
+		while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+			if (!Receive(sock, buffer))
+				return false;
+		}
+
+		request = StubRequest();
+		size_t line_end = buffer.find("\r\n");
+		std::string line = buffer.substr(0, line_end);
+		size_t sp1 = line.find(' ');
+		size_t sp2 = line.find(' ', sp1 + 1);
+		request.method = line.substr(0, sp1);
+		request.path = line.substr(sp1 + 1, sp2 - sp1 - 1);
+
+		size_t pos = line_end + 2;
+		while (pos < end) {
+			size_t next = buffer.find("\r\n", pos);
+			std::string header = buffer.substr(pos, next - pos);
+			size_t colon = header.find(':');
+			if (colon != std::string::npos) {
+				std::string name = header.substr(0, colon);
+				for (auto& c : name)
+					c = (char)tolower((unsigned char)c);
+				size_t value = header.find_first_not_of(' ', colon + 1);
+				request.headers[name] = value != std::string::npos ? header.substr(value) : std::string();
+			}
+			pos = next + 2;
+		}
+		buffer.erase(0, end + 4);
+
+		size_t length = (size_t)atoi(request.header("content-length").c_str());
+		while (buffer.size() < length) {
+			if (!Receive(sock, buffer))
+				return false;
+		}
+		request.body = buffer.substr(0, length);
+		buffer.erase(0, length);
+		return true;
+	}
+
+	static bool Receive(stub_socket_t sock, std::string& buffer) {
+		char data[16 * 1024];
+		int size = recv(sock, data, sizeof(data), 0);
+		if (size <= 0)
+			return false;
+		buffer.append(data, size);
+		return true;
+	}
+
+	//HEADֻظͷContent-Length԰body
+	static bool WriteResponse(stub_socket_t sock, const StubResponse& response, bool head) {
+		std::string data = "HTTP/1.1 " + std::to_string(response.status) + " Stub\r\n";
+		for (auto& header : response.headers)
+			data += header.first + ": " + header.second + "\r\n";
+		if (response.status != 304)
+			data += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+		data += "\r\n";
+		if (response.status != 304 && !head)
+			data += response.body;
+
+		size_t sent = 0;
+		while (sent < data.size()) {
+			int size = send(sock, data.data() + sent, (int)(data.size() - sent), STUB_SEND_FLAGS);
+			if (size <= 0)
+				return false;
+			sent += size;
+		}
+		return true;
+	}
+
+	stub_socket_t listen_;
+	int port_;
+	std::atomic<bool> running_;
+	std::thread accept_thread_;
+	std::mutex lock_;
+	std::vector<stub_socket_t> sockets_;
+	std::vector<std::thread> threads_;
+	Handler handler_;
+
+	std::atomic<int> connections_;
+	std::atomic<int> requests_;
+	std::atomic<int> in_flight_;
+	std::atomic<int> max_in_flight_;
+};
@@ -0,0 +1,142 @@
+#include "async/image_loader.h"
+#include "stbimage/stb_image_write.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static void waitFor(const std::atomic<int>& value, int expect) {
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (value < expect && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+static void writeImage(const char* file, int x, int y) {
+	std::vector<unsigned char> pixels(x * y * 3);
+	for (size_t i = 0; i < pixels.size(); ++i)
+		pixels[i] = (unsigned char)(i * 13);
+	ASSERT_TRUE(stbi_write_png(file, x, y, 3, pixels.data(), 0) != 0);
+}
+
+//ȫֵģǰղָ
+class ImageCacheTest : public testing::Test {
+protected:
+	void SetUp() override {
+		cache_ = ImageCache::Instance();
+		capacity_ = cache_->GetCapacity();
+		cache_->Clear();
+		before_ = cache_->GetStats();
+	}
+
+	void TearDown() override {
+		cache_->SetCapacity(capacity_);
+		cache_->Clear();
+	}
+
+	ImageCacheStats delta() {
+		ImageCacheStats stats = cache_->GetStats();
+		stats.hits -= before_.hits;
+		stats.misses -= before_.misses;
+		stats.coalesced -= before_.coalesced;
+		stats.evictions -= before_.evictions;
+		return stats;
+	}
+
+	ImageCache* cache_;
+	size_t capacity_;
+	ImageCacheStats before_;
+};
+
+//ͬһͼƬĲֻһΣֱ֮
+TEST_F(ImageCacheTest, CoalesceAndHit) {
+	writeImage("image_cache_a.png", 64, 48);
+
+	const int kCount = 8;
+	ImageLoader loader;
+	std::atomic<int> done(0);
+	std::vector<ImageData*> images(kCount * 2, nullptr);
+	for (int i = 0; i < kCount; ++i) {
+		loader.Load("image_cache_a.png", [&, i](RefPtr<ImageData> image) {
+			images[i] = image.get();
+			++done;
+		});
+	}
+	waitFor(done, kCount);
+
+	for (int i = kCount; i < kCount * 2; ++i) {
+		loader.Load("image_cache_a.png", [&, i](RefPtr<ImageData> image) {
+			images[i] = image.get();
+			++done;
+		});
+	}
+	waitFor(done, kCount * 2);
+
+	ASSERT_TRUE(images[0] != nullptr);
+	EXPECT_EQ(images[0]->x(), 64);
+	for (auto image : images)
+		EXPECT_EQ(image, images[0]);
+
+	ImageCacheStats stats = delta();
+	EXPECT_EQ(stats.misses, 1);
+	EXPECT_EQ(stats.coalesced + stats.hits, kCount * 2 - 1);
+	EXPECT_GE(stats.hits, kCount);
+	EXPECT_EQ(stats.bytes, 64 * 48 * 3);
+	EXPECT_EQ(stats.entries, 1);
+	remove("image_cache_a.png");
+}
+
+//Ŀߴֱͨͬ𻺴
+TEST_F(ImageCacheTest, KeyedBySizeAndComp) {
+	writeImage("image_cache_b.png", 40, 40);
+
+	ImageLoader loader;
+	std::atomic<int> done(0);
+	RefPtr<ImageData> original, thumb, rgba;
+	loader.Load("image_cache_b.png", [&](RefPtr<ImageData> image) { original = image; ++done; });
+	loader.Load("image_cache_b.png", 10, 10, 0, [&](RefPtr<ImageData> image) { thumb = image; ++done; });
+	loader.Load("image_cache_b.png", 0, 0, 4, [&](RefPtr<ImageData> image) { rgba = image; ++done; });
+	waitFor(done, 3);
+
+	ASSERT_TRUE(original && thumb && rgba);
+	EXPECT_EQ(thumb->x(), 10);
+	EXPECT_EQ(thumb->comp(), 3);
+	EXPECT_EQ(rgba->x(), 40);
+	EXPECT_EQ(rgba->comp(), 4);
+	EXPECT_TRUE(cache_->Find("image_cache_b.png", 10, 10, 0) == thumb);
+	EXPECT_EQ(delta().misses, 3);
+	EXPECT_EQ(cache_->GetStats().bytes, 40 * 40 * 3 + 10 * 10 * 3 + 40 * 40 * 4);
+
+	//ʧܲ
+	RefPtr<ImageData> missing = MakeRefCounted<ImageData>();
+	loader.Load("image_cache_missing.png", [&](RefPtr<ImageData> image) { missing = image; ++done; });
+	waitFor(done, 4);
+	EXPECT_TRUE(!missing);
+	EXPECT_EQ(cache_->GetStats().entries, 3);
+	remove("image_cache_b.png");
+}
+
+//ֽʱ̭δõ
+TEST_F(ImageCacheTest, EvictByBytes) {
+	writeImage("image_cache_c.png", 32, 32);
+	cache_->SetCapacity(32 * 32 * 3 * 2);
+
+	ImageLoader loader;
+	std::atomic<int> done(0);
+	auto load = [&](int size) {
+		int expect = done + 1;
+		loader.Load("image_cache_c.png", size, size, 0, [&](RefPtr<ImageData>) { ++done; });
+		waitFor(done, expect);
+	};
+
+	load(32);
+	load(31);
+	load(32);
+	load(30);
+	EXPECT_TRUE(cache_->Find("image_cache_c.png", 31, 31, 0) == nullptr);
+	EXPECT_TRUE(cache_->Find("image_cache_c.png", 32, 32, 0) != nullptr);
+	EXPECT_TRUE(cache_->Find("image_cache_c.png", 30, 30, 0) != nullptr);
+	EXPECT_EQ(delta().evictions, 1);
+	EXPECT_LE(cache_->GetStats().bytes, 32 * 32 * 3 * 2);
+	remove("image_cache_c.png");
+}
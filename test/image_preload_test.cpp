@@ -0,0 +1,323 @@
+#include "duilib/Utils/ImageDecoder.h"
+#include "duilib/Utils/PixelKernel.h"
+#include "async/thread.h"
+#include "stbimage/stb_image.h"
+#include "stbimage/stb_image_write.h"
+#include "gtest/gtest.h"
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace DuiLib;
+using Clock = std::chrono::steady_clock;
+
+static void appendBytes(void* context, void* data, int size) {
+	std::vector<uint8_t>* out = static_cast<std::vector<uint8_t>*>(context);
+	out->insert(out->end(), (uint8_t*)data, (uint8_t*)data + size);
+}
+
+//ڴеRGBA png͸
+static std::vector<uint8_t> makePng(int x, int y, unsigned seed) {
+	std::mt19937 rand(seed);
+	std::vector<uint8_t> pixels((size_t)x * y * 4);
+	for (size_t i = 0; i < pixels.size(); i += 4) {
+		pixels[i] = (uint8_t)(i / 4 % x * 255 / x);
+		pixels[i + 1] = (uint8_t)(i / 4 / x * 255 / y);
+		pixels[i + 2] = (uint8_t)rand();
+		pixels[i + 3] = (uint8_t)(rand() % 3 == 0 ? rand() : 255);
+	}
+	std::vector<uint8_t> png;
+	stbi_write_png_to_func(appendBytes, &png, x, y, 4, pixels.data(), 0);
+	return png;
+}
+
+//stbiֱӽתĽ
+static std::vector<uint8_t> reference(const std::vector<uint8_t>& png, uint32_t mask, bool* alpha) {
+	int x, y, n;
+	uint8_t* pixel = stbi_load_from_memory(png.data(), (int)png.size(), &x, &y, &n, 4);
+	std::vector<uint8_t> bgra((size_t)x * y * 4);
+	*alpha = CPixelKernel::RgbaToPremultipliedBgra(pixel, bgra.data(), (size_t)x * y, mask, CPixelKernel::kScalar);
+	stbi_image_free(pixel);
+	return bgra;
+}
+
+static std::unique_ptr<uint8_t[]> copyBytes(const std::vector<uint8_t>& bytes) {
+	std::unique_ptr<uint8_t[]> data(new uint8_t[bytes.size()]);
+	memcpy(data.get(), bytes.data(), bytes.size());
+	return data;
+}
+
+//õͼƬԴַڴеpngͳƶȡ
+//readerйݣԽִеҲͷŵĶ
+class MemoryImages {
+public:
+	MemoryImages() : data_(std::make_shared<Data>()) {}
+
+	void Add(const image_string& name, std::vector<uint8_t> png) {
+		data_->images[name] = std::move(png);
+	}
+
+	CImagePreloader::Reader reader() {
+		std::shared_ptr<Data> data = data_;
+		return [data](const image_string& name, size_t& size, int& scale) -> std::unique_ptr<uint8_t[]> {
+			data->reads++;
+			auto find = data->images.find(name);
+			if (find == data->images.end())
+				return nullptr;
+			size = find->second.size();
+			scale = 100;
+			return copyBytes(find->second);
+		};
+	}
+
+	const std::vector<uint8_t>& png(const image_string& name) { return data_->images[name]; }
+	int reads() const { return data_->reads; }
+private:
+	struct Data {
+		std::map<image_string, std::vector<uint8_t>> images;
+		std::atomic<int> reads{ 0 };
+	};
+	std::shared_ptr<Data> data_;
+};
+
+static image_string imageName(int i) {
+	char name[32];
+	snprintf(name, sizeof(name), "skin/%d.png", i);
+	std::string s(name);
+	return image_string(s.begin(), s.end());
+}
+
+//ԭתֱתDIBĽοһ
+TEST(DecodedImage, MatchesReference) {
+	std::vector<uint8_t> png = makePng(37, 23, 1);
+	bool expect_alpha = false;
+	std::vector<uint8_t> expect = reference(png, 0, &expect_alpha);
+	EXPECT_TRUE(expect_alpha);
+
+	CDecodedImage image;
+	ASSERT_TRUE(image.Decode(png.data(), png.size()));
+	EXPECT_EQ(image.GetWidth(), 37);
+	EXPECT_EQ(image.GetHeight(), 23);
+	EXPECT_FALSE(image.IsConverted());
+
+	std::vector<uint8_t> dib(expect.size());
+	EXPECT_EQ(image.Convert(0, dib.data()), expect_alpha);
+	EXPECT_EQ(dib, expect);
+	EXPECT_FALSE(image.IsConverted());
+
+	EXPECT_EQ(image.Convert(0), expect_alpha);
+	EXPECT_TRUE(image.IsConverted());
+	EXPECT_EQ(std::vector<uint8_t>(image.GetBits(), image.GetBits() + expect.size()), expect);
+
+	//Ѿתֻ
+	std::vector<uint8_t> copy(expect.size());
+	EXPECT_EQ(image.Convert(0, copy.data()), expect_alpha);
+	EXPECT_EQ(copy, expect);
+}
+
+//dpiͼƬȱʧʱٷֱԭͼΧscale
+TEST(DecodedImage, Scale) {
+	std::vector<uint8_t> png = makePng(40, 20, 2);
+	CDecodedImage image;
+	ASSERT_TRUE(image.Decode(png.data(), png.size(), 150));
+	EXPECT_EQ(image.GetWidth(), 60);
+	EXPECT_EQ(image.GetHeight(), 30);
+	ASSERT_TRUE(image.Decode(png.data(), png.size(), 125));
+	EXPECT_EQ(image.GetWidth(), 50);
+	EXPECT_EQ(image.GetHeight(), 25);
+	for (int scale : { 0, 100, 800 }) {
+		ASSERT_TRUE(image.Decode(png.data(), png.size(), scale));
+		EXPECT_EQ(image.GetWidth(), 40) << scale;
+		EXPECT_EQ(image.GetHeight(), 20) << scale;
+	}
+
+	//͸ŽҪalphaͨ
+	std::vector<uint8_t> pixels(16 * 16 * 3, 200);
+	std::vector<uint8_t> opaque;
+	stbi_write_png_to_func(appendBytes, &opaque, 16, 16, 3, pixels.data(), 0);
+	ASSERT_TRUE(image.Decode(opaque.data(), opaque.size(), 200));
+	EXPECT_EQ(image.GetWidth(), 32);
+	EXPECT_FALSE(image.Convert(0));
+	EXPECT_EQ(image.GetBits()[0], 200);
+	EXPECT_EQ(image.GetBits()[3], 255);
+}
+
+TEST(DecodedImage, Invalid) {
+	const uint8_t garbage[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	CDecodedImage image;
+	EXPECT_FALSE(image.Decode(garbage, sizeof(garbage)));
+	EXPECT_EQ(image.GetBits(), nullptr);
+	EXPECT_FALSE(image.Convert(0));
+}
+
+//ÿͼƬֻȡһΣȡĽͬһ£ȡߺ¼Ƴ
+TEST(ImagePreloader, TakeMatchesSyncLoad) {
+	MemoryImages images;
+	const int kCount = 24;
+	for (int i = 0; i < kCount; ++i)
+		images.Add(imageName(i), makePng(20 + i, 30 - i, i));
+
+	CImagePreloader preloader(images.reader());
+	for (int i = 0; i < kCount; ++i) {
+		preloader.Preload(imageName(i), 0);
+		preloader.Preload(imageName(i), 0);
+	}
+	EXPECT_EQ(preloader.GetCount(), (size_t)kCount);
+
+	uint32_t mask = 1;
+	EXPECT_TRUE(preloader.Lookup(imageName(3), mask));
+	EXPECT_EQ(mask, 0u);
+
+	for (int i = kCount - 1; i >= 0; --i) {
+		CDecodedImage image;
+		ASSERT_TRUE(preloader.Take(imageName(i), 0, image)) << i;
+		EXPECT_TRUE(image.IsConverted());
+		bool alpha = false;
+		std::vector<uint8_t> expect = reference(images.png(imageName(i)), 0, &alpha);
+		std::vector<uint8_t> dib(expect.size());
+		EXPECT_EQ(image.Convert(0, dib.data()), alpha);
+		EXPECT_EQ(dib, expect) << i;
+	}
+	EXPECT_EQ(images.reads(), kCount);
+	EXPECT_EQ(preloader.GetCount(), 0u);
+
+	CDecodedImage image;
+	EXPECT_FALSE(preloader.Take(imageName(0), 0, image));
+	EXPECT_FALSE(preloader.Lookup(imageName(0), mask));
+}
+
+//maskͬҲļûԤʱfalseɵ߰ԭʽ
+TEST(ImagePreloader, Fallback) {
+	MemoryImages images;
+	images.Add(imageName(0), makePng(8, 8, 0));
+	images.Add(imageName(1), makePng(8, 8, 1));
+	CImagePreloader preloader(images.reader());
+	preloader.Preload(imageName(0), 0xff00ff00);
+	preloader.Preload(imageName(1), 0);
+	preloader.Preload(imageName(99), 0);
+
+	CDecodedImage image;
+	EXPECT_FALSE(preloader.Take(imageName(0), 0, image));
+	EXPECT_FALSE(preloader.Take(imageName(99), 0, image));
+	EXPECT_FALSE(preloader.Take(imageName(2), 0, image));
+	EXPECT_TRUE(preloader.Take(imageName(1), 0, image));
+	EXPECT_EQ(image.GetWidth(), 8);
+
+	//ѶڴֻͼƬ߳Ͻ
+	std::vector<uint8_t> png = makePng(12, 6, 3);
+	preloader.Preload(imageName(5), 0, copyBytes(png), png.size(), 200);
+	ASSERT_TRUE(preloader.Take(imageName(5), 0, image));
+	EXPECT_EQ(image.GetWidth(), 24);
+	EXPECT_EQ(image.GetHeight(), 12);
+}
+
+//ͼƬ̶߳ռʱȡŶеͼƬɵֱ߳ӽ룬ȴǰ
+TEST(ImagePreloader, TakeQueuedOnCaller) {
+	const size_t kBlocked = ThreadManager::Instance()->pool()->size();
+	std::vector<uint8_t> png = makePng(16, 16, 4);
+
+	std::mutex lock;
+	std::condition_variable cv;
+	bool release = false;
+	std::atomic<size_t> blocked(0);
+	std::thread::id reader_thread;
+	image_string last = imageName(1000);
+	CImagePreloader preloader([&](const image_string& name, size_t& size, int& scale) -> std::unique_ptr<uint8_t[]> {
+		if (name == last) {
+			reader_thread = std::this_thread::get_id();
+		}
+		else {
+			std::unique_lock<std::mutex> locker(lock);
+			blocked++;
+			cv.notify_all();
+			cv.wait(locker, [&]() { return release; });
+		}
+		size = png.size();
+		return copyBytes(png);
+	});
+
+	for (size_t i = 0; i < kBlocked; ++i)
+		preloader.Preload(imageName((int)i), 0);
+	{
+		std::unique_lock<std::mutex> locker(lock);
+		ASSERT_TRUE(cv.wait_for(locker, std::chrono::seconds(10), [&]() { return blocked == kBlocked; }));
+	}
+	preloader.Preload(last, 0);
+
+	CDecodedImage image;
+	EXPECT_TRUE(preloader.Take(last, 0, image));
+	EXPECT_EQ(reader_thread, std::this_thread::get_id());
+
+	{
+		std::lock_guard<std::mutex> locker(lock);
+		release = true;
+	}
+	cv.notify_all();
+	for (size_t i = 0; i < kBlocked; ++i)
+		EXPECT_TRUE(preloader.Take(imageName((int)i), 0, image));
+}
+
+//ͷźִеԼ״̬ͷŵĶ
+TEST(ImagePreloader, DestroyWhileDecoding) {
+	MemoryImages images;
+	for (int i = 0; i < 64; ++i)
+		images.Add(imageName(i), makePng(64, 64, i));
+	for (int round = 0; round < 10; ++round) {
+		CImagePreloader preloader(images.reader());
+		for (int i = 0; i < 64; ++i)
+			preloader.Preload(imageName(i), 0);
+		if (round % 2) {
+			preloader.Clear();
+			EXPECT_EQ(preloader.GetCount(), 0u);
+		}
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	EXPECT_LE(images.reads(), 640);
+}
+
+//80ƤͼƬ߳żأԱԤغʹ˳ȡ
+TEST(ImagePreloader, Benchmark) {
+	const int kCount = 80;
+	MemoryImages images;
+	std::vector<std::vector<uint8_t>> pngs;
+	for (int i = 0; i < 8; ++i)
+		pngs.push_back(makePng(320, 240, i));
+	for (int i = 0; i < kCount; ++i)
+		images.Add(imageName(i), pngs[i % pngs.size()]);
+	CImagePreloader::Reader reader = images.reader();
+
+	auto start = Clock::now();
+	for (int i = 0; i < kCount; ++i) {
+		size_t size = 0;
+		int scale = 100;
+		std::unique_ptr<uint8_t[]> data = reader(imageName(i), size, scale);
+		CDecodedImage image;
+		ASSERT_TRUE(image.Decode(data.get(), size, scale));
+		std::vector<uint8_t> dib((size_t)image.GetWidth() * image.GetHeight() * 4);
+		image.Convert(0, dib.data());
+	}
+	double sync_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	start = Clock::now();
+	CImagePreloader preloader(reader);
+	for (int i = 0; i < kCount; ++i)
+		preloader.Preload(imageName(i), 0);
+	double submit_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	for (int i = 0; i < kCount; ++i) {
+		CDecodedImage image;
+		ASSERT_TRUE(preloader.Take(imageName(i), 0, image));
+		std::vector<uint8_t> dib((size_t)image.GetWidth() * image.GetHeight() * 4);
+		image.Convert(0, dib.data());
+	}
+	double preload_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	printf("%d images 320x240: sync %.1f ms, preload %.1f ms (submit %.2f ms), %zu workers\n",
+		kCount, sync_ms, preload_ms, submit_ms, ThreadManager::Instance()->pool()->size());
+}
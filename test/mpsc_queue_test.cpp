@@ -0,0 +1,186 @@
+#include "gtest/gtest.h"
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <stdio.h>
+
+//ThreadTaskManagerõǼУMPSCжԱ
+//81ߣӳp99ʵǰһȷ
+
+using Task = std::function<void()>;
+
+//Thread::PostTask/PopTaskͬļ
+class LockedQueue {
+public:
+	void Push(Task task) {
+		std::lock_guard<std::mutex> locker(lock_);
+		tasks_.push(std::move(task));
+	}
+
+	bool Pop(Task& task) {
+		std::lock_guard<std::mutex> locker(lock_);
+		if (tasks_.empty())
+			return false;
+		task = std::move(tasks_.front());
+		tasks_.pop();
+		return true;
+	}
+private:
+	std::mutex lock_;
+	std::queue<Task> tasks_;
+};
+
+//ߵ߶(Vyukov)ÿԪһڵ
+class MpscQueue {
+public:
+	MpscQueue()
+		:head_(new Node()), tail_(head_.load(std::memory_order_relaxed))
+	{
+	}
+
+	~MpscQueue() {
+		Task task;
+		while (Pop(task)) {
+		}
+		delete tail_;
+	}
+
+	void Push(Task task) {
+		Node* node = new Node();
+		node->task = std::move(task);
+		Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+		prev->next.store(node, std::memory_order_release);
+	}
+
+	//̵ֻ߳
+	bool Pop(Task& task) {
+		Node* tail = tail_;
+		Node* next = tail->next.load(std::memory_order_acquire);
+		if (!next)
+			return false;
+
+		task = std::move(next->task);
+		tail_ = next;
+		delete tail;
+		return true;
+	}
+private:
+	struct Node {
+		Node()
+			:next(nullptr)
+		{
+		}
+
+		std::atomic<Node*> next;
+		Task task;
+	};
+
+	std::atomic<Node*> head_;
+	Node* tail_;
+};
+
+template<class Queue>
+static void runFifo() {
+	const int kProducers = 8;
+	const int kCount = 20000;
+	Queue queue;
+
+	std::vector<std::thread> producers;
+	std::vector<int> next(kProducers, 0);
+	bool ordered = true;
+	for (int p = 0; p < kProducers; ++p) {
+		producers.emplace_back([&, p]() {
+			for (int i = 0; i < kCount; ++i) {
+				queue.Push([&, p, i]() {
+					if (next[p] != i)
+						ordered = false;
+					next[p] = i + 1;
+				});
+			}
+		});
+	}
+
+	int received = 0;
+	Task task;
+	while (received < kProducers * kCount) {
+		if (queue.Pop(task)) {
+			task();
+			++received;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+	for (auto& t : producers)
+		t.join();
+	EXPECT_TRUE(ordered);
+	EXPECT_FALSE(queue.Pop(task));
+}
+
+//ͬһߵ˳ִ
+TEST(TaskQueue, FifoPerProducer) {
+	runFifo<LockedQueue>();
+	runFifo<MpscQueue>();
+}
+
+template<class Queue>
+static void runContention(const char* name) {
+	const int kProducers = 8;
+	const int kCount = 50000;
+	Queue queue;
+	std::atomic<bool> done(false);
+	std::atomic<int> executed(0);
+	std::vector<std::vector<int64_t>> latency(kProducers);
+
+	std::thread consumer([&]() {
+		Task task;
+		while (!done || executed < kProducers * kCount) {
+			if (queue.Pop(task))
+				task();
+			else
+				std::this_thread::yield();
+		}
+	});
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<std::thread> producers;
+	for (int p = 0; p < kProducers; ++p) {
+		producers.emplace_back([&, p]() {
+			auto& samples = latency[p];
+			samples.reserve(kCount);
+			for (int i = 0; i < kCount; ++i) {
+				auto t0 = std::chrono::steady_clock::now();
+				queue.Push([&executed]() { ++executed; });
+				auto t1 = std::chrono::steady_clock::now();
+				samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+			}
+		});
+	}
+	for (auto& t : producers)
+		t.join();
+	done = true;
+	consumer.join();
+
+	auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - start).count();
+
+	std::vector<int64_t> all;
+	for (auto& samples : latency)
+		all.insert(all.end(), samples.begin(), samples.end());
+	std::sort(all.begin(), all.end());
+	int64_t p99 = all[all.size() * 99 / 100];
+
+	printf("%-12s %.0f ops/s, p99 enqueue %lld ns\n", name,
+		us > 0 ? all.size() * 1000000.0 / us : 0.0, (long long)p99);
+	EXPECT_EQ(executed, kProducers * kCount);
+}
+
+TEST(TaskQueue, Contention) {
+	runContention<LockedQueue>("mutex queue");
+	runContention<MpscQueue>("mpsc queue");
+}
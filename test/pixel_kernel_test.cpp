@@ -0,0 +1,115 @@
+#include "duilib/Utils/PixelKernel.h"
+#include "gtest/gtest.h"
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace DuiLib;
+using Clock = std::chrono::steady_clock;
+
+static const char* kLevelNames[] = { "scalar", "sse2", "ssse3", "avx2" };
+
+//أȫ͸͸͵mask
+static std::vector<uint8_t> makePixels(size_t count, uint32_t mask, unsigned seed) {
+	std::mt19937 rand(seed);
+	std::vector<uint8_t> pixels(count * 4);
+	for (size_t i = 0; i < count; ++i) {
+		uint8_t* p = &pixels[i * 4];
+		for (int c = 0; c < 4; ++c)
+			p[c] = (uint8_t)rand();
+		switch (rand() % 4) {
+		case 0:
+			p[3] = 255;
+			break;
+		case 1:
+			p[3] = 0;
+			break;
+		case 2:
+			//תõmask͸BGRдRGB
+			p[0] = (uint8_t)(mask >> 16);
+			p[1] = (uint8_t)(mask >> 8);
+			p[2] = (uint8_t)mask;
+			p[3] = (uint8_t)(mask >> 24);
+			break;
+		}
+	}
+	return pixels;
+}
+
+//ʵ汾ֽһ£ֳȵβǵ
+TEST(PixelKernel, MatchesScalar) {
+	const uint32_t mask = 0xff00ff00;
+	std::vector<uint8_t> src = makePixels(1000, mask, 1);
+	for (size_t count : { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 1000 }) {
+		std::vector<uint8_t> expect(count * 4 + 4, 0xcd);
+		bool expect_alpha = CPixelKernel::RgbaToPremultipliedBgra(src.data(), expect.data(), count, mask, CPixelKernel::kScalar);
+		for (int level = CPixelKernel::kSSE2; level <= CPixelKernel::Best(); ++level) {
+			std::vector<uint8_t> dst(count * 4 + 4, 0xcd);
+			bool alpha = CPixelKernel::RgbaToPremultipliedBgra(src.data(), dst.data(), count, mask, (CPixelKernel::Level)level);
+			EXPECT_EQ(dst, expect) << kLevelNames[level] << " count " << count;
+			EXPECT_EQ(alpha, expect_alpha) << kLevelNames[level] << " count " << count;
+		}
+	}
+}
+
+//Ԥˡͨmaskalphaɫȫ
+TEST(PixelKernel, Exhaustive) {
+	std::vector<uint8_t> src(256 * 256 * 4);
+	for (int a = 0; a < 256; ++a) {
+		for (int c = 0; c < 256; ++c) {
+			uint8_t* p = &src[(a * 256 + c) * 4];
+			p[0] = (uint8_t)c;
+			p[1] = (uint8_t)(255 - c);
+			p[2] = (uint8_t)(c ^ 0x5a);
+			p[3] = (uint8_t)a;
+		}
+	}
+	for (int level = CPixelKernel::kScalar; level <= CPixelKernel::Best(); ++level) {
+		std::vector<uint8_t> dst(src.size());
+		CPixelKernel::RgbaToPremultipliedBgra(src.data(), dst.data(), 256 * 256, 0, (CPixelKernel::Level)level);
+		for (size_t i = 0; i < 256 * 256; ++i) {
+			const uint8_t* s = &src[i * 4];
+			const uint8_t* d = &dst[i * 4];
+			ASSERT_EQ(d[0], s[2] * s[3] / 255) << kLevelNames[level];
+			ASSERT_EQ(d[1], s[1] * s[3] / 255) << kLevelNames[level];
+			ASSERT_EQ(d[2], s[0] * s[3] / 255) << kLevelNames[level];
+			ASSERT_EQ(d[3], s[3]) << kLevelNames[level];
+		}
+	}
+}
+
+//͸ûmaskʱҪalphaͨ
+TEST(PixelKernel, AlphaFlag) {
+	std::vector<uint8_t> opaque(37 * 4, 255);
+	for (int level = CPixelKernel::kScalar; level <= CPixelKernel::Best(); ++level) {
+		std::vector<uint8_t> dst(opaque.size());
+		CPixelKernel::Level l = (CPixelKernel::Level)level;
+		EXPECT_FALSE(CPixelKernel::RgbaToPremultipliedBgra(opaque.data(), dst.data(), 37, 0xff000000, l));
+		EXPECT_TRUE(CPixelKernel::RgbaToPremultipliedBgra(opaque.data(), dst.data(), 37, 0xffffffff, l));
+		EXPECT_EQ(dst, std::vector<uint8_t>(opaque.size(), 0));
+
+		std::vector<uint8_t> translucent = opaque;
+		translucent[36 * 4 + 3] = 254;
+		EXPECT_TRUE(CPixelKernel::RgbaToPremultipliedBgra(translucent.data(), dst.data(), 37, 0, l));
+		translucent[36 * 4 + 3] = 255;
+		translucent[5 * 4 + 3] = 0;
+		EXPECT_TRUE(CPixelKernel::RgbaToPremultipliedBgra(translucent.data(), dst.data(), 37, 0, l));
+	}
+}
+
+//1920x1080ͼתʱ
+TEST(PixelKernel, Benchmark) {
+	const size_t kCount = 1920 * 1080;
+	const int kRuns = 20;
+	std::vector<uint8_t> src = makePixels(kCount, 0xff00ff00, 2);
+	std::vector<uint8_t> dst(kCount * 4);
+	for (int level = CPixelKernel::kScalar; level <= CPixelKernel::Best(); ++level) {
+		CPixelKernel::RgbaToPremultipliedBgra(src.data(), dst.data(), kCount, 0xff00ff00, (CPixelKernel::Level)level);
+		auto start = Clock::now();
+		for (int i = 0; i < kRuns; ++i)
+			CPixelKernel::RgbaToPremultipliedBgra(src.data(), dst.data(), kCount, 0xff00ff00, (CPixelKernel::Level)level);
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count() / kRuns;
+		printf("%-8s %7.3f ms, %7.1f Mpixel/s\n", kLevelNames[level], ms, kCount / ms / 1000);
+	}
+}
@@ -0,0 +1,502 @@
+#include "async/storage.h"
+#include "sqlite3/sqlite3.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <stdio.h>
+
+static const char* kTestDb = "storage_test.db";
+
+static void removeDb() {
+	remove(kTestDb);
+	remove("storage_test.db-journal");
+	remove("storage_test.db-wal");
+	remove("storage_test.db-shm");
+}
+
+static void waitFor(const std::atomic<int>& value, int expect) {
+	while (value < expect) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+static void openDb(Storage& storage, const StorageOptions& options) {
+	std::atomic<int> done(0);
+	storage.Open(kTestDb, options, [&](int code) {
+		EXPECT_EQ(code, 0);
+		++done;
+	});
+	storage.Exec("CREATE TABLE msg(id INTEGER PRIMARY KEY, body TEXT)", [&](int code, std::string) {
+		EXPECT_EQ(code, 0);
+		++done;
+	});
+	waitFor(done, 2);
+}
+
+static void closeDb(Storage& storage) {
+	std::atomic<int> done(0);
+	storage.Close([&](int code) {
+		++done;
+	});
+	waitFor(done, 1);
+}
+
+static int64_t countRows(Storage& storage) {
+	std::atomic<int> done(0);
+	int64_t count = -1;
+	storage.Query("SELECT count(*) FROM msg", StorageParams(), true, [&](StorageResultPtr result) {
+		if (result->code == 0 && result->rows.size() == 1)
+			count = result->rows[0][0].i;
+		++done;
+	});
+	waitFor(done, 1);
+	return count;
+}
+
+static StorageParams makeParams(int64_t id, const std::string& body) {
+	StorageParams params(2);
+	params[0].value.type = StorageValue::kInteger;
+	params[0].value.i = id;
+	params[1].value.type = StorageValue::kText;
+	params[1].value.data = body;
+	return params;
+}
+
+//λúְ󶨲
+TEST(StorageConnection, BindTypedRows) {
+	StorageConnection conn;
+	ASSERT_EQ(conn.Open(":memory:", StorageOptions(), false), 0);
+	ASSERT_EQ(conn.Execute("CREATE TABLE t(i INTEGER, f REAL, s TEXT, b BLOB, n)", StorageParams(), false)->code, 0);
+
+	StorageParams params(5);
+	params[0].value.type = StorageValue::kInteger;
+	params[0].value.i = 1ll << 40;
+	params[1].value.type = StorageValue::kFloat;
+	params[1].value.f = 1.5;
+	params[2].value.type = StorageValue::kText;
+	params[2].value.data = "hello";
+	params[3].value.type = StorageValue::kBlob;
+	params[3].value.data.assign("a\0b", 3);
+	StorageResultPtr result = conn.Execute("INSERT INTO t VALUES(?,?,?,?,?)", params, false);
+	EXPECT_EQ(result->code, 0);
+	EXPECT_EQ(result->changes, 1);
+	EXPECT_EQ(result->last_insert_rowid, 1);
+
+	//ֿʡǰ׺
+	StorageParams named(2);
+	named[0].name = "s";
+	named[0].value.type = StorageValue::kText;
+	named[0].value.data = "hello";
+	named[1].name = "@i";
+	named[1].value.type = StorageValue::kInteger;
+	named[1].value.i = 1ll << 40;
+	result = conn.Execute("SELECT * FROM t WHERE s=:s AND i=@i", named, true);
+	ASSERT_EQ(result->code, 0);
+	ASSERT_EQ(result->rows.size(), 1u);
+	ASSERT_EQ(result->columns.size(), 5u);
+	EXPECT_EQ(result->columns[2], "s");
+
+	const StorageRow& row = result->rows[0];
+	EXPECT_EQ(row[0].type, StorageValue::kInteger);
+	EXPECT_EQ(row[0].i, 1ll << 40);
+	EXPECT_EQ(row[1].type, StorageValue::kFloat);
+	EXPECT_EQ(row[1].f, 1.5);
+	EXPECT_EQ(row[2].type, StorageValue::kText);
+	EXPECT_EQ(row[2].data, "hello");
+	EXPECT_EQ(row[3].type, StorageValue::kBlob);
+	EXPECT_EQ(row[3].data, std::string("a\0b", 3));
+	EXPECT_EQ(row[4].type, StorageValue::kNull);
+
+	result = conn.Execute("SELECT * FROM missing", StorageParams(), true);
+	EXPECT_NE(result->code, 0);
+	EXPECT_FALSE(result->error.empty());
+}
+
+//ʱֻ̭δʹõ䣬ظִ
+TEST(StorageConnection, StatementCache) {
+	StorageConnection conn;
+	ASSERT_EQ(conn.Open(":memory:", StorageOptions(), false), 0);
+
+	for (int round = 0; round < 3; ++round) {
+		for (int i = 0; i < 100; ++i) {
+			StorageParams params(1);
+			params[0].value.type = StorageValue::kInteger;
+			params[0].value.i = round;
+			StorageResultPtr result = conn.Execute("SELECT ?+" + std::to_string(i), params, true);
+			ASSERT_EQ(result->code, 0);
+			ASSERT_EQ(result->rows.size(), 1u);
+			EXPECT_EQ(result->rows[0][0].i, round + i);
+		}
+	}
+
+	//رպʹû
+	conn.Close();
+	EXPECT_EQ(conn.Execute("SELECT 1", StorageParams(), true)->code, SQLITE_MISUSE);
+}
+
+//ʱBeginTransactionfalseύ
+TEST(StorageConnection, Transaction) {
+	StorageConnection conn;
+	ASSERT_EQ(conn.Open(":memory:", StorageOptions(), false), 0);
+	ASSERT_EQ(conn.Execute("CREATE TABLE t(i INTEGER)", StorageParams(), false)->code, 0);
+
+	EXPECT_TRUE(conn.BeginTransaction());
+	EXPECT_FALSE(conn.BeginTransaction());
+	conn.Execute("INSERT INTO t VALUES(1)", StorageParams(), false);
+	EXPECT_EQ(conn.EndTransaction(false), 0);
+	EXPECT_EQ(conn.Execute("SELECT count(*) FROM t", StorageParams(), true)->rows[0][0].i, 0);
+
+	EXPECT_TRUE(conn.BeginTransaction());
+	conn.Execute("INSERT INTO t VALUES(1)", StorageParams(), false);
+	EXPECT_EQ(conn.EndTransaction(true), 0);
+	EXPECT_EQ(conn.Execute("SELECT count(*) FROM t", StorageParams(), true)->rows[0][0].i, 1);
+}
+
+//ͬһеʧֻӰԼĻص
+TEST(Storage, WriteQueue) {
+	removeDb();
+	Storage storage;
+	openDb(storage, StorageOptions());
+
+	const int kCount = 100;
+	std::atomic<int> done(0);
+	std::atomic<int> failed(0);
+	for (int i = 0; i < kCount; ++i) {
+		int64_t id = i == 50 ? 1 : i + 1;
+		storage.Write("INSERT INTO msg VALUES(?,?)", makeParams(id, "hello"), [&](StorageResultPtr result) {
+			if (result->code != 0)
+				++failed;
+			++done;
+		});
+	}
+	waitFor(done, kCount);
+
+	EXPECT_EQ(failed, 1);
+	EXPECT_EQ(countRows(storage), kCount - 1);
+	closeDb(storage);
+	removeDb();
+}
+
+//رʱύʣдʱʣдصʧ
+TEST(Storage, WriteQueueTeardown) {
+	removeDb();
+	StorageOptions options;
+	options.flush_latency = 60000;
+	std::atomic<int> done(0);
+	std::atomic<int> failed(0);
+	{
+		Storage storage;
+		openDb(storage, options);
+		for (int i = 0; i < 10; ++i) {
+			storage.Write("INSERT INTO msg VALUES(?,?)", makeParams(i + 1, "hello"), [&](StorageResultPtr result) {
+				EXPECT_EQ(result->code, 0);
+				++done;
+			});
+		}
+		closeDb(storage);
+		EXPECT_EQ(done, 10);
+
+		storage.Write("INSERT INTO msg VALUES(?,?)", makeParams(11, "hello"), [&](StorageResultPtr result) {
+			EXPECT_NE(result->code, 0);
+			++failed;
+		});
+	}
+	EXPECT_EQ(failed, 1);
+	removeDb();
+}
+
+//дִStorageҪд꣬صִһ
+TEST(Storage, DestroyDuringWrite) {
+	removeDb();
+	StorageOptions options;
+	options.batch_size = 1;
+	std::atomic<int> done(0);
+	std::atomic<int> failed(0);
+	{
+		Storage storage;
+		openDb(storage, options);
+		storage.Write("INSERT INTO msg SELECT x, 'hello' FROM (WITH RECURSIVE c(x) AS "
+			"(SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 200000) SELECT x FROM c)",
+			StorageParams(), [&](StorageResultPtr result) {
+			EXPECT_EQ(result->code, 0);
+			++done;
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		for (int i = 0; i < 10; ++i) {
+			storage.Write("INSERT INTO msg VALUES(?,?)", makeParams(300000 + i, "hello"), [&](StorageResultPtr result) {
+				if (result->code == 0)
+					++done;
+				else
+					++failed;
+			});
+		}
+	}
+	EXPECT_GE(done, 1);
+	EXPECT_EQ(done + failed, 11);
+	removeDb();
+}
+
+TEST(Storage, BatchRollback) {
+	removeDb();
+	Storage storage;
+	openDb(storage, StorageOptions());
+
+	std::vector<StorageStatement> statements(3);
+	for (int i = 0; i < 3; ++i) {
+		statements[i].sql = "INSERT INTO msg VALUES(?,?)";
+		statements[i].params = makeParams(i == 2 ? 1 : i + 1, "hello");
+	}
+
+	std::atomic<int> done(0);
+	storage.Batch(statements, [&](int code, std::vector<StorageResultPtr> results) {
+		EXPECT_NE(code, 0);
+		EXPECT_EQ(results.size(), 3u);
+		++done;
+	});
+	waitFor(done, 1);
+	EXPECT_EQ(countRows(storage), 0);
+
+	statements.pop_back();
+	storage.Batch(statements, [&](int code, std::vector<StorageResultPtr> results) {
+		EXPECT_EQ(code, 0);
+		EXPECT_EQ(results.size(), 2u);
+		++done;
+	});
+	waitFor(done, 2);
+	EXPECT_EQ(countRows(storage), 2);
+	closeDb(storage);
+	removeDb();
+}
+
+//ԶύдеĲٶȶԱ
+TEST(Storage, InsertThroughput) {
+	const int kExecCount = 2000;
+	const int kWriteCount = 50000;
+
+	{
+		removeDb();
+		Storage storage;
+		StorageOptions options;
+		options.wal = false;
+		options.synchronous = 2;
+		openDb(storage, options);
+
+		std::atomic<int> done(0);
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < kExecCount; ++i) {
+			std::string sql = "INSERT INTO msg VALUES(" + std::to_string(i + 1) + ",'hello')";
+			storage.Exec(sql, [&](int code, std::string) {
+				++done;
+			});
+		}
+		waitFor(done, kExecCount);
+		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start).count();
+		printf("exec autocommit  %.0f inserts/s\n", ms > 0 ? kExecCount * 1000.0 / ms : 0.0);
+
+		EXPECT_EQ(countRows(storage), kExecCount);
+		closeDb(storage);
+	}
+
+	{
+		removeDb();
+		Storage storage;
+		openDb(storage, StorageOptions());
+
+		std::atomic<int> done(0);
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < kWriteCount; ++i) {
+			storage.Write("INSERT INTO msg VALUES(?,?)", makeParams(i + 1, "hello"), [&](StorageResultPtr result) {
+				++done;
+			});
+		}
+		waitFor(done, kWriteCount);
+		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start).count();
+		printf("wal write queue  %.0f inserts/s\n", ms > 0 ? kWriteCount * 1000.0 / ms : 0.0);
+
+		EXPECT_EQ(countRows(storage), kWriteCount);
+		closeDb(storage);
+	}
+	removeDb();
+}
+
+//ѯִֻʱѯд
+TEST(Storage, ConcurrentReads) {
+	removeDb();
+	Storage storage;
+	openDb(storage, StorageOptions());
+
+	std::atomic<int> done(0);
+	storage.Write("INSERT INTO msg VALUES(?,?)", makeParams(1, "hello"), [&](StorageResultPtr result) {
+		EXPECT_EQ(result->code, 0);
+		++done;
+	});
+	waitFor(done, 1);
+
+	std::atomic<bool> slow_done(false);
+	storage.Read("WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x+1 FROM c LIMIT 5000000) SELECT count(*) FROM c",
+		StorageParams(), [&](StorageResultPtr result) {
+		EXPECT_EQ(result->code, 0);
+		slow_done = true;
+	});
+
+	std::atomic<int> fast_before_slow(0);
+	const int kCount = 20;
+	for (int i = 0; i < kCount; ++i) {
+		StorageParams params(1);
+		params[0].value.type = StorageValue::kInteger;
+		params[0].value.i = 1;
+		storage.Read("SELECT body FROM msg WHERE id=?", params, [&](StorageResultPtr result) {
+			EXPECT_EQ(result->code, 0);
+			EXPECT_EQ(result->rows.size(), 1u);
+			if (!slow_done)
+				++fast_before_slow;
+			++done;
+		});
+	}
+	storage.Write("INSERT INTO msg VALUES(?,?)", makeParams(2, "world"), [&](StorageResultPtr result) {
+		EXPECT_EQ(result->code, 0);
+		if (!slow_done)
+			++fast_before_slow;
+		++done;
+	});
+	waitFor(done, kCount + 2);
+	while (!slow_done) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	EXPECT_EQ(fast_before_slow, kCount + 1);
+	EXPECT_TRUE(Storage::IsReadOnlySql("  select * from msg;  "));
+	EXPECT_FALSE(Storage::IsReadOnlySql("SELECT 1; DELETE FROM msg"));
+	EXPECT_FALSE(Storage::IsReadOnlySql("INSERT INTO msg VALUES(3,'a')"));
+	closeDb(storage);
+	removeDb();
+}
+
+//ֻӴʧʱѯش򿪵Ĵ룬ʧܵӷŻس
+TEST(Storage, ReaderOpenFailure) {
+	removeDb();
+	Storage storage;
+	openDb(storage, StorageOptions());
+
+	//Windows޷ɾѴ򿪵ļ
+	if (remove(kTestDb) != 0) {
+		closeDb(storage);
+		removeDb();
+		return;
+	}
+
+	std::atomic<int> done(0);
+	for (int i = 0; i < 3; ++i) {
+		storage.Read("SELECT count(*) FROM msg", StorageParams(), [&](StorageResultPtr result) {
+			EXPECT_EQ(result->code, SQLITE_CANTOPEN);
+			++done;
+		});
+		waitFor(done, i + 1);
+	}
+	closeDb(storage);
+	removeDb();
+}
+
+//execԤ䶼дϰ˳ִУ֮ܶǰд
+TEST(Storage, ReadYourWrites) {
+	removeDb();
+	Storage storage;
+	openDb(storage, StorageOptions());
+
+	const int kCount = 200;
+	std::atomic<int> done(0);
+	std::atomic<int> stale(0);
+	for (int i = 0; i < kCount; ++i) {
+		std::string id = std::to_string(i + 1);
+		storage.Exec("INSERT INTO msg VALUES(" + id + ",'hello')", [&](int code, std::string) {
+			EXPECT_EQ(code, 0);
+		});
+		storage.Exec("SELECT id FROM msg WHERE id=" + id, [&](int code, std::string data) {
+			if (data == "[]")
+				++stale;
+			++done;
+		});
+		StorageParams params(1);
+		params[0].value.type = StorageValue::kInteger;
+		params[0].value.i = i + 1;
+		storage.Query("SELECT id FROM msg WHERE id=?", params, true, [&](StorageResultPtr result) {
+			if (result->rows.size() != 1)
+				++stale;
+			++done;
+		});
+	}
+	waitFor(done, kCount * 2);
+
+	EXPECT_EQ(stale, 0);
+	closeDb(storage);
+	removeDb();
+}
+
+static void readAll(StorageCursorPtr cursor, int64_t* rows, size_t* max_chunk) {
+	std::atomic<int> done(0);
+	std::function<void()> fetch = [&]() {
+		cursor->Fetch([&](StorageResultPtr result, bool finished) {
+			EXPECT_EQ(result->code, 0);
+			*rows += result->rows.size();
+			*max_chunk = std::max(*max_chunk, result->rows.size());
+			if (finished)
+				++done;
+			else
+				fetch();
+		});
+	};
+	fetch();
+	waitFor(done, 1);
+}
+
+//αÿ෵chunkУֻӺдӶʹ
+TEST(Storage, Cursor) {
+	for (int wal = 0; wal < 2; ++wal) {
+		removeDb();
+		Storage storage;
+		StorageOptions options;
+		options.wal = wal != 0;
+		openDb(storage, options);
+
+		const int kCount = 10000;
+		std::vector<StorageStatement> statements(kCount);
+		for (int i = 0; i < kCount; ++i) {
+			statements[i].sql = "INSERT INTO msg VALUES(?,?)";
+			statements[i].params = makeParams(i + 1, "hello");
+		}
+		std::atomic<int> done(0);
+		storage.Batch(statements, [&](int code, std::vector<StorageResultPtr>) {
+			EXPECT_EQ(code, 0);
+			++done;
+		});
+		waitFor(done, 1);
+
+		int64_t rows = 0;
+		size_t max_chunk = 0;
+		readAll(storage.OpenCursor("SELECT * FROM msg", StorageParams(), 1000), &rows, &max_chunk);
+		EXPECT_EQ(rows, kCount);
+		EXPECT_EQ(max_chunk, 1000u);
+
+		//ǰرպٷ
+		StorageCursorPtr cursor = storage.OpenCursor("SELECT * FROM msg", StorageParams(), 10);
+		cursor->Fetch([&](StorageResultPtr result, bool finished) {
+			EXPECT_EQ(result->rows.size(), 10u);
+			EXPECT_FALSE(finished);
+			++done;
+		});
+		waitFor(done, 2);
+		cursor->Close();
+		cursor->Fetch([&](StorageResultPtr result, bool finished) {
+			EXPECT_TRUE(result->rows.empty());
+			EXPECT_TRUE(finished);
+			++done;
+		});
+		waitFor(done, 3);
+
+		closeDb(storage);
+	}
+	removeDb();
+}
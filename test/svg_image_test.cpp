@@ -0,0 +1,213 @@
+#include "duilib/Utils/SvgImage.h"
+#include "gtest/gtest.h"
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+using namespace DuiLib;
+using Clock = std::chrono::steady_clock;
+
+//ߺɫҰ߰͸ɫͼ
+static const char kIcon[] =
+	"<svg xmlns='http://www.w3.org/2000/svg' width='32' height='24' viewBox='0 0 32 24'>"
+	"<rect x='0' y='0' width='16' height='24' fill='red'/>"
+	"<rect x='16' y='0' width='16' height='24' fill='#0000FF' fill-opacity='0.5'/>"
+	"</svg>";
+
+static image_string svgName(const char* name) {
+	std::string s(name);
+	return image_string(s.begin(), s.end());
+}
+
+//ͳƶȡreader
+static CSvgCache::Reader countingReader(std::shared_ptr<std::atomic<int>> reads, const char* text = kIcon) {
+	std::string svg(text);
+	return [reads, svg](size_t& size) -> std::unique_ptr<uint8_t[]> {
+		++*reads;
+		size = svg.size();
+		std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
+		memcpy(data.get(), svg.data(), size);
+		return data;
+	};
+}
+
+static const uint8_t* pixelAt(const CDecodedImage& image, int x, int y) {
+	return image.GetBits() + ((size_t)y * image.GetWidth() + x) * 4;
+}
+
+TEST(SvgDocument, Rasterize) {
+	auto document = CSvgDocument::Parse((const uint8_t*)kIcon, strlen(kIcon));
+	ASSERT_TRUE(document != nullptr);
+	EXPECT_EQ(32, (int)document->GetWidth());
+	EXPECT_EQ(24, (int)document->GetHeight());
+
+	std::vector<uint8_t> rgba(64 * 48 * 4);
+	ASSERT_TRUE(document->Rasterize(64, 48, rgba.data()));
+	const uint8_t* left = &rgba[(24 * 64 + 10) * 4];
+	EXPECT_EQ(255, left[0]);
+	EXPECT_EQ(0, left[2]);
+	EXPECT_EQ(255, left[3]);
+	const uint8_t* right = &rgba[(24 * 64 + 50) * 4];
+	EXPECT_EQ(255, right[2]);
+	EXPECT_NEAR(128, right[3], 1);
+
+	//ȱźУ
+	std::vector<uint8_t> tall(32 * 48 * 4);
+	ASSERT_TRUE(document->Rasterize(32, 48, tall.data()));
+	EXPECT_EQ(0, tall[(2 * 32 + 4) * 4 + 3]);
+	EXPECT_EQ(255, tall[(24 * 32 + 4) * 4 + 3]);
+}
+
+TEST(SvgDocument, Invalid) {
+	const char text[] = "not an svg";
+	EXPECT_TRUE(CSvgDocument::Parse((const uint8_t*)text, strlen(text)) == nullptr);
+	EXPECT_TRUE(CSvgDocument::Parse(NULL, 0) == nullptr);
+	//ûгߴĵ޷դ
+	const char empty[] = "<svg xmlns='http://www.w3.org/2000/svg'></svg>";
+	EXPECT_TRUE(CSvgDocument::Parse((const uint8_t*)empty, strlen(empty)) == nullptr);
+}
+
+TEST(SvgCache, IsSvg) {
+	EXPECT_TRUE(CSvgCache::IsSvg(svgName("icons/close.svg")));
+	EXPECT_TRUE(CSvgCache::IsSvg(svgName("icons/close@150.SVG")));
+	EXPECT_FALSE(CSvgCache::IsSvg(svgName("icons/close.png")));
+	EXPECT_FALSE(CSvgCache::IsSvg(svgName("svg")));
+}
+
+//ĵֻһΣÿߴֻդһ
+TEST(SvgCache, ParseOnceRasterizePerSize) {
+	CSvgCache cache;
+	auto reads = std::make_shared<std::atomic<int>>(0);
+	CSvgCache::Reader reader = countingReader(reads);
+	image_string name = svgName("icons/icon.svg");
+
+	CDecodedImage image;
+	ASSERT_TRUE(cache.Load(name, 100, reader, image));
+	EXPECT_EQ(32, image.GetWidth());
+	EXPECT_EQ(24, image.GetHeight());
+	ASSERT_TRUE(cache.Load(name, 150, reader, image));
+	EXPECT_EQ(48, image.GetWidth());
+	EXPECT_EQ(36, image.GetHeight());
+	ASSERT_TRUE(cache.Load(name, 200, reader, image));
+	EXPECT_EQ(64, image.GetWidth());
+	EXPECT_EQ(255, pixelAt(image, 10, 24)[0]);
+
+	//лդ񻯹dpi
+	CDecodedImage again;
+	ASSERT_TRUE(cache.Load(name, 150, reader, again));
+	ASSERT_TRUE(cache.Load(name, 64, 48, reader, again));
+	EXPECT_EQ(0, memcmp(image.GetBits(), again.GetBits(), 64 * 48 * 4));
+
+	TSvgCacheStats stats = cache.GetStats();
+	EXPECT_EQ(1, reads->load());
+	EXPECT_EQ(1, stats.parses);
+	EXPECT_EQ(1u, stats.documents);
+	EXPECT_EQ(3, stats.rasterizations);
+	EXPECT_EQ(2, stats.hits);
+	EXPECT_EQ(3u, stats.rasters);
+	EXPECT_EQ((size_t)(32 * 24 + 48 * 36 + 64 * 48) * 4, stats.bytes);
+
+	//еرתӰ컺
+	image.Convert(0);
+	ASSERT_TRUE(cache.Load(name, 200, reader, again));
+	EXPECT_FALSE(again.IsConverted());
+	EXPECT_EQ(255, pixelAt(again, 10, 24)[0]);
+}
+
+TEST(SvgCache, Evict) {
+	CSvgCache cache(2 * 32 * 32 * 4);
+	auto reads = std::make_shared<std::atomic<int>>(0);
+	CSvgCache::Reader reader = countingReader(reads);
+	image_string name = svgName("icon.svg");
+
+	CDecodedImage image;
+	ASSERT_TRUE(cache.Load(name, 32, 32, reader, image));
+	ASSERT_TRUE(cache.Load(name, 31, 31, reader, image));
+	//ʹõ
+	ASSERT_TRUE(cache.Load(name, 32, 32, reader, image));
+	ASSERT_TRUE(cache.Load(name, 30, 30, reader, image));
+	TSvgCacheStats stats = cache.GetStats();
+	EXPECT_EQ(1, stats.evictions);
+	EXPECT_EQ(2u, stats.rasters);
+	EXPECT_LE(stats.bytes, (size_t)2 * 32 * 32 * 4);
+
+	ASSERT_TRUE(cache.Load(name, 32, 32, reader, image));
+	EXPECT_EQ(2, cache.GetStats().hits);
+
+	//Ĳ棬ĵȻ
+	ASSERT_TRUE(cache.Load(name, 200, 200, reader, image));
+	EXPECT_EQ(200, image.GetWidth());
+	EXPECT_EQ(2u, cache.GetStats().rasters);
+	EXPECT_EQ(1, reads->load());
+
+	cache.Clear();
+	stats = cache.GetStats();
+	EXPECT_EQ(0u, stats.documents);
+	EXPECT_EQ(0u, stats.bytes);
+	ASSERT_TRUE(cache.Load(name, 32, 32, reader, image));
+	EXPECT_EQ(2, reads->load());
+}
+
+TEST(SvgCache, Failure) {
+	CSvgCache cache;
+	auto reads = std::make_shared<std::atomic<int>>(0);
+	CDecodedImage image;
+	EXPECT_FALSE(cache.Load(svgName("bad.svg"), 100, countingReader(reads, "<html></html>"), image));
+	EXPECT_FALSE(cache.Load(svgName("missing.svg"), 100, [](size_t&) { return std::unique_ptr<uint8_t[]>(); }, image));
+	EXPECT_FALSE(cache.Load(svgName("icon.svg"), 0, 10, countingReader(reads), image));
+	//ʧܵĵ棬´¶ȡ
+	EXPECT_FALSE(cache.Load(svgName("bad.svg"), 100, countingReader(reads, "<html></html>"), image));
+	EXPECT_EQ(2, reads->load());
+	EXPECT_EQ(0u, cache.GetStats().documents);
+}
+
+//ĵʱ̭δõģٴʹʱ½
+TEST(SvgCache, DocumentLimit) {
+	CSvgCache cache(0, 2);
+	auto reads = std::make_shared<std::atomic<int>>(0);
+	CSvgCache::Reader reader = countingReader(reads);
+	CDecodedImage image;
+
+	ASSERT_TRUE(cache.Load(svgName("a.svg"), 100, reader, image));
+	ASSERT_TRUE(cache.Load(svgName("b.svg"), 100, reader, image));
+	ASSERT_TRUE(cache.Load(svgName("a.svg"), 100, reader, image));
+	ASSERT_TRUE(cache.Load(svgName("c.svg"), 100, reader, image));
+	EXPECT_EQ(3, reads->load());
+	EXPECT_EQ(2u, cache.GetStats().documents);
+
+	ASSERT_TRUE(cache.Load(svgName("a.svg"), 100, reader, image));
+	EXPECT_EQ(3, reads->load());
+	ASSERT_TRUE(cache.Load(svgName("b.svg"), 100, reader, image));
+	EXPECT_EQ(4, reads->load());
+}
+
+//״դ뻺еĺʱ
+TEST(SvgCache, Benchmark) {
+	const int kIcons = 50;
+	CSvgCache cache;
+	auto reads = std::make_shared<std::atomic<int>>(0);
+	CSvgCache::Reader reader = countingReader(reads);
+	CDecodedImage image;
+
+	auto start = Clock::now();
+	for (int i = 0; i < kIcons; ++i) {
+		char name[32];
+		snprintf(name, sizeof(name), "icon%d.svg", i);
+		ASSERT_TRUE(cache.Load(svgName(name), 200, reader, image));
+	}
+	double miss_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	start = Clock::now();
+	for (int i = 0; i < kIcons; ++i) {
+		char name[32];
+		snprintf(name, sizeof(name), "icon%d.svg", i);
+		ASSERT_TRUE(cache.Load(svgName(name), 200, reader, image));
+	}
+	double hit_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	printf("%d icons 64x48: parse+rasterize %.3f ms/icon, cached %.3f ms/icon\n",
+		kIcons, miss_ms / kIcons, hit_ms / kIcons);
+	EXPECT_EQ(kIcons, cache.GetStats().hits);
+}
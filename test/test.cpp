@@ -10,8 +10,10 @@ TEST(ImageLoader, LoadImage) {
 
 	loader.Load("test.jpg", [](RefPtr<ImageData> img) {
 		int fff = 0;
-		img->Resize(100, 100);
-		img->SavePng("out.png");
+		//ؽڻйǰȸ
+		RefPtr<ImageData> thumb = img->Clone();
+		thumb->Resize(100, 100);
+		thumb->SavePng("out.png");
 		int fff2 = 0;
 		});
 
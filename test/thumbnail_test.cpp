@@ -0,0 +1,256 @@
+#include "async/image_loader.h"
+#include "async/image_scaler.h"
+#include "stbimage/stb_image.h"
+#include "stbimage/stb_image_resize.h"
+#include "stbimage/stb_image_write.h"
+#include "gtest/gtest.h"
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static void waitFor(const std::atomic<int>& value, int expect) {
+	auto deadline = Clock::now() + std::chrono::seconds(10);
+	while (value < expect && Clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+//ƣСʱƽҲиƵϸ
+static std::vector<unsigned char> makePixels(int x, int y, int comp) {
+	std::vector<unsigned char> pixels((size_t)x * y * comp);
+	for (int j = 0; j < y; ++j) {
+		for (int i = 0; i < x; ++i) {
+			unsigned char* p = &pixels[((size_t)j * x + i) * comp];
+			for (int c = 0; c < comp; ++c) {
+				double wave = 100 * sin(i * 0.05 + c) * cos(j * 0.03);
+				p[c] = (unsigned char)std::max(0.0, std::min(255.0, (i + j) * 128.0 / (x + y) + 64 + wave));
+			}
+		}
+	}
+	return pixels;
+}
+
+//صȨĸοʵ
+static std::vector<double> referenceBox(const unsigned char* src, int src_x, int src_y, int dst_x, int dst_y, int comp) {
+	std::vector<double> out((size_t)dst_x * dst_y * comp, 0);
+	double sx = (double)src_x / dst_x;
+	double sy = (double)src_y / dst_y;
+	for (int j = 0; j < dst_y; ++j) {
+		for (int i = 0; i < dst_x; ++i) {
+			for (int v = (int)(j * sy); v < src_y && v < (j + 1) * sy; ++v) {
+				double wy = std::min<double>(v + 1, (j + 1) * sy) - std::max<double>(v, j * sy);
+				for (int u = (int)(i * sx); u < src_x && u < (i + 1) * sx; ++u) {
+					double wx = std::min<double>(u + 1, (i + 1) * sx) - std::max<double>(u, i * sx);
+					for (int c = 0; c < comp; ++c)
+						out[((size_t)j * dst_x + i) * comp + c] += src[((size_t)v * src_x + u) * comp + c] * wx * wy / (sx * sy);
+				}
+			}
+		}
+	}
+	return out;
+}
+
+//ʵֽһ£븡ο1
+TEST(ImageScaler, MatchesReference) {
+	const int sizes[][4] = {
+		{ 37, 23, 10, 7 },
+		{ 640, 480, 97, 61 },
+		{ 100, 100, 100, 100 },
+		{ 33, 900, 33, 17 },
+		{ 301, 5, 2, 1 },
+	};
+	for (auto& size : sizes) {
+		for (int comp = 1; comp <= 4; ++comp) {
+			std::vector<unsigned char> src = makePixels(size[0], size[1], comp);
+			std::vector<double> ref = referenceBox(src.data(), size[0], size[1], size[2], size[3], comp);
+
+			std::vector<unsigned char> scalar(ref.size());
+			ASSERT_TRUE(ImageScaler::Scale(src.data(), size[0], size[1], 0, scalar.data(), size[2], size[3], 0, comp, ImageScaler::kScalar));
+			for (size_t k = 0; k < ref.size(); ++k)
+				ASSERT_LE(fabs(scalar[k] - ref[k]), 1.0) << size[0] << "x" << size[1] << " comp " << comp << " at " << k;
+
+			for (int kernel = ImageScaler::kSSE2; kernel <= ImageScaler::Best(); ++kernel) {
+				std::vector<unsigned char> simd(ref.size());
+				ASSERT_TRUE(ImageScaler::Scale(src.data(), size[0], size[1], 0, simd.data(), size[2], size[3], 0, comp, (ImageScaler::Kernel)kernel));
+				EXPECT_EQ(simd, scalar) << "kernel " << kernel << " comp " << comp;
+			}
+		}
+	}
+}
+
+//дߵĻʱֻĶÿеǰx*compֽ
+TEST(ImageScaler, CallerBuffer) {
+	std::vector<unsigned char> src = makePixels(64, 48, 4);
+	const int stride = 20 * 4 + 12;
+	std::vector<unsigned char> dst(stride * 15, 0xcd);
+	ASSERT_TRUE(ImageScaler::Scale(src.data(), 64, 48, 0, dst.data(), 20, 15, stride, 4));
+	for (int j = 0; j < 15; ++j) {
+		for (int k = 20 * 4; k < stride; ++k)
+			EXPECT_EQ(dst[j * stride + k], 0xcd);
+	}
+
+	//ɫź󱣳ԭɫ
+	std::vector<unsigned char> solid(64 * 48 * 4, 77);
+	ASSERT_TRUE(ImageScaler::Scale(solid.data(), 64, 48, 0, dst.data(), 19, 13, 0, 4));
+	for (int k = 0; k < 19 * 13 * 4; ++k)
+		ASSERT_EQ(dst[k], 77);
+
+	EXPECT_FALSE(ImageScaler::Scale(src.data(), 64, 48, 0, dst.data(), 0, 15, 0, 4));
+}
+
+//DCTСĳߴȡݽӽͼƽ
+TEST(Thumbnail, ScaledJpegDecode) {
+	const int kX = 1001;
+	const int kY = 757;
+	std::vector<unsigned char> pixels = makePixels(kX, kY, 3);
+	ASSERT_TRUE(stbi_write_jpg("thumbnail_scaled.jpg", kX, kY, 3, pixels.data(), 90) != 0);
+
+	int fx = 0, fy = 0, fc = 0;
+	unsigned char* full = stbi_load("thumbnail_scaled.jpg", &fx, &fy, &fc, 3);
+	ASSERT_TRUE(full != nullptr);
+	for (int denom = 1; denom <= 8; denom *= 2) {
+		int x = 0, y = 0, n = 0;
+		unsigned char* scaled = stbi_load_scaled("thumbnail_scaled.jpg", &x, &y, &n, 3, denom);
+		ASSERT_TRUE(scaled != nullptr);
+		EXPECT_EQ(x, (kX + denom - 1) / denom);
+		EXPECT_EQ(y, (kY + denom - 1) / denom);
+		EXPECT_EQ(n, 3);
+
+		double error = 0;
+		int count = 0;
+		for (int j = 0; j < kY / denom; ++j) {
+			for (int i = 0; i < kX / denom; ++i) {
+				for (int c = 0; c < 3; ++c) {
+					int sum = 0;
+					for (int v = 0; v < denom; ++v)
+						for (int u = 0; u < denom; ++u)
+							sum += full[((j * denom + v) * fx + i * denom + u) * 3 + c];
+					error += fabs((double)sum / (denom * denom) - scaled[(j * x + i) * 3 + c]);
+					++count;
+				}
+			}
+		}
+		printf("1/%d mean error %.3f\n", denom, error / count);
+		EXPECT_LT(error / count, denom == 1 ? 0.01 : denom) << "1/" << denom;
+		stbi_image_free(scaled);
+	}
+	stbi_image_free(full);
+
+	//ɫȳjpeg֧ͬ
+	ASSERT_TRUE(stbi_write_jpg("thumbnail_444.jpg", 99, 61, 3, pixels.data(), 95) != 0);
+	int x = 0, y = 0, n = 0;
+	unsigned char* rgba = stbi_load_scaled("thumbnail_444.jpg", &x, &y, &n, 4, 4);
+	ASSERT_TRUE(rgba != nullptr);
+	EXPECT_EQ(x, 25);
+	EXPECT_EQ(y, 16);
+	EXPECT_EQ(rgba[3], 255);
+	stbi_image_free(rgba);
+	remove("thumbnail_scaled.jpg");
+	remove("thumbnail_444.jpg");
+}
+
+//ֿ߱С֮ڣСͼŴ첽ؽImageCache
+TEST(Thumbnail, Load) {
+	std::vector<unsigned char> pixels = makePixels(800, 600, 3);
+	ASSERT_TRUE(stbi_write_jpg("thumbnail_a.jpg", 800, 600, 3, pixels.data(), 90) != 0);
+	ASSERT_TRUE(stbi_write_png("thumbnail_b.png", 600, 800, 3, pixels.data(), 0) != 0);
+
+	auto jpg = MakeRefCounted<ImageData>();
+	ASSERT_TRUE(jpg->LoadThumbnail("thumbnail_a.jpg", 160, 160, 4));
+	EXPECT_EQ(jpg->x(), 160);
+	EXPECT_EQ(jpg->y(), 120);
+	EXPECT_EQ(jpg->comp(), 4);
+
+	auto png = MakeRefCounted<ImageData>();
+	ASSERT_TRUE(png->LoadThumbnail("thumbnail_b.png", 160, 100));
+	EXPECT_EQ(png->x(), 75);
+	EXPECT_EQ(png->y(), 100);
+	EXPECT_EQ(png->comp(), 3);
+
+	auto small = MakeRefCounted<ImageData>();
+	ASSERT_TRUE(small->LoadThumbnail("thumbnail_a.jpg", 1000, 1000));
+	EXPECT_EQ(small->x(), 800);
+	EXPECT_EQ(small->y(), 600);
+	EXPECT_FALSE(small->LoadThumbnail("thumbnail_missing.jpg", 100, 100));
+
+	ImageCache::Instance()->Clear();
+	ImageLoader loader;
+	std::atomic<int> done(0);
+	RefPtr<ImageData> thumbnail;
+	RefPtr<ImageData> original;
+	loader.LoadThumbnail("thumbnail_a.jpg", 64, 64, 4, [&](RefPtr<ImageData> image) {
+		thumbnail = image;
+		++done;
+	});
+	loader.Load("thumbnail_a.jpg", 64, 64, 4, [&](RefPtr<ImageData> image) {
+		original = image;
+		++done;
+	});
+	waitFor(done, 2);
+	ASSERT_TRUE(thumbnail && original);
+	EXPECT_EQ(thumbnail->x(), 64);
+	EXPECT_EQ(thumbnail->y(), 48);
+	EXPECT_EQ(original->x(), 64);
+	EXPECT_EQ(original->y(), 64);
+
+	loader.LoadThumbnail("thumbnail_a.jpg", 64, 64, 4, [&](RefPtr<ImageData> image) {
+		EXPECT_EQ(image.get(), thumbnail.get());
+		++done;
+	});
+	waitFor(done, 3);
+	EXPECT_EQ(ImageCache::Instance()->GetStats().entries, 2);
+	ImageCache::Instance()->Clear();
+	remove("thumbnail_a.jpg");
+	remove("thumbnail_b.png");
+}
+
+//ͼͼͼ+stbir Ա DCTС+ƽ
+TEST(Thumbnail, Benchmark) {
+	const int kX = 4000;
+	const int kY = 3000;
+	const int kRuns = 3;
+	std::vector<unsigned char> pixels = makePixels(kX, kY, 3);
+	ASSERT_TRUE(stbi_write_jpg("thumbnail_bench.jpg", kX, kY, 3, pixels.data(), 90) != 0);
+	ASSERT_TRUE(stbi_write_png("thumbnail_bench.png", kX, kY, 3, pixels.data(), 0) != 0);
+
+	for (const char* file : { "thumbnail_bench.jpg", "thumbnail_bench.png" }) {
+		double full = 0;
+		double thumbnail = 0;
+		for (int i = 0; i < kRuns; ++i) {
+			auto start = Clock::now();
+			auto image = MakeRefCounted<ImageData>();
+			ASSERT_TRUE(image->Load(file, 4));
+			image->Resize(256, 192);
+			full += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+			start = Clock::now();
+			auto small = MakeRefCounted<ImageData>();
+			ASSERT_TRUE(small->LoadThumbnail(file, 256, 256, 4));
+			thumbnail += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			EXPECT_EQ(small->x(), 256);
+			EXPECT_EQ(small->y(), 192);
+		}
+		printf("%-20s load+resize %8.2f ms, thumbnail %8.2f ms\n", file, full / kRuns, thumbnail / kRuns);
+	}
+
+	//Ƚźˣ4000x3000 RGBAС256x192
+	std::vector<unsigned char> rgba = makePixels(kX, kY, 4);
+	std::vector<unsigned char> out(256 * 192 * 4);
+	auto start = Clock::now();
+	stbir_resize_uint8(rgba.data(), kX, kY, 0, out.data(), 256, 192, 0, 4);
+	double stbir = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	printf("%-20s %8.2f ms\n", "stbir", stbir);
+	const char* names[] = { "box scalar", "box sse2", "box avx2" };
+	for (int kernel = ImageScaler::kScalar; kernel <= ImageScaler::Best(); ++kernel) {
+		start = Clock::now();
+		ImageScaler::Scale(rgba.data(), kX, kY, 0, out.data(), 256, 192, 0, 4, (ImageScaler::Kernel)kernel);
+		printf("%-20s %8.2f ms\n", names[kernel], std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+	}
+	remove("thumbnail_bench.jpg");
+	remove("thumbnail_bench.png");
+}
@@ -0,0 +1,143 @@
+#include "async/timer_wheel.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+TEST(TimerWheel, FireOnce) {
+	TimerWheel wheel(10, 0);
+	int fired = 0;
+	wheel.Schedule(1, 0, 100, 0, [&]() { ++fired; });
+
+	EXPECT_EQ(wheel.Advance(90), 0u);
+	EXPECT_EQ(fired, 0);
+	EXPECT_EQ(wheel.Advance(100), 1u);
+	EXPECT_EQ(fired, 1);
+	EXPECT_TRUE(wheel.empty());
+	EXPECT_EQ(wheel.NextTimeout(100), -1);
+}
+
+TEST(TimerWheel, Repeat) {
+	TimerWheel wheel(10, 0);
+	int fired = 0;
+	wheel.Schedule(1, 0, 50, 50, [&]() { ++fired; });
+
+	for (uint64_t now = 0; now <= 1000; now += 10) {
+		wheel.Advance(now);
+	}
+	EXPECT_EQ(fired, 20);
+	EXPECT_TRUE(wheel.Has(1));
+	EXPECT_TRUE(wheel.Cancel(1));
+	EXPECT_FALSE(wheel.Cancel(1));
+}
+
+//ͬһtickڵڵĶʱһAdvanceִ
+TEST(TimerWheel, Coalesce) {
+	TimerWheel wheel(10, 0);
+	int fired = 0;
+	for (uint32_t i = 0; i < 100; ++i) {
+		wheel.Schedule(i + 1, 0, 41 + (i % 9), 0, [&]() { ++fired; });
+	}
+	EXPECT_EQ(wheel.NextTimeout(0), 50);
+	EXPECT_EQ(wheel.Advance(50), 100u);
+	EXPECT_EQ(fired, 100);
+}
+
+//Խ㼶Ķʱʱ˳򴥷
+TEST(TimerWheel, Cascade) {
+	TimerWheel wheel(1, 0);
+	std::vector<uint32_t> delays = { 3, 255, 256, 257, 5000, 16384, 16385, 70000, 1100000, 80000000 };
+	std::vector<uint64_t> fired_at(delays.size(), 0);
+
+	for (size_t i = 0; i < delays.size(); ++i) {
+		wheel.Schedule((uint32_t)i + 1, 0, delays[i], 0, [&, i]() { fired_at[i] = 1; });
+	}
+
+	uint64_t now = 0;
+	while (!wheel.empty()) {
+		int64_t timeout = wheel.NextTimeout(now);
+		ASSERT_GE(timeout, 0);
+		now += timeout;
+		std::vector<uint64_t> before = fired_at;
+		wheel.Advance(now);
+		for (size_t i = 0; i < delays.size(); ++i) {
+			if (!before[i] && fired_at[i]) {
+				fired_at[i] = now;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < delays.size(); ++i) {
+		EXPECT_EQ(fired_at[i], delays[i]) << "delay " << delays[i];
+	}
+}
+
+//мӶʱµʱ㣬Ҫtick׷
+TEST(TimerWheel, ScheduleAfterIdle) {
+	TimerWheel wheel(10, 0);
+	int fired = 0;
+	wheel.Schedule(1, 0, 100, 0, [&]() { ++fired; });
+	EXPECT_EQ(wheel.Advance(100), 1u);
+
+	const uint64_t now = 8ull * 24 * 3600 * 1000 + 5;
+	wheel.Schedule(2, now, 100, 0, [&]() { ++fired; });
+	EXPECT_EQ(wheel.NextTimeout(now), 105);
+	EXPECT_EQ(wheel.Advance(now + 90), 0u);
+	EXPECT_EQ(wheel.Advance(now + 105), 1u);
+	EXPECT_EQ(fired, 2);
+}
+
+TEST(TimerWheel, CancelInCallback) {
+	TimerWheel wheel(10, 0);
+	int fired = 0;
+	wheel.Schedule(1, 0, 20, 0, [&]() { ++fired; wheel.Cancel(2); });
+	wheel.Schedule(2, 0, 20, 0, [&]() { ++fired; });
+	wheel.Schedule(3, 0, 20, 20, [&]() { ++fired; wheel.Cancel(3); });
+
+	wheel.Advance(1000);
+	EXPECT_EQ(fired, 2);
+	EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, Reschedule) {
+	TimerWheel wheel(10, 0);
+	int fired = 0;
+	wheel.Schedule(1, 0, 100, 0, [&]() { fired = 1; });
+	wheel.Schedule(1, 50, 100, 0, [&]() { fired = 2; });
+	EXPECT_EQ(wheel.size(), 1u);
+
+	wheel.Advance(100);
+	EXPECT_EQ(fired, 0);
+	wheel.Advance(150);
+	EXPECT_EQ(fired, 2);
+}
+
+TEST(TimerWheel, ManyTimers) {
+	TimerWheel wheel(10, 0);
+	const uint32_t kCount = 100000;
+	uint32_t fired = 0;
+	for (uint32_t i = 0; i < kCount; ++i) {
+		wheel.Schedule(i + 1, 0, (i * 7919) % 600000, 0, [&]() { ++fired; });
+	}
+	for (uint32_t i = 0; i < kCount; i += 2) {
+		wheel.Cancel(i + 1);
+	}
+	wheel.Advance(600000);
+	EXPECT_EQ(fired, kCount / 2);
+}
+
+TEST(TimerWheel, NextTimeoutAcrossLap) {
+	//ӷʱ俪ʼλÿײһȦı߽
+	TimerWheel wheel(10, 2000);
+	wheel.Schedule(1, 2000, 1000, 0, []() {});
+	EXPECT_EQ(wheel.NextTimeout(2000), 1000);
+
+	wheel.Advance(2500);
+	EXPECT_EQ(wheel.NextTimeout(2500), 500);
+	EXPECT_EQ(wheel.Advance(3000), 1u);
+	EXPECT_EQ(wheel.NextTimeout(3000), -1);
+
+	for (uint64_t now = 3000; now < 10000; now += 370) {
+		wheel.Advance(now);
+		wheel.Schedule(2, now, 1500, 0, []() {});
+		EXPECT_EQ(wheel.NextTimeout(now), 1500);
+	}
+}
@@ -0,0 +1,127 @@
+#include "async/worker_pool.h"
+#include "stbimage/stb_image.h"
+#include "stbimage/stb_image_write.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <vector>
+
+static void writeToVector(void* context, void* data, int size) {
+	auto buffer = (std::vector<uint8_t>*)context;
+	buffer->insert(buffer->end(), (uint8_t*)data, (uint8_t*)data + size);
+}
+
+//һڽԵpng
+static std::vector<uint8_t> makePng(int w, int h) {
+	std::vector<uint8_t> pixel(w * h * 4);
+	for (int y = 0; y < h; ++y) {
+		for (int x = 0; x < w; ++x) {
+			uint8_t* p = &pixel[(y * w + x) * 4];
+			p[0] = (uint8_t)(x * 255 / w);
+			p[1] = (uint8_t)(y * 255 / h);
+			p[2] = (uint8_t)((x ^ y) & 0xff);
+			p[3] = 0xff;
+		}
+	}
+
+	std::vector<uint8_t> png;
+	stbi_write_png_to_func(writeToVector, &png, w, h, 4, pixel.data(), w * 4);
+	return png;
+}
+
+TEST(WorkerPool, RunAllTasks) {
+	std::atomic<int> count(0);
+	{
+		WorkerPool pool(4);
+		std::mutex lock;
+		std::condition_variable cv;
+		for (int i = 0; i < 1000; ++i) {
+			pool.PostTask([&]() {
+				if (++count == 1000) {
+					std::lock_guard<std::mutex> locker(lock);
+					cv.notify_one();
+				}
+			});
+		}
+		std::unique_lock<std::mutex> locker(lock);
+		cv.wait_for(locker, std::chrono::seconds(10), [&]() { return count == 1000; });
+	}
+	EXPECT_EQ(count, 1000);
+}
+
+TEST(WorkerPool, SequencedOrder) {
+	WorkerPool pool(4);
+	SequencedTaskQueue queue(&pool);
+
+	std::vector<int> order;
+	std::atomic<int> running(0);
+	std::atomic<bool> overlap(false);
+	std::atomic<bool> done(false);
+	std::mutex lock;
+	std::condition_variable cv;
+
+	for (int i = 0; i < 500; ++i) {
+		queue.PostTask([&, i]() {
+			if (++running > 1)
+				overlap = true;
+			order.push_back(i);
+			--running;
+			if (i == 499) {
+				std::lock_guard<std::mutex> locker(lock);
+				done = true;
+				cv.notify_one();
+			}
+		});
+	}
+
+	std::unique_lock<std::mutex> locker(lock);
+	cv.wait_for(locker, std::chrono::seconds(10), [&]() { return done.load(); });
+
+	EXPECT_FALSE(overlap);
+	ASSERT_EQ(order.size(), 500u);
+	for (int i = 0; i < 500; ++i) {
+		EXPECT_EQ(order[i], i);
+	}
+}
+
+//200ͼͬ߳µ
+TEST(WorkerPool, DecodeThroughput) {
+	const int kImageCount = 200;
+	std::vector<uint8_t> png = makePng(512, 512);
+	ASSERT_FALSE(png.empty());
+
+	size_t max_workers = std::thread::hardware_concurrency();
+	if (max_workers == 0)
+		max_workers = 2;
+
+	for (size_t workers = 1; workers <= max_workers; workers *= 2) {
+		std::atomic<int> decoded(0);
+		std::mutex lock;
+		std::condition_variable cv;
+
+		auto start = std::chrono::steady_clock::now();
+		{
+			WorkerPool pool(workers);
+			for (int i = 0; i < kImageCount; ++i) {
+				pool.PostTask([&]() {
+					int x, y, comp;
+					uint8_t* pixel = stbi_load_from_memory(png.data(), (int)png.size(), &x, &y, &comp, 4);
+					if (pixel) {
+						stbi_image_free(pixel);
+					}
+					if (++decoded == kImageCount) {
+						std::lock_guard<std::mutex> locker(lock);
+						cv.notify_one();
+					}
+				});
+			}
+			std::unique_lock<std::mutex> locker(lock);
+			cv.wait(locker, [&]() { return decoded == kImageCount; });
+		}
+		auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start).count();
+
+		printf("workers %2zu: %d images in %lld ms, %.1f images/s\n", workers, kImageCount,
+			(long long)ms, ms > 0 ? kImageCount * 1000.0 / ms : 0.0);
+		EXPECT_EQ(decoded, kImageCount);
+	}
+}
@@ -1,7 +1,10 @@
 #include "image_loader.h"
+#include "image_scaler.h"
 #include "stbimage/stb_image.h"
 #include "stbimage/stb_image_resize.h"
 #include "stbimage/stb_image_write.h"
+#include <string.h>
+#include <algorithm>
 
 ImageData::ImageData() 
 	:x_(0),y_(0),comp_(0),pixel_(nullptr)
@@ -12,14 +15,28 @@ ImageData::~ImageData() {
 	stbi_image_free(pixel_);
 }
 
-bool ImageData::Load(const char* file) {
+bool ImageData::Load(const char* file, int comp) {
 	if (pixel_) {
 		stbi_image_free(pixel_);
 	}
-	pixel_ = stbi_load(file, &x_, &y_, &comp_, 0);
+	pixel_ = stbi_load(file, &x_, &y_, &comp_, comp);
+	if (pixel_ && comp != 0)
+		comp_ = comp;
 	return pixel_ != nullptr;
 }
 
+RefPtr<ImageData> ImageData::Clone() const {
+	auto img = MakeRefCounted<ImageData>();
+	if (pixel_) {
+		img->pixel_ = (uint8_t*)stbi_image_malloc(bytes());
+		memcpy(img->pixel_, pixel_, bytes());
+		img->x_ = x_;
+		img->y_ = y_;
+		img->comp_ = comp_;
+	}
+	return img;
+}
+
 bool ImageData::SaveJpg(const char* file) {
 	if (!pixel_)
 		return false;
@@ -33,6 +50,64 @@ bool ImageData::SavePng(const char* file) {
 	return stbi_write_png(file, x_, y_, comp_, pixel_, 0);
 }
 
+//ֿ߱Сmax_x*max_y֮
+static void FitSize(int x, int y, int max_x, int max_y, int* fit_x, int* fit_y) {
+	if (x <= max_x && y <= max_y) {
+		*fit_x = x;
+		*fit_y = y;
+	} else if ((int64_t)x * max_y > (int64_t)y * max_x) {
+		*fit_x = max_x;
+		*fit_y = (int)std::max<int64_t>(1, ((int64_t)y * max_x + x / 2) / x);
+	} else {
+		*fit_y = max_y;
+		*fit_x = (int)std::max<int64_t>(1, ((int64_t)x * max_y + y / 2) / y);
+	}
+}
+
+bool ImageData::LoadThumbnail(const char* file, int max_x, int max_y, int comp) {
+	int x = 0, y = 0, n = 0;
+	if (max_x <= 0 || max_y <= 0 || !stbi_info(file, &x, &y, &n))
+		return false;
+
+	int fit_x = 0, fit_y = 0;
+	FitSize(x, y, max_x, max_y, &fit_x, &fit_y);
+
+	//ȡԲСĿߴСjpegԸò
+	int denom = 8;
+	while (denom > 1 && ((x + denom - 1) / denom < fit_x || (y + denom - 1) / denom < fit_y))
+		denom /= 2;
+
+	uint8_t* pixel = stbi_load_scaled(file, &x, &y, &n, comp, denom);
+	if (!pixel)
+		return false;
+	if (comp != 0)
+		n = comp;
+
+	if (x != fit_x || y != fit_y) {
+		uint8_t* scaled = (uint8_t*)stbi_image_malloc((size_t)fit_x * fit_y * n);
+		if (!ImageScaler::Scale(pixel, x, y, 0, scaled, fit_x, fit_y, 0, n)) {
+			stbi_image_free(scaled);
+			stbi_image_free(pixel);
+			return false;
+		}
+		stbi_image_free(pixel);
+		pixel = scaled;
+	}
+
+	stbi_image_free(pixel_);
+	pixel_ = pixel;
+	x_ = fit_x;
+	y_ = fit_y;
+	comp_ = n;
+	return true;
+}
+
+bool ImageData::ScaleTo(uint8_t* dst, int x, int y, int stride) const {
+	if (!pixel_)
+		return false;
+	return ImageScaler::Scale(pixel_, x_, y_, 0, dst, x, y, stride, comp_);
+}
+
 void ImageData::Resize(int x, int y) {
 	if (!pixel_)
 		return;
@@ -48,6 +123,121 @@ void ImageData::Resize(int x, int y) {
 	}
 }
 
+bool ImageCache::Key::operator<(const Key& other) const {
+	if (x != other.x)
+		return x < other.x;
+	if (y != other.y)
+		return y < other.y;
+	if (comp != other.comp)
+		return comp < other.comp;
+	if (thumbnail != other.thumbnail)
+		return thumbnail < other.thumbnail;
+	return path < other.path;
+}
+
+ImageCache* ImageCache::Instance() {
+	static ImageCache cache;
+	return &cache;
+}
+
+ImageCache::ImageCache()
+	:capacity_(64 * 1024 * 1024)
+{
+	memset(&stats_, 0, sizeof(stats_));
+}
+
+void ImageCache::SetCapacity(size_t bytes) {
+	std::lock_guard<std::mutex> locker(lock_);
+	capacity_ = bytes;
+	Evict();
+}
+
+size_t ImageCache::GetCapacity() {
+	std::lock_guard<std::mutex> locker(lock_);
+	return capacity_;
+}
+
+RefPtr<ImageData> ImageCache::Find(const std::string& path, int x, int y, int comp) {
+	std::lock_guard<std::mutex> locker(lock_);
+	auto found = index_.find(Key{ path, x, y, comp, false });
+	if (found == index_.end())
+		return nullptr;
+	entries_.splice(entries_.begin(), entries_, found->second);
+	return found->second->image;
+}
+
+void ImageCache::Clear() {
+	std::lock_guard<std::mutex> locker(lock_);
+	entries_.clear();
+	index_.clear();
+	stats_.bytes = 0;
+}
+
+ImageCacheStats ImageCache::GetStats() {
+	std::lock_guard<std::mutex> locker(lock_);
+	ImageCacheStats stats = stats_;
+	stats.entries = (int)entries_.size();
+	return stats;
+}
+
+bool ImageCache::Request(const Key& key, ImageCallback callback, RefPtr<ImageData>* image) {
+	std::lock_guard<std::mutex> locker(lock_);
+
+	auto found = index_.find(key);
+	if (found != index_.end()) {
+		++stats_.hits;
+		entries_.splice(entries_.begin(), entries_, found->second);
+		*image = found->second->image;
+		return false;
+	}
+
+	auto decoding = decoding_.find(key);
+	if (decoding != decoding_.end()) {
+		++stats_.coalesced;
+		decoding->second.push_back(callback);
+		return false;
+	}
+
+	++stats_.misses;
+	decoding_[key].push_back(callback);
+	return true;
+}
+
+void ImageCache::Complete(const Key& key, RefPtr<ImageData> image) {
+	std::vector<ImageCallback> callbacks;
+	{
+		std::lock_guard<std::mutex> locker(lock_);
+
+		//ʧܵĲ棬´¼
+		if (image && image->bytes() <= capacity_ && !index_.count(key)) {
+			entries_.push_front(Entry{ key, image });
+			index_[key] = entries_.begin();
+			stats_.bytes += image->bytes();
+			Evict();
+		}
+
+		auto decoding = decoding_.find(key);
+		if (decoding != decoding_.end()) {
+			callbacks.swap(decoding->second);
+			decoding_.erase(decoding);
+		}
+	}
+
+	for (auto& callback : callbacks) {
+		callback(image);
+	}
+}
+
+void ImageCache::Evict() {
+	while (stats_.bytes > (int64_t)capacity_ && !entries_.empty()) {
+		Entry& last = entries_.back();
+		stats_.bytes -= last.image->bytes();
+		++stats_.evictions;
+		index_.erase(last.key);
+		entries_.pop_back();
+	}
+}
+
 ImageLoader::ImageLoader() 
 	:thread_mgr_(ThreadManager::Instance())
 {
@@ -56,18 +246,80 @@ ImageLoader::ImageLoader()
 ImageLoader::~ImageLoader() {
 }
 
-void ImageLoader::Load(const std::string& path,
-	std::function<void(RefPtr<ImageData>)> finish) {
+static bool IsUrl(const std::string& path) {
+	return path.compare(0, 7, "http://") == 0 || path.compare(0, 8, "https://") == 0;
+}
 
-	WeakPtr<ImageLoader> ptr = weak_ptr();
-	std::string path_(path);
-	thread_mgr_->PostTask(ThreadManager::kImage, [path_,ptr,finish]() {
-		auto img_data = MakeRefCounted<ImageData>();
-		bool rslt = img_data->Load(path_.c_str());
+ImageFetcher ImageLoader::fetcher_;
+std::mutex ImageLoader::fetcher_lock_;
 
+void ImageLoader::SetFetcher(ImageFetcher fetcher) {
+	std::lock_guard<std::mutex> locker(fetcher_lock_);
+	fetcher_ = std::move(fetcher);
+}
+
+void ImageLoader::Load(const std::string& path, ImageCallback finish) {
+	Load(path, 0, 0, 0, finish);
+}
+
+void ImageLoader::Load(const std::string& path, int x, int y, int comp, ImageCallback finish) {
+	Request(ImageCache::Key{ path, x, y, comp, false }, finish);
+}
+
+void ImageLoader::LoadThumbnail(const std::string& path, int max_x, int max_y, int comp, ImageCallback finish) {
+	Request(ImageCache::Key{ path, max_x, max_y, comp, true }, finish);
+}
+
+void ImageLoader::Request(const ImageCache::Key& key, ImageCallback finish) {
+	WeakPtr<ImageLoader> ptr = weak_ptr();
+	ImageCallback done = [ptr, finish](RefPtr<ImageData> img_data) {
 		auto pThis = ptr.Lock();
-		if(pThis)
-			finish(rslt?img_data:nullptr);
+		if (pThis)
+			finish(img_data);
 		ptr.Unlock();
+	};
+
+	RefPtr<ImageData> cached;
+	if (!ImageCache::Instance()->Request(key, done, &cached)) {
+		//ʱͬͼƬ̻߳صȴеɽʱص
+		if (cached) {
+			thread_mgr_->PostTask(ThreadManager::kImage, [done, cached]() {
+				done(cached);
+			});
+		}
+		return;
+	}
+
+	const std::string& path = key.path;
+	ImageFetcher fetcher;
+	if (IsUrl(path)) {
+		std::lock_guard<std::mutex> locker(fetcher_lock_);
+		fetcher = fetcher_;
+	}
+	if (fetcher) {
+		//ͼƬfetcherأͼƬ߳
+		ThreadManager* thread_mgr = thread_mgr_;
+		fetcher(path, [thread_mgr, key](const std::string& file) {
+			Decode(thread_mgr, key, file);
+		});
+		return;
+	}
+
+	Decode(thread_mgr_, key, path);
+}
+
+void ImageLoader::Decode(ThreadManager* thread_mgr, const ImageCache::Key& key, const std::string& file) {
+	thread_mgr->PostTask(ThreadManager::kImage, [key, file]() {
+		auto img_data = MakeRefCounted<ImageData>();
+		bool rslt = false;
+		if (key.thumbnail) {
+			rslt = img_data->LoadThumbnail(file.c_str(), key.x, key.y, key.comp);
+		} else {
+			rslt = img_data->Load(file.c_str(), key.comp);
+			if (rslt && key.x > 0 && key.y > 0 && (key.x != img_data->x() || key.y != img_data->y()))
+				img_data->Resize(key.x, key.y);
+		}
+
+		ImageCache::Instance()->Complete(key, rslt ? img_data : nullptr);
 	});
 }
@@ -2,7 +2,11 @@
 #include "thread.h"
 #include "weak_ptr.h"
 #include "ref_counted.h"
+#include <list>
+#include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 //ͼƬ
 class ImageData:public RefCounted {
@@ -10,15 +14,25 @@ public:
 	ImageData();
 	~ImageData();
 
-	bool Load(const char* file);
+	//compΪ0ʱļͨ
+	bool Load(const char* file, int comp = 0);
+
+	//߱Сmax_x*max_y֮ڣŴjpegֱDCT1/21/41/8뵽
+	//СĿĳߴ磬ٰƽţͼС
+	bool LoadThumbnail(const char* file, int max_x, int max_y, int comp = 0);
 
 	int x() { return x_; }
 	int y() { return y_; }
 	int comp() { return comp_; }
 	uint8_t* pixel() { return pixel_; }
+	size_t bytes() const { return (size_t)x_ * y_ * comp_; }
 
 	void Resize(int x, int y);
 
+	//ŵṩĻstrideΪ0ʱ
+	bool ScaleTo(uint8_t* dst, int x, int y, int stride) const;
+	RefPtr<ImageData> Clone() const;
+
 	bool SaveJpg(const char* file);
 	bool SavePng(const char* file);
 private:
@@ -28,18 +42,91 @@ private:
 	uint8_t* pixel_;
 };
 
+using ImageCallback = std::function<void(RefPtr<ImageData>)>;
+
+//http/httpsַΪļɺļ·صʧʱΪգ̻߳ص
+using ImageFetcher = std::function<void(const std::string& url, std::function<void(const std::string& file)> done)>;
+
+struct ImageCacheStats {
+	int64_t hits;		//ֱʹѽͼƬ
+	int64_t misses;		//Ҫ
+	int64_t coalesced;	//ȴͬһͼƬڽеĽ
+	int64_t evictions;
+	int64_t bytes;		//ͼƬֽ
+	int entries;
+};
+
+//ͼƬĻ棬·Ŀߴֽͨʱ̭δõ
+//ͬһͼƬĲֻһΡͼƬ޸ǰClone()̰߳ȫ
+class ImageCache {
+public:
+	static ImageCache* Instance();
+
+	void SetCapacity(size_t bytes);
+	size_t GetCapacity();
+
+	RefPtr<ImageData> Find(const std::string& path, int x, int y, int comp);
+	void Clear();
+	ImageCacheStats GetStats();
+
+private:
+	friend class ImageLoader;
+
+	struct Key {
+		std::string path;
+		int x;
+		int y;
+		int comp;
+		bool thumbnail;	//xyΪͼߴ
+
+		bool operator<(const Key& other) const;
+	};
+
+	struct Entry {
+		Key key;
+		RefPtr<ImageData> image;
+	};
+
+	ImageCache();
+
+	//trueʱɵ߽룬ɺCompleteʱimage
+	bool Request(const Key& key, ImageCallback callback, RefPtr<ImageData>* image);
+	void Complete(const Key& key, RefPtr<ImageData> image);
+	void Evict();
+
+	std::list<Entry> entries_;	//ʹõǰ
+	std::map<Key, std::list<Entry>::iterator> index_;
+	std::map<Key, std::vector<ImageCallback>> decoding_;
+	size_t capacity_;
+	ImageCacheStats stats_;
+	std::mutex lock_;
+};
+
 //ͼƬImageLoaderͷ,finishᱻ
 class ImageLoader:public WeakObject<ImageLoader> {
 public:
 	ImageLoader();
 	~ImageLoader();
 
-	//첽ͼƬ
-	void Load(const std::string& path, 
-		std::function<void(RefPtr<ImageData>)> finish);
+	//첽ͼƬfetcherʱhttp/httpsַfetcher
+	void Load(const std::string& path, ImageCallback finish);
+
+	//ͨ벢ŵx*yΪ0ʱԭֵImageCache
+	void Load(const std::string& path, int x, int y, int comp, ImageCallback finish);
+
+	//첽ͼImageData::LoadThumbnail
+	void LoadThumbnail(const std::string& path, int max_x, int max_y, int comp, ImageCallback finish);
+
+	//ӦòͼƬطʽ(繲Դ)Ϊʱ֧ͼƬ
+	static void SetFetcher(ImageFetcher fetcher);
 
 private:
+	void Request(const ImageCache::Key& key, ImageCallback finish);
+	static void Decode(ThreadManager* thread_mgr, const ImageCache::Key& key, const std::string& file);
+
 	ThreadManager* thread_mgr_;
+	static ImageFetcher fetcher_;
+	static std::mutex fetcher_lock_;
 };
 
 
@@ -0,0 +1,290 @@
+#include "image_scaler.h"
+#include "stbimage/stb_image_resize.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define IMAGE_SCALER_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+//ÿصȨ֮Ϊ1<<kWeightBitsˮƽ7λСΪint16255*128
+const int kWeightBits = 14;
+const int kRowShift = 7;
+const int kStoreShift = 2 * kWeightBits - kRowShift;
+
+//һÿظǵԴؼԵȨ
+struct Taps {
+	std::vector<int> start;
+	std::vector<int> count;
+	std::vector<int> offset;
+	std::vector<int16_t> weights;
+};
+
+//iԴ[i*src/dst, (i+1)*src/dst)ȨΪÿԴصص
+void BuildTaps(int src, int dst, Taps* taps) {
+	taps->start.resize(dst);
+	taps->count.resize(dst);
+	taps->offset.resize(dst);
+	taps->weights.clear();
+	for (int i = 0; i < dst; ++i) {
+		int64_t begin = (int64_t)i * src;
+		int64_t end = begin + src;
+		int first = (int)(begin / dst);
+		int last = (int)((end - 1) / dst);
+		int offset = (int)taps->weights.size();
+		int sum = 0;
+		int biggest = offset;
+		for (int p = first; p <= last; ++p) {
+			int64_t overlap = std::min(end, (int64_t)(p + 1) * dst) - std::max(begin, (int64_t)p * dst);
+			int weight = (int)(((overlap << kWeightBits) + src / 2) / src);
+			taps->weights.push_back((int16_t)weight);
+			sum += weight;
+			if (weight > taps->weights[biggest])
+				biggest = (int)taps->weights.size() - 1;
+		}
+		//Ȩϣ֤ɫͼźɫ
+		taps->weights[biggest] += (int16_t)((1 << kWeightBits) - sum);
+		taps->start[i] = first;
+		taps->count[i] = last - first + 1;
+		taps->offset[i] = offset;
+	}
+}
+
+void HorizontalScalar(const uint8_t* src, const Taps& taps, int dst_x, int comp, int16_t* out) {
+	for (int i = 0; i < dst_x; ++i) {
+		const uint8_t* p = src + taps.start[i] * comp;
+		const int16_t* w = &taps.weights[taps.offset[i]];
+		for (int c = 0; c < comp; ++c) {
+			int sum = 1 << (kRowShift - 1);
+			for (int t = 0; t < taps.count[i]; ++t)
+				sum += p[t * comp + c] * w[t];
+			out[i * comp + c] = (int16_t)(sum >> kRowShift);
+		}
+	}
+}
+
+void VerticalScalar(const int16_t* line, int weight, int width, int32_t* acc) {
+	for (int k = 0; k < width; ++k)
+		acc[k] += line[k] * weight;
+}
+
+void StoreScalar(const int32_t* acc, int width, uint8_t* dst) {
+	for (int k = 0; k < width; ++k) {
+		int v = (acc[k] + (1 << (kStoreShift - 1))) >> kStoreShift;
+		dst[k] = (uint8_t)std::min(255, std::max(0, v));
+	}
+}
+
+#ifdef IMAGE_SCALER_X86
+
+//ۼRGBApʣnԴأؽ16λһmadd
+TARGET_SSE2 inline __m128i AccumulateSSE2(__m128i acc, const uint8_t* p, const int16_t* w, int n) {
+	const __m128i zero = _mm_setzero_si128();
+	for (; n >= 2; n -= 2, p += 8, w += 2) {
+		__m128i px = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)p), zero);
+		px = _mm_unpacklo_epi16(px, _mm_srli_si128(px, 8));
+		__m128i wt = _mm_set1_epi32((uint16_t)w[0] | ((int)w[1] << 16));
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(px, wt));
+	}
+	if (n) {
+		int32_t v;
+		memcpy(&v, p, 4);
+		__m128i px = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), zero), zero);
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(px, _mm_set1_epi32((uint16_t)w[0])));
+	}
+	return acc;
+}
+
+TARGET_SSE2 void HorizontalSSE2(const uint8_t* src, const Taps& taps, int dst_x, int16_t* out) {
+	const __m128i round = _mm_set1_epi32(1 << (kRowShift - 1));
+	for (int i = 0; i < dst_x; ++i) {
+		__m128i acc = AccumulateSSE2(round, src + taps.start[i] * 4, &taps.weights[taps.offset[i]], taps.count[i]);
+		acc = _mm_srai_epi32(acc, kRowShift);
+		_mm_storel_epi64((__m128i*)(out + i * 4), _mm_packs_epi32(acc, acc));
+	}
+}
+
+TARGET_SSE2 void VerticalSSE2(const int16_t* line, int weight, int width, int32_t* acc) {
+	const __m128i wt = _mm_set1_epi16((int16_t)weight);
+	int k = 0;
+	for (; k + 8 <= width; k += 8) {
+		__m128i h = _mm_loadu_si128((const __m128i*)(line + k));
+		__m128i lo = _mm_mullo_epi16(h, wt);
+		__m128i hi = _mm_mulhi_epi16(h, wt);
+		__m128i* a = (__m128i*)(acc + k);
+		_mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), _mm_unpacklo_epi16(lo, hi)));
+		_mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), _mm_unpackhi_epi16(lo, hi)));
+	}
+	VerticalScalar(line + k, weight, width - k, acc + k);
+}
+
+TARGET_SSE2 void StoreSSE2(const int32_t* acc, int width, uint8_t* dst) {
+	const __m128i round = _mm_set1_epi32(1 << (kStoreShift - 1));
+	int k = 0;
+	for (; k + 8 <= width; k += 8) {
+		__m128i a = _mm_srai_epi32(_mm_add_epi32(_mm_loadu_si128((const __m128i*)(acc + k)), round), kStoreShift);
+		__m128i b = _mm_srai_epi32(_mm_add_epi32(_mm_loadu_si128((const __m128i*)(acc + k + 4)), round), kStoreShift);
+		__m128i v = _mm_packs_epi32(a, b);
+		_mm_storel_epi64((__m128i*)(dst + k), _mm_packus_epi16(v, v));
+	}
+	StoreScalar(acc + k, width - k, dst + k);
+}
+
+//һδĸԴأÿ128λͨأֽųmadd
+TARGET_AVX2 void HorizontalAVX2(const uint8_t* src, const Taps& taps, int dst_x, int16_t* out) {
+	const __m256i pairs = _mm256_setr_epi8(
+		0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15,
+		0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+	const __m256i spread = _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1);
+	const __m128i round = _mm_set1_epi32(1 << (kRowShift - 1));
+	for (int i = 0; i < dst_x; ++i) {
+		const uint8_t* p = src + taps.start[i] * 4;
+		const int16_t* w = &taps.weights[taps.offset[i]];
+		int n = taps.count[i];
+		__m128i sum = round;
+		//С4ʱûпɺϲģֱ128λ
+		if (n >= 4) {
+			__m256i acc = _mm256_setzero_si256();
+			for (; n >= 4; n -= 4, p += 16, w += 4) {
+				__m256i px = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)p));
+				px = _mm256_shuffle_epi8(px, pairs);
+				//ĸint16Ȩɶԣֱ㲥ͨ
+				__m256i wt = _mm256_castsi128_si256(_mm_loadl_epi64((const __m128i*)w));
+				wt = _mm256_permutevar8x32_epi32(wt, spread);
+				acc = _mm256_add_epi32(acc, _mm256_madd_epi16(px, wt));
+			}
+			sum = _mm_add_epi32(sum, _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));
+		}
+		sum = AccumulateSSE2(sum, p, w, n);
+		sum = _mm_srai_epi32(sum, kRowShift);
+		_mm_storel_epi64((__m128i*)(out + i * 4), _mm_packs_epi32(sum, sum));
+	}
+}
+
+TARGET_AVX2 void VerticalAVX2(const int16_t* line, int weight, int width, int32_t* acc) {
+	const __m256i wt = _mm256_set1_epi16((int16_t)weight);
+	int k = 0;
+	for (; k + 16 <= width; k += 16) {
+		__m256i h = _mm256_loadu_si256((const __m256i*)(line + k));
+		__m256i lo = _mm256_mullo_epi16(h, wt);
+		__m256i hi = _mm256_mulhi_epi16(h, wt);
+		//unpack128λͨڽٰͨƴԭ˳
+		__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+		__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+		__m256i* a = (__m256i*)(acc + k);
+		_mm256_storeu_si256(a, _mm256_add_epi32(_mm256_loadu_si256(a), _mm256_permute2x128_si256(p0, p1, 0x20)));
+		_mm256_storeu_si256(a + 1, _mm256_add_epi32(_mm256_loadu_si256(a + 1), _mm256_permute2x128_si256(p0, p1, 0x31)));
+	}
+	VerticalSSE2(line + k, weight, width - k, acc + k);
+}
+
+bool HasAVX2() {
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	//ҪϵͳYMMĴ
+	if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif // IMAGE_SCALER_X86
+
+void Horizontal(ImageScaler::Kernel kernel, const uint8_t* src, const Taps& taps, int dst_x, int comp, int16_t* out) {
+#ifdef IMAGE_SCALER_X86
+	if (comp == 4 && kernel == ImageScaler::kAVX2)
+		return HorizontalAVX2(src, taps, dst_x, out);
+	if (comp == 4 && kernel == ImageScaler::kSSE2)
+		return HorizontalSSE2(src, taps, dst_x, out);
+#endif
+	HorizontalScalar(src, taps, dst_x, comp, out);
+}
+
+void Vertical(ImageScaler::Kernel kernel, const int16_t* line, int weight, int width, int32_t* acc) {
+#ifdef IMAGE_SCALER_X86
+	if (kernel == ImageScaler::kAVX2)
+		return VerticalAVX2(line, weight, width, acc);
+	if (kernel == ImageScaler::kSSE2)
+		return VerticalSSE2(line, weight, width, acc);
+#endif
+	VerticalScalar(line, weight, width, acc);
+}
+
+void Store(ImageScaler::Kernel kernel, const int32_t* acc, int width, uint8_t* dst) {
+#ifdef IMAGE_SCALER_X86
+	if (kernel != ImageScaler::kScalar)
+		return StoreSSE2(acc, width, dst);
+#endif
+	StoreScalar(acc, width, dst);
+}
+
+} // namespace
+
+ImageScaler::Kernel ImageScaler::Best() {
+#ifdef IMAGE_SCALER_X86
+	static const Kernel best = HasAVX2() ? kAVX2 : kSSE2;
+	return best;
+#else
+	return kScalar;
+#endif
+}
+
+bool ImageScaler::Scale(const uint8_t* src, int src_x, int src_y, int src_stride,
+	uint8_t* dst, int dst_x, int dst_y, int dst_stride, int comp, Kernel kernel) {
+	if (!src || !dst || src_x <= 0 || src_y <= 0 || dst_x <= 0 || dst_y <= 0 || comp < 1 || comp > 4)
+		return false;
+	if (src_stride == 0)
+		src_stride = src_x * comp;
+	if (dst_stride == 0)
+		dst_stride = dst_x * comp;
+
+	//ƽֻʺС
+	if (dst_x > src_x || dst_y > src_y)
+		return stbir_resize_uint8(src, src_x, src_y, src_stride, dst, dst_x, dst_y, dst_stride, comp) != 0;
+
+	if (kernel > Best())
+		kernel = Best();
+
+	Taps cols;
+	Taps rows;
+	BuildTaps(src_x, dst_x, &cols);
+	BuildTaps(src_y, dst_y, &rows);
+
+	const int width = dst_x * comp;
+	std::vector<int16_t> line(width);
+	std::vector<int32_t> acc(width);
+	int filtered = -1;
+	for (int y = 0; y < dst_y; ++y) {
+		std::fill(acc.begin(), acc.end(), 0);
+		for (int t = 0; t < rows.count[y]; ++t) {
+			//๲߽ϵһԴУֻˮƽŵһм
+			int row = rows.start[y] + t;
+			if (row != filtered) {
+				Horizontal(kernel, src + (size_t)row * src_stride, cols, dst_x, comp, line.data());
+				filtered = row;
+			}
+			Vertical(kernel, line.data(), rows.weights[rows.offset[y] + t], width, acc.data());
+		}
+		Store(kernel, acc.data(), width, dst + (size_t)y * dst_stride);
+	}
+	return true;
+}
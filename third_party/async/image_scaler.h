@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+
+//ƽ(box)СͼƬֱдṩĻ
+//x86ˮƽSSE2/AVX2ʵʹͬĶ㣬ֽһ
+class ImageScaler {
+public:
+	enum Kernel {
+		kScalar,
+		kSSE2,
+		kAVX2,
+	};
+
+	//ǰCPUֵ֧ʵ
+	static Kernel Best();
+
+	//strideΪ0ʱx*compУĿԴʱ˻stbirֵ
+	//kernelCPU֧ʱʹBest()
+	static bool Scale(const uint8_t* src, int src_x, int src_y, int src_stride,
+		uint8_t* dst, int dst_x, int dst_y, int dst_stride, int comp, Kernel kernel = Best());
+};
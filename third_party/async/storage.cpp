@@ -1,33 +1,512 @@
 #include "storage.h"
 #include "sqlite3/sqlite3.h"
 #include "cjsonpp/cjsonpp.h"
+#include <deque>
+#include <ctype.h>
 
 using namespace cjsonpp;
 
+//ÿ໺Ԥ
+static const size_t kMaxCachedStatements = 64;
+
+//ȴдύʱ
+static const int kBusyTimeout = 5000;
+
+int on_exec(void* ud, int argc, char** argv, char** name) {
+	Json* array = (Json*)ud;
+	Json value = Json::object();
+	for (int i = 0; i < argc; ++i) {
+		value.add(name[i], argv[i]);
+	}
+	array->add(value);
+	return 0;
+}
+
+StorageConnection::StorageConnection()
+	:db_(nullptr), generation_(0)
+{
+}
+
+StorageConnection::~StorageConnection() {
+	Close();
+}
+
+int StorageConnection::Open(const std::string& name, const StorageOptions& options, bool readonly) {
+	Close();
+	++generation_;
+
+	int flags = readonly ? SQLITE_OPEN_READONLY : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+	int rslt = sqlite3_open_v2(name.c_str(), &db_, flags, nullptr);
+	if (rslt != SQLITE_OK) {
+		sqlite3_close(db_);
+		db_ = nullptr;
+		return rslt;
+	}
+
+	sqlite3_busy_timeout(db_, kBusyTimeout);
+	if (!readonly) {
+		//WALģʽsynchronous=NORMALֻڼʱfsync
+		std::string pragma = "PRAGMA synchronous=" + std::to_string(options.synchronous) + ";";
+		if (options.wal)
+			pragma = "PRAGMA journal_mode=WAL;" + pragma;
+		sqlite3_exec(db_, pragma.c_str(), nullptr, nullptr, nullptr);
+	}
+	return rslt;
+}
+
+int StorageConnection::Close() {
+	ClearStatements();
+	int rslt = SQLITE_OK;
+	if (db_) {
+		//αܻδͷţӳٵͷźر
+		rslt = sqlite3_close_v2(db_);
+		db_ = nullptr;
+		++generation_;
+	}
+	return rslt;
+}
+
+int StorageConnection::Exec(const std::string& sql, std::string* out) {
+	if (!db_) {
+		*out = "database not open";
+		return SQLITE_MISUSE;
+	}
+
+	Json result = Json::array();
+	char* error = nullptr;
+	int code = sqlite3_exec(db_, sql.c_str(), on_exec, &result, &error);
+	if (code != SQLITE_OK) {
+		*out = error ? error : sqlite3_errstr(code);
+		sqlite3_free(error);
+	} else {
+		*out = result.dump();
+	}
+	return code;
+}
+
+StorageResultPtr StorageConnection::Execute(const std::string& sql, const StorageParams& params, bool fetch_rows) {
+	auto result = std::make_shared<StorageResult>();
+	if (!db_) {
+		result->code = SQLITE_MISUSE;
+		result->error = "database not open";
+		return result;
+	}
+
+	sqlite3_stmt* stmt = GetStatement(sql, &result->code);
+	if (!stmt) {
+		result->error = sqlite3_errmsg(db_);
+		return result;
+	}
+
+	int code = BindParams(stmt, params);
+
+	if (code == SQLITE_OK) {
+		int count = sqlite3_column_count(stmt);
+		if (fetch_rows) {
+			for (int i = 0; i < count; ++i) {
+				result->columns.push_back(sqlite3_column_name(stmt, i));
+			}
+		}
+
+		while ((code = sqlite3_step(stmt)) == SQLITE_ROW) {
+			if (!fetch_rows)
+				continue;
+
+			StorageRow row;
+			ReadRow(stmt, &row);
+			result->rows.push_back(std::move(row));
+		}
+		if (code == SQLITE_DONE)
+			code = SQLITE_OK;
+	}
+
+	result->code = code;
+	if (code != SQLITE_OK) {
+		result->error = sqlite3_errmsg(db_);
+	} else {
+		result->changes = sqlite3_changes(db_);
+		result->last_insert_rowid = sqlite3_last_insert_rowid(db_);
+	}
+
+	sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+	return result;
+}
+
+int StorageConnection::BindParams(sqlite3_stmt* stmt, const StorageParams& params) {
+	int code = SQLITE_OK;
+	int index = 0;
+	for (auto& param : params) {
+		++index;
+		int pos = index;
+		if (!param.name.empty()) {
+			pos = sqlite3_bind_parameter_index(stmt, param.name.c_str());
+			//ʡ:@$ǰ׺
+			const char* prefixs[] = { ":","@","$" };
+			for (int i = 0; pos == 0 && i < 3; ++i) {
+				pos = sqlite3_bind_parameter_index(stmt, (prefixs[i] + param.name).c_str());
+			}
+			if (pos == 0)
+				continue;
+		}
+
+		const StorageValue& value = param.value;
+		switch (value.type) {
+		case StorageValue::kInteger:
+			code = sqlite3_bind_int64(stmt, pos, value.i);
+			break;
+		case StorageValue::kFloat:
+			code = sqlite3_bind_double(stmt, pos, value.f);
+			break;
+		case StorageValue::kText:
+			code = sqlite3_bind_text(stmt, pos, value.data.c_str(), (int)value.data.size(), SQLITE_TRANSIENT);
+			break;
+		case StorageValue::kBlob:
+			code = sqlite3_bind_blob(stmt, pos, value.data.data(), (int)value.data.size(), SQLITE_TRANSIENT);
+			break;
+		default:
+			code = sqlite3_bind_null(stmt, pos);
+			break;
+		}
+		if (code != SQLITE_OK)
+			break;
+	}
+	return code;
+}
+
+void StorageConnection::ReadRow(sqlite3_stmt* stmt, StorageRow* row) {
+	int count = sqlite3_column_count(stmt);
+	row->resize(count);
+	for (int i = 0; i < count; ++i) {
+		StorageValue& value = (*row)[i];
+		switch (sqlite3_column_type(stmt, i)) {
+		case SQLITE_INTEGER:
+			value.type = StorageValue::kInteger;
+			value.i = sqlite3_column_int64(stmt, i);
+			break;
+		case SQLITE_FLOAT:
+			value.type = StorageValue::kFloat;
+			value.f = sqlite3_column_double(stmt, i);
+			break;
+		case SQLITE_TEXT:
+			value.type = StorageValue::kText;
+			value.data.assign((const char*)sqlite3_column_text(stmt, i), sqlite3_column_bytes(stmt, i));
+			break;
+		case SQLITE_BLOB:
+			value.type = StorageValue::kBlob;
+			value.data.assign((const char*)sqlite3_column_blob(stmt, i), sqlite3_column_bytes(stmt, i));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+sqlite3_stmt* StorageConnection::Prepare(const std::string& sql, const StorageParams& params, int* code) {
+	sqlite3_stmt* stmt = nullptr;
+	*code = sqlite3_prepare_v2(db_, sql.c_str(), (int)sql.size(), &stmt, nullptr);
+	if (*code == SQLITE_OK)
+		*code = BindParams(stmt, params);
+
+	if (*code != SQLITE_OK) {
+		sqlite3_finalize(stmt);
+		return nullptr;
+	}
+	return stmt;
+}
+
+bool StorageConnection::BeginTransaction() {
+	if (!db_ || !sqlite3_get_autocommit(db_))
+		return false;
+	return sqlite3_exec(db_, "BEGIN IMMEDIATE", nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+int StorageConnection::EndTransaction(bool commit) {
+	return sqlite3_exec(db_, commit ? "COMMIT" : "ROLLBACK", nullptr, nullptr, nullptr);
+}
+
+std::string StorageConnection::error() const {
+	return db_ ? sqlite3_errmsg(db_) : "database not open";
+}
+
+sqlite3_stmt* StorageConnection::GetStatement(const std::string& sql, int* code) {
+	auto find = statements_.find(sql);
+	if (find != statements_.end()) {
+		*code = SQLITE_OK;
+		statement_list_.splice(statement_list_.begin(), statement_list_, find->second);
+		return find->second->second;
+	}
+
+	sqlite3_stmt* stmt = nullptr;
+	*code = sqlite3_prepare_v2(db_, sql.c_str(), (int)sql.size(), &stmt, nullptr);
+	if (*code != SQLITE_OK) {
+		sqlite3_finalize(stmt);
+		return nullptr;
+	}
+
+	//̭δʹõ
+	if (statements_.size() >= kMaxCachedStatements) {
+		CachedStatement& last = statement_list_.back();
+		sqlite3_finalize(last.second);
+		statements_.erase(last.first);
+		statement_list_.pop_back();
+	}
+	statement_list_.push_front(std::make_pair(sql, stmt));
+	statements_[sql] = statement_list_.begin();
+	return stmt;
+}
+
+void StorageConnection::ClearStatements() {
+	for (auto& item : statement_list_) {
+		sqlite3_finalize(item.second);
+	}
+	statement_list_.clear();
+	statements_.clear();
+}
+
+
+StorageCursor::StorageCursor(const std::string& sql, StorageParams params, size_t chunk, Runner runner)
+	:sql_(sql), params_(std::move(params)), chunk_(chunk > 0 ? chunk : 1), runner_(std::move(runner)),
+	stmt_(nullptr), generation_(0), done_(false), closed_(false)
+{
+}
+
+StorageCursor::~StorageCursor() {
+	sqlite3_finalize(stmt_);
+}
+
+void StorageCursor::Fetch(std::function<void(StorageResultPtr, bool)> finish) {
+	//αִ֤꣬ڼ䲻ͷ
+	auto self = shared_from_this();
+	runner_([self, this, finish](StorageConnection* conn) {
+		std::lock_guard<std::mutex> locker(lock_);
+		auto result = std::make_shared<StorageResult>();
+		if (done_ || closed_) {
+			finish(result, true);
+			return;
+		}
+
+		if (!conn || !conn->IsOpen() || (stmt_ && generation_ != conn->generation())) {
+			result->code = SQLITE_MISUSE;
+			result->error = "database not open";
+		} else if (!stmt_) {
+			stmt_ = conn->Prepare(sql_, params_, &result->code);
+			generation_ = conn->generation();
+			if (stmt_) {
+				int count = sqlite3_column_count(stmt_);
+				for (int i = 0; i < count; ++i) {
+					columns_.push_back(sqlite3_column_name(stmt_, i));
+				}
+			} else {
+				result->error = conn->error();
+			}
+		}
+
+		bool done = true;
+		if (stmt_ && result->code == SQLITE_OK) {
+			result->columns = columns_;
+			int code;
+			while ((code = sqlite3_step(stmt_)) == SQLITE_ROW) {
+				StorageRow row;
+				StorageConnection::ReadRow(stmt_, &row);
+				result->rows.push_back(std::move(row));
+				if (result->rows.size() >= chunk_)
+					break;
+			}
+
+			if (code == SQLITE_ROW) {
+				done = false;
+			} else if (code != SQLITE_DONE) {
+				result->code = code;
+				result->error = conn->error();
+			}
+		}
+
+		if (done) {
+			done_ = true;
+			sqlite3_finalize(stmt_);
+			stmt_ = nullptr;
+		}
+		finish(result, done);
+	});
+}
+
+void StorageCursor::Close() {
+	//̳߳ϵִУȱͷ
+	closed_ = true;
+	auto self = shared_from_this();
+	runner_([self, this](StorageConnection*) {
+		std::lock_guard<std::mutex> locker(lock_);
+		done_ = true;
+		sqlite3_finalize(stmt_);
+		stmt_ = nullptr;
+	});
+}
+
+//ֻӳأڶ̳߳ϲִУͬʱִе
+class StorageReaders :public std::enable_shared_from_this<StorageReaders> {
+public:
+	//ֻʧʱconnΪգcodeΪ򿪵Ĵ
+	using ReadTask = std::function<void(StorageConnection* conn, int code)>;
+
+	StorageReaders(WorkerPool* pool)
+		:pool_(pool), enabled_(false), generation_(0), max_readers_(0), active_(0)
+	{
+	}
+
+	//дӴ򿪺ã֮Ĳѯʹµ
+	void Reset(const std::string& name, const StorageOptions& options, bool enabled) {
+		std::lock_guard<std::mutex> locker(lock_);
+		++generation_;
+		idle_.clear();
+		name_ = name;
+		options_ = options;
+		enabled_ = enabled && options.readers > 0;
+		max_readers_ = options.readers;
+	}
+
+	//αʹöֻӣfalseʱֻʹд
+	bool GetSource(std::string* name, StorageOptions* options) {
+		std::lock_guard<std::mutex> locker(lock_);
+		*name = name_;
+		*options = options_;
+		return enabled_;
+	}
+
+	WorkerPool* pool() { return pool_; }
+
+	//ֻӲʱfalse
+	bool PostTask(ReadTask task) {
+		{
+			std::lock_guard<std::mutex> locker(lock_);
+			if (!enabled_)
+				return false;
+
+			tasks_.push_back(std::move(task));
+			if (active_ >= max_readers_)
+				return true;
+			++active_;
+		}
+
+		auto self = shared_from_this();
+		pool_->PostTask([self]() {
+			self->Run();
+		});
+		return true;
+	}
+private:
+	struct Reader {
+		std::unique_ptr<StorageConnection> conn;
+		uint32_t generation;
+	};
+
+	void Run() {
+		Reader reader;
+		std::string name;
+		StorageOptions options;
+		for (;;) {
+			ReadTask task;
+			{
+				std::lock_guard<std::mutex> locker(lock_);
+				if (reader.conn && reader.generation != generation_)
+					reader.conn.reset();
+
+				if (tasks_.empty()) {
+					--active_;
+					if (reader.conn && enabled_)
+						idle_.push_back(std::move(reader));
+					return;
+				}
+
+				task = std::move(tasks_.front());
+				tasks_.pop_front();
+				if (!reader.conn && !idle_.empty()) {
+					reader = std::move(idle_.back());
+					idle_.pop_back();
+				}
+				if (!reader.conn) {
+					reader.generation = generation_;
+					name = name_;
+					options = options_;
+				}
+			}
+
+			int code = SQLITE_OK;
+			if (!reader.conn) {
+				reader.conn.reset(new StorageConnection());
+				code = reader.conn->Open(name, options, true);
+				//ʧܵӲŻسУһ´
+				if (code != SQLITE_OK)
+					reader.conn.reset();
+			}
+			task(reader.conn.get(), code);
+		}
+	}
+
+	WorkerPool* pool_;
+	std::mutex lock_;
+	std::deque<ReadTask> tasks_;
+	std::vector<Reader> idle_;
+	std::string name_;
+	StorageOptions options_;
+	bool enabled_;
+	uint32_t generation_;
+	size_t max_readers_;
+	size_t active_;
+};
+
+
 Storage::Storage() 
-	:sqlite_(nullptr), thread_mgr_(ThreadManager::Instance())
+	:thread_mgr_(ThreadManager::Instance()),
+	flush_posted_(false)
 {
+	StorageOptions options;
+	batch_size_ = options.batch_size;
+	flush_latency_ = options.flush_latency;
+	readers_ = std::make_shared<StorageReaders>(thread_mgr_->read_pool());
 }
 
 Storage::~Storage() {
+	//ȵִе˳֮òStorageٷʳԱ
+	InvalidateWeakPtrs();
+
+	//ʣдֱӻصʧ
+	std::vector<PendingWrite> writes;
+	{
+		std::lock_guard<std::mutex> locker(write_lock_);
+		writes.swap(writes_);
+	}
+	for (auto& write : writes) {
+		auto result = std::make_shared<StorageResult>();
+		result->code = SQLITE_ABORT;
+		result->error = "storage destroyed";
+		write.finish(result);
+	}
 }
 
 void Storage::Open(const std::string& name, std::function<void(int)> finish) {
+	Open(name, StorageOptions(), finish);
+}
+
+void Storage::Open(const std::string& name, const StorageOptions& options, std::function<void(int)> finish) {
+	{
+		std::lock_guard<std::mutex> locker(write_lock_);
+		batch_size_ = options.batch_size > 0 ? options.batch_size : 1;
+		flush_latency_ = options.flush_latency;
+	}
+
 	std::string name_(name);
+	StorageOptions options_(options);
 	WeakPtr<Storage> ptr = weak_ptr();
-	thread_mgr_->PostTask(ThreadManager::kStorage,[ptr, name_,finish]() {
+	thread_mgr_->PostTask(ThreadManager::kStorage,[ptr, name_, options_, finish]() {
 		Storage* pThis = ptr.Lock();
 		if (pThis) {
-			if (pThis->sqlite_) {
-				sqlite3_close(pThis->sqlite_);
-				pThis->sqlite_ = nullptr;
-			}
+			int rslt = pThis->writer_.Open(name_, options_, false);
 
-			int rslt = sqlite3_open(name_.c_str(), &pThis->sqlite_);
-			if (rslt != 0) {
-				sqlite3_close(pThis->sqlite_);
-				pThis->sqlite_ = nullptr;
-			}
+			//ڴݿʱݿ޷Ӵ
+			bool shared = rslt == SQLITE_OK && options_.wal && !name_.empty()
+				&& name_ != ":memory:" && name_.find("mode=memory") == std::string::npos;
+			pThis->readers_->Reset(name_, options_, shared);
 			finish(rslt);
 		}
 		ptr.Unlock();
@@ -39,9 +518,13 @@ void Storage::Close(std::function<void(int)> finish) {
 	WeakPtr<Storage> ptr = weak_ptr();
 	thread_mgr_->PostTask(ThreadManager::kStorage, [ptr, finish]() {
 		Storage* pThis = ptr.Lock();
-		if (pThis && pThis->sqlite_) {
-			int rslt = sqlite3_close(pThis->sqlite_);
-			pThis->sqlite_ = nullptr;
+		if (pThis) {
+			//رǰύдʣдδʱصʧ
+			pThis->FlushWrites(true);
+		}
+		if (pThis && pThis->writer_.IsOpen()) {
+			pThis->readers_->Reset(std::string(), StorageOptions(), false);
+			int rslt = pThis->writer_.Close();
 			finish(rslt);
 		}
 		ptr.Unlock();
@@ -49,37 +532,235 @@ void Storage::Close(std::function<void(int)> finish) {
 
 }
 
-int on_exec(void* ud, int argc, char** argv, char** name) {
-	Json* array = (Json*)ud;
-	Json value = Json::object();
-	for (int i = 0; i < argc; ++i) {
-		value.add(name[i], argv[i]);
-	}
-	array->add(value);
-	return 0;
+void Storage::Exec(const std::string& sql, std::function<void(int,std::string)> finish) {
+	std::string sql_(sql);
+	WeakPtr<Storage> ptr = weak_ptr();
+	thread_mgr_->PostTask(ThreadManager::kStorage,[ptr, sql_, finish]() {
+		Storage* pThis = ptr.Lock();
+		if (pThis && pThis->writer_.IsOpen()) {
+			std::string data;
+			int code = pThis->writer_.Exec(sql_, &data);
+			finish(code, data);
+		}
+		ptr.Unlock();
+	});
 }
 
-void Storage::Exec(const std::string& sql, std::function<void(int,std::string)> finish) {
+void Storage::Query(const std::string& sql, StorageParams params, bool fetch_rows,
+	std::function<void(StorageResultPtr)> finish) {
 	std::string sql_(sql);
+	auto params_ = std::make_shared<StorageParams>(std::move(params));
 	WeakPtr<Storage> ptr = weak_ptr();
 
-	thread_mgr_->PostTask(ThreadManager::kStorage,[ptr, sql_, finish]() {
+	thread_mgr_->PostTask(ThreadManager::kStorage, [ptr, sql_, params_, fetch_rows, finish]() {
+		Storage* pThis = ptr.Lock();
+		if (pThis) {
+			finish(pThis->writer_.Execute(sql_, *params_, fetch_rows));
+		}
+		ptr.Unlock();
+	});
+}
+
+void Storage::Read(const std::string& sql, StorageParams params,
+	std::function<void(StorageResultPtr)> finish) {
+	std::string sql_(sql);
+	auto params_ = std::make_shared<StorageParams>(std::move(params));
+	bool posted = readers_->PostTask([sql_, params_, finish](StorageConnection* conn, int code) {
+		if (!conn) {
+			auto result = std::make_shared<StorageResult>();
+			result->code = code;
+			result->error = sqlite3_errstr(code);
+			finish(result);
+			return;
+		}
+		finish(conn->Execute(sql_, *params_, true));
+	});
+	if (posted)
+		return;
+
+	WeakPtr<Storage> ptr = weak_ptr();
+	thread_mgr_->PostTask(ThreadManager::kStorage, [ptr, sql_, params_, finish]() {
 		Storage* pThis = ptr.Lock();
-		if (pThis && pThis->sqlite_) {
-			Json result = Json::array();
-			char* error;
-			int code = sqlite3_exec(pThis->sqlite_, sql_.c_str(), on_exec, &result, &error);
-			if (code != SQLITE_OK) {
-				finish(code, error);
+		if (pThis) {
+			finish(pThis->writer_.Execute(sql_, *params_, true));
+		}
+		ptr.Unlock();
+	});
+}
+
+StorageCursorPtr Storage::OpenCursor(const std::string& sql, StorageParams params, size_t chunk) {
+	StorageCursor::Runner runner;
+	std::string name;
+	StorageOptions options;
+	if (IsReadOnlySql(sql) && readers_->GetSource(&name, &options)) {
+		//α᳤ʱռӣѯ
+		WorkerPool* pool = readers_->pool();
+		auto conn = std::make_shared<StorageConnection>();
+		runner = [pool, conn, name, options](std::function<void(StorageConnection*)> task) {
+			pool->PostTask([conn, name, options, task]() {
+				if (!conn->IsOpen())
+					conn->Open(name, options, true);
+				task(conn.get());
+			});
+		};
+	} else {
+		ThreadManager* thread_mgr = thread_mgr_;
+		WeakPtr<Storage> ptr = weak_ptr();
+		runner = [thread_mgr, ptr](std::function<void(StorageConnection*)> task) {
+			thread_mgr->PostTask(ThreadManager::kStorage, [ptr, task]() {
+				Storage* pThis = ptr.Lock();
+				task(pThis ? &pThis->writer_ : nullptr);
+				ptr.Unlock();
+			});
+		};
+	}
+	return std::make_shared<StorageCursor>(sql, std::move(params), chunk, runner);
+}
+
+bool Storage::IsReadOnlySql(const std::string& sql) {
+	size_t begin = 0;
+	while (begin < sql.size() && isspace((unsigned char)sql[begin]))
+		++begin;
+	if (sql.size() - begin < 6)
+		return false;
+
+	for (size_t i = 0; i < 6; ++i) {
+		if (tolower((unsigned char)sql[begin + i]) != "select"[i])
+			return false;
+	}
+
+	//ʱܰд
+	size_t end = sql.find(';', begin);
+	if (end == std::string::npos)
+		return true;
+	for (++end; end < sql.size(); ++end) {
+		if (!isspace((unsigned char)sql[end]))
+			return false;
+	}
+	return true;
+}
+
+void Storage::Batch(std::vector<StorageStatement> statements,
+	std::function<void(int, std::vector<StorageResultPtr>)> finish) {
+	auto statements_ = std::make_shared<std::vector<StorageStatement>>(std::move(statements));
+	WeakPtr<Storage> ptr = weak_ptr();
+
+	thread_mgr_->PostTask(ThreadManager::kStorage, [ptr, statements_, finish]() {
+		Storage* pThis = ptr.Lock();
+		if (pThis) {
+			StorageConnection& writer = pThis->writer_;
+			std::vector<StorageResultPtr> results;
+			bool owned = writer.BeginTransaction();
+			int code = SQLITE_OK;
+			for (auto& statement : *statements_) {
+				StorageResultPtr result = writer.Execute(statement.sql, statement.params, false);
+				results.push_back(result);
+				if (result->code != SQLITE_OK) {
+					code = result->code;
+					break;
+				}
 			}
-			else {
-				finish(code, result.dump());
+
+			if (owned) {
+				int rslt = writer.EndTransaction(code == SQLITE_OK);
+				if (code == SQLITE_OK)
+					code = rslt;
 			}
+			finish(code, std::move(results));
 		}
 		ptr.Unlock();
 	});
 }
 
+void Storage::Write(const std::string& sql, StorageParams params,
+	std::function<void(StorageResultPtr)> finish) {
+	PendingWrite write;
+	write.statement.sql = sql;
+	write.statement.params = std::move(params);
+	write.finish = std::move(finish);
+
+	//еһдȴflush_latencyչbatch_sizeʱύ
+	bool post = false;
+	bool full = false;
+	uint32_t latency;
+	{
+		std::lock_guard<std::mutex> locker(write_lock_);
+		writes_.push_back(std::move(write));
+		if (!flush_posted_) {
+			flush_posted_ = true;
+			post = true;
+		}
+		full = writes_.size() == batch_size_;
+		latency = flush_latency_;
+	}
+
+	if (full)
+		PostFlush(0);
+	else if (post)
+		PostFlush(latency);
+}
+
+void Storage::PostFlush(uint32_t delay) {
+	WeakPtr<Storage> ptr = weak_ptr();
+	thread_mgr_->PostDelayedTask(ThreadManager::kStorage, [ptr]() {
+		Storage* pThis = ptr.Lock();
+		if (pThis) {
+			pThis->FlushWrites(false);
+		}
+		ptr.Unlock();
+	}, delay);
+}
+
+void Storage::FlushWrites(bool all) {
+	std::vector<PendingWrite> writes;
+	bool more = false;
+	uint32_t delay = 0;
+	{
+		std::lock_guard<std::mutex> locker(write_lock_);
+		size_t count = all ? writes_.size() : std::min(writes_.size(), batch_size_);
+		writes.assign(std::make_move_iterator(writes_.begin()), std::make_move_iterator(writes_.begin() + count));
+		writes_.erase(writes_.begin(), writes_.begin() + count);
+
+		//ʣд¼ʱһʱύ
+		more = !writes_.empty();
+		if (more)
+			delay = writes_.size() >= batch_size_ ? 0 : flush_latency_;
+		flush_posted_ = more;
+	}
+
+	if (more)
+		PostFlush(delay);
+
+	if (writes.empty())
+		return;
+
+	std::vector<StorageResultPtr> results;
+	results.reserve(writes.size());
+	bool owned = writer_.BeginTransaction();
+	for (auto& write : writes) {
+		results.push_back(writer_.Execute(write.statement.sql, write.statement.params, false));
+	}
+
+	if (owned) {
+		//ύʧʱûд
+		int code = writer_.EndTransaction(true);
+		if (code != SQLITE_OK) {
+			std::string error = writer_.error();
+			writer_.EndTransaction(false);
+			for (auto& result : results) {
+				if (result->code == SQLITE_OK) {
+					result->code = code;
+					result->error = error;
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0; i < writes.size(); ++i) {
+		writes[i].finish(results[i]);
+	}
+}
+
 
 #include <thread>
 
@@ -2,8 +2,154 @@
 #include "thread.h"
 #include "weak_ptr.h"
 #include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
 
 typedef struct sqlite3 sqlite3;
+typedef struct sqlite3_stmt sqlite3_stmt;
+
+//sqliteֵֶtextblobdata
+struct StorageValue {
+	enum Type {
+		kNull,
+		kInteger,
+		kFloat,
+		kText,
+		kBlob,
+	};
+
+	StorageValue()
+		:type(kNull), i(0), f(0)
+	{
+	}
+
+	Type type;
+	int64_t i;
+	double f;
+	std::string data;
+};
+
+typedef std::vector<StorageValue> StorageRow;
+
+//󶨲nameΪʱλð
+struct StorageParam {
+	std::string name;
+	StorageValue value;
+};
+
+typedef std::vector<StorageParam> StorageParams;
+
+//Ԥִн
+struct StorageResult {
+	StorageResult()
+		:code(0), changes(0), last_insert_rowid(0)
+	{
+	}
+
+	int code;
+	std::string error;
+	std::vector<std::string> columns;
+	std::vector<StorageRow> rows;
+	int changes;
+	int64_t last_insert_rowid;
+};
+
+typedef std::shared_ptr<StorageResult> StorageResultPtr;
+
+//ִе
+struct StorageStatement {
+	std::string sql;
+	StorageParams params;
+};
+
+//ݿĲ
+struct StorageOptions {
+	StorageOptions()
+		:wal(true), synchronous(1), batch_size(1000), flush_latency(5), readers(4)
+	{
+	}
+
+	bool wal;				//ʹWAL־ģʽ
+	int synchronous;		//PRAGMA synchronous0:OFF 1:NORMAL 2:FULL 3:EXTRA
+	size_t batch_size;		//дÿ
+	uint32_t flush_latency;	//ддȴĺ0ʾȴ
+	size_t readers;			//ֻWALģʽļݿЧ0ʾдд
+};
+
+//sqliteӼԤ仺棬ͬһʱֻһ߳ʹ
+class StorageConnection {
+public:
+	StorageConnection();
+	~StorageConnection();
+
+	int Open(const std::string& name, const StorageOptions& options, bool readonly);
+	int Close();
+	bool IsOpen() const { return db_ != nullptr; }
+
+	//sqlite3_execתΪjson
+	int Exec(const std::string& sql, std::string* out);
+	StorageResultPtr Execute(const std::string& sql, const StorageParams& params, bool fetch_rows);
+
+	//(űԼִBEGIN)ʱfalseύ
+	bool BeginTransaction();
+	int EndTransaction(bool commit);
+	std::string error() const;
+
+	//Ԥ벻䲢󶨲ɵfinalize
+	sqlite3_stmt* Prepare(const std::string& sql, const StorageParams& params, int* code);
+
+	//ÿOpen/Close1жǷѹر
+	uint32_t generation() const { return generation_; }
+
+	static int BindParams(sqlite3_stmt* stmt, const StorageParams& params);
+	static void ReadRow(sqlite3_stmt* stmt, StorageRow* row);
+private:
+	sqlite3_stmt* GetStatement(const std::string& sql, int* code);
+	void ClearStatements();
+
+	typedef std::pair<std::string, sqlite3_stmt*> CachedStatement;
+
+	sqlite3* db_;
+	uint32_t generation_;
+	std::list<CachedStatement> statement_list_;	//ʹõǰ
+	std::unordered_map<std::string, std::list<CachedStatement>::iterator> statements_;
+};
+
+//ȡα꣬ÿFetchڴ洢߳ಽchunk
+//ڴռֻchunkйأȡһȡһγɱѹ
+class StorageCursor :public std::enable_shared_from_this<StorageCursor> {
+public:
+	//ִ߳Ӳʱnullptr
+	using Runner = std::function<void(std::function<void(StorageConnection*)>)>;
+
+	StorageCursor(const std::string& sql, StorageParams params, size_t chunk, Runner runner);
+	~StorageCursor();
+
+	//һλص֮ǰٴεãdoneΪtrueʾѶ
+	void Fetch(std::function<void(StorageResultPtr, bool done)> finish);
+
+	//ǰͷԽ
+	void Close();
+private:
+	std::mutex lock_;
+	std::string sql_;
+	StorageParams params_;
+	size_t chunk_;
+	Runner runner_;
+	sqlite3_stmt* stmt_;
+	uint32_t generation_;
+	std::vector<std::string> columns_;
+	bool done_;
+	std::atomic<bool> closed_;
+};
+
+typedef std::shared_ptr<StorageCursor> StorageCursorPtr;
+
+class StorageReaders;
 
 class Storage:public WeakObject<Storage> {
 public:
@@ -11,11 +157,58 @@ public:
 	~Storage();
 
 	void Open(const std::string& name, std::function<void(int)> finish);
+	void Open(const std::string& name, const StorageOptions& options, std::function<void(int)> finish);
 	void Close(std::function<void(int)> finish);
 	void Exec(const std::string& sql, std::function<void(int,std::string)> finish);
+
+	//ʹûԤִsqlfetch_rowsΪfalseʱؽ
+	//ExecһдϰͶ˳ִУ֮ܶǰͶݵд
+	void Query(const std::string& sql, StorageParams params, bool fetch_rows,
+		std::function<void(StorageResultPtr)> finish);
+
+	//һִУһʧعcodeΪʧĴ
+	void Batch(std::vector<StorageStatement> statements,
+		std::function<void(int, std::vector<StorageResultPtr>)> finish);
+
+	//дУедbatch_size/flush_latencyϲһύ
+	//ÿ䵥صʧܲӰͬ
+	void Write(const std::string& sql, StorageParams params,
+		std::function<void(StorageResultPtr)> finish);
+
+	//ֻϲִвѯдδύд
+	//ûֻʱдִ
+	void Read(const std::string& sql, StorageParams params,
+		std::function<void(StorageResultPtr)> finish);
+
+	//αֻ꣬ʹöֻ
+	StorageCursorPtr OpenCursor(const std::string& sql, StorageParams params, size_t chunk);
+
+	//ֻһSELECT䣬ִֻ
+	static bool IsReadOnlySql(const std::string& sql);
 private:
-	sqlite3* sqlite_;
+	struct PendingWrite {
+		StorageStatement statement;
+		std::function<void(StorageResultPtr)> finish;
+	};
+
+	//delayڴ洢߳ύдУ0ʾͶ
+	void PostFlush(uint32_t delay);
+
+	//ֻڴ洢̵߳ãallΪfalseʱύbatch_size
+	void FlushWrites(bool all);
+
 	ThreadManager* thread_mgr_;
+	StorageConnection writer_;
+
+	//ֻӳأѯ񲻳WeakPtrд̻߳
+	std::shared_ptr<StorageReaders> readers_;
+
+	//д
+	std::mutex write_lock_;
+	std::vector<PendingWrite> writes_;
+	bool flush_posted_;
+	size_t batch_size_;
+	uint32_t flush_latency_;
 };
 
 void testStorage();
@@ -30,6 +30,9 @@ void SetThreadName(DWORD dwWorkThreadID, LPCSTR szWorkThreadName) {
 }
 #endif
 
+//洢ֻѯ߳
+static const size_t kReadThreads = 4;
+
 Thread::Thread(const char* name) {
 	if (name)
 		name_ = name;
@@ -41,7 +44,7 @@ Thread::~Thread() {
 void Thread::PostTask(Task task) {
 	{
 		std::lock_guard<std::mutex> locker(task_lock_);
-		tasks_.push(task);
+		tasks_.push(std::move(task));
 	}
 	event_.Signal();
 }
@@ -82,13 +85,12 @@ Task Thread::PopTask() {
 		return nullptr;
 	}
 	else {
-		auto task = tasks_.front();
+		auto task = std::move(tasks_.front());
 		tasks_.pop();
 		return task;
 	}
 }
 
-
 ThreadManager* ThreadManager::s_instance_ = NULL;
 
 ThreadManager* ThreadManager::Instance() {
@@ -109,26 +111,128 @@ void ThreadManager::RegisterUITaskHandler(TaskHandler ui_task_handler) {
 void ThreadManager::PostTask(TID tid, Task task) {
 	if (tid == kUI) {
 		assert(ui_task_handler_);
-		ui_task_handler_(task);
-	} else {
-		threads_[tid]->PostTask(task);
+		ui_task_handler_(std::move(task));
+		return;
+	}
+
+	switch (modes_[tid]) {
+	case kSequenced:
+		sequences_[tid]->PostTask(std::move(task));
+		break;
+	case kDedicated:
+		threads_[tid]->PostTask(std::move(task));
+		break;
+	default:
+		pool_->PostTask(std::move(task));
+		break;
 	}
 }
 
-ThreadManager::ThreadManager() {
-	threads_[kIO] = new Thread("IO_Thread");
-	threads_[kStorage] = new Thread("Storage_Thread");
-	threads_[kImage] = new Thread("Image_Thread");
-	for (auto& thread:threads_) {
-		thread->Start();
+void ThreadManager::PostDelayedTask(TID tid, Task task, uint32_t delay) {
+	if (delay == 0) {
+		PostTask(tid, std::move(task));
+		return;
 	}
+
+	auto expire = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
+	std::lock_guard<std::mutex> locker(delayed_lock_);
+	if (!delayed_thread_) {
+		delayed_thread_.reset(new std::thread([this]() {
+#if defined(WIN32) && defined(_DEBUG)
+			SetThreadName(GetCurrentThreadId(), "Timer_Thread");
+#endif
+			RunDelayedTasks();
+		}));
+	}
+
+	//ԭȵʱѶʱ߳
+	bool earliest = delayed_tasks_.empty() || expire < delayed_tasks_.begin()->first;
+	delayed_tasks_.insert(std::make_pair(expire, std::make_pair(tid, std::move(task))));
+	if (earliest)
+		delayed_cond_.notify_one();
+}
+
+void ThreadManager::RunDelayedTasks() {
+	std::unique_lock<std::mutex> locker(delayed_lock_);
+	while (!delayed_quit_) {
+		if (delayed_tasks_.empty()) {
+			delayed_cond_.wait(locker);
+			continue;
+		}
+
+		auto first = delayed_tasks_.begin();
+		if (std::chrono::steady_clock::now() < first->first) {
+			delayed_cond_.wait_until(locker, first->first);
+			continue;
+		}
+
+		TID tid = first->second.first;
+		Task task = std::move(first->second.second);
+		delayed_tasks_.erase(first);
+
+		//ͶʱٴͶӳ
+		locker.unlock();
+		PostTask(tid, std::move(task));
+		locker.lock();
+	}
+}
+
+void ThreadManager::SetTaskMode(TID tid, TaskMode mode) {
+	assert(tid != kUI);
+	if (tid == kUI)
+		return;
+
+	modes_[tid] = mode;
+	if (mode == kSequenced && !sequences_[tid]) {
+		sequences_[tid].reset(new SequencedTaskQueue(pool_.get()));
+	} else if (mode == kDedicated && !threads_[tid]) {
+		static const char* names[] = { "IO_Thread","Storage_Thread","Image_Thread" };
+		threads_[tid].reset(new Thread(names[tid]));
+		threads_[tid]->Start();
+	}
+}
+
+ThreadManager::TaskMode ThreadManager::GetTaskMode(TID tid) const {
+	assert(tid != kUI);
+	return modes_[tid];
+}
+
+WorkerPool* ThreadManager::read_pool() {
+	std::lock_guard<std::mutex> locker(read_pool_lock_);
+	if (!read_pool_) {
+		read_pool_.reset(new WorkerPool(kReadThreads));
+	}
+	return read_pool_.get();
+}
+
+ThreadManager::ThreadManager()
+	:pool_(new WorkerPool()),
+	delayed_quit_(false)
+{
+	SetTaskMode(kIO, kParallel);
+	SetTaskMode(kImage, kParallel);
+	//洢Ҫִ֤˳
+	SetTaskMode(kStorage, kSequenced);
 }
 
 
 ThreadManager::~ThreadManager() {
+	{
+		std::lock_guard<std::mutex> locker(delayed_lock_);
+		delayed_quit_ = true;
+		delayed_cond_.notify_one();
+	}
+	if (delayed_thread_) {
+		delayed_thread_->join();
+	}
+
 	for (auto& thread : threads_) {
-		thread->Stop();
-		thread->Join();
-		delete thread;
+		if (thread) {
+			thread->Stop();
+			thread->Join();
+		}
 	}
-}
\ No newline at end of file
+	read_pool_.reset();
+	//ֹ̳ͣ߳أͷе˳
+	pool_.reset();
+}
@@ -7,10 +7,13 @@
 #include <atomic>
 #include <string>
 #include <array>
+#include <map>
+#include <chrono>
+#include <condition_variable>
 #include "waitable_event.h"
+#include "worker_pool.h"
 
 
-using Task = std::function<void()>;
 using TaskHandler = std::function<void(Task)>;
 
 class Thread {
@@ -45,17 +48,49 @@ public:
 		kUI,        //߳
 	};
 
+	//ȷʽ
+	enum TaskMode {
+		kParallel,	//̳߳ϲִ
+		kSequenced,	//̳߳ϰͶ˳ִ
+		kDedicated,	//ڶִ߳
+	};
+
 	static ThreadManager* Instance();
 	static void DestroyInstance();
 
 	void RegisterUITaskHandler(TaskHandler ui_task_handler);
 	void PostTask(TID tid,Task task);
 
+	//delayͶݵtidɶĶʱ̼߳ʱ
+	void PostDelayedTask(TID tid, Task task, uint32_t delay);
+
+	//tidͶ֮ǰãkUI
+	void SetTaskMode(TID tid, TaskMode mode);
+	TaskMode GetTaskMode(TID tid) const;
+
+	WorkerPool* pool() { return pool_.get(); }
+
+	//洢ֻѯʹõĶ̳߳أѯռ̳߳
+	WorkerPool* read_pool();
 protected:
 	ThreadManager();
 	~ThreadManager();
 
+	void RunDelayedTasks();
+
 	static ThreadManager* s_instance_;
-	std::array<Thread*, 3> threads_;
+	std::unique_ptr<WorkerPool> pool_;
+	std::unique_ptr<WorkerPool> read_pool_;
+	std::mutex read_pool_lock_;
+	std::array<TaskMode, 3> modes_;
+	std::array<std::unique_ptr<SequencedTaskQueue>, 3> sequences_;
+	std::array<std::unique_ptr<Thread>, 3> threads_;
 	TaskHandler ui_task_handler_;
+
+	//ʱӳ
+	std::mutex delayed_lock_;
+	std::condition_variable delayed_cond_;
+	std::multimap<std::chrono::steady_clock::time_point, std::pair<TID, Task>> delayed_tasks_;
+	std::unique_ptr<std::thread> delayed_thread_;
+	bool delayed_quit_;
 };
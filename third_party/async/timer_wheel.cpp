@@ -0,0 +1,212 @@
+#include "timer_wheel.h"
+#include <assert.h>
+
+TimerWheel::TimerWheel(uint32_t tick_ms, uint64_t now)
+	:tick_ms_(tick_ms > 0 ? tick_ms : 1)
+{
+	current_ = now / tick_ms_;
+	for (auto& head : root_) {
+		InitList(&head);
+	}
+	for (auto& level : levels_) {
+		for (auto& head : level) {
+			InitList(&head);
+		}
+	}
+}
+
+TimerWheel::~TimerWheel() {
+}
+
+void TimerWheel::InitList(Link* head) {
+	head->prev = head;
+	head->next = head;
+}
+
+void TimerWheel::Unlink(Link* node) {
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->prev = node;
+	node->next = node;
+}
+
+void TimerWheel::Append(Link* head, Link* node) {
+	node->prev = head->prev;
+	node->next = head;
+	head->prev->next = node;
+	head->prev = node;
+}
+
+uint64_t TimerWheel::ToTick(uint64_t ms) const {
+	//ȡ֤ǰ
+	return (ms + tick_ms_ - 1) / tick_ms_;
+}
+
+void TimerWheel::Schedule(uint32_t id, uint64_t now, uint32_t delay, uint32_t interval, Callback callback) {
+	Cancel(id);
+
+	//ڼܾܺûAdvanceֱǰtick´Advancetick׷
+	if (timers_.empty() && now / tick_ms_ > current_)
+		current_ = now / tick_ms_;
+
+	std::unique_ptr<Node> node(new Node());
+	node->id = id;
+	node->expire = ToTick(now + delay);
+	node->interval = interval > 0 ? (uint32_t)ToTick(interval) : 0;
+	node->callback = std::move(callback);
+	InitList(node.get());
+
+	Insert(node.get());
+	timers_[id] = std::move(node);
+}
+
+bool TimerWheel::Cancel(uint32_t id) {
+	auto find = timers_.find(id);
+	if (find == timers_.end())
+		return false;
+
+	Unlink(find->second.get());
+	timers_.erase(find);
+	return true;
+}
+
+void TimerWheel::Insert(Node* node) {
+	uint64_t expire = node->expire;
+	if (expire < current_)
+		expire = current_;
+
+	uint64_t idx = expire - current_;
+	Link* head;
+	if (idx < kRootSize) {
+		head = &root_[expire & kRootMask];
+	} else if (idx < (1ull << (kRootBits + kLevelBits))) {
+		head = &levels_[0][(expire >> kRootBits) & kLevelMask];
+	} else if (idx < (1ull << (kRootBits + 2 * kLevelBits))) {
+		head = &levels_[1][(expire >> (kRootBits + kLevelBits)) & kLevelMask];
+	} else {
+		//Χȷ߲Զλãʱ¼
+		const uint64_t max_idx = (1ull << (kRootBits + 3 * kLevelBits)) - 1;
+		if (idx > max_idx)
+			expire = current_ + max_idx;
+		head = &levels_[2][(expire >> (kRootBits + 2 * kLevelBits)) & kLevelMask];
+	}
+	Append(head, node);
+}
+
+void TimerWheel::Cascade(int level, uint32_t index) {
+	Link list;
+	InitList(&list);
+
+	Link* head = &levels_[level][index];
+	if (head->next == head)
+		return;
+
+	//ժº²뵽Ͳ
+	list.next = head->next;
+	list.prev = head->prev;
+	list.next->prev = &list;
+	list.prev->next = &list;
+	InitList(head);
+
+	while (list.next != &list) {
+		Node* node = static_cast<Node*>(list.next);
+		Unlink(node);
+		Insert(node);
+	}
+}
+
+size_t TimerWheel::Advance(uint64_t now) {
+	uint64_t target = now / tick_ms_;
+	size_t count = 0;
+
+	while (current_ <= target) {
+		if (timers_.empty()) {
+			current_ = target + 1;
+			break;
+		}
+
+		uint32_t index = (uint32_t)(current_ & kRootMask);
+		if (index == 0) {
+			for (int level = 0; level < kLevelCount; ++level) {
+				uint32_t level_index = (uint32_t)(current_ >> (kRootBits + level * kLevelBits)) & kLevelMask;
+				Cascade(level, level_index);
+				if (level_index != 0)
+					break;
+			}
+		}
+
+		Link expired;
+		InitList(&expired);
+		Link* head = &root_[index];
+		if (head->next != head) {
+			expired.next = head->next;
+			expired.prev = head->prev;
+			expired.next->prev = &expired;
+			expired.prev->next = &expired;
+			InitList(head);
+		}
+
+		uint64_t fire_tick = current_++;
+
+		//صпӻȡʱÿֻժһڵ
+		while (expired.next != &expired) {
+			Node* node = static_cast<Node*>(expired.next);
+			Unlink(node);
+			++count;
+
+			if (node->interval > 0) {
+				node->expire = fire_tick + node->interval;
+				Insert(node);
+				Callback callback = node->callback;
+				callback();
+			} else {
+				Callback callback = std::move(node->callback);
+				timers_.erase(node->id);
+				callback();
+			}
+		}
+	}
+	return count;
+}
+
+int64_t TimerWheel::NextTimeout(uint64_t now) const {
+	if (timers_.empty())
+		return -1;
+
+	auto timeout = [this, now](uint64_t tick) {
+		int64_t ms = (int64_t)(tick * tick_ms_) - (int64_t)now;
+		return ms > 0 ? ms : 0;
+	};
+
+	//ɨײһȦӵǰλûƣȦĶʱҲҵ
+	uint64_t tick = current_;
+	for (uint32_t i = 0; i < kRootSize; ++i, ++tick) {
+		if ((tick & kRootMask) == 0 && NeedCascade(tick))
+			return timeout(tick);
+
+		const Link* head = &root_[tick & kRootMask];
+		if (head->next != head)
+			return timeout(tick);
+	}
+
+	//ײѿգһȦʼҵҪλ
+	tick = (current_ | kRootMask) + 1;
+	for (uint32_t i = 0; i < kLevelSize * kLevelSize; ++i) {
+		if (NeedCascade(tick))
+			break;
+		tick += kRootSize;
+	}
+	return timeout(tick);
+}
+
+bool TimerWheel::NeedCascade(uint64_t tick) const {
+	for (int level = 0; level < kLevelCount; ++level) {
+		uint32_t index = (uint32_t)(tick >> (kRootBits + level * kLevelBits)) & kLevelMask;
+		const Link* head = &levels_[level][index];
+		if (head->next != head)
+			return true;
+		if (index != 0)
+			break;
+	}
+	return false;
+}
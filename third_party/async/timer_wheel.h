@@ -0,0 +1,67 @@
+#pragma once
+#include <functional>
+#include <unordered_map>
+#include <memory>
+#include <stdint.h>
+
+//ֲʱ֣ȡO(1)ͬһtickڵڵĶʱһAdvanceִ
+//ʱɵߴ()üʱӲԣ̰߳ȫֻͬһ߳ʹ
+class TimerWheel {
+public:
+	using Callback = std::function<void()>;
+
+	explicit TimerWheel(uint32_t tick_ms = 10, uint64_t now = 0);
+	~TimerWheel();
+
+	//ӶʱidѴʱ滻ԭʱintervalΪ0ʾִֻһ
+	void Schedule(uint32_t id, uint64_t now, uint32_t delay, uint32_t interval, Callback callback);
+	bool Cancel(uint32_t id);
+	bool Has(uint32_t id) const { return timers_.find(id) != timers_.end(); }
+
+	//ִnow֮ǰڵĶʱִеĸ
+	size_t Advance(uint64_t now);
+
+	//һҪAdvanceĺûжʱʱ-1
+	int64_t NextTimeout(uint64_t now) const;
+
+	size_t size() const { return timers_.size(); }
+	bool empty() const { return timers_.empty(); }
+	uint32_t tick() const { return tick_ms_; }
+private:
+	struct Link {
+		Link* prev;
+		Link* next;
+	};
+
+	struct Node :public Link {
+		uint32_t id;
+		uint64_t expire;	//ڵtick
+		uint32_t interval;	//ظtick
+		Callback callback;
+	};
+
+	enum {
+		kRootBits = 8,
+		kLevelBits = 6,
+		kRootSize = 1 << kRootBits,
+		kLevelSize = 1 << kLevelBits,
+		kRootMask = kRootSize - 1,
+		kLevelMask = kLevelSize - 1,
+		kLevelCount = 3,
+	};
+
+	static void InitList(Link* head);
+	static void Unlink(Link* node);
+	static void Append(Link* head, Link* node);
+
+	void Insert(Node* node);
+	void Cascade(int level, uint32_t index);
+	bool NeedCascade(uint64_t tick) const;
+	uint64_t ToTick(uint64_t ms) const;
+
+	uint32_t tick_ms_;
+	uint64_t current_;	//һtick
+	Link root_[kRootSize];
+	Link levels_[kLevelCount][kLevelSize];
+	std::unordered_map<uint32_t, std::unique_ptr<Node>> timers_;
+};
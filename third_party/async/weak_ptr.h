@@ -68,6 +68,15 @@ public:
 		return WeakPtr<T>(weak_impl_);
 	}
 
+protected:
+	//ʱȵãȴ֮WeakPtr::Lock()ؿ
+	//ʱԱѾ٣ܵȵ~WeakObjectÿ
+	void InvalidateWeakPtrs() {
+		weak_impl_->Lock();
+		weak_impl_->ptr = nullptr;
+		weak_impl_->Unlock();
+	}
+
 private:
 	friend class WeakPtr<T>;
 	WeakImpl<T>* weak_impl_;
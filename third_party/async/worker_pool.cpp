@@ -0,0 +1,148 @@
+#include "worker_pool.h"
+#include <assert.h>
+
+//ǰ̳߳߳ؼ±꣬ڰѹ߳ͶݵŵԼĶ
+static thread_local WorkerPool* tls_pool = nullptr;
+static thread_local size_t tls_index = 0;
+
+WorkerPool::WorkerPool(size_t count)
+	:next_worker_(0), pending_(0), quit_(false)
+{
+	if (count == 0)
+		count = std::thread::hardware_concurrency();
+	if (count == 0)
+		count = 2;
+
+	for (size_t i = 0; i < count; ++i) {
+		workers_.emplace_back(new Worker());
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		workers_[i]->thread = std::thread(&WorkerPool::Run, this, i);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> locker(wait_lock_);
+		quit_ = true;
+	}
+	wait_cv_.notify_all();
+
+	for (auto& worker : workers_) {
+		if (worker->thread.joinable())
+			worker->thread.join();
+	}
+}
+
+void WorkerPool::PostTask(Task task) {
+	size_t index;
+	if (tls_pool == this) {
+		index = tls_index;
+	} else {
+		index = next_worker_++ % workers_.size();
+	}
+
+	//ȼӣȡߺ
+	++pending_;
+	{
+		Worker* worker = workers_[index].get();
+		std::lock_guard<std::mutex> locker(worker->lock);
+		worker->tasks.push_back(std::move(task));
+	}
+
+	{
+		std::lock_guard<std::mutex> locker(wait_lock_);
+	}
+	wait_cv_.notify_one();
+}
+
+void WorkerPool::Run(size_t index) {
+	tls_pool = this;
+	tls_index = index;
+
+	while (!quit_) {
+		Task task;
+		if (PopTask(index, task) || StealTask(index, task)) {
+			--pending_;
+			task();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> locker(wait_lock_);
+		wait_cv_.wait(locker, [this]() {
+			return quit_ || pending_ > 0;
+		});
+	}
+
+	tls_pool = nullptr;
+}
+
+bool WorkerPool::PopTask(size_t index, Task& task) {
+	Worker* worker = workers_[index].get();
+	std::lock_guard<std::mutex> locker(worker->lock);
+	if (worker->tasks.empty())
+		return false;
+
+	//ߴӶβȡͶݵݻڻ
+	task = std::move(worker->tasks.back());
+	worker->tasks.pop_back();
+	return true;
+}
+
+bool WorkerPool::StealTask(size_t index, Task& task) {
+	size_t count = workers_.size();
+	for (size_t i = 1; i < count; ++i) {
+		Worker* victim = workers_[(index + i) % count].get();
+		std::lock_guard<std::mutex> locker(victim->lock);
+		if (!victim->tasks.empty()) {
+			//ӶͷȡͶݵ񣬺ߴ
+			task = std::move(victim->tasks.front());
+			victim->tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+
+SequencedTaskQueue::SequencedTaskQueue(WorkerPool* pool)
+	:pool_(pool), running_(false)
+{
+	assert(pool_);
+}
+
+SequencedTaskQueue::~SequencedTaskQueue() {
+}
+
+void SequencedTaskQueue::PostTask(Task task) {
+	bool schedule = false;
+	{
+		std::lock_guard<std::mutex> locker(lock_);
+		tasks_.push(std::move(task));
+		if (!running_) {
+			running_ = true;
+			schedule = true;
+		}
+	}
+
+	if (schedule) {
+		pool_->PostTask(std::bind(&SequencedTaskQueue::RunTasks, this));
+	}
+}
+
+void SequencedTaskQueue::RunTasks() {
+	while (true) {
+		Task task;
+		{
+			std::lock_guard<std::mutex> locker(lock_);
+			if (tasks_.empty()) {
+				running_ = false;
+				return;
+			}
+			task = std::move(tasks_.front());
+			tasks_.pop();
+		}
+		task();
+	}
+}
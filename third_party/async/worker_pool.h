@@ -0,0 +1,58 @@
+#pragma once
+#include <functional>
+#include <deque>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <atomic>
+#include <vector>
+
+using Task = std::function<void()>;
+
+//̳߳أÿ߳ԼУʱ߳ȡ
+class WorkerPool {
+public:
+	//countΪ0ʱcpu
+	explicit WorkerPool(size_t count = 0);
+	~WorkerPool();
+
+	void PostTask(Task task);
+
+	size_t size() const { return workers_.size(); }
+private:
+	struct Worker {
+		std::mutex lock;
+		std::deque<Task> tasks;
+		std::thread thread;
+	};
+
+	void Run(size_t index);
+	bool PopTask(size_t index, Task& task);
+	bool StealTask(size_t index, Task& task);
+
+	std::vector<std::unique_ptr<Worker>> workers_;
+	std::atomic<size_t> next_worker_;
+	std::atomic<size_t> pending_;
+	std::atomic<bool> quit_;
+
+	std::mutex wait_lock_;
+	std::condition_variable wait_cv_;
+};
+
+//̳߳˳ִͬһʱֻһִ
+class SequencedTaskQueue {
+public:
+	SequencedTaskQueue(WorkerPool* pool);
+	~SequencedTaskQueue();
+
+	void PostTask(Task task);
+private:
+	void RunTasks();
+
+	WorkerPool* pool_;
+	std::mutex lock_;
+	std::queue<Task> tasks_;
+	bool running_;
+};
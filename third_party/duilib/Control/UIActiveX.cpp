@@ -1022,12 +1022,19 @@ namespace DuiLib {
 		return true;
 	}
 
+#define ACTIVEX_ATTRIBUTES(X)\
+	X(clsid) X(modulename) X(delaycreate)
+	IMPLEMENT_DUIATTRIBUTES(CActiveXUI, ACTIVEX_ATTRIBUTES)
+
 	void CActiveXUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcscmp(pstrName, _T("clsid")) == 0 ) CreateControl(pstrValue);
-		else if( _tcscmp(pstrName, _T("modulename")) == 0 ) SetModuleName(pstrValue);
-		else if( _tcscmp(pstrName, _T("delaycreate")) == 0 ) SetDelayCreate(_tcscmp(pstrValue, _T("true")) == 0);
-		else CControlUI::SetAttribute(pstrName, pstrValue);
+		using namespace CActiveXUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_clsid: CreateControl(pstrValue); break;
+		case kAttr_modulename: SetModuleName(pstrValue); break;
+		case kAttr_delaycreate: SetDelayCreate(_tcscmp(pstrValue, _T("true")) == 0); break;
+		default: CControlUI::SetAttribute(pstrName, pstrValue); break;
+		}
 	}
 
 	LRESULT CActiveXUI::MessageHandler(UINT uMsg, WPARAM wParam, LPARAM lParam, bool& bHandled)
@@ -58,6 +58,9 @@ namespace DuiLib {
 		bool DoPaint(HDC hDC, const RECT& rcPaint, CControlUI* pStopControl);
 
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 
 		LRESULT MessageHandler(UINT uMsg, WPARAM wParam, LPARAM lParam, bool& bHandled);
 
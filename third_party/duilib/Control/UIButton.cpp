@@ -356,65 +356,80 @@ namespace DuiLib
 		return m_sBindTabLayoutName;
 	}
 
+#define BUTTON_ATTRIBUTES(X)\
+	X(normalimage) X(hotimage) X(pushedimage) X(focusedimage) X(disabledimage) X(hotforeimage)\
+	X(stateimage) X(statecount) X(bindtabindex) X(bindtablayoutname) X(hotbkcolor) X(pushedbkcolor)\
+	X(disabledbkcolor) X(hottextcolor) X(pushedtextcolor) X(focusedtextcolor) X(hotfont) X(pushedfont)\
+	X(focuedfont)
+	IMPLEMENT_DUIATTRIBUTES(CButtonUI, BUTTON_ATTRIBUTES)
+
 	void CButtonUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("pushedimage")) == 0 ) SetPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("disabledimage")) == 0 ) SetDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotforeimage")) == 0 ) SetHotForeImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("stateimage")) == 0 ) SetStateImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("statecount")) == 0 ) SetStateCount(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("bindtabindex")) == 0 ) BindTabIndex(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("bindtablayoutname")) == 0 ) BindTabLayoutName(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotbkcolor")) == 0 )
-		{
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetHotBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("pushedbkcolor")) == 0 )
-		{
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetPushedBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("disabledbkcolor")) == 0 )
-		{
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetDisabledBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("hottextcolor")) == 0 )
-		{
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetHotTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("pushedtextcolor")) == 0 )
-		{
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetPushedTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("focusedtextcolor")) == 0 )
-		{
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetFocusedTextColor(clrColor);
+		using namespace CButtonUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_normalimage: SetNormalImage(pstrValue); break;
+		case kAttr_hotimage: SetHotImage(pstrValue); break;
+		case kAttr_pushedimage: SetPushedImage(pstrValue); break;
+		case kAttr_focusedimage: SetFocusedImage(pstrValue); break;
+		case kAttr_disabledimage: SetDisabledImage(pstrValue); break;
+		case kAttr_hotforeimage: SetHotForeImage(pstrValue); break;
+		case kAttr_stateimage: SetStateImage(pstrValue); break;
+		case kAttr_statecount: SetStateCount(_ttoi(pstrValue)); break;
+		case kAttr_bindtabindex: BindTabIndex(_ttoi(pstrValue)); break;
+		case kAttr_bindtablayoutname: BindTabLayoutName(pstrValue); break;
+		case kAttr_hotbkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetHotBkColor(clrColor);
+			}
+			break;
+		case kAttr_pushedbkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetPushedBkColor(clrColor);
+			}
+			break;
+		case kAttr_disabledbkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetDisabledBkColor(clrColor);
+			}
+			break;
+		case kAttr_hottextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetHotTextColor(clrColor);
+			}
+			break;
+		case kAttr_pushedtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetPushedTextColor(clrColor);
+			}
+			break;
+		case kAttr_focusedtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetFocusedTextColor(clrColor);
+			}
+			break;
+		case kAttr_hotfont: SetHotFont(_ttoi(pstrValue)); break;
+		case kAttr_pushedfont: SetPushedFont(_ttoi(pstrValue)); break;
+		case kAttr_focuedfont: SetFocusedFont(_ttoi(pstrValue)); break;
+		default: CLabelUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else if( _tcsicmp(pstrName, _T("hotfont")) == 0 ) SetHotFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("pushedfont")) == 0 ) SetPushedFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("focuedfont")) == 0 ) SetFocusedFont(_ttoi(pstrValue));
-		
-		else CLabelUI::SetAttribute(pstrName, pstrValue);
 	}
 
 	void CButtonUI::PaintText(HDC hDC)
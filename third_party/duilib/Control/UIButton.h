@@ -64,6 +64,9 @@ namespace DuiLib
 		void SetFocusedTextColor(DWORD dwColor);
 		DWORD GetFocusedTextColor() const;
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 
 		void PaintText(HDC hDC);
 
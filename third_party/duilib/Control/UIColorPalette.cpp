@@ -202,12 +202,19 @@ namespace DuiLib {
 		return m_strThumbImage.GetData();
 	}
 
+#define COLORPALETTE_ATTRIBUTES(X)\
+	X(palletheight) X(barheight) X(thumbimage)
+	IMPLEMENT_DUIATTRIBUTES(CColorPaletteUI, COLORPALETTE_ATTRIBUTES)
+
 	void CColorPaletteUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if (_tcscmp(pstrName, _T("palletheight")) == 0) SetPalletHeight(_ttoi(pstrValue));
-		else if (_tcscmp(pstrName, _T("barheight")) == 0) SetBarHeight(_ttoi(pstrValue));
-		else if (_tcscmp(pstrName, _T("thumbimage")) == 0) SetThumbImage(pstrValue);
-		else CControlUI::SetAttribute(pstrName, pstrValue);
+		using namespace CColorPaletteUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_palletheight: SetPalletHeight(_ttoi(pstrValue)); break;
+		case kAttr_barheight: SetBarHeight(_ttoi(pstrValue)); break;
+		case kAttr_thumbimage: SetThumbImage(pstrValue); break;
+		default: CControlUI::SetAttribute(pstrName, pstrValue); break;
+		}
 	}
 
 	void CColorPaletteUI::DoInit()
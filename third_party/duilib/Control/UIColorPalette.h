@@ -19,6 +19,9 @@ namespace DuiLib {
 		virtual LPCTSTR GetClass() const;
 		virtual LPVOID GetInterface(LPCTSTR pstrName);
 		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		virtual CssSetter GetCssSetter(LPCTSTR pstrName);
 
 		//设置/获取 Pallet（调色板主界面）的高度
 		void SetPalletHeight(int nHeight);
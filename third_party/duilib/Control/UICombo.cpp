@@ -968,192 +968,247 @@ namespace DuiLib {
 	{
 		CControlUI::Move(szOffset, bNeedInvalidate);
 	}
+
+#define COMBO_ATTRIBUTES(X)\
+	X(align) X(valign) X(endellipsis) X(wordbreak) X(font) X(textcolor)\
+	X(disabledtextcolor) X(textpadding) X(showhtml) X(showshadow) X(normalimage) X(hotimage)\
+	X(pushedimage) X(focusedimage) X(disabledimage) X(scrollselect) X(dropbox) X(dropboxsize)\
+	X(itemfont) X(itemalign) X(itemvalign) X(itemendellipsis) X(itemtextpadding) X(itemtextcolor)\
+	X(itembkcolor) X(itembkimage) X(itemaltbk) X(itemselectedtextcolor) X(itemselectedbkcolor) X(itemselectedimage)\
+	X(itemhottextcolor) X(itemhotbkcolor) X(itemhotimage) X(itemdisabledtextcolor) X(itemdisabledbkcolor) X(itemdisabledimage)\
+	X(itemlinecolor) X(itemshowhtml)
+	IMPLEMENT_DUIATTRIBUTES(CComboUI, COMBO_ATTRIBUTES)
+
 	void CComboUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("align")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
-				m_uTextStyle &= ~(DT_CENTER | DT_RIGHT | DT_SINGLELINE);
-				m_uTextStyle |= DT_LEFT;
+		using namespace CComboUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_align:
+			{
+				if( _tcsstr(pstrValue, _T("left")) != NULL ) {
+					m_uTextStyle &= ~(DT_CENTER | DT_RIGHT | DT_SINGLELINE);
+					m_uTextStyle |= DT_LEFT;
+				}
+				if( _tcsstr(pstrValue, _T("center")) != NULL ) {
+					m_uTextStyle &= ~(DT_LEFT | DT_RIGHT );
+					m_uTextStyle |= DT_CENTER;
+				}
+				if( _tcsstr(pstrValue, _T("right")) != NULL ) {
+					m_uTextStyle &= ~(DT_LEFT | DT_CENTER | DT_SINGLELINE);
+					m_uTextStyle |= DT_RIGHT;
+				}
 			}
-			if( _tcsstr(pstrValue, _T("center")) != NULL ) {
-				m_uTextStyle &= ~(DT_LEFT | DT_RIGHT );
-				m_uTextStyle |= DT_CENTER;
+			break;
+		case kAttr_valign:
+			{
+				if( _tcsstr(pstrValue, _T("top")) != NULL ) {
+					m_uTextStyle &= ~(DT_BOTTOM | DT_VCENTER);
+					m_uTextStyle |= (DT_TOP | DT_SINGLELINE);
+				}
+				if( _tcsstr(pstrValue, _T("vcenter")) != NULL ) {
+					m_uTextStyle &= ~(DT_TOP | DT_BOTTOM );            
+					m_uTextStyle |= (DT_VCENTER | DT_SINGLELINE);
+				}
+				if( _tcsstr(pstrValue, _T("bottom")) != NULL ) {
+					m_uTextStyle &= ~(DT_TOP | DT_VCENTER);
+					m_uTextStyle |= (DT_BOTTOM | DT_SINGLELINE);
+				}
 			}
-			if( _tcsstr(pstrValue, _T("right")) != NULL ) {
-				m_uTextStyle &= ~(DT_LEFT | DT_CENTER | DT_SINGLELINE);
-				m_uTextStyle |= DT_RIGHT;
+			break;
+		case kAttr_endellipsis:
+			{
+				if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
+				else m_uTextStyle &= ~DT_END_ELLIPSIS;
 			}
-		}
-		else if( _tcsicmp(pstrName, _T("valign")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("top")) != NULL ) {
-				m_uTextStyle &= ~(DT_BOTTOM | DT_VCENTER);
-				m_uTextStyle |= (DT_TOP | DT_SINGLELINE);
+			break;
+		case kAttr_wordbreak:
+			{
+				if( _tcsicmp(pstrValue, _T("true")) == 0 ) {
+					m_uTextStyle &= ~DT_SINGLELINE;
+					m_uTextStyle |= DT_WORDBREAK | DT_EDITCONTROL;
+				}
+				else {
+					m_uTextStyle &= ~DT_WORDBREAK & ~DT_EDITCONTROL;
+					m_uTextStyle |= DT_SINGLELINE;
+				}
 			}
-			if( _tcsstr(pstrValue, _T("vcenter")) != NULL ) {
-				m_uTextStyle &= ~(DT_TOP | DT_BOTTOM );            
-				m_uTextStyle |= (DT_VCENTER | DT_SINGLELINE);
+			break;
+		case kAttr_font: SetFont(_ttoi(pstrValue)); break;
+		case kAttr_textcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetTextColor(clrColor);
 			}
-			if( _tcsstr(pstrValue, _T("bottom")) != NULL ) {
-				m_uTextStyle &= ~(DT_TOP | DT_VCENTER);
-				m_uTextStyle |= (DT_BOTTOM | DT_SINGLELINE);
+			break;
+		case kAttr_disabledtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetDisabledTextColor(clrColor);
 			}
-		}
-		else if( _tcsicmp(pstrName, _T("endellipsis")) == 0 ) {
-			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
-			else m_uTextStyle &= ~DT_END_ELLIPSIS;
-		}   
-		else if( _tcsicmp(pstrName, _T("wordbreak")) == 0 ) {
-			if( _tcsicmp(pstrValue, _T("true")) == 0 ) {
-				m_uTextStyle &= ~DT_SINGLELINE;
-				m_uTextStyle |= DT_WORDBREAK | DT_EDITCONTROL;
+			break;
+		case kAttr_textpadding:
+			{
+				RECT rcTextPadding = { 0 };
+				LPTSTR pstr = NULL;
+				rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+				SetTextPadding(rcTextPadding);
 			}
-			else {
-				m_uTextStyle &= ~DT_WORDBREAK & ~DT_EDITCONTROL;
-				m_uTextStyle |= DT_SINGLELINE;
+			break;
+		case kAttr_showhtml: SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_showshadow: SetShowShadow(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_normalimage: SetNormalImage(pstrValue); break;
+		case kAttr_hotimage: SetHotImage(pstrValue); break;
+		case kAttr_pushedimage: SetPushedImage(pstrValue); break;
+		case kAttr_focusedimage: SetFocusedImage(pstrValue); break;
+		case kAttr_disabledimage: SetDisabledImage(pstrValue); break;
+		case kAttr_scrollselect: SetScrollSelect(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_dropbox: SetDropBoxAttributeList(pstrValue); break;
+		case kAttr_dropboxsize:
+			{
+				SIZE szDropBoxSize = { 0 };
+				LPTSTR pstr = NULL;
+				szDropBoxSize.cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				szDropBoxSize.cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				SetDropBoxSize(szDropBoxSize);
 			}
-		}    
-		else if( _tcsicmp(pstrName, _T("font")) == 0 ) SetFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("disabledtextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetDisabledTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("textpadding")) == 0 ) {
-			RECT rcTextPadding = { 0 };
-			LPTSTR pstr = NULL;
-			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
-			SetTextPadding(rcTextPadding);
-		}
-		else if( _tcsicmp(pstrName, _T("showhtml")) == 0 ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("showshadow")) == 0 ) SetShowShadow(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("pushedimage")) == 0 ) SetPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("disabledimage")) == 0 ) SetDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("scrollselect")) == 0 ) SetScrollSelect(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("dropbox")) == 0 ) SetDropBoxAttributeList(pstrValue);
-		else if( _tcsicmp(pstrName, _T("dropboxsize")) == 0)
-		{
-			SIZE szDropBoxSize = { 0 };
-			LPTSTR pstr = NULL;
-			szDropBoxSize.cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			szDropBoxSize.cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			SetDropBoxSize(szDropBoxSize);
-		}
-		else if( _tcsicmp(pstrName, _T("itemfont")) == 0 ) SetItemFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("itemalign")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_CENTER | DT_RIGHT);
-				m_ListInfo.uTextStyle |= DT_LEFT;
+			break;
+		case kAttr_itemfont: SetItemFont(_ttoi(pstrValue)); break;
+		case kAttr_itemalign:
+			{
+				if( _tcsstr(pstrValue, _T("left")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_CENTER | DT_RIGHT);
+					m_ListInfo.uTextStyle |= DT_LEFT;
+				}
+				if( _tcsstr(pstrValue, _T("center")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_LEFT | DT_RIGHT);
+					m_ListInfo.uTextStyle |= DT_CENTER;
+				}
+				if( _tcsstr(pstrValue, _T("right")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_LEFT | DT_CENTER);
+					m_ListInfo.uTextStyle |= DT_RIGHT;
+				}
 			}
-			if( _tcsstr(pstrValue, _T("center")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_LEFT | DT_RIGHT);
-				m_ListInfo.uTextStyle |= DT_CENTER;
+			break;
+		case kAttr_itemvalign:
+			{
+				if( _tcsstr(pstrValue, _T("top")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_VCENTER | DT_BOTTOM);
+					m_ListInfo.uTextStyle |= DT_TOP;
+				}
+				if( _tcsstr(pstrValue, _T("vcenter")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_TOP | DT_BOTTOM | DT_WORDBREAK);
+					m_ListInfo.uTextStyle |= DT_VCENTER | DT_SINGLELINE;
+				}
+				if( _tcsstr(pstrValue, _T("bottom")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_TOP | DT_VCENTER);
+					m_ListInfo.uTextStyle |= DT_BOTTOM;
+				}
 			}
-			if( _tcsstr(pstrValue, _T("right")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_LEFT | DT_CENTER);
-				m_ListInfo.uTextStyle |= DT_RIGHT;
+			break;
+		case kAttr_itemendellipsis:
+			{
+				if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_ListInfo.uTextStyle |= DT_END_ELLIPSIS;
+				else m_ListInfo.uTextStyle &= ~DT_END_ELLIPSIS;
 			}
-		}
-		else if( _tcsicmp(pstrName, _T("itemvalign")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("top")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_VCENTER | DT_BOTTOM);
-				m_ListInfo.uTextStyle |= DT_TOP;
+			break;
+		case kAttr_itemtextpadding:
+			{
+				RECT rcTextPadding = { 0 };
+				LPTSTR pstr = NULL;
+				rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+				SetItemTextPadding(rcTextPadding);
 			}
-			if( _tcsstr(pstrValue, _T("vcenter")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_TOP | DT_BOTTOM | DT_WORDBREAK);
-				m_ListInfo.uTextStyle |= DT_VCENTER | DT_SINGLELINE;
+			break;
+		case kAttr_itemtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetItemTextColor(clrColor);
 			}
-			if( _tcsstr(pstrValue, _T("bottom")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_TOP | DT_VCENTER);
-				m_ListInfo.uTextStyle |= DT_BOTTOM;
+			break;
+		case kAttr_itembkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetItemBkColor(clrColor);
 			}
+			break;
+		case kAttr_itembkimage: SetItemBkImage(pstrValue); break;
+		case kAttr_itemaltbk: SetAlternateBk(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_itemselectedtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetSelectedItemTextColor(clrColor);
+			}
+			break;
+		case kAttr_itemselectedbkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetSelectedItemBkColor(clrColor);
+			}
+			break;
+		case kAttr_itemselectedimage: SetSelectedItemImage(pstrValue); break;
+		case kAttr_itemhottextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetHotItemTextColor(clrColor);
+			}
+			break;
+		case kAttr_itemhotbkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetHotItemBkColor(clrColor);
+			}
+			break;
+		case kAttr_itemhotimage: SetHotItemImage(pstrValue); break;
+		case kAttr_itemdisabledtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetDisabledItemTextColor(clrColor);
+			}
+			break;
+		case kAttr_itemdisabledbkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetDisabledItemBkColor(clrColor);
+			}
+			break;
+		case kAttr_itemdisabledimage: SetDisabledItemImage(pstrValue); break;
+		case kAttr_itemlinecolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetItemLineColor(clrColor);
+			}
+			break;
+		case kAttr_itemshowhtml: SetItemShowHtml(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		default: CContainerUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else if( _tcsicmp(pstrName, _T("itemendellipsis")) == 0 ) {
-			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_ListInfo.uTextStyle |= DT_END_ELLIPSIS;
-			else m_ListInfo.uTextStyle &= ~DT_END_ELLIPSIS;
-		}   
-		else if( _tcsicmp(pstrName, _T("itemtextpadding")) == 0 ) {
-			RECT rcTextPadding = { 0 };
-			LPTSTR pstr = NULL;
-			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
-			SetItemTextPadding(rcTextPadding);
-		}
-		else if( _tcsicmp(pstrName, _T("itemtextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetItemTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itembkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetItemBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itembkimage")) == 0 ) SetItemBkImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemaltbk")) == 0 ) SetAlternateBk(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("itemselectedtextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetSelectedItemTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemselectedbkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetSelectedItemBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemselectedimage")) == 0 ) SetSelectedItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemhottextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetHotItemTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemhotbkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetHotItemBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemhotimage")) == 0 ) SetHotItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemdisabledtextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetDisabledItemTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemdisabledbkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetDisabledItemBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemdisabledimage")) == 0 ) SetDisabledItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemlinecolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetItemLineColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemshowhtml")) == 0 ) SetItemShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
 	}
 
 	bool CComboUI::DoPaint(HDC hDC, const RECT& rcPaint, CControlUI* pStopControl)
@@ -115,6 +115,9 @@ namespace DuiLib {
 		void Move(SIZE szOffset, bool bNeedInvalidate = true);
 		void DoEvent(TEventUI& event);
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 
 		bool DoPaint(HDC hDC, const RECT& rcPaint, CControlUI* pStopControl);
 		void PaintText(HDC hDC);
@@ -657,28 +657,39 @@ namespace DuiLib
 		return CControlUI::EstimateSize(szAvailable);
 	}
 
+#define EDIT_ATTRIBUTES(X)\
+	X(readonly) X(numberonly) X(autoselall) X(password) X(passwordchar) X(maxchar)\
+	X(normalimage) X(hotimage) X(focusedimage) X(disabledimage) X(tipvalue) X(tipvaluecolor)\
+	X(nativetextcolor) X(nativebkcolor)
+	IMPLEMENT_DUIATTRIBUTES(CEditUI, EDIT_ATTRIBUTES)
+
 	void CEditUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("readonly")) == 0 ) SetReadOnly(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("numberonly")) == 0 ) SetNumberOnly(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcscmp(pstrName, _T("autoselall")) == 0 ) SetAutoSelAll(_tcscmp(pstrValue, _T("true")) == 0);	
-		else if( _tcsicmp(pstrName, _T("password")) == 0 ) SetPasswordMode(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("passwordchar")) == 0 ) SetPasswordChar(*pstrValue);
-		else if( _tcsicmp(pstrName, _T("maxchar")) == 0 ) SetMaxChar(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("disabledimage")) == 0 ) SetDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("tipvalue")) == 0 ) SetTipValue(pstrValue);
-		else if( _tcsicmp(pstrName, _T("tipvaluecolor")) == 0 ) SetTipValueColor(pstrValue);
-		else if( _tcsicmp(pstrName, _T("nativetextcolor")) == 0 ) SetNativeEditTextColor(pstrValue);
-		else if( _tcsicmp(pstrName, _T("nativebkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetNativeEditBkColor(clrColor);
-		}
-		else CLabelUI::SetAttribute(pstrName, pstrValue);
+		using namespace CEditUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_readonly: SetReadOnly(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_numberonly: SetNumberOnly(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_autoselall: SetAutoSelAll(_tcscmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_password: SetPasswordMode(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_passwordchar: SetPasswordChar(*pstrValue); break;
+		case kAttr_maxchar: SetMaxChar(_ttoi(pstrValue)); break;
+		case kAttr_normalimage: SetNormalImage(pstrValue); break;
+		case kAttr_hotimage: SetHotImage(pstrValue); break;
+		case kAttr_focusedimage: SetFocusedImage(pstrValue); break;
+		case kAttr_disabledimage: SetDisabledImage(pstrValue); break;
+		case kAttr_tipvalue: SetTipValue(pstrValue); break;
+		case kAttr_tipvaluecolor: SetTipValueColor(pstrValue); break;
+		case kAttr_nativetextcolor: SetNativeEditTextColor(pstrValue); break;
+		case kAttr_nativebkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetNativeEditBkColor(clrColor);
+			}
+			break;
+		default: CLabelUI::SetAttribute(pstrName, pstrValue); break;
+		}
 	}
 
 	void CEditUI::PaintStatusImage(HDC hDC)
@@ -65,6 +65,9 @@ namespace DuiLib
 		SIZE EstimateSize(SIZE szAvailable);
 		void DoEvent(TEventUI& event);
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 
 		void PaintStatusImage(HDC hDC);
 		void PaintText(HDC hDC);
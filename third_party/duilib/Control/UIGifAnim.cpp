@@ -1,6 +1,5 @@
 #include "StdAfx.h"
 #include "UIGifAnim.h"
-#include "Utils/stb_image.h"
 
 namespace DuiLib
 {
@@ -12,6 +11,8 @@ IMPLEMENT_DUICONTROL(CGifAnimUI)
 
 CGifAnimUI::CGifAnimUI(void)
 {
+	m_hFrame = NULL;
+	m_pFrameBits = NULL;
 	m_nFramePosition = 0;
 	m_bIsAutoPlay = true;
 	m_bIsAutoSize = false;
@@ -24,11 +25,7 @@ CGifAnimUI::CGifAnimUI(void)
 
 CGifAnimUI::~CGifAnimUI(void)
 {
-	for (int i = 0; i < m_Frames.GetSize(); i++)
-	{
-		AnimFrame* pFrame = (AnimFrame*)m_Frames[i];
-		delete pFrame;
-	}
+	FreeFrame();
 	if (m_pManager)
 		m_pManager->KillTimer(this, EVENT_TIME_ID);
 }
@@ -61,17 +58,19 @@ void CGifAnimUI::SetVisible(bool bVisible /* = true */)
 		Stop();
 }
 
+#define GIFANIM_ATTRIBUTES(X)\
+	X(bkimage) X(autoplay) X(autosize)
+IMPLEMENT_DUIATTRIBUTES(CGifAnimUI, GIFANIM_ATTRIBUTES)
+
 void CGifAnimUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 {
-	if (_tcscmp(pstrName, _T("bkimage")) == 0) SetBkImage(pstrValue);
-	else if (_tcscmp(pstrName, _T("autoplay")) == 0) {
-		SetAutoPlay(_tcscmp(pstrValue, _T("true")) == 0);
+	using namespace CGifAnimUIAttr;
+	switch( GetAttributeId(pstrName) ) {
+	case kAttr_bkimage: SetBkImage(pstrValue); break;
+	case kAttr_autoplay: SetAutoPlay(_tcscmp(pstrValue, _T("true")) == 0); break;
+	case kAttr_autosize: SetAutoSize(_tcscmp(pstrValue, _T("true")) == 0); break;
+	default: CControlUI::SetAttribute(pstrName, pstrValue); break;
 	}
-	else if (_tcscmp(pstrName, _T("autosize")) == 0) {
-		SetAutoSize(_tcscmp(pstrValue, _T("true")) == 0);
-	}
-	else
-		CControlUI::SetAttribute(pstrName, pstrValue);
 }
 
 void CGifAnimUI::SetBkImage(const CDuiString& strImage)
@@ -79,14 +78,7 @@ void CGifAnimUI::SetBkImage(const CDuiString& strImage)
 	if (m_sBkImage == strImage) return;
 	m_sBkImage = strImage;
 	Stop();
-
-	for (int i = 0; i < m_Frames.GetSize(); i++)
-	{
-		AnimFrame* pFrame = (AnimFrame*)m_Frames[i];
-		delete pFrame;
-	}
-	m_Frames.Empty();
-	m_nFramePosition = 0;
+	FreeFrame();
 
 	//
 	if (LoadFromFile(strImage.GetData()))
@@ -97,7 +89,7 @@ void CGifAnimUI::SetBkImage(const CDuiString& strImage)
 			SetFixedHeight(m_nFrameHeight);
 		}
 
-		if (m_bIsAutoPlay && m_Frames.GetSize() > 0)
+		if (m_bIsAutoPlay)
 		{
 			Play();
 		}
@@ -128,7 +120,7 @@ bool CGifAnimUI::IsAutoPlay() const
 void CGifAnimUI::SetAutoSize(bool bIsAuto)
 {
 	m_bIsAutoSize = bIsAuto;
-	if (m_Frames.IsEmpty() == false)
+	if (m_hFrame)
 	{
 		if (m_bIsAutoSize)
 		{
@@ -145,14 +137,12 @@ bool CGifAnimUI::IsAutoSize() const
 
 void CGifAnimUI::Play()
 {
-	if (m_bIsPlaying || m_Frames.IsEmpty())
+	if (m_bIsPlaying || !m_hFrame)
 		return;
 
 	m_nLoopedNum = 0;
 
-	long lPause = ((AnimFrame*)m_Frames[m_nFramePosition])->nDelayMs;
-	if (lPause == 0) lPause = 100;
-	m_pManager->SetTimer(this, EVENT_TIME_ID, lPause);
+	m_pManager->SetTimer(this, EVENT_TIME_ID, GetFrameDelay());
 
 	m_bIsPlaying = true;
 	Invalidate();
@@ -160,7 +150,7 @@ void CGifAnimUI::Play()
 
 void CGifAnimUI::Pause()
 {
-	if (!m_bIsPlaying || m_Frames.IsEmpty())
+	if (!m_bIsPlaying || !m_hFrame)
 		return;
 
 	m_pManager->KillTimer(this, EVENT_TIME_ID);
@@ -174,7 +164,9 @@ void CGifAnimUI::Stop()
 		return;
 
 	m_pManager->KillTimer(this, EVENT_TIME_ID);
-	m_nFramePosition = 0;
+	//صһ֡
+	m_Gif.Rewind();
+	NextFrame();
 	this->Invalidate();
 	m_bIsPlaying = false;
 	m_nLoopedNum = 0;
@@ -194,39 +186,57 @@ void CGifAnimUI::OnTimer(UINT_PTR idEvent)
 
 		if (m_nLoopedNum <= m_nLoopCout)
 		{
-			if (m_Frames.GetSize() > 0)
-				m_nFramePosition = (++m_nFramePosition) % m_Frames.GetSize();
-
-			long lPause = ((AnimFrame*)m_Frames[m_nFramePosition])->nDelayMs;
-			if (lPause == 0) lPause = 100;
-			m_pManager->SetTimer(this, EVENT_TIME_ID, lPause);
+			NextFrame();
+			m_pManager->SetTimer(this, EVENT_TIME_ID, GetFrameDelay());
 		}
 	}
 	else
 	{
-		if (m_Frames.GetSize() > 0)
-			m_nFramePosition = (++m_nFramePosition) % m_Frames.GetSize();
+		NextFrame();
+		m_pManager->SetTimer(this, EVENT_TIME_ID, GetFrameDelay());
+	}
+}
 
-		long lPause = ((AnimFrame*)m_Frames[m_nFramePosition])->nDelayMs;
-		if (lPause == 0) lPause = 100;
-		m_pManager->SetTimer(this, EVENT_TIME_ID, lPause);
+void CGifAnimUI::NextFrame()
+{
+	if (!m_pFrameBits)
+		return;
+	//һ֡ͼƬ߳Ͻãֻ
+	int nFrame = m_Gif.NextFrame(m_pFrameBits);
+	if (nFrame >= 0)
+		m_nFramePosition = nFrame;
+}
+
+long CGifAnimUI::GetFrameDelay() const
+{
+	long lPause = m_Gif.GetDelay(m_nFramePosition);
+	if (lPause == 0) lPause = 100;
+	return lPause;
+}
+
+void CGifAnimUI::FreeFrame()
+{
+	if (m_hFrame)
+	{
+		::DeleteObject(m_hFrame);
+		m_hFrame = NULL;
+		m_pFrameBits = NULL;
 	}
+	m_nFramePosition = 0;
 }
 
 void CGifAnimUI::PaintBkImage(HDC hDC)
 {
 	//Ƶǰ֡
-	if (m_Frames.IsEmpty())
+	if (!m_hFrame)
 	{
 		CControlUI::PaintBkImage(hDC);
 	}
 	else
 	{
-		AnimFrame* pFrame = (AnimFrame*)m_Frames[m_nFramePosition];
-
 		RECT rcDest = m_rcItem;
 		RECT bmpSrc = { 0,0,m_nFrameWidth ,m_nFrameHeight };
-		CRenderEngine::DrawBitmap(hDC, pFrame->hBmpFrame, rcDest, m_rcPaint, bmpSrc,TRUE);
+		CRenderEngine::DrawBitmap(hDC, m_hFrame, rcDest, m_rcPaint, bmpSrc,TRUE);
 	}
 }
 
@@ -248,57 +258,32 @@ bool CGifAnimUI::LoadFromFile(LPCTSTR pstrGifPath)
 
 bool CGifAnimUI::LoadFromMemory(LPVOID pBuf, size_t dwSize)
 {
-	int* delays = NULL;
-	int nFrameCount = 0;
+	FreeFrame();
 	m_nLoopCout = 0;
-	int comp = 0;
-	unsigned char* pData = 
-		stbi_load_gif_from_memory((unsigned char*)pBuf, dwSize, &delays, &m_nFrameWidth, &m_nFrameHeight, &nFrameCount, &comp,4);
-	if (pData)
-	{
-		BITMAPINFO bmi;
-		::ZeroMemory(&bmi, sizeof(BITMAPINFO));
-		bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-		bmi.bmiHeader.biWidth = m_nFrameWidth;
-		bmi.bmiHeader.biHeight = -m_nFrameHeight;
-		bmi.bmiHeader.biPlanes = 1;
-		bmi.bmiHeader.biBitCount = 32;
-		bmi.bmiHeader.biCompression = BI_RGB;
-		bmi.bmiHeader.biSizeImage = (m_nFrameWidth * 32 + 31) / 32 * 4 * m_nFrameHeight;
-
-		for (int nFram = 0; nFram < nFrameCount; nFram++)
-		{
-			LPBYTE pDest = NULL;
-			HBITMAP hBitmap = ::CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, (void**)&pDest, NULL, 0);
-			if (!hBitmap) {
-				stbi_image_free(delays);
-				stbi_image_free(pData);
-				return false;
-			}
-
-			AnimFrame* pframe = new AnimFrame;
-			pframe->nFrameId = nFram;
-			pframe->nDelayMs = delays[nFram];
-
-			LPBYTE pFramBit = pData + m_nFrameWidth * m_nFrameHeight * nFram * 4;
-			for (int i = 0; i < m_nFrameWidth * m_nFrameHeight; i++)
-			{
-				pDest[i * 4 + 3] = pFramBit[i * 4 + 3];
-				pDest[i * 4] = pFramBit[i * 4 + 2];
-				pDest[i * 4 + 1] = pFramBit[i * 4 + 1];
-				pDest[i * 4 + 2] = pFramBit[i * 4];
-			}
-
-			pframe->hBmpFrame = hBitmap;
-			m_Frames.Add(pframe);
-		}
+	//ֻɨ֡ͬһ֮֡ÿȡ֡ʱԤԼһ֡
+	if (!m_Gif.Open((const uint8_t*)pBuf, dwSize))
+		return false;
 
-		stbi_image_free(delays);
-		stbi_image_free(pData);
-		return true;
-	}
+	m_nFrameWidth = m_Gif.GetWidth();
+	m_nFrameHeight = m_Gif.GetHeight();
+	m_nLoopCout = m_Gif.GetLoopCount();
+
+	BITMAPINFO bmi;
+	::ZeroMemory(&bmi, sizeof(BITMAPINFO));
+	bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bmi.bmiHeader.biWidth = m_nFrameWidth;
+	bmi.bmiHeader.biHeight = -m_nFrameHeight;
+	bmi.bmiHeader.biPlanes = 1;
+	bmi.bmiHeader.biBitCount = 32;
+	bmi.bmiHeader.biCompression = BI_RGB;
+	bmi.bmiHeader.biSizeImage = (m_nFrameWidth * 32 + 31) / 32 * 4 * m_nFrameHeight;
+
+	m_hFrame = ::CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, (void**)&m_pFrameBits, NULL, 0);
+	if (!m_hFrame)
+		return false;
 
-	return false;
+	NextFrame();
+	return true;
 }
 
-}//namespace
+}//namespace
\ No newline at end of file
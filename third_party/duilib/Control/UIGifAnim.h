@@ -6,37 +6,6 @@
 namespace DuiLib
 {
 
-typedef struct tagAnimFrame
-{
-	tagAnimFrame()
-	{
-		nFrameId = 0;
-		hBmpFrame = NULL;
-		nDelayMs = 0;
-	};
-	~tagAnimFrame()
-	{
-		if (hBmpFrame)
-		{
-			DeleteObject(hBmpFrame);
-			hBmpFrame = NULL;
-		}
-	}
-	tagAnimFrame& operator=(const tagAnimFrame& value)
-	{
-		nFrameId = value.nFrameId;
-		hBmpFrame = value.hBmpFrame;
-		nDelayMs = value.nDelayMs;
-
-		return *this;
-	};
-
-	UINT32 nFrameId;
-	HBITMAP hBmpFrame;
-	UINT32 nDelayMs;
-}AnimFrame;
-
-
 class UILIB_API CGifAnimUI:public CControlUI
 {
 public:
@@ -51,6 +20,9 @@ public:
 	virtual void	DoEvent(TEventUI& event);
 	virtual void	SetVisible(bool bVisible = true);
 	virtual void	SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+	static int GetAttributeId(LPCTSTR pstrName);
+	static const LPCTSTR* GetAttributeNames(int& nCount);
+	virtual CssSetter	GetCssSetter(LPCTSTR pstrName);
 	virtual void	SetBkImage(const CDuiString& strImage);
 
 	virtual void    PaintBkImage(HDC hDC);
@@ -67,13 +39,19 @@ public:
 	virtual bool	LoadFromFile(LPCTSTR pstrGifPath);
 	virtual bool	LoadFromMemory(LPVOID pBuf, size_t dwSize);
 protected:
-	CStdPtrArray	m_Frames;
+	void	FreeFrame();
+	void	NextFrame();
+	long	GetFrameDelay() const;
+
+	CGifFrameQueue	m_Gif;						// 只保留压缩数据，下一帧在图片线程上预先解码
+	HBITMAP			m_hFrame;					// 当前帧
+	LPBYTE			m_pFrameBits;
 	UINT			m_nFramePosition;			// 当前放到第几帧
 
 	int m_nFrameWidth;
 	int m_nFrameHeight;
 
-	int m_nLoopCout;		//播放几次 0无限循环//stbimg里面，解析gif时似乎没有读取这个值
+	int m_nLoopCout;		//播放几次 0无限循环
 	int m_nLoopedNum;
 
 	CDuiString		m_sBkImage;
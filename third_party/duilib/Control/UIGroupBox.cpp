@@ -134,25 +134,32 @@ namespace DuiLib
 		SIZE cXY = {rcText.right - rcText.left, rcText.bottom - rcText.top};
 		return cXY;
 	}
+
+#define GROUPBOX_ATTRIBUTES(X)\
+	X(textcolor) X(disabledtextcolor) X(font)
+	IMPLEMENT_DUIATTRIBUTES(CGroupBoxUI, GROUPBOX_ATTRIBUTES)
+
 	void CGroupBoxUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) 
-		{
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("disabledtextcolor")) == 0 ) 
-		{
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetDisabledTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("font")) == 0 ) 
-		{
-			SetFont(_ttoi(pstrValue));
+		using namespace CGroupBoxUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_textcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetTextColor(clrColor);
+			}
+			break;
+		case kAttr_disabledtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetDisabledTextColor(clrColor);
+			}
+			break;
+		case kAttr_font: SetFont(_ttoi(pstrValue)); break;
 		}
 
 		CVerticalLayoutUI::SetAttribute(pstrName, pstrValue);
@@ -20,12 +20,15 @@ namespace DuiLib
 		DWORD GetDisabledTextColor() const;
 		void SetFont(int index);
 		int GetFont() const;
+		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		virtual CssSetter GetCssSetter(LPCTSTR pstrName);
 
 	protected:	
 		//Paint
 		virtual void PaintText(HDC hDC);
 		virtual void PaintBorder(HDC hDC);
-		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
 
 	private:
 		SIZE CalcrectSize(SIZE szAvailable);
@@ -440,19 +440,28 @@ namespace DuiLib{
 		return CControlUI::EstimateSize(szAvailable);
 	}
 
+#define HOTKEY_ATTRIBUTES(X)\
+	X(normalimage) X(hotimage) X(focusedimage) X(disabledimage) X(nativebkcolor)
+	IMPLEMENT_DUIATTRIBUTES(CHotKeyUI, HOTKEY_ATTRIBUTES)
+
 	void CHotKeyUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcscmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcscmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcscmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcscmp(pstrName, _T("disabledimage")) == 0 ) SetDisabledImage(pstrValue);
-		else if( _tcscmp(pstrName, _T("nativebkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetNativeBkColor(clrColor);
+		using namespace CHotKeyUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_normalimage: SetNormalImage(pstrValue); break;
+		case kAttr_hotimage: SetHotImage(pstrValue); break;
+		case kAttr_focusedimage: SetFocusedImage(pstrValue); break;
+		case kAttr_disabledimage: SetDisabledImage(pstrValue); break;
+		case kAttr_nativebkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetNativeBkColor(clrColor);
+			}
+			break;
+		default: CLabelUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else CLabelUI::SetAttribute(pstrName, pstrValue);
 	}
 
 	void CHotKeyUI::PaintStatusImage(HDC hDC)
@@ -207,90 +207,110 @@ namespace DuiLib
 		CControlUI::DoEvent(event);
 	}
 
+#define LABEL_ATTRIBUTES(X)\
+	X(align) X(valign) X(endellipsis) X(wordbreak) X(noprefix) X(font)\
+	X(textcolor) X(disabledtextcolor) X(textpadding) X(showhtml) X(autocalcwidth) X(autocalcheight)
+	IMPLEMENT_DUIATTRIBUTES(CLabelUI, LABEL_ATTRIBUTES)
+
 	void CLabelUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("align")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
-				m_uTextStyle &= ~(DT_CENTER | DT_RIGHT);
-				m_uTextStyle |= DT_LEFT;
-			}
-			if( _tcsstr(pstrValue, _T("center")) != NULL ) {
-				m_uTextStyle &= ~(DT_LEFT | DT_RIGHT );
-				m_uTextStyle |= DT_CENTER;
-			}
-			if( _tcsstr(pstrValue, _T("right")) != NULL ) {
-				m_uTextStyle &= ~(DT_LEFT | DT_CENTER);
-				m_uTextStyle |= DT_RIGHT;
+		using namespace CLabelUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_align:
+			{
+				if( _tcsstr(pstrValue, _T("left")) != NULL ) {
+					m_uTextStyle &= ~(DT_CENTER | DT_RIGHT);
+					m_uTextStyle |= DT_LEFT;
+				}
+				if( _tcsstr(pstrValue, _T("center")) != NULL ) {
+					m_uTextStyle &= ~(DT_LEFT | DT_RIGHT );
+					m_uTextStyle |= DT_CENTER;
+				}
+				if( _tcsstr(pstrValue, _T("right")) != NULL ) {
+					m_uTextStyle &= ~(DT_LEFT | DT_CENTER);
+					m_uTextStyle |= DT_RIGHT;
+				}
 			}
-		}
-		else if( _tcsicmp(pstrName, _T("valign")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("top")) != NULL ) {
-				m_uTextStyle &= ~(DT_BOTTOM | DT_VCENTER | DT_WORDBREAK);
-				m_uTextStyle |= (DT_TOP | DT_SINGLELINE);
+			break;
+		case kAttr_valign:
+			{
+				if( _tcsstr(pstrValue, _T("top")) != NULL ) {
+					m_uTextStyle &= ~(DT_BOTTOM | DT_VCENTER | DT_WORDBREAK);
+					m_uTextStyle |= (DT_TOP | DT_SINGLELINE);
+				}
+				if( _tcsstr(pstrValue, _T("vcenter")) != NULL ) {
+					m_uTextStyle &= ~(DT_TOP | DT_BOTTOM | DT_WORDBREAK);            
+					m_uTextStyle |= (DT_VCENTER | DT_SINGLELINE);
+				}
+				if( _tcsstr(pstrValue, _T("bottom")) != NULL ) {
+					m_uTextStyle &= ~(DT_TOP | DT_VCENTER | DT_WORDBREAK);
+					m_uTextStyle |= (DT_BOTTOM | DT_SINGLELINE);
+				}
 			}
-			if( _tcsstr(pstrValue, _T("vcenter")) != NULL ) {
-				m_uTextStyle &= ~(DT_TOP | DT_BOTTOM | DT_WORDBREAK);            
-				m_uTextStyle |= (DT_VCENTER | DT_SINGLELINE);
+			break;
+		case kAttr_endellipsis:
+			{
+				if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
+				else m_uTextStyle &= ~DT_END_ELLIPSIS;
 			}
-			if( _tcsstr(pstrValue, _T("bottom")) != NULL ) {
-				m_uTextStyle &= ~(DT_TOP | DT_VCENTER | DT_WORDBREAK);
-				m_uTextStyle |= (DT_BOTTOM | DT_SINGLELINE);
+			break;
+		case kAttr_wordbreak:
+			{
+				if( _tcsicmp(pstrValue, _T("true")) == 0 ) {
+					m_uTextStyle &= ~DT_SINGLELINE;
+					m_uTextStyle |= DT_WORDBREAK | DT_EDITCONTROL;
+				}
+				else {
+					m_uTextStyle &= ~DT_WORDBREAK & ~DT_EDITCONTROL;
+					m_uTextStyle |= DT_SINGLELINE;
+				}
 			}
-		}
-		else if( _tcsicmp(pstrName, _T("endellipsis")) == 0 ) {
-			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
-			else m_uTextStyle &= ~DT_END_ELLIPSIS;
-		}   
-		else if( _tcsicmp(pstrName, _T("wordbreak")) == 0 ) {
-			if( _tcsicmp(pstrValue, _T("true")) == 0 ) {
-				m_uTextStyle &= ~DT_SINGLELINE;
-				m_uTextStyle |= DT_WORDBREAK | DT_EDITCONTROL;
+			break;
+		case kAttr_noprefix:
+			{
+				if( _tcsicmp(pstrValue, _T("true")) == 0)
+				{
+					m_uTextStyle |= DT_NOPREFIX;
+				}
+				else
+				{
+					m_uTextStyle = m_uTextStyle & ~DT_NOPREFIX;
+				}
 			}
-			else {
-				m_uTextStyle &= ~DT_WORDBREAK & ~DT_EDITCONTROL;
-				m_uTextStyle |= DT_SINGLELINE;
+			break;
+		case kAttr_font: SetFont(_ttoi(pstrValue)); break;
+		case kAttr_textcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetTextColor(clrColor);
 			}
-		}
-		else if( _tcsicmp(pstrName, _T("noprefix")) == 0 ) {
-			if( _tcsicmp(pstrValue, _T("true")) == 0)
+			break;
+		case kAttr_disabledtextcolor:
 			{
-				m_uTextStyle |= DT_NOPREFIX;
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetDisabledTextColor(clrColor);
 			}
-			else
+			break;
+		case kAttr_textpadding:
 			{
-				m_uTextStyle = m_uTextStyle & ~DT_NOPREFIX;
+				RECT rcTextPadding = { 0 };
+				LPTSTR pstr = NULL;
+				rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+				SetTextPadding(rcTextPadding);
 			}
+			break;
+		case kAttr_showhtml: SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_autocalcwidth: SetAutoCalcWidth(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_autocalcheight: SetAutoCalcHeight(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		default: CControlUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else if( _tcsicmp(pstrName, _T("font")) == 0 ) SetFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("disabledtextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetDisabledTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("textpadding")) == 0 ) {
-			RECT rcTextPadding = { 0 };
-			LPTSTR pstr = NULL;
-			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
-			SetTextPadding(rcTextPadding);
-		}
-		else if( _tcsicmp(pstrName, _T("showhtml")) == 0 ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("autocalcwidth")) == 0 ) {
-			SetAutoCalcWidth(_tcsicmp(pstrValue, _T("true")) == 0);
-		}
-		else if( _tcsicmp(pstrName, _T("autocalcheight")) == 0 ) {
-			SetAutoCalcHeight(_tcsicmp(pstrValue, _T("true")) == 0);
-		}
-		else CControlUI::SetAttribute(pstrName, pstrValue);
 	}
 
 	void CLabelUI::PaintText(HDC hDC)
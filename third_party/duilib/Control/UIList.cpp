@@ -883,120 +883,157 @@ namespace DuiLib {
 		m_pList->SetScrollPos(CDuiSize(sz.cx + dx, sz.cy + dy));
 	}
 
+#define LIST_ATTRIBUTES(X)\
+	X(header) X(headerbkimage) X(scrollselect) X(fixedscrollbar) X(multiexpanding) X(itemfont)\
+	X(itemalign) X(itemvalign) X(itemendellipsis) X(itemtextpadding) X(itemtextcolor) X(itembkcolor)\
+	X(itembkimage) X(itemaltbk) X(itemselectedtextcolor) X(itemselectedbkcolor) X(itemselectedimage) X(itemhottextcolor)\
+	X(itemhotbkcolor) X(itemhotimage) X(itemdisabledtextcolor) X(itemdisabledbkcolor) X(itemdisabledimage) X(itemlinecolor)\
+	X(itemshowrowline) X(itemshowcolumnline) X(itemshowhtml) X(multiselect) X(itemrselected)
+	IMPLEMENT_DUIATTRIBUTES(CListUI, LIST_ATTRIBUTES)
+
 	void CListUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("header")) == 0 ) GetHeader()->SetVisible(_tcsicmp(pstrValue, _T("hidden")) != 0);
-		else if( _tcsicmp(pstrName, _T("headerbkimage")) == 0 ) GetHeader()->SetBkImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("scrollselect")) == 0 ) SetScrollSelect(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("fixedscrollbar")) == 0 ) SetFixedScrollbar(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("multiexpanding")) == 0 ) SetMultiExpanding(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("itemfont")) == 0 ) m_ListInfo.nFont = _ttoi(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemalign")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_CENTER | DT_RIGHT);
-				m_ListInfo.uTextStyle |= DT_LEFT;
-			}
-			if( _tcsstr(pstrValue, _T("center")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_LEFT | DT_RIGHT);
-				m_ListInfo.uTextStyle |= DT_CENTER;
-			}
-			if( _tcsstr(pstrValue, _T("right")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_LEFT | DT_CENTER);
-				m_ListInfo.uTextStyle |= DT_RIGHT;
-			}
-		}
-		else if( _tcsicmp(pstrName, _T("itemvalign")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("top")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_VCENTER | DT_BOTTOM);
-				m_ListInfo.uTextStyle |= DT_TOP;
-			}
-			if( _tcsstr(pstrValue, _T("vcenter")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_TOP | DT_BOTTOM | DT_WORDBREAK);
-				m_ListInfo.uTextStyle |= DT_VCENTER | DT_SINGLELINE;
-			}
-			if( _tcsstr(pstrValue, _T("bottom")) != NULL ) {
-				m_ListInfo.uTextStyle &= ~(DT_TOP | DT_VCENTER);
-				m_ListInfo.uTextStyle |= DT_BOTTOM;
-			}
-		}
-		else if( _tcsicmp(pstrName, _T("itemendellipsis")) == 0 ) {
-			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_ListInfo.uTextStyle |= DT_END_ELLIPSIS;
-			else m_ListInfo.uTextStyle &= ~DT_END_ELLIPSIS;
-		}    
-		else if( _tcsicmp(pstrName, _T("itemtextpadding")) == 0 ) {
-			RECT rcTextPadding = { 0 };
-			LPTSTR pstr = NULL;
-			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
-			SetItemTextPadding(rcTextPadding);
-		}
-		else if( _tcsicmp(pstrName, _T("itemtextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetItemTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itembkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetItemBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itembkimage")) == 0 ) SetItemBkImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemaltbk")) == 0 ) SetAlternateBk(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("itemselectedtextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetSelectedItemTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemselectedbkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetSelectedItemBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemselectedimage")) == 0 ) SetSelectedItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemhottextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetHotItemTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemhotbkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetHotItemBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemhotimage")) == 0 ) SetHotItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemdisabledtextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetDisabledItemTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemdisabledbkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetDisabledItemBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemdisabledimage")) == 0 ) SetDisabledItemImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("itemlinecolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetItemLineColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("itemshowrowline")) == 0 ) SetItemShowRowLine(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("itemshowcolumnline")) == 0 ) SetItemShowColumnLine(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("itemshowhtml")) == 0 ) SetItemShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if ( _tcscmp(pstrName, _T("multiselect")) == 0 ) SetMultiSelect(_tcscmp(pstrValue, _T("true")) == 0);
-		else if ( _tcscmp(pstrName, _T("itemrselected")) == 0 ) SetItemRSelected(_tcscmp(pstrValue, _T("true")) == 0);
-		else CVerticalLayoutUI::SetAttribute(pstrName, pstrValue);
+		using namespace CListUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_header: GetHeader()->SetVisible(_tcsicmp(pstrValue, _T("hidden")) != 0); break;
+		case kAttr_headerbkimage: GetHeader()->SetBkImage(pstrValue); break;
+		case kAttr_scrollselect: SetScrollSelect(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_fixedscrollbar: SetFixedScrollbar(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_multiexpanding: SetMultiExpanding(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_itemfont: m_ListInfo.nFont = _ttoi(pstrValue); break;
+		case kAttr_itemalign:
+			{
+				if( _tcsstr(pstrValue, _T("left")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_CENTER | DT_RIGHT);
+					m_ListInfo.uTextStyle |= DT_LEFT;
+				}
+				if( _tcsstr(pstrValue, _T("center")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_LEFT | DT_RIGHT);
+					m_ListInfo.uTextStyle |= DT_CENTER;
+				}
+				if( _tcsstr(pstrValue, _T("right")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_LEFT | DT_CENTER);
+					m_ListInfo.uTextStyle |= DT_RIGHT;
+				}
+			}
+			break;
+		case kAttr_itemvalign:
+			{
+				if( _tcsstr(pstrValue, _T("top")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_VCENTER | DT_BOTTOM);
+					m_ListInfo.uTextStyle |= DT_TOP;
+				}
+				if( _tcsstr(pstrValue, _T("vcenter")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_TOP | DT_BOTTOM | DT_WORDBREAK);
+					m_ListInfo.uTextStyle |= DT_VCENTER | DT_SINGLELINE;
+				}
+				if( _tcsstr(pstrValue, _T("bottom")) != NULL ) {
+					m_ListInfo.uTextStyle &= ~(DT_TOP | DT_VCENTER);
+					m_ListInfo.uTextStyle |= DT_BOTTOM;
+				}
+			}
+			break;
+		case kAttr_itemendellipsis:
+			{
+				if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_ListInfo.uTextStyle |= DT_END_ELLIPSIS;
+				else m_ListInfo.uTextStyle &= ~DT_END_ELLIPSIS;
+			}
+			break;
+		case kAttr_itemtextpadding:
+			{
+				RECT rcTextPadding = { 0 };
+				LPTSTR pstr = NULL;
+				rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+				SetItemTextPadding(rcTextPadding);
+			}
+			break;
+		case kAttr_itemtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetItemTextColor(clrColor);
+			}
+			break;
+		case kAttr_itembkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetItemBkColor(clrColor);
+			}
+			break;
+		case kAttr_itembkimage: SetItemBkImage(pstrValue); break;
+		case kAttr_itemaltbk: SetAlternateBk(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_itemselectedtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetSelectedItemTextColor(clrColor);
+			}
+			break;
+		case kAttr_itemselectedbkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetSelectedItemBkColor(clrColor);
+			}
+			break;
+		case kAttr_itemselectedimage: SetSelectedItemImage(pstrValue); break;
+		case kAttr_itemhottextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetHotItemTextColor(clrColor);
+			}
+			break;
+		case kAttr_itemhotbkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetHotItemBkColor(clrColor);
+			}
+			break;
+		case kAttr_itemhotimage: SetHotItemImage(pstrValue); break;
+		case kAttr_itemdisabledtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetDisabledItemTextColor(clrColor);
+			}
+			break;
+		case kAttr_itemdisabledbkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetDisabledItemBkColor(clrColor);
+			}
+			break;
+		case kAttr_itemdisabledimage: SetDisabledItemImage(pstrValue); break;
+		case kAttr_itemlinecolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetItemLineColor(clrColor);
+			}
+			break;
+		case kAttr_itemshowrowline: SetItemShowRowLine(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_itemshowcolumnline: SetItemShowColumnLine(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_itemshowhtml: SetItemShowHtml(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_multiselect: SetMultiSelect(_tcscmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_itemrselected: SetItemRSelected(_tcscmp(pstrValue, _T("true")) == 0); break;
+		default: CVerticalLayoutUI::SetAttribute(pstrName, pstrValue); break;
+		}
 	}
 
 	IListCallbackUI* CListUI::GetTextCallback() const
@@ -1735,56 +1772,75 @@ namespace DuiLib {
 		return m_nScale;
 	}
 
+#define LISTHEADERITEM_ATTRIBUTES(X)\
+	X(dragable) X(sepwidth) X(align) X(endellipsis) X(font) X(textcolor)\
+	X(textpadding) X(showhtml) X(normalimage) X(hotimage) X(pushedimage) X(focusedimage)\
+	X(sepimage) X(scale)
+	IMPLEMENT_DUIATTRIBUTES(CListHeaderItemUI, LISTHEADERITEM_ATTRIBUTES)
+
 	void CListHeaderItemUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("dragable")) == 0 ) SetDragable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("sepwidth")) == 0 ) SetSepWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("align")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
-				m_uTextStyle &= ~(DT_CENTER | DT_RIGHT);
-				m_uTextStyle |= DT_LEFT;
-			}
-			if( _tcsstr(pstrValue, _T("center")) != NULL ) {
-				m_uTextStyle &= ~(DT_LEFT | DT_RIGHT);
-				m_uTextStyle |= DT_CENTER;
-			}
-			if( _tcsstr(pstrValue, _T("right")) != NULL ) {
-				m_uTextStyle &= ~(DT_LEFT | DT_CENTER);
-				m_uTextStyle |= DT_RIGHT;
-			}
-		}
-		else if( _tcsicmp(pstrName, _T("endellipsis")) == 0 ) {
-			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
-			else m_uTextStyle &= ~DT_END_ELLIPSIS;
-		}    
-		else if( _tcsicmp(pstrName, _T("font")) == 0 ) SetFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("textpadding")) == 0 ) {
-			RECT rcTextPadding = { 0 };
-			LPTSTR pstr = NULL;
-			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
-			SetTextPadding(rcTextPadding);
-		}
-		else if( _tcsicmp(pstrName, _T("showhtml")) == 0 ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("pushedimage")) == 0 ) SetPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("sepimage")) == 0 ) SetSepImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("scale")) == 0 ) {
-			LPTSTR pstr = NULL;
-			SetScale(_tcstol(pstrValue, &pstr, 10)); 
+		using namespace CListHeaderItemUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_dragable: SetDragable(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_sepwidth: SetSepWidth(_ttoi(pstrValue)); break;
+		case kAttr_align:
+			{
+				if( _tcsstr(pstrValue, _T("left")) != NULL ) {
+					m_uTextStyle &= ~(DT_CENTER | DT_RIGHT);
+					m_uTextStyle |= DT_LEFT;
+				}
+				if( _tcsstr(pstrValue, _T("center")) != NULL ) {
+					m_uTextStyle &= ~(DT_LEFT | DT_RIGHT);
+					m_uTextStyle |= DT_CENTER;
+				}
+				if( _tcsstr(pstrValue, _T("right")) != NULL ) {
+					m_uTextStyle &= ~(DT_LEFT | DT_CENTER);
+					m_uTextStyle |= DT_RIGHT;
+				}
+			}
+			break;
+		case kAttr_endellipsis:
+			{
+				if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
+				else m_uTextStyle &= ~DT_END_ELLIPSIS;
+			}
+			break;
+		case kAttr_font: SetFont(_ttoi(pstrValue)); break;
+		case kAttr_textcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetTextColor(clrColor);
+			}
+			break;
+		case kAttr_textpadding:
+			{
+				RECT rcTextPadding = { 0 };
+				LPTSTR pstr = NULL;
+				rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+				SetTextPadding(rcTextPadding);
+			}
+			break;
+		case kAttr_showhtml: SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_normalimage: SetNormalImage(pstrValue); break;
+		case kAttr_hotimage: SetHotImage(pstrValue); break;
+		case kAttr_pushedimage: SetPushedImage(pstrValue); break;
+		case kAttr_focusedimage: SetFocusedImage(pstrValue); break;
+		case kAttr_sepimage: SetSepImage(pstrValue); break;
+		case kAttr_scale:
+			{
+				LPTSTR pstr = NULL;
+				SetScale(_tcstol(pstrValue, &pstr, 10)); 
 
+			}
+			break;
+		default: CContainerUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
 	}
 
 	void CListHeaderItemUI::DoEvent(TEventUI& event)
@@ -202,6 +202,9 @@ namespace DuiLib {
 		void Move(SIZE szOffset, bool bNeedInvalidate = true);
 		void DoEvent(TEventUI& event);
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 
 		IListCallbackUI* GetTextCallback() const;
 		void SetTextCallback(IListCallbackUI* pCallback);
@@ -342,6 +345,9 @@ namespace DuiLib {
 		void DoEvent(TEventUI& event);
 		SIZE EstimateSize(SIZE szAvailable);
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 		RECT GetThumbRect() const;
 
 		void PaintText(HDC hDC);
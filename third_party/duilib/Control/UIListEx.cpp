@@ -514,69 +514,82 @@ namespace DuiLib {
 		Invalidate();
 	}
 
+#define LISTCONTAINERHEADERITEM_ATTRIBUTES(X)\
+	X(dragable) X(sepwidth) X(align) X(endellipsis) X(font) X(textcolor)\
+	X(textpadding) X(showhtml) X(normalimage) X(hotimage) X(pushedimage) X(focusedimage)\
+	X(sepimage) X(editable) X(comboable) X(checkable) X(checkboxwidth) X(checkboxheight)\
+	X(checkboxnormalimage) X(checkboxhotimage) X(checkboxpushedimage) X(checkboxfocusedimage) X(checkboxdisabledimage) X(checkboxselectedimage)\
+	X(checkboxforeimage)
+	IMPLEMENT_DUIATTRIBUTES(CListContainerHeaderItemUI, LISTCONTAINERHEADERITEM_ATTRIBUTES)
+
 	void CListContainerHeaderItemUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("dragable")) == 0 ) SetDragable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("sepwidth")) == 0 ) SetSepWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("align")) == 0 ) 
-		{
-			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
-				m_uTextStyle &= ~(DT_CENTER | DT_RIGHT);
-				m_uTextStyle |= DT_LEFT;
+		using namespace CListContainerHeaderItemUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_dragable: SetDragable(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_sepwidth: SetSepWidth(_ttoi(pstrValue)); break;
+		case kAttr_align:
+			{
+				if( _tcsstr(pstrValue, _T("left")) != NULL ) {
+					m_uTextStyle &= ~(DT_CENTER | DT_RIGHT);
+					m_uTextStyle |= DT_LEFT;
+				}
+				if( _tcsstr(pstrValue, _T("center")) != NULL ) {
+					m_uTextStyle &= ~(DT_LEFT | DT_RIGHT);
+					m_uTextStyle |= DT_CENTER;
+				}
+				if( _tcsstr(pstrValue, _T("right")) != NULL ) {
+					m_uTextStyle &= ~(DT_LEFT | DT_CENTER);
+					m_uTextStyle |= DT_RIGHT;
+				}
 			}
-			if( _tcsstr(pstrValue, _T("center")) != NULL ) {
-				m_uTextStyle &= ~(DT_LEFT | DT_RIGHT);
-				m_uTextStyle |= DT_CENTER;
+			break;
+		case kAttr_endellipsis:
+			{
+				if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
+				else m_uTextStyle &= ~DT_END_ELLIPSIS;
 			}
-			if( _tcsstr(pstrValue, _T("right")) != NULL ) {
-				m_uTextStyle &= ~(DT_LEFT | DT_CENTER);
-				m_uTextStyle |= DT_RIGHT;
+			break;
+		case kAttr_font: SetFont(_ttoi(pstrValue)); break;
+		case kAttr_textcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetTextColor(clrColor);
 			}
+			break;
+		case kAttr_textpadding:
+			{
+				RECT rcTextPadding = { 0 };
+				LPTSTR pstr = NULL;
+				rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);
+				rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);
+				rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);
+				rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10);
+				SetTextPadding(rcTextPadding);
+			}
+			break;
+		case kAttr_showhtml: SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_normalimage: SetNormalImage(pstrValue); break;
+		case kAttr_hotimage: SetHotImage(pstrValue); break;
+		case kAttr_pushedimage: SetPushedImage(pstrValue); break;
+		case kAttr_focusedimage: SetFocusedImage(pstrValue); break;
+		case kAttr_sepimage: SetSepImage(pstrValue); break;
+		case kAttr_editable: SetColumeEditable(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_comboable: SetColumeComboable(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_checkable: SetColumeCheckable(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_checkboxwidth: SetCheckBoxWidth(_ttoi(pstrValue)); break;
+		case kAttr_checkboxheight: SetCheckBoxHeight(_ttoi(pstrValue)); break;
+		case kAttr_checkboxnormalimage: SetCheckBoxNormalImage(pstrValue); break;
+		case kAttr_checkboxhotimage: SetCheckBoxHotImage(pstrValue); break;
+		case kAttr_checkboxpushedimage: SetCheckBoxPushedImage(pstrValue); break;
+		case kAttr_checkboxfocusedimage: SetCheckBoxFocusedImage(pstrValue); break;
+		case kAttr_checkboxdisabledimage: SetCheckBoxDisabledImage(pstrValue); break;
+		case kAttr_checkboxselectedimage: SetCheckBoxSelectedImage(pstrValue); break;
+		case kAttr_checkboxforeimage: SetCheckBoxForeImage(pstrValue); break;
+		default: CContainerUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else if( _tcsicmp(pstrName, _T("endellipsis")) == 0 ) 
-		{
-			if( _tcsicmp(pstrValue, _T("true")) == 0 ) m_uTextStyle |= DT_END_ELLIPSIS;
-			else m_uTextStyle &= ~DT_END_ELLIPSIS;
-		}    
-		else if( _tcsicmp(pstrName, _T("font")) == 0 ) SetFont(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("textcolor")) == 0 ) 
-		{
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("textpadding")) == 0 ) 
-		{
-			RECT rcTextPadding = { 0 };
-			LPTSTR pstr = NULL;
-			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);
-			rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);
-			rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);
-			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10);
-			SetTextPadding(rcTextPadding);
-		}
-		else if( _tcsicmp(pstrName, _T("showhtml")) == 0 ) SetShowHtml(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("pushedimage")) == 0 ) SetPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("sepimage")) == 0 ) SetSepImage(pstrValue);
-
-		else if( _tcsicmp(pstrName, _T("editable")) == 0 ) SetColumeEditable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("comboable")) == 0 ) SetColumeComboable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("checkable")) == 0 ) SetColumeCheckable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("checkboxwidth")) == 0 ) SetCheckBoxWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("checkboxheight")) == 0 ) SetCheckBoxHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("checkboxnormalimage")) == 0 ) SetCheckBoxNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxhotimage")) == 0 ) SetCheckBoxHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxpushedimage")) == 0 ) SetCheckBoxPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxfocusedimage")) == 0 ) SetCheckBoxFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxdisabledimage")) == 0 ) SetCheckBoxDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxselectedimage")) == 0 ) SetCheckBoxSelectedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxforeimage")) == 0 ) SetCheckBoxForeImage(pstrValue);
-
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
 	}
 
 	void CListContainerHeaderItemUI::DoEvent(TEventUI& event)
@@ -1376,18 +1389,27 @@ Label_ForeImage:
 	{
 		return CRenderEngine::DrawImageString(hDC, m_pManager, rcCheckBox, m_rcPaint, pStrImage, pStrModify);
 	}
+
+#define LISTTEXTEXTELEMENT_ATTRIBUTES(X)\
+	X(checkboxwidth) X(checkboxheight) X(checkboxnormalimage) X(checkboxhotimage) X(checkboxpushedimage) X(checkboxfocusedimage)\
+	X(checkboxdisabledimage) X(checkboxselectedimage) X(checkboxforeimage)
+	IMPLEMENT_DUIATTRIBUTES(CListTextExtElementUI, LISTTEXTEXTELEMENT_ATTRIBUTES)
+
 	void CListTextExtElementUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("checkboxwidth")) == 0 ) SetCheckBoxWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("checkboxheight")) == 0 ) SetCheckBoxHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("checkboxnormalimage")) == 0 ) SetCheckBoxNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxhotimage")) == 0 ) SetCheckBoxHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxpushedimage")) == 0 ) SetCheckBoxPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxfocusedimage")) == 0 ) SetCheckBoxFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxdisabledimage")) == 0 ) SetCheckBoxDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxselectedimage")) == 0 ) SetCheckBoxSelectedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("checkboxforeimage")) == 0 ) SetCheckBoxForeImage(pstrValue);
-		else CListLabelElementUI::SetAttribute(pstrName, pstrValue);
+		using namespace CListTextExtElementUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_checkboxwidth: SetCheckBoxWidth(_ttoi(pstrValue)); break;
+		case kAttr_checkboxheight: SetCheckBoxHeight(_ttoi(pstrValue)); break;
+		case kAttr_checkboxnormalimage: SetCheckBoxNormalImage(pstrValue); break;
+		case kAttr_checkboxhotimage: SetCheckBoxHotImage(pstrValue); break;
+		case kAttr_checkboxpushedimage: SetCheckBoxPushedImage(pstrValue); break;
+		case kAttr_checkboxfocusedimage: SetCheckBoxFocusedImage(pstrValue); break;
+		case kAttr_checkboxdisabledimage: SetCheckBoxDisabledImage(pstrValue); break;
+		case kAttr_checkboxselectedimage: SetCheckBoxSelectedImage(pstrValue); break;
+		case kAttr_checkboxforeimage: SetCheckBoxForeImage(pstrValue); break;
+		default: CListLabelElementUI::SetAttribute(pstrName, pstrValue); break;
+		}
 	}
 	LPCTSTR CListTextExtElementUI::GetCheckBoxNormalImage()
 	{
@@ -112,6 +112,9 @@ namespace DuiLib {
 		void DoEvent(TEventUI& event);
 		SIZE EstimateSize(SIZE szAvailable);
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 		RECT GetThumbRect() const;
 
 		void PaintText(HDC hDC);
@@ -257,6 +260,9 @@ namespace DuiLib {
 	public:
 		virtual bool DoPaint(HDC hDC, const RECT& rcPaint, CControlUI* pStopControl);
 		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		virtual CssSetter GetCssSetter(LPCTSTR pstrName);
 		virtual void PaintStatusImage(HDC hDC);
 		BOOL DrawCheckBoxImage(HDC hDC, LPCTSTR pStrImage, LPCTSTR pStrModify, RECT& rcCheckBox);
 		LPCTSTR GetCheckBoxNormalImage();
@@ -1144,62 +1144,71 @@ namespace DuiLib {
 		m_bShowExplandIcon = bShow;
 	}
 
+#define MENUELEMENT_ATTRIBUTES(X)\
+	X(icon) X(iconsize) X(checkitem) X(ischeck) X(linetype) X(expland)\
+	X(linecolor) X(linepadding) X(height)
+	IMPLEMENT_DUIATTRIBUTES(CMenuElementUI, MENUELEMENT_ATTRIBUTES)
+
 	void CMenuElementUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("icon")) == 0){
-			SetIcon(pstrValue);
-		}
-		else if( _tcsicmp(pstrName, _T("iconsize")) == 0 ) {
-			LPTSTR pstr = NULL;
-			LONG cx = 0, cy = 0;
-			cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);   
-			SetIconSize(cx, cy);
-		}
-		else if( _tcsicmp(pstrName, _T("checkitem")) == 0 ) {		
-			SetCheckItem(_tcsicmp(pstrValue, _T("true")) == 0 ? true : false);		
-		}
-		else if( _tcsicmp(pstrName, _T("ischeck")) == 0 ) {		
-			CStdStringPtrMap* mCheckInfos = CMenuWnd::GetGlobalContextMenuObserver().GetMenuCheckInfo();
-			if (mCheckInfos != NULL)
+		using namespace CMenuElementUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_icon: SetIcon(pstrValue); break;
+		case kAttr_iconsize:
 			{
-				bool bFind = false;
-				for(int i = 0; i < mCheckInfos->GetSize(); i++) {
-					MenuItemInfo* itemInfo = (MenuItemInfo*)mCheckInfos->GetAt(i);
-					if(lstrcmpi(itemInfo->szName, GetName()) == 0) {
-						bFind = true;
-						break;
+				LPTSTR pstr = NULL;
+				LONG cx = 0, cy = 0;
+				cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);   
+				SetIconSize(cx, cy);
+			}
+			break;
+		case kAttr_checkitem: SetCheckItem(_tcsicmp(pstrValue, _T("true")) == 0 ? true : false); break;
+		case kAttr_ischeck:
+			{		
+				CStdStringPtrMap* mCheckInfos = CMenuWnd::GetGlobalContextMenuObserver().GetMenuCheckInfo();
+				if (mCheckInfos != NULL)
+				{
+					bool bFind = false;
+					for(int i = 0; i < mCheckInfos->GetSize(); i++) {
+						MenuItemInfo* itemInfo = (MenuItemInfo*)mCheckInfos->GetAt(i);
+						if(lstrcmpi(itemInfo->szName, GetName()) == 0) {
+							bFind = true;
+							break;
+						}
 					}
+					if(!bFind) SetChecked(_tcsicmp(pstrValue, _T("true")) == 0 ? true : false);
 				}
-				if(!bFind) SetChecked(_tcsicmp(pstrValue, _T("true")) == 0 ? true : false);
 			}
-		}	
-		else if( _tcsicmp(pstrName, _T("linetype")) == 0){
-			if (_tcsicmp(pstrValue, _T("true")) == 0)
-				SetLineType();
-		}
-		else if( _tcsicmp(pstrName, _T("expland")) == 0 ) {
-			SetShowExplandIcon(_tcsicmp(pstrValue, _T("true")) == 0 ? true : false);
-		}
-		else if( _tcsicmp(pstrName, _T("linecolor")) == 0){
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			SetLineColor(_tcstoul(pstrValue, &pstr, 16));
-		}
-		else if( _tcsicmp(pstrName, _T("linepadding")) == 0 ) {
-			RECT rcInset = { 0 };
-			LPTSTR pstr = NULL;
-			rcInset.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			rcInset.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			rcInset.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-			rcInset.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
-			SetLinePadding(rcInset);
-		}
-		else if	( _tcsicmp(pstrName, _T("height")) == 0){
-			SetFixedHeight(_ttoi(pstrValue));
+			break;
+		case kAttr_linetype:
+			{
+				if (_tcsicmp(pstrValue, _T("true")) == 0)
+					SetLineType();
+			}
+			break;
+		case kAttr_expland: SetShowExplandIcon(_tcsicmp(pstrValue, _T("true")) == 0 ? true : false); break;
+		case kAttr_linecolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				SetLineColor(_tcstoul(pstrValue, &pstr, 16));
+			}
+			break;
+		case kAttr_linepadding:
+			{
+				RECT rcInset = { 0 };
+				LPTSTR pstr = NULL;
+				rcInset.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				rcInset.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				rcInset.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
+				rcInset.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+				SetLinePadding(rcInset);
+			}
+			break;
+		case kAttr_height: SetFixedHeight(_ttoi(pstrValue)); break;
+		default: CListContainerElementUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else
-			CListContainerElementUI::SetAttribute(pstrName, pstrValue);
 	}
 
 
@@ -376,6 +376,9 @@ public:
 	void DrawItemExpland(HDC hDC, const RECT& rcItem);
 
 	void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+	static int GetAttributeId(LPCTSTR pstrName);
+	static const LPCTSTR* GetAttributeNames(int& nCount);
+	CssSetter GetCssSetter(LPCTSTR pstrName);
 
 	MenuItemInfo* GetItemInfo(LPCTSTR pstrName);
 	MenuItemInfo* SetItemInfo(LPCTSTR pstrName, bool bChecked);
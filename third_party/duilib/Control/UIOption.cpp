@@ -207,30 +207,43 @@ namespace DuiLib
 	{
 		return m_iSelectedFont;
 	}
+
+#define OPTION_ATTRIBUTES(X)\
+	X(group) X(selected) X(selectedimage) X(selectedhotimage) X(selectedpushedimage) X(selectedforeimage)\
+	X(selectedstateimage) X(selectedstatecount) X(selectedbkcolor) X(selectedtextcolor) X(selectedfont)
+	IMPLEMENT_DUIATTRIBUTES(COptionUI, OPTION_ATTRIBUTES)
+
 	void COptionUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("group")) == 0 ) SetGroup(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selected")) == 0 ) Selected(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("selectedimage")) == 0 ) SetSelectedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selectedhotimage")) == 0 ) SetSelectedHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selectedpushedimage")) == 0 ) SetSelectedPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selectedforeimage")) == 0 ) SetSelectedForedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selectedstateimage")) == 0 ) SetSelectedStateImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("selectedstatecount")) == 0 ) SetSelectedStateCount(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("selectedbkcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetSelectedBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("selectedtextcolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetSelectedTextColor(clrColor);
+		using namespace COptionUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_group: SetGroup(pstrValue); break;
+		case kAttr_selected: Selected(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_selectedimage: SetSelectedImage(pstrValue); break;
+		case kAttr_selectedhotimage: SetSelectedHotImage(pstrValue); break;
+		case kAttr_selectedpushedimage: SetSelectedPushedImage(pstrValue); break;
+		case kAttr_selectedforeimage: SetSelectedForedImage(pstrValue); break;
+		case kAttr_selectedstateimage: SetSelectedStateImage(pstrValue); break;
+		case kAttr_selectedstatecount: SetSelectedStateCount(_ttoi(pstrValue)); break;
+		case kAttr_selectedbkcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetSelectedBkColor(clrColor);
+			}
+			break;
+		case kAttr_selectedtextcolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetSelectedTextColor(clrColor);
+			}
+			break;
+		case kAttr_selectedfont: SetSelectedFont(_ttoi(pstrValue)); break;
+		default: CButtonUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else if( _tcsicmp(pstrName, _T("selectedfont")) == 0 ) SetSelectedFont(_ttoi(pstrValue));
-		else CButtonUI::SetAttribute(pstrName, pstrValue);
 	}
 
 	void COptionUI::PaintBkColor(HDC hDC)
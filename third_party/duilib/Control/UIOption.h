@@ -52,6 +52,9 @@ namespace DuiLib
 		virtual void Selected(bool bSelected);
 
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 
 		void PaintBkColor(HDC hDC);
 		void PaintStatusImage(HDC hDC);
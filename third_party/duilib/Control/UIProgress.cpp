@@ -89,14 +89,21 @@ namespace DuiLib
 		UpdateText();
 	}
 
+#define PROGRESS_ATTRIBUTES(X)\
+	X(hor) X(min) X(max) X(value) X(isstretchfore)
+	IMPLEMENT_DUIATTRIBUTES(CProgressUI, PROGRESS_ATTRIBUTES)
+
 	void CProgressUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("hor")) == 0 ) SetHorizontal(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("min")) == 0 ) SetMinValue(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("max")) == 0 ) SetMaxValue(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("value")) == 0 ) SetValue(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("isstretchfore"))==0) SetStretchForeImage(_tcsicmp(pstrValue, _T("true")) == 0? true : false);
-		else CLabelUI::SetAttribute(pstrName, pstrValue);
+		using namespace CProgressUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_hor: SetHorizontal(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_min: SetMinValue(_ttoi(pstrValue)); break;
+		case kAttr_max: SetMaxValue(_ttoi(pstrValue)); break;
+		case kAttr_value: SetValue(_ttoi(pstrValue)); break;
+		case kAttr_isstretchfore: SetStretchForeImage(_tcsicmp(pstrValue, _T("true")) == 0? true : false); break;
+		default: CLabelUI::SetAttribute(pstrName, pstrValue); break;
+		}
 	}
 
 	void CProgressUI::PaintForeColor(HDC hDC)
@@ -28,6 +28,9 @@ namespace DuiLib
 		int GetValue() const;
 		void SetValue(int nValue);
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 		void PaintForeColor(HDC hDC);
 		void PaintForeImage(HDC hDC);
 		virtual void UpdateText();
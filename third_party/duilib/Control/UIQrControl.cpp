@@ -53,6 +53,13 @@ void CQrControlUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 		CControlUI::SetAttribute(pstrName,pstrValue);
 }
 
+CssSetter CQrControlUI::GetCssSetter(LPCTSTR pstrName)
+{
+	// textǶάݣCControlUI::SetText
+	if (_tcscmp(pstrName,L"text")==0) return NULL;
+	return CControlUI::GetCssSetter(pstrName);
+}
+
 static int GetEncoderClsid(const WCHAR* format, CLSID* pClsid)
 {
 	UINT num = 0;                     // number of image encoders   
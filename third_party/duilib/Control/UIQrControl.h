@@ -13,6 +13,7 @@ public:
 	void SetText(LPCTSTR text);//ı
 	virtual void PaintStatusImage(HDC hDC);//ƶά
 	virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+	virtual CssSetter GetCssSetter(LPCTSTR pstrName);
 
 	LPCTSTR GetClass() const { return _T("QrControlUI"); }
 
@@ -2415,97 +2415,106 @@ err:
 		}
 	}
 
+#define RICHEDIT_ATTRIBUTES(X)\
+	X(vscrollbar) X(autovscroll) X(hscrollbar) X(autohscroll) X(multiline) X(wanttab)\
+	X(wantreturn) X(wantctrlreturn) X(transparent) X(rich) X(readonly) X(password)\
+	X(align) X(font) X(textcolor) X(maxchar) X(normalimage) X(hotimage)\
+	X(focusedimage) X(disabledimage) X(textpadding) X(tipvalue) X(tipvaluecolor) X(tipvaluealign)
+	IMPLEMENT_DUIATTRIBUTES(CRichEditUI, RICHEDIT_ATTRIBUTES)
+
 	void CRichEditUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcscmp(pstrName, _T("vscrollbar")) == 0 ) {
+		using namespace CRichEditUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		// 这几个属性设置样式后还要交给基类处理
+		case kAttr_vscrollbar:
 			if( _tcscmp(pstrValue, _T("true")) == 0 ) m_lTwhStyle |= ES_DISABLENOSCROLL | WS_VSCROLL;
-		}
-		if( _tcscmp(pstrName, _T("autovscroll")) == 0 ) {
+			CContainerUI::SetAttribute(pstrName, pstrValue);
+			break;
+		case kAttr_autovscroll:
 			if( _tcscmp(pstrValue, _T("true")) == 0 ) m_lTwhStyle |= ES_AUTOVSCROLL;
-		}
-		else if( _tcscmp(pstrName, _T("hscrollbar")) == 0 ) {
+			CContainerUI::SetAttribute(pstrName, pstrValue);
+			break;
+		case kAttr_hscrollbar:
 			if( _tcscmp(pstrValue, _T("true")) == 0 ) m_lTwhStyle |= ES_DISABLENOSCROLL | WS_HSCROLL;
-		}
-		if( _tcscmp(pstrName, _T("autohscroll")) == 0 ) {
+			CContainerUI::SetAttribute(pstrName, pstrValue);
+			break;
+		case kAttr_autohscroll:
 			if( _tcscmp(pstrValue, _T("true")) == 0 ) m_lTwhStyle |= ES_AUTOHSCROLL;
-		}
-		else if( _tcsicmp(pstrName, _T("multiline")) == 0 ) {
-			SetMultiLine(_tcscmp(pstrValue, _T("true")) == 0);
-		}
-		else if( _tcscmp(pstrName, _T("wanttab")) == 0 ) {
-			SetWantTab(_tcscmp(pstrValue, _T("true")) == 0);
-		}
-		else if( _tcscmp(pstrName, _T("wantreturn")) == 0 ) {
-			SetWantReturn(_tcscmp(pstrValue, _T("true")) == 0);
-		}
-		else if( _tcscmp(pstrName, _T("wantctrlreturn")) == 0 ) {
-			SetWantCtrlReturn(_tcscmp(pstrValue, _T("true")) == 0);
-		}
-		else if( _tcscmp(pstrName, _T("transparent")) == 0 ) {
-			SetTransparent(_tcscmp(pstrValue, _T("true")) == 0);
-		}
-		else if( _tcscmp(pstrName, _T("rich")) == 0 ) {
-			SetRich(_tcscmp(pstrValue, _T("true")) == 0);
-		}
-		else if( _tcscmp(pstrName, _T("multiline")) == 0 ) {
-			if( _tcscmp(pstrValue, _T("false")) == 0 ) m_lTwhStyle &= ~ES_MULTILINE;
-		}
-		else if( _tcscmp(pstrName, _T("readonly")) == 0 ) {
-			if( _tcscmp(pstrValue, _T("true")) == 0 ) { m_lTwhStyle |= ES_READONLY; m_bReadOnly = true; }
-		}
-		else if( _tcscmp(pstrName, _T("password")) == 0 ) {
-			if( _tcscmp(pstrValue, _T("true")) == 0 ) m_lTwhStyle |= ES_PASSWORD;
-		}
-		else if( _tcscmp(pstrName, _T("align")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
-				m_lTwhStyle &= ~(ES_CENTER | ES_RIGHT);
-				m_lTwhStyle |= ES_LEFT;
-			}
-			if( _tcsstr(pstrValue, _T("center")) != NULL ) {
-				m_lTwhStyle &= ~(ES_LEFT | ES_RIGHT);
-				m_lTwhStyle |= ES_CENTER;
+			break;
+		case kAttr_multiline: SetMultiLine(_tcscmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_wanttab: SetWantTab(_tcscmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_wantreturn: SetWantReturn(_tcscmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_wantctrlreturn: SetWantCtrlReturn(_tcscmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_transparent: SetTransparent(_tcscmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_rich: SetRich(_tcscmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_readonly:
+			{
+				if( _tcscmp(pstrValue, _T("true")) == 0 ) { m_lTwhStyle |= ES_READONLY; m_bReadOnly = true; }
 			}
-			if( _tcsstr(pstrValue, _T("right")) != NULL ) {
-				m_lTwhStyle &= ~(ES_LEFT | ES_CENTER);
-				m_lTwhStyle |= ES_RIGHT;
+			break;
+		case kAttr_password:
+			if( _tcscmp(pstrValue, _T("true")) == 0 ) m_lTwhStyle |= ES_PASSWORD;
+			break;
+		case kAttr_align:
+			{
+				if( _tcsstr(pstrValue, _T("left")) != NULL ) {
+					m_lTwhStyle &= ~(ES_CENTER | ES_RIGHT);
+					m_lTwhStyle |= ES_LEFT;
+				}
+				if( _tcsstr(pstrValue, _T("center")) != NULL ) {
+					m_lTwhStyle &= ~(ES_LEFT | ES_RIGHT);
+					m_lTwhStyle |= ES_CENTER;
+				}
+				if( _tcsstr(pstrValue, _T("right")) != NULL ) {
+					m_lTwhStyle &= ~(ES_LEFT | ES_CENTER);
+					m_lTwhStyle |= ES_RIGHT;
+				}
 			}
-		}
-		else if( _tcscmp(pstrName, _T("font")) == 0 ) SetFont(_ttoi(pstrValue));
-		else if( _tcscmp(pstrName, _T("textcolor")) == 0 ) {
-			while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetTextColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("maxchar")) == 0 ) SetLimitText(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("normalimage")) == 0 ) SetNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hotimage")) == 0 ) SetHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("focusedimage")) == 0 ) SetFocusedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("disabledimage")) == 0 ) SetDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("textpadding")) == 0 ) {
-			RECT rcTextPadding = { 0 };
-			LPTSTR pstr = NULL;
-			rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-			rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
-			SetTextPadding(rcTextPadding);
-		}
-		else if( _tcsicmp(pstrName, _T("tipvalue")) == 0 ) SetTipValue(pstrValue);
-		else if( _tcsicmp(pstrName, _T("tipvaluecolor")) == 0 ) SetTipValueColor(pstrValue);
-		else if( _tcsicmp(pstrName, _T("tipvaluealign")) == 0 ) {
-			if( _tcsstr(pstrValue, _T("left")) != NULL ) {
-				m_uTipValueAlign = DT_SINGLELINE | DT_LEFT;
+			break;
+		case kAttr_font: SetFont(_ttoi(pstrValue)); break;
+		case kAttr_textcolor:
+			{
+				while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetTextColor(clrColor);
 			}
-			if( _tcsstr(pstrValue, _T("center")) != NULL ) {
-				m_uTipValueAlign = DT_SINGLELINE | DT_CENTER;
+			break;
+		case kAttr_maxchar: SetLimitText(_ttoi(pstrValue)); break;
+		case kAttr_normalimage: SetNormalImage(pstrValue); break;
+		case kAttr_hotimage: SetHotImage(pstrValue); break;
+		case kAttr_focusedimage: SetFocusedImage(pstrValue); break;
+		case kAttr_disabledimage: SetDisabledImage(pstrValue); break;
+		case kAttr_textpadding:
+			{
+				RECT rcTextPadding = { 0 };
+				LPTSTR pstr = NULL;
+				rcTextPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				rcTextPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
+				rcTextPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+				SetTextPadding(rcTextPadding);
 			}
-			if( _tcsstr(pstrValue, _T("right")) != NULL ) {
-				m_uTipValueAlign = DT_SINGLELINE | DT_RIGHT;
+			break;
+		case kAttr_tipvalue: SetTipValue(pstrValue); break;
+		case kAttr_tipvaluecolor: SetTipValueColor(pstrValue); break;
+		case kAttr_tipvaluealign:
+			{
+				if( _tcsstr(pstrValue, _T("left")) != NULL ) {
+					m_uTipValueAlign = DT_SINGLELINE | DT_LEFT;
+				}
+				if( _tcsstr(pstrValue, _T("center")) != NULL ) {
+					m_uTipValueAlign = DT_SINGLELINE | DT_CENTER;
+				}
+				if( _tcsstr(pstrValue, _T("right")) != NULL ) {
+					m_uTipValueAlign = DT_SINGLELINE | DT_RIGHT;
+				}
 			}
+			break;
+		default: CContainerUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else CContainerUI::SetAttribute(pstrName, pstrValue);
 	}
 
 	LRESULT CRichEditUI::MessageHandler(UINT uMsg, WPARAM wParam, LPARAM lParam, bool& bHandled)
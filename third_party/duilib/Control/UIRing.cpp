@@ -39,6 +39,13 @@ namespace DuiLib
 			CLabelUI::SetAttribute(pstrName, pstrValue);
 	}
 
+	CssSetter CRingUI::GetCssSetter(LPCTSTR pstrName)
+	{
+		// bkimage由SetAttribute加载为旋转用的图片
+		if (_tcsicmp(pstrName, _T("bkimage")) == 0) return NULL;
+		return CLabelUI::GetCssSetter(pstrName);
+	}
+
 	void CRingUI::SetBkImage( LPCTSTR pStrImage )
 	{
 		if (m_sBkImage == pStrImage) return;
@@ -19,6 +19,7 @@ namespace DuiLib
 		LPCTSTR GetClass() const;
 		LPVOID GetInterface(LPCTSTR pstrName);
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 		void SetBkImage(LPCTSTR pStrImage);	
 		virtual void DoEvent(TEventUI& event);
 		virtual void PaintBkImage(HDC hDC);	
@@ -756,35 +756,46 @@ namespace DuiLib
 		if( m_pOwner != NULL ) m_pOwner->DoEvent(event); else CControlUI::DoEvent(event);
 	}
 
+#define SCROLLBAR_ATTRIBUTES(X)\
+	X(button1normalimage) X(button1hotimage) X(button1pushedimage) X(button1disabledimage) X(button2normalimage) X(button2hotimage)\
+	X(button2pushedimage) X(button2disabledimage) X(thumbnormalimage) X(thumbhotimage) X(thumbpushedimage) X(thumbdisabledimage)\
+	X(railnormalimage) X(railhotimage) X(railpushedimage) X(raildisabledimage) X(bknormalimage) X(bkhotimage)\
+	X(bkpushedimage) X(bkdisabledimage) X(hor) X(linesize) X(range) X(value)\
+	X(showbutton1) X(showbutton2)
+	IMPLEMENT_DUIATTRIBUTES(CScrollBarUI, SCROLLBAR_ATTRIBUTES)
+
 	void CScrollBarUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("button1normalimage")) == 0 ) SetButton1NormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button1hotimage")) == 0 ) SetButton1HotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button1pushedimage")) == 0 ) SetButton1PushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button1disabledimage")) == 0 ) SetButton1DisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button2normalimage")) == 0 ) SetButton2NormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button2hotimage")) == 0 ) SetButton2HotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button2pushedimage")) == 0 ) SetButton2PushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("button2disabledimage")) == 0 ) SetButton2DisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbnormalimage")) == 0 ) SetThumbNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbhotimage")) == 0 ) SetThumbHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbpushedimage")) == 0 ) SetThumbPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbdisabledimage")) == 0 ) SetThumbDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("railnormalimage")) == 0 ) SetRailNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("railhotimage")) == 0 ) SetRailHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("railpushedimage")) == 0 ) SetRailPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("raildisabledimage")) == 0 ) SetRailDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("bknormalimage")) == 0 ) SetBkNormalImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("bkhotimage")) == 0 ) SetBkHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("bkpushedimage")) == 0 ) SetBkPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("bkdisabledimage")) == 0 ) SetBkDisabledImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("hor")) == 0 ) SetHorizontal(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("linesize")) == 0 ) SetLineSize(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("range")) == 0 ) SetScrollRange(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("value")) == 0 ) SetScrollPos(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("showbutton1")) == 0 ) SetShowButton1(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("showbutton2")) == 0 ) SetShowButton2(_tcsicmp(pstrValue, _T("true")) == 0);
-		else CControlUI::SetAttribute(pstrName, pstrValue);
+		using namespace CScrollBarUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_button1normalimage: SetButton1NormalImage(pstrValue); break;
+		case kAttr_button1hotimage: SetButton1HotImage(pstrValue); break;
+		case kAttr_button1pushedimage: SetButton1PushedImage(pstrValue); break;
+		case kAttr_button1disabledimage: SetButton1DisabledImage(pstrValue); break;
+		case kAttr_button2normalimage: SetButton2NormalImage(pstrValue); break;
+		case kAttr_button2hotimage: SetButton2HotImage(pstrValue); break;
+		case kAttr_button2pushedimage: SetButton2PushedImage(pstrValue); break;
+		case kAttr_button2disabledimage: SetButton2DisabledImage(pstrValue); break;
+		case kAttr_thumbnormalimage: SetThumbNormalImage(pstrValue); break;
+		case kAttr_thumbhotimage: SetThumbHotImage(pstrValue); break;
+		case kAttr_thumbpushedimage: SetThumbPushedImage(pstrValue); break;
+		case kAttr_thumbdisabledimage: SetThumbDisabledImage(pstrValue); break;
+		case kAttr_railnormalimage: SetRailNormalImage(pstrValue); break;
+		case kAttr_railhotimage: SetRailHotImage(pstrValue); break;
+		case kAttr_railpushedimage: SetRailPushedImage(pstrValue); break;
+		case kAttr_raildisabledimage: SetRailDisabledImage(pstrValue); break;
+		case kAttr_bknormalimage: SetBkNormalImage(pstrValue); break;
+		case kAttr_bkhotimage: SetBkHotImage(pstrValue); break;
+		case kAttr_bkpushedimage: SetBkPushedImage(pstrValue); break;
+		case kAttr_bkdisabledimage: SetBkDisabledImage(pstrValue); break;
+		case kAttr_hor: SetHorizontal(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_linesize: SetLineSize(_ttoi(pstrValue)); break;
+		case kAttr_range: SetScrollRange(_ttoi(pstrValue)); break;
+		case kAttr_value: SetScrollPos(_ttoi(pstrValue)); break;
+		case kAttr_showbutton1: SetShowButton1(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_showbutton2: SetShowButton2(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		default: CControlUI::SetAttribute(pstrName, pstrValue); break;
+		}
 	}
 
 	bool CScrollBarUI::DoPaint(HDC hDC, const RECT& rcPaint, CControlUI* pStopControl)
@@ -247,25 +247,30 @@ namespace DuiLib
 		return m_bSendMove;
 	}
 
+#define SLIDER_ATTRIBUTES(X)\
+	X(thumbimage) X(thumbhotimage) X(thumbpushedimage) X(thumbsize) X(step) X(sendmove)
+	IMPLEMENT_DUIATTRIBUTES(CSliderUI, SLIDER_ATTRIBUTES)
+
 	void CSliderUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("thumbimage")) == 0 ) SetThumbImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbhotimage")) == 0 ) SetThumbHotImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbpushedimage")) == 0 ) SetThumbPushedImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("thumbsize")) == 0 ) {
-			SIZE szXY = {0};
-			LPTSTR pstr = NULL;
-			szXY.cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			szXY.cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr); 
-			SetThumbSize(szXY);
-		}
-		else if( _tcsicmp(pstrName, _T("step")) == 0 ) {
-			SetChangeStep(_ttoi(pstrValue));
-		}
-		else if( _tcsicmp(pstrName, _T("sendmove")) == 0 ) {
-			SetCanSendMove(_tcsicmp(pstrValue, _T("true")) == 0);
+		using namespace CSliderUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_thumbimage: SetThumbImage(pstrValue); break;
+		case kAttr_thumbhotimage: SetThumbHotImage(pstrValue); break;
+		case kAttr_thumbpushedimage: SetThumbPushedImage(pstrValue); break;
+		case kAttr_thumbsize:
+			{
+				SIZE szXY = {0};
+				LPTSTR pstr = NULL;
+				szXY.cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				szXY.cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr); 
+				SetThumbSize(szXY);
+			}
+			break;
+		case kAttr_step: SetChangeStep(_ttoi(pstrValue)); break;
+		case kAttr_sendmove: SetCanSendMove(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		default: CProgressUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else CProgressUI::SetAttribute(pstrName, pstrValue);
 	}
 
 	void CSliderUI::PaintForeImage(HDC hDC)
@@ -499,6 +499,13 @@ namespace DuiLib
 		else CListContainerElementUI::SetAttribute(pstrName,pstrValue);
 	}
 
+	CssSetter CTreeNodeUI::GetCssSetter( LPCTSTR pstrName )
+	{
+		// text设置在节点按钮上
+		if(_tcsicmp(pstrName, _T("text")) == 0 ) return NULL;
+		return CListContainerElementUI::GetCssSetter(pstrName);
+	}
+
 	//************************************
 	// 函数名称: GetTreeNodes
 	// 返回类型: DuiLib::CStdPtrArray
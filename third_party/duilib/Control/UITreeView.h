@@ -60,6 +60,7 @@ namespace DuiLib
 		void SetSelItemHotTextColor(DWORD _dwSelHotItemTextColor);
 		DWORD GetSelItemHotTextColor() const;
 		void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		CssSetter GetCssSetter(LPCTSTR pstrName);
 
 		CStdPtrArray GetTreeNodes();
 		int			 GetTreeIndex();
@@ -390,50 +390,48 @@ void CWaterfallListUI::Reload()
 	    SetPos(m_rcItem);
 }
 
+#define WATERFALLLIST_ATTRIBUTES(X)\
+	X(itembkcolor) X(itemhotcolor) X(itemselcolor) X(itembkimage) X(itemhotimage) X(itemselimage)\
+	X(itemheight)
+IMPLEMENT_DUIATTRIBUTES(CWaterfallListUI, WATERFALLLIST_ATTRIBUTES)
+
 void CWaterfallListUI::SetAttribute(LPCTSTR pstrName,LPCTSTR pstrValue)
 {
-	if (_tcscmp(pstrName,_T("itembkcolor"))==0)
-	{
-		while( *pstrValue > '\0' && *pstrValue <= ' ') pstrValue = CharNext(pstrValue);
-        if( *pstrValue == '#') pstrValue = CharNext(pstrValue);
-        TCHAR* pstr = NULL;
-        uint32_t clrColor = _tcstoul(pstrValue, &pstr, 16);
-        m_listInfo.itemBkColor= (clrColor);
-	}
-	else if (_tcscmp(pstrName,_T("itemhotcolor"))==0)
-	{
-		while( *pstrValue > '\0' && *pstrValue <= ' ') pstrValue = CharNext(pstrValue);
-        if( *pstrValue == '#') pstrValue = CharNext(pstrValue);
-        TCHAR* pstr = NULL;
-        uint32_t clrColor = _tcstoul(pstrValue, &pstr, 16);
-        m_listInfo.itemHotColor= (clrColor);
-	}
-	else if (_tcscmp(pstrName,_T("itemselcolor"))==0)
-	{
-		while( *pstrValue > '\0' && *pstrValue <= ' ') pstrValue = CharNext(pstrValue);
-        if( *pstrValue == '#') pstrValue = CharNext(pstrValue);
-        TCHAR* pstr = NULL;
-        uint32_t clrColor = _tcstoul(pstrValue, &pstr, 16);
-        m_listInfo.itemSelColor= (clrColor);
-	}
-	else if (_tcscmp(pstrName,_T("itembkimage"))==0)
-	{
-		m_listInfo.itemBkImage = pstrValue;
-	}
-	else if (_tcscmp(pstrName,_T("itemhotimage"))==0)
-	{
-		m_listInfo.itemHotImage = pstrValue;
-	}
-	else if (_tcscmp(pstrName,_T("itemselimage"))==0)
-	{
-		m_listInfo.itemSelImage = pstrValue;
-	}
-	else if (_tcscmp(pstrName,_T("itemheight"))==0)
-	{
-		m_itemHeight=_ttoi(pstrValue);
+	using namespace CWaterfallListUIAttr;
+	switch( GetAttributeId(pstrName) ) {
+	case kAttr_itembkcolor:
+		{
+			while( *pstrValue > '\0' && *pstrValue <= ' ') pstrValue = CharNext(pstrValue);
+			if( *pstrValue == '#') pstrValue = CharNext(pstrValue);
+			TCHAR* pstr = NULL;
+			uint32_t clrColor = _tcstoul(pstrValue, &pstr, 16);
+			m_listInfo.itemBkColor= (clrColor);
+		}
+		break;
+	case kAttr_itemhotcolor:
+		{
+			while( *pstrValue > '\0' && *pstrValue <= ' ') pstrValue = CharNext(pstrValue);
+			if( *pstrValue == '#') pstrValue = CharNext(pstrValue);
+			TCHAR* pstr = NULL;
+			uint32_t clrColor = _tcstoul(pstrValue, &pstr, 16);
+			m_listInfo.itemHotColor= (clrColor);
+		}
+		break;
+	case kAttr_itemselcolor:
+		{
+			while( *pstrValue > '\0' && *pstrValue <= ' ') pstrValue = CharNext(pstrValue);
+			if( *pstrValue == '#') pstrValue = CharNext(pstrValue);
+			TCHAR* pstr = NULL;
+			uint32_t clrColor = _tcstoul(pstrValue, &pstr, 16);
+			m_listInfo.itemSelColor= (clrColor);
+		}
+		break;
+	case kAttr_itembkimage: m_listInfo.itemBkImage = pstrValue; break;
+	case kAttr_itemhotimage: m_listInfo.itemHotImage = pstrValue; break;
+	case kAttr_itemselimage: m_listInfo.itemSelImage = pstrValue; break;
+	case kAttr_itemheight: m_itemHeight=_ttoi(pstrValue); break;
+	default: CContainerUI::SetAttribute(pstrName,pstrValue); break;
 	}
-	else
-		CContainerUI::SetAttribute(pstrName,pstrValue);
 }
 
 
@@ -62,6 +62,9 @@ public:
 
 	ListInfo* GetListInfo(){return &m_listInfo;}
 	void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue) override;
+	static int GetAttributeId(LPCTSTR pstrName);
+	static const LPCTSTR* GetAttributeNames(int& nCount);
+	CssSetter GetCssSetter(LPCTSTR pstrName) override;
 private:
 	CWaterfallListCellUI* findDisplayCell(int id)
 	{
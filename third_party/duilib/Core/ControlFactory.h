@@ -37,4 +37,36 @@ public:\
 
 #define INNER_REGISTER_DUICONTROL(class_name)\
 	RegistControl(_T(#class_name), (CreateClass)class_name::CreateControl);
+
+// 控件自己在SetAttribute中处理的属性表。list为X宏，形如 #define BUTTON_ATTRIBUTES(X) X(normalimage) X(hotimage)
+// 生成枚举class_name##Attr::kAttr_属性名，按枚举顺序返回属性名的class_name::GetAttributeNames，
+// 以及用完美哈希查找属性id的class_name::GetAttributeId
+#define DUI_ATTRIBUTE_ID(name)		kAttr_##name,
+#define DUI_ATTRIBUTE_NAME(name)	_T(#name),
+
+#define IMPLEMENT_DUIATTRIBUTEID(class_name, list)\
+	namespace class_name##Attr { enum { list(DUI_ATTRIBUTE_ID) }; }\
+	const LPCTSTR* class_name::GetAttributeNames(int& nCount)\
+	{\
+		static const LPCTSTR names[] = { list(DUI_ATTRIBUTE_NAME) };\
+		nCount = sizeof(names) / sizeof(names[0]);\
+		return names;\
+	}\
+	int class_name::GetAttributeId(LPCTSTR pstrName)\
+	{\
+		int nCount = 0;\
+		const LPCTSTR* names = GetAttributeNames(nCount);\
+		static const CAttributeTable table(names, nCount);\
+		return table.GetId(pstrName);\
+	}
+
+// 派生控件另外生成class_name::GetCssSetter：表中的属性由自己的SetAttribute处理，
+// css不使用基类预编译的setter，其余的交给基类
+#define IMPLEMENT_DUIATTRIBUTES(class_name, list)\
+	IMPLEMENT_DUIATTRIBUTEID(class_name, list)\
+	CssSetter class_name::GetCssSetter(LPCTSTR pstrName)\
+	{\
+		if( GetAttributeId(pstrName) >= 0 ) return NULL;\
+		return __super::GetCssSetter(pstrName);\
+	}
 }
\ No newline at end of file
@@ -574,7 +574,7 @@ namespace DuiLib
 					m_pHorizontalScrollBar->ApplyAttributeList(pDefaultAttributes);
 				}
 
-				m_pManager->ApplyCss(m_pVerticalScrollBar, _T("HScrollBar"), NULL, NULL);
+				m_pManager->ApplyCss(m_pHorizontalScrollBar, _T("HScrollBar"), NULL, NULL);
 			}
 		}
 		else if( !bEnableHorizontal && m_pHorizontalScrollBar ) {
@@ -695,67 +695,83 @@ namespace DuiLib
 		}
 	}
 
+#define CONTAINER_ATTRIBUTES(X)\
+	X(inset) X(mousechild) X(vscrollbar) X(vscrollbarstyle) X(hscrollbar) X(hscrollbarstyle)\
+	X(childpadding) X(childalign) X(childvalign) X(scrollstepsize)
+	IMPLEMENT_DUIATTRIBUTES(CContainerUI, CONTAINER_ATTRIBUTES)
+
 	void CContainerUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
 	{
-		if( _tcsicmp(pstrName, _T("inset")) == 0 ) {
-			RECT rcInset = { 0 };
-			LPTSTR pstr = NULL;
-			rcInset.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			rcInset.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			rcInset.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-			rcInset.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
-			SetInset(rcInset);
-		}
-		else if( _tcsicmp(pstrName, _T("mousechild")) == 0 ) SetMouseChildEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("vscrollbar")) == 0 ) {
-			EnableScrollBar(_tcsicmp(pstrValue, _T("true")) == 0, GetHorizontalScrollBar() != NULL);
-		}
-		else if( _tcsicmp(pstrName, _T("vscrollbarstyle")) == 0 ) {
-			m_sVerticalScrollBarStyle = pstrValue;
-			EnableScrollBar(TRUE, GetHorizontalScrollBar() != NULL);
-			if( GetVerticalScrollBar() ) {
-				LPCTSTR pStyle = m_pManager->GetStyle(m_sVerticalScrollBarStyle);
-				if( pStyle ) {
-					GetVerticalScrollBar()->ApplyAttributeList(pStyle);
-				}
-				else {
-					GetVerticalScrollBar()->ApplyAttributeList(pstrValue);
-				}
+		using namespace CContainerUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_inset:
+			{
+				RECT rcInset = { 0 };
+				LPTSTR pstr = NULL;
+				rcInset.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				rcInset.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				rcInset.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
+				rcInset.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+				SetInset(rcInset);
 			}
-		}
-		else if( _tcsicmp(pstrName, _T("hscrollbar")) == 0 ) {
-			EnableScrollBar(GetVerticalScrollBar() != NULL, _tcsicmp(pstrValue, _T("true")) == 0);
-		}
-		else if( _tcsicmp(pstrName, _T("hscrollbarstyle")) == 0 ) {
-			m_sHorizontalScrollBarStyle = pstrValue;
-			EnableScrollBar(TRUE, GetHorizontalScrollBar() != NULL);
-			if( GetHorizontalScrollBar() ) {
-				LPCTSTR pStyle = m_pManager->GetStyle(m_sHorizontalScrollBarStyle);
-				if( pStyle ) {
-					GetHorizontalScrollBar()->ApplyAttributeList(pStyle);
+			break;
+		case kAttr_mousechild: SetMouseChildEnabled(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_vscrollbar: EnableScrollBar(_tcsicmp(pstrValue, _T("true")) == 0, GetHorizontalScrollBar() != NULL); break;
+		case kAttr_vscrollbarstyle:
+			{
+				m_sVerticalScrollBarStyle = pstrValue;
+				EnableScrollBar(TRUE, GetHorizontalScrollBar() != NULL);
+				if( GetVerticalScrollBar() ) {
+					LPCTSTR pStyle = m_pManager->GetStyle(m_sVerticalScrollBarStyle);
+					if( pStyle ) {
+						GetVerticalScrollBar()->ApplyAttributeList(pStyle);
+					}
+					else {
+						GetVerticalScrollBar()->ApplyAttributeList(pstrValue);
+					}
 				}
-				else {
-					GetHorizontalScrollBar()->ApplyAttributeList(pstrValue);
+			}
+			break;
+		case kAttr_hscrollbar: EnableScrollBar(GetVerticalScrollBar() != NULL, _tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_hscrollbarstyle:
+			{
+				m_sHorizontalScrollBarStyle = pstrValue;
+				EnableScrollBar(TRUE, GetHorizontalScrollBar() != NULL);
+				if( GetHorizontalScrollBar() ) {
+					LPCTSTR pStyle = m_pManager->GetStyle(m_sHorizontalScrollBarStyle);
+					if( pStyle ) {
+						GetHorizontalScrollBar()->ApplyAttributeList(pStyle);
+					}
+					else {
+						GetHorizontalScrollBar()->ApplyAttributeList(pstrValue);
+					}
 				}
 			}
+			break;
+		case kAttr_childpadding: SetChildPadding(_ttoi(pstrValue)); break;
+		case kAttr_childalign:
+			{
+				if( _tcscmp(pstrValue, _T("left")) == 0 ) m_iChildAlign = DT_LEFT;
+				else if( _tcscmp(pstrValue, _T("center")) == 0 ) m_iChildAlign = DT_CENTER;
+				else if( _tcscmp(pstrValue, _T("right")) == 0 ) m_iChildAlign = DT_RIGHT;
+			}
+			break;
+		case kAttr_childvalign:
+			{
+				if( _tcscmp(pstrValue, _T("top")) == 0 ) m_iChildVAlign = DT_TOP;
+				else if( _tcscmp(pstrValue, _T("vcenter")) == 0 ) m_iChildVAlign = DT_VCENTER;
+				else if( _tcscmp(pstrValue, _T("bottom")) == 0 ) m_iChildVAlign = DT_BOTTOM;
+			}
+			break;
+		case kAttr_scrollstepsize: SetScrollStepSize(_ttoi(pstrValue)); break;
+		default: CControlUI::SetAttribute(pstrName, pstrValue); break;
 		}
-		else if( _tcsicmp(pstrName, _T("childpadding")) == 0 ) SetChildPadding(_ttoi(pstrValue));
-		else if( _tcscmp(pstrName, _T("childalign")) == 0 ) {
-			if( _tcscmp(pstrValue, _T("left")) == 0 ) m_iChildAlign = DT_LEFT;
-			else if( _tcscmp(pstrValue, _T("center")) == 0 ) m_iChildAlign = DT_CENTER;
-			else if( _tcscmp(pstrValue, _T("right")) == 0 ) m_iChildAlign = DT_RIGHT;
-		}
-		else if( _tcscmp(pstrName, _T("childvalign")) == 0 ) {
-			if( _tcscmp(pstrValue, _T("top")) == 0 ) m_iChildVAlign = DT_TOP;
-			else if( _tcscmp(pstrValue, _T("vcenter")) == 0 ) m_iChildVAlign = DT_VCENTER;
-			else if( _tcscmp(pstrValue, _T("bottom")) == 0 ) m_iChildVAlign = DT_BOTTOM;
-		}
-		else if( _tcsicmp(pstrName, _T("scrollstepsize")) == 0 ) SetScrollStepSize(_ttoi(pstrValue));
-		else CControlUI::SetAttribute(pstrName, pstrValue);
 	}
 
 	void CContainerUI::SetManager(CPaintManagerUI* pManager, CControlUI* pParent, bool bInit)
 	{
+		// 子控件先初始化，此时就要能沿GetParent()找到所有祖先(后代选择器)
+		m_pParent = pParent;
 		for( int it = 0; it < m_items.GetSize(); it++ ) {
 			static_cast<CControlUI*>(m_items[it])->SetManager(pManager, this, bInit);
 		}
@@ -44,7 +44,8 @@ namespace DuiLib {
 		m_nBorderStyle(PS_SOLID),
 		m_nTooltipWidth(300),
 		m_wCursor(0),
-		m_instance(NULL)
+		m_instance(NULL),
+		m_pCssState(NULL)
 	{
 		m_cXY.cx = m_cXY.cy = 0;
 		m_cxyFixed.cx = m_cxyFixed.cy = 0;
@@ -64,6 +65,7 @@ namespace DuiLib {
 		if( OnDestroy ) OnDestroy(this);
 		RemoveAllCustomAttribute();	
 		RemoveAllSaveAttribute();
+		delete m_pCssState;
 		if( m_pManager != NULL ) m_pManager->ReapObjects(this);
 	}
 
@@ -74,7 +76,9 @@ namespace DuiLib {
 
 	void CControlUI::SetName(LPCTSTR pstrName)
 	{
+		CDuiString sOldName = m_sName;
 		m_sName = pstrName;
+		if( m_pManager != NULL && sOldName != m_sName ) m_pManager->InvalidateCss(this, sOldName, NULL);
 	}
 
 	LPVOID CControlUI::GetInterface(LPCTSTR pstrName)
@@ -985,262 +989,402 @@ namespace DuiLib {
 			cls.SetAt(cls.GetLength() - 2, _T('\0'));
 		}
 
-		//先应用css样式
+		//先应用css样式，class和name先设上，之后设置属性时不会再次匹配
 		LPCTSTR cssClass = GetSaveAttribute(_T("class"));
 		LPCTSTR name = GetSaveAttribute(_T("name"));
+		if (cssClass) m_sStyleClass = cssClass;
+		if (name) m_sName = name;
 		m_pManager->ApplyCss(this, cls, cssClass, name);
 
-		//再应用保存的属性
+		//再应用保存的属性，之后加载的样式表也不覆盖
 		for (int i = 0; i < m_mSaveAttrList.GetSize(); ++i) {
 			Attribute* attr = (Attribute*)m_mSaveAttrList.GetAt(i);
+			GetCssState(true)->SetInline(attr->name.GetData());
 			SetAttribute(attr->name, attr->value);
 		}
 		RemoveAllSaveAttribute();
 	}
 
-	void CControlUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	void CControlUI::SetStyleClass(LPCTSTR pstrClass)
 	{
-		// 是否样式表
-		if (m_pManager != NULL && _tcsicmp(pstrName, _T("style")) == 0) {
-			LPCTSTR pStyle = m_pManager->GetStyle(pstrValue);
-			if( pStyle != NULL) {
-				ApplyAttributeList(pStyle);
-				return;
-			}
-		}
+		CDuiString sOldClass = m_sStyleClass;
+		m_sStyleClass = pstrClass;
+		if( m_pManager != NULL && sOldClass != m_sStyleClass ) m_pManager->InvalidateCss(this, NULL, sOldClass);
+	}
 
-		if( _tcsicmp(pstrName, _T("pos")) == 0 ) {
-			RECT rcPos = { 0 };
-			LPTSTR pstr = NULL;
-			rcPos.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			rcPos.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			rcPos.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-			rcPos.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
-			SIZE szXY = {rcPos.left >= 0 ? rcPos.left : rcPos.right, rcPos.top >= 0 ? rcPos.top : rcPos.bottom};
-			SetFixedXY(szXY);
-			SetFixedWidth(rcPos.right - rcPos.left);
-			SetFixedHeight(rcPos.bottom - rcPos.top);
-		}
-		else if (_tcsicmp(pstrName, _T("flex")) == 0) {
-			m_nFlex = _ttoi(pstrValue);
-		}
-		else if( _tcsicmp(pstrName, _T("float")) == 0 ) {
-			CDuiString nValue = pstrValue;
-			// 动态计算相对比例
-			if(nValue.Find(',') < 0) {
-				SetFloat(_tcsicmp(pstrValue, _T("true")) == 0);
+	CDuiString CControlUI::GetStyleClass() const
+	{
+		return m_sStyleClass;
+	}
+
+	CssStyleState* CControlUI::GetCssState(bool bCreate)
+	{
+		if( m_pCssState == NULL && bCreate ) m_pCssState = new CssStyleState;
+		return m_pCssState;
+	}
+
+#define CONTROL_ATTRIBUTES(X)\
+	X(style) X(pos) X(flex) X(float) X(floatalign) X(padding)\
+	X(gradient) X(bkcolor) X(bkcolor1) X(bkcolor2) X(bkcolor3) X(forecolor)\
+	X(bordercolor) X(focusbordercolor) X(colorhsl) X(bordersize) X(leftbordersize) X(topbordersize)\
+	X(rightbordersize) X(bottombordersize) X(borderstyle) X(borderround) X(bkimage) X(foreimage)\
+	X(width) X(height) X(minwidth) X(minheight) X(maxwidth) X(maxheight)\
+	X(name) X(drag) X(drop) X(resourcetext) X(rtext) X(text)\
+	X(tooltip) X(userdata) X(enabled) X(mouse) X(keyboard) X(visible)\
+	X(shortcut) X(menu) X(cursor) X(virtualwnd) X(innerstyle) X(class)
+	IMPLEMENT_DUIATTRIBUTEID(CControlUI, CONTROL_ATTRIBUTES)
+
+	void CControlUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	{
+		using namespace CControlUIAttr;
+		switch( GetAttributeId(pstrName) ) {
+		case kAttr_style:
+			{
+				// 是否样式表
+				LPCTSTR pStyle = m_pManager != NULL ? m_pManager->GetStyle(pstrValue) : NULL;
+				if( pStyle != NULL ) ApplyAttributeList(pStyle);
+				else AddCustomAttribute(pstrName, pstrValue);
 			}
-			else {
-				TPercentInfo piFloatPercent = { 0 };
+			break;
+		case kAttr_pos:
+			{
+				RECT rcPos = { 0 };
 				LPTSTR pstr = NULL;
-				piFloatPercent.left = _tcstod(pstrValue, &pstr);  ASSERT(pstr);
-				piFloatPercent.top = _tcstod(pstr + 1, &pstr);    ASSERT(pstr);
-				piFloatPercent.right = _tcstod(pstr + 1, &pstr);  ASSERT(pstr);
-				piFloatPercent.bottom = _tcstod(pstr + 1, &pstr); ASSERT(pstr);
-				SetFloatPercent(piFloatPercent);
-				SetFloat(true);
+				rcPos.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				rcPos.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				rcPos.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
+				rcPos.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+				SIZE szXY = {rcPos.left >= 0 ? rcPos.left : rcPos.right, rcPos.top >= 0 ? rcPos.top : rcPos.bottom};
+				SetFixedXY(szXY);
+				SetFixedWidth(rcPos.right - rcPos.left);
+				SetFixedHeight(rcPos.bottom - rcPos.top);
 			}
-		}
-		else if( _tcsicmp(pstrName, _T("floatalign")) == 0) {
-			UINT uAlign = GetFloatAlign();
-			// 解析文字属性
-			while( *pstrValue != _T('\0') ) {
-				CDuiString sValue;
-				while( *pstrValue == _T(',') || *pstrValue == _T(' ') ) pstrValue = ::CharNext(pstrValue);
-
-				while( *pstrValue != _T('\0') && *pstrValue != _T(',') && *pstrValue != _T(' ') ) {
-					LPTSTR pstrTemp = ::CharNext(pstrValue);
-					while( pstrValue < pstrTemp) {
-						sValue += *pstrValue++;
-					}
-				}
-				if(sValue.CompareNoCase(_T("null")) == 0) {
-					uAlign = 0;
-				}
-				if( sValue.CompareNoCase(_T("left")) == 0 ) {
-					uAlign &= ~(DT_CENTER | DT_RIGHT);
-					uAlign |= DT_LEFT;
-				}
-				else if( sValue.CompareNoCase(_T("center")) == 0 ) {
-					uAlign &= ~(DT_LEFT | DT_RIGHT);
-					uAlign |= DT_CENTER;
+			break;
+		case kAttr_flex: m_nFlex = _ttoi(pstrValue); break;
+		case kAttr_float:
+			{
+				CDuiString nValue = pstrValue;
+				// 动态计算相对比例
+				if(nValue.Find(',') < 0) {
+					SetFloat(_tcsicmp(pstrValue, _T("true")) == 0);
 				}
-				else if( sValue.CompareNoCase(_T("right")) == 0 ) {
-					uAlign &= ~(DT_LEFT | DT_CENTER);
-					uAlign |= DT_RIGHT;
+				else {
+					TPercentInfo piFloatPercent = { 0 };
+					LPTSTR pstr = NULL;
+					piFloatPercent.left = _tcstod(pstrValue, &pstr);  ASSERT(pstr);
+					piFloatPercent.top = _tcstod(pstr + 1, &pstr);    ASSERT(pstr);
+					piFloatPercent.right = _tcstod(pstr + 1, &pstr);  ASSERT(pstr);
+					piFloatPercent.bottom = _tcstod(pstr + 1, &pstr); ASSERT(pstr);
+					SetFloatPercent(piFloatPercent);
+					SetFloat(true);
 				}
-				else if( sValue.CompareNoCase(_T("top")) == 0 ) {
-					uAlign &= ~(DT_BOTTOM | DT_VCENTER);
-					uAlign |= DT_TOP;
+			}
+			break;
+		case kAttr_floatalign:
+			{
+				UINT uAlign = GetFloatAlign();
+				// 解析文字属性
+				while( *pstrValue != _T('\0') ) {
+					CDuiString sValue;
+					while( *pstrValue == _T(',') || *pstrValue == _T(' ') ) pstrValue = ::CharNext(pstrValue);
+
+					while( *pstrValue != _T('\0') && *pstrValue != _T(',') && *pstrValue != _T(' ') ) {
+						LPTSTR pstrTemp = ::CharNext(pstrValue);
+						while( pstrValue < pstrTemp) {
+							sValue += *pstrValue++;
+						}
+					}
+					if(sValue.CompareNoCase(_T("null")) == 0) {
+						uAlign = 0;
+					}
+					if( sValue.CompareNoCase(_T("left")) == 0 ) {
+						uAlign &= ~(DT_CENTER | DT_RIGHT);
+						uAlign |= DT_LEFT;
+					}
+					else if( sValue.CompareNoCase(_T("center")) == 0 ) {
+						uAlign &= ~(DT_LEFT | DT_RIGHT);
+						uAlign |= DT_CENTER;
+					}
+					else if( sValue.CompareNoCase(_T("right")) == 0 ) {
+						uAlign &= ~(DT_LEFT | DT_CENTER);
+						uAlign |= DT_RIGHT;
+					}
+					else if( sValue.CompareNoCase(_T("top")) == 0 ) {
+						uAlign &= ~(DT_BOTTOM | DT_VCENTER);
+						uAlign |= DT_TOP;
+					}
+					else if( sValue.CompareNoCase(_T("vcenter")) == 0 ) {
+						uAlign &= ~(DT_TOP | DT_BOTTOM);
+						uAlign |= DT_VCENTER;
+					}
+					else if( sValue.CompareNoCase(_T("bottom")) == 0 ) {
+						uAlign &= ~(DT_TOP | DT_VCENTER);
+						uAlign |= DT_BOTTOM;
+					}
 				}
-				else if( sValue.CompareNoCase(_T("vcenter")) == 0 ) {
-					uAlign &= ~(DT_TOP | DT_BOTTOM);
-					uAlign |= DT_VCENTER;
+				SetFloatAlign(uAlign);
+			}
+			break;
+		case kAttr_padding:
+			{
+				RECT rcPadding = { 0 };
+				LPTSTR pstr = NULL;
+				rcPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				rcPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
+				rcPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
+				rcPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
+				SetPadding(rcPadding);
+			}
+			break;
+		case kAttr_gradient: SetGradient(pstrValue); break;
+		case kAttr_bkcolor:
+		case kAttr_bkcolor1:
+			{
+				while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetBkColor(clrColor);
+			}
+			break;
+		case kAttr_bkcolor2:
+			{
+				while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetBkColor2(clrColor);
+			}
+			break;
+		case kAttr_bkcolor3:
+			{
+				while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetBkColor3(clrColor);
+			}
+			break;
+		case kAttr_forecolor:
+			{
+				while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetForeColor(clrColor);
+			}
+			break;
+		case kAttr_bordercolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetBorderColor(clrColor);
+			}
+			break;
+		case kAttr_focusbordercolor:
+			{
+				if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
+				LPTSTR pstr = NULL;
+				DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
+				SetFocusBorderColor(clrColor);
+			}
+			break;
+		case kAttr_colorhsl: SetColorHSL(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_bordersize:
+			{
+				CDuiString nValue = pstrValue;
+				if(nValue.Find(',') < 0) {
+					SetBorderSize(_ttoi(pstrValue));
+					RECT rcPadding = {0};
+					SetBorderSize(rcPadding);
 				}
-				else if( sValue.CompareNoCase(_T("bottom")) == 0 ) {
-					uAlign &= ~(DT_TOP | DT_VCENTER);
-					uAlign |= DT_BOTTOM;
+				else {
+					RECT rcPadding = { 0 };
+					LPTSTR pstr = NULL;
+					rcPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);
+					rcPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);
+					rcPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);
+					rcPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);
+					SetBorderSize(rcPadding);
 				}
 			}
-			SetFloatAlign(uAlign);
-		}
-		else if( _tcsicmp(pstrName, _T("padding")) == 0 ) {
-			RECT rcPadding = { 0 };
-			LPTSTR pstr = NULL;
-			rcPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			rcPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);    
-			rcPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);    
-			rcPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);    
-			SetPadding(rcPadding);
-		}
-		else if( _tcsicmp(pstrName, _T("gradient")) == 0 ) SetGradient(pstrValue);
-		else if( _tcsicmp(pstrName, _T("bkcolor")) == 0 || _tcsicmp(pstrName, _T("bkcolor1")) == 0 ) {
-			while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetBkColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("bkcolor2")) == 0 ) {
-			while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetBkColor2(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("bkcolor3")) == 0 ) {
-			while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetBkColor3(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("forecolor")) == 0 ) {
-			while( *pstrValue > _T('\0') && *pstrValue <= _T(' ') ) pstrValue = ::CharNext(pstrValue);
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetForeColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("bordercolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetBorderColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("focusbordercolor")) == 0 ) {
-			if( *pstrValue == _T('#')) pstrValue = ::CharNext(pstrValue);
-			LPTSTR pstr = NULL;
-			DWORD clrColor = _tcstoul(pstrValue, &pstr, 16);
-			SetFocusBorderColor(clrColor);
-		}
-		else if( _tcsicmp(pstrName, _T("colorhsl")) == 0 ) SetColorHSL(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("bordersize")) == 0 ) {
-			CDuiString nValue = pstrValue;
-			if(nValue.Find(',') < 0) {
-				SetBorderSize(_ttoi(pstrValue));
-				RECT rcPadding = {0};
-				SetBorderSize(rcPadding);
-			}
-			else {
-				RECT rcPadding = { 0 };
+			break;
+		case kAttr_leftbordersize: SetLeftBorderSize(_ttoi(pstrValue)); break;
+		case kAttr_topbordersize: SetTopBorderSize(_ttoi(pstrValue)); break;
+		case kAttr_rightbordersize: SetRightBorderSize(_ttoi(pstrValue)); break;
+		case kAttr_bottombordersize: SetBottomBorderSize(_ttoi(pstrValue)); break;
+		case kAttr_borderstyle: SetBorderStyle(_ttoi(pstrValue)); break;
+		case kAttr_borderround:
+			{
+				SIZE cxyRound = { 0 };
 				LPTSTR pstr = NULL;
-				rcPadding.left = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);
-				rcPadding.top = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);
-				rcPadding.right = _tcstol(pstr + 1, &pstr, 10);  ASSERT(pstr);
-				rcPadding.bottom = _tcstol(pstr + 1, &pstr, 10); ASSERT(pstr);
-				SetBorderSize(rcPadding);
+				cxyRound.cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
+				cxyRound.cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);
+				SetBorderRound(cxyRound);
 			}
-		}
-		else if( _tcsicmp(pstrName, _T("leftbordersize")) == 0 ) SetLeftBorderSize(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("topbordersize")) == 0 ) SetTopBorderSize(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("rightbordersize")) == 0 ) SetRightBorderSize(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("bottombordersize")) == 0 ) SetBottomBorderSize(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("borderstyle")) == 0 ) SetBorderStyle(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("borderround")) == 0 ) {
-			SIZE cxyRound = { 0 };
-			LPTSTR pstr = NULL;
-			cxyRound.cx = _tcstol(pstrValue, &pstr, 10);  ASSERT(pstr);    
-			cxyRound.cy = _tcstol(pstr + 1, &pstr, 10);    ASSERT(pstr);
-			SetBorderRound(cxyRound);
-		}
-		else if( _tcsicmp(pstrName, _T("bkimage")) == 0 ) SetBkImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("foreimage")) == 0 ) SetForeImage(pstrValue);
-		else if( _tcsicmp(pstrName, _T("width")) == 0 ) SetFixedWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("height")) == 0 ) SetFixedHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("minwidth")) == 0 ) SetMinWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("minheight")) == 0 ) SetMinHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("maxwidth")) == 0 ) SetMaxWidth(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("maxheight")) == 0 ) SetMaxHeight(_ttoi(pstrValue));
-		else if( _tcsicmp(pstrName, _T("name")) == 0 ) SetName(pstrValue);
-		else if( _tcsicmp(pstrName, _T("drag")) == 0 ) SetDragEnable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("drop")) == 0 ) SetDropEnable(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("resourcetext")) == 0 ) SetResourceText(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if (_tcsicmp(pstrName, _T("rtext")) == 0) {
-			SetResourceText(true);
-			SetText(pstrValue);
-		}
-		else if( _tcsicmp(pstrName, _T("text")) == 0 ) SetText(pstrValue);
-		else if( _tcsicmp(pstrName, _T("tooltip")) == 0 ) SetToolTip(pstrValue);
-		else if( _tcsicmp(pstrName, _T("userdata")) == 0 ) SetUserData(pstrValue);
-		else if( _tcsicmp(pstrName, _T("enabled")) == 0 ) SetEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("mouse")) == 0 ) SetMouseEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("keyboard")) == 0 ) SetKeyboardEnabled(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("visible")) == 0 ) SetVisible(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("float")) == 0 ) SetFloat(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("shortcut")) == 0 ) SetShortcut(pstrValue[0]);
-		else if( _tcsicmp(pstrName, _T("menu")) == 0 ) SetContextMenuUsed(_tcsicmp(pstrValue, _T("true")) == 0);
-		else if( _tcsicmp(pstrName, _T("cursor")) == 0 && pstrValue) {
-			if( _tcsicmp(pstrValue, _T("arrow")) == 0 )			SetCursor(DUI_ARROW);
-			else if( _tcsicmp(pstrValue, _T("ibeam")) == 0 )	SetCursor(DUI_IBEAM);
-			else if( _tcsicmp(pstrValue, _T("wait")) == 0 )		SetCursor(DUI_WAIT);
-			else if( _tcsicmp(pstrValue, _T("cross")) == 0 )	SetCursor(DUI_CROSS);
-			else if( _tcsicmp(pstrValue, _T("uparrow")) == 0 )	SetCursor(DUI_UPARROW);
-			else if( _tcsicmp(pstrValue, _T("size")) == 0 )		SetCursor(DUI_SIZE);
-			else if( _tcsicmp(pstrValue, _T("icon")) == 0 )		SetCursor(DUI_ICON);
-			else if( _tcsicmp(pstrValue, _T("sizenwse")) == 0 )	SetCursor(DUI_SIZENWSE);
-			else if( _tcsicmp(pstrValue, _T("sizenesw")) == 0 )	SetCursor(DUI_SIZENESW);
-			else if( _tcsicmp(pstrValue, _T("sizewe")) == 0 )	SetCursor(DUI_SIZEWE);
-			else if( _tcsicmp(pstrValue, _T("sizens")) == 0 )	SetCursor(DUI_SIZENS);
-			else if( _tcsicmp(pstrValue, _T("sizeall")) == 0 )	SetCursor(DUI_SIZEALL);
-			else if( _tcsicmp(pstrValue, _T("no")) == 0 )		SetCursor(DUI_NO);
-			else if( _tcsicmp(pstrValue, _T("hand")) == 0 )		SetCursor(DUI_HAND);
-		}
-		else if( _tcsicmp(pstrName, _T("virtualwnd")) == 0 ) SetVirtualWnd(pstrValue);
-		else if( _tcsicmp(pstrName, _T("innerstyle")) == 0 ) {
-			CDuiString sXmlData = pstrValue;
-			sXmlData.Replace(_T("&quot;"), _T("\""));
-			LPCTSTR pstrList = sXmlData.GetData();
-			CDuiString sItem;
-			CDuiString sValue;
-			while( *pstrList != _T('\0') ) {
-				sItem.Empty();
-				sValue.Empty();
-				while( *pstrList != _T('\0') && *pstrList != _T('=') ) {
-					LPTSTR pstrTemp = ::CharNext(pstrList);
-					while( pstrList < pstrTemp) {
-						sItem += *pstrList++;
+			break;
+		case kAttr_bkimage: SetBkImage(pstrValue); break;
+		case kAttr_foreimage: SetForeImage(pstrValue); break;
+		case kAttr_width: SetFixedWidth(_ttoi(pstrValue)); break;
+		case kAttr_height: SetFixedHeight(_ttoi(pstrValue)); break;
+		case kAttr_minwidth: SetMinWidth(_ttoi(pstrValue)); break;
+		case kAttr_minheight: SetMinHeight(_ttoi(pstrValue)); break;
+		case kAttr_maxwidth: SetMaxWidth(_ttoi(pstrValue)); break;
+		case kAttr_maxheight: SetMaxHeight(_ttoi(pstrValue)); break;
+		case kAttr_name: SetName(pstrValue); break;
+		case kAttr_class: SetStyleClass(pstrValue); break;
+		case kAttr_drag: SetDragEnable(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_drop: SetDropEnable(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_resourcetext: SetResourceText(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_rtext:
+			{
+				SetResourceText(true);
+				SetText(pstrValue);
+			}
+			break;
+		case kAttr_text: SetText(pstrValue); break;
+		case kAttr_tooltip: SetToolTip(pstrValue); break;
+		case kAttr_userdata: SetUserData(pstrValue); break;
+		case kAttr_enabled: SetEnabled(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_mouse: SetMouseEnabled(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_keyboard: SetKeyboardEnabled(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_visible: SetVisible(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_shortcut: SetShortcut(pstrValue[0]); break;
+		case kAttr_menu: SetContextMenuUsed(_tcsicmp(pstrValue, _T("true")) == 0); break;
+		case kAttr_cursor:
+			{
+				if( pstrValue == NULL ) AddCustomAttribute(pstrName, pstrValue);
+				else if( _tcsicmp(pstrValue, _T("arrow")) == 0 )			SetCursor(DUI_ARROW);
+				else if( _tcsicmp(pstrValue, _T("ibeam")) == 0 )	SetCursor(DUI_IBEAM);
+				else if( _tcsicmp(pstrValue, _T("wait")) == 0 )		SetCursor(DUI_WAIT);
+				else if( _tcsicmp(pstrValue, _T("cross")) == 0 )	SetCursor(DUI_CROSS);
+				else if( _tcsicmp(pstrValue, _T("uparrow")) == 0 )	SetCursor(DUI_UPARROW);
+				else if( _tcsicmp(pstrValue, _T("size")) == 0 )		SetCursor(DUI_SIZE);
+				else if( _tcsicmp(pstrValue, _T("icon")) == 0 )		SetCursor(DUI_ICON);
+				else if( _tcsicmp(pstrValue, _T("sizenwse")) == 0 )	SetCursor(DUI_SIZENWSE);
+				else if( _tcsicmp(pstrValue, _T("sizenesw")) == 0 )	SetCursor(DUI_SIZENESW);
+				else if( _tcsicmp(pstrValue, _T("sizewe")) == 0 )	SetCursor(DUI_SIZEWE);
+				else if( _tcsicmp(pstrValue, _T("sizens")) == 0 )	SetCursor(DUI_SIZENS);
+				else if( _tcsicmp(pstrValue, _T("sizeall")) == 0 )	SetCursor(DUI_SIZEALL);
+				else if( _tcsicmp(pstrValue, _T("no")) == 0 )		SetCursor(DUI_NO);
+				else if( _tcsicmp(pstrValue, _T("hand")) == 0 )		SetCursor(DUI_HAND);
+			}
+			break;
+		case kAttr_virtualwnd: SetVirtualWnd(pstrValue); break;
+		case kAttr_innerstyle:
+			{
+				CDuiString sXmlData = pstrValue;
+				sXmlData.Replace(_T("&quot;"), _T("\""));
+				LPCTSTR pstrList = sXmlData.GetData();
+				CDuiString sItem;
+				CDuiString sValue;
+				while( *pstrList != _T('\0') ) {
+					sItem.Empty();
+					sValue.Empty();
+					while( *pstrList != _T('\0') && *pstrList != _T('=') ) {
+						LPTSTR pstrTemp = ::CharNext(pstrList);
+						while( pstrList < pstrTemp) {
+							sItem += *pstrList++;
+						}
 					}
-				}
-				ASSERT( *pstrList == _T('=') );
-				if( *pstrList++ != _T('=') ) return;
-				ASSERT( *pstrList == _T('\"') );
-				if( *pstrList++ != _T('\"') ) return;
-				while( *pstrList != _T('\0') && *pstrList != _T('\"') ) {
-					LPTSTR pstrTemp = ::CharNext(pstrList);
-					while( pstrList < pstrTemp) {
-						sValue += *pstrList++;
+					ASSERT( *pstrList == _T('=') );
+					if( *pstrList++ != _T('=') ) return;
+					ASSERT( *pstrList == _T('\"') );
+					if( *pstrList++ != _T('\"') ) return;
+					while( *pstrList != _T('\0') && *pstrList != _T('\"') ) {
+						LPTSTR pstrTemp = ::CharNext(pstrList);
+						while( pstrList < pstrTemp) {
+							sValue += *pstrList++;
+						}
 					}
+					ASSERT( *pstrList == _T('\"') );
+					if( *pstrList++ != _T('\"') ) return;
+					SetAttribute(sItem, sValue);
+					if( *pstrList++ != _T(' ') && *pstrList++ != _T(',') ) return;
 				}
-				ASSERT( *pstrList == _T('\"') );
-				if( *pstrList++ != _T('\"') ) return;
-				SetAttribute(sItem, sValue);
-				if( *pstrList++ != _T(' ') && *pstrList++ != _T(',') ) return;
 			}
+			break;
+		default:
+			{
+				AddCustomAttribute(pstrName, pstrValue);
+			}
+			break;
 		}
-		else {
-			AddCustomAttribute(pstrName, pstrValue);
+	}
+
+	CssSetter CControlUI::GetCssSetter(LPCTSTR pstrName)
+	{
+		struct Entry {
+			LPCTSTR name;
+			CssSetter setter;
+		};
+#define CSS_SETTER(...) [](void* target, const CssDeclaration& d) { CControlUI* p = static_cast<CControlUI*>(target); const CssValue& v = d.parsed; __VA_ARGS__; }
+		// 与SetAttribute的解析方式一一对应，需要解析字符串的属性(style、float、cursor等)不在此列
+		static const Entry entries[] = {
+			{ _T("pos"), CSS_SETTER(
+				SIZE szXY = { v.numbers[0] >= 0 ? v.numbers[0] : v.numbers[2], v.numbers[1] >= 0 ? v.numbers[1] : v.numbers[3] };
+				p->SetFixedXY(szXY);
+				p->SetFixedWidth(v.numbers[2] - v.numbers[0]);
+				p->SetFixedHeight(v.numbers[3] - v.numbers[1])) },
+			{ _T("flex"), CSS_SETTER(p->m_nFlex = v.numbers[0]) },
+			{ _T("padding"), CSS_SETTER(
+				RECT rc = { v.numbers[0], v.numbers[1], v.numbers[2], v.numbers[3] };
+				p->SetPadding(rc)) },
+			{ _T("bkcolor"), CSS_SETTER(p->SetBkColor(v.color)) },
+			{ _T("bkcolor1"), CSS_SETTER(p->SetBkColor(v.color)) },
+			{ _T("bkcolor2"), CSS_SETTER(p->SetBkColor2(v.color)) },
+			{ _T("bkcolor3"), CSS_SETTER(p->SetBkColor3(v.color)) },
+			{ _T("forecolor"), CSS_SETTER(p->SetForeColor(v.color)) },
+			{ _T("bordercolor"), CSS_SETTER(p->SetBorderColor(v.color)) },
+			{ _T("focusbordercolor"), CSS_SETTER(p->SetFocusBorderColor(v.color)) },
+			{ _T("colorhsl"), CSS_SETTER(p->SetColorHSL(v.boolean)) },
+			{ _T("bordersize"), CSS_SETTER(
+				if (!v.list) {
+					p->SetBorderSize((int)v.numbers[0]);
+					RECT rc = { 0 };
+					p->SetBorderSize(rc);
+				}
+				else {
+					RECT rc = { v.numbers[0], v.numbers[1], v.numbers[2], v.numbers[3] };
+					p->SetBorderSize(rc);
+				}) },
+			{ _T("leftbordersize"), CSS_SETTER(p->SetLeftBorderSize(v.numbers[0])) },
+			{ _T("topbordersize"), CSS_SETTER(p->SetTopBorderSize(v.numbers[0])) },
+			{ _T("rightbordersize"), CSS_SETTER(p->SetRightBorderSize(v.numbers[0])) },
+			{ _T("bottombordersize"), CSS_SETTER(p->SetBottomBorderSize(v.numbers[0])) },
+			{ _T("borderstyle"), CSS_SETTER(p->SetBorderStyle(v.numbers[0])) },
+			{ _T("borderround"), CSS_SETTER(
+				SIZE cxyRound = { v.numbers[0], v.numbers[1] };
+				p->SetBorderRound(cxyRound)) },
+			{ _T("bkimage"), CSS_SETTER(p->SetBkImage(d.value.c_str())) },
+			{ _T("foreimage"), CSS_SETTER(p->SetForeImage(d.value.c_str())) },
+			{ _T("width"), CSS_SETTER(p->SetFixedWidth(v.numbers[0])) },
+			{ _T("height"), CSS_SETTER(p->SetFixedHeight(v.numbers[0])) },
+			{ _T("minwidth"), CSS_SETTER(p->SetMinWidth(v.numbers[0])) },
+			{ _T("minheight"), CSS_SETTER(p->SetMinHeight(v.numbers[0])) },
+			{ _T("maxwidth"), CSS_SETTER(p->SetMaxWidth(v.numbers[0])) },
+			{ _T("maxheight"), CSS_SETTER(p->SetMaxHeight(v.numbers[0])) },
+			{ _T("name"), CSS_SETTER(p->SetName(d.value.c_str())) },
+			{ _T("drag"), CSS_SETTER(p->SetDragEnable(v.boolean)) },
+			{ _T("drop"), CSS_SETTER(p->SetDropEnable(v.boolean)) },
+			{ _T("resourcetext"), CSS_SETTER(p->SetResourceText(v.boolean)) },
+			{ _T("text"), CSS_SETTER(p->SetText(d.value.c_str())) },
+			{ _T("tooltip"), CSS_SETTER(p->SetToolTip(d.value.c_str())) },
+			{ _T("userdata"), CSS_SETTER(p->SetUserData(d.value.c_str())) },
+			{ _T("enabled"), CSS_SETTER(p->SetEnabled(v.boolean)) },
+			{ _T("mouse"), CSS_SETTER(p->SetMouseEnabled(v.boolean)) },
+			{ _T("keyboard"), CSS_SETTER(p->SetKeyboardEnabled(v.boolean)) },
+			{ _T("visible"), CSS_SETTER(p->SetVisible(v.boolean)) },
+			{ _T("menu"), CSS_SETTER(p->SetContextMenuUsed(v.boolean)) },
+		};
+#undef CSS_SETTER
+
+		for (size_t i = 0; i < sizeof(entries) / sizeof(entries[0]); ++i) {
+			if (_tcsicmp(pstrName, entries[i].name) == 0)
+				return entries[i].setter;
 		}
+		return NULL;
 	}
 
 	CControlUI* CControlUI::ApplyAttributeList(LPCTSTR pstrValue)
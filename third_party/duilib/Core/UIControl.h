@@ -189,8 +189,19 @@ namespace DuiLib {
 		void RemoveAllSaveAttribute();
 		void ApplySaveAttributeList();
 
+		// css的class，多个用空格分开，在界面中修改时会重新匹配样式
+		void SetStyleClass(LPCTSTR pstrClass);
+		CDuiString GetStyleClass() const;
+		// 匹配css用的元素名、匹配到的规则及内联属性，没有样式化过的控件为NULL
+		CssStyleState* GetCssState(bool bCreate = false);
+
 		virtual void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		static int GetAttributeId(LPCTSTR pstrName);
+		static const LPCTSTR* GetAttributeNames(int& nCount);
 		CControlUI* ApplyAttributeList(LPCTSTR pstrList);
+		// 返回直接应用预解析css值的函数，效果与SetAttribute相同，没有时返回NULL并回退到SetAttribute。
+		// 用IMPLEMENT_DUIATTRIBUTES的子类自动对自己表中的属性返回NULL，用字符串比较处理基类属性的子类需要自己重载
+		virtual CssSetter GetCssSetter(LPCTSTR pstrName);
 
 		virtual SIZE EstimateSize(SIZE szAvailable);
 		virtual bool Paint(HDC hDC, const RECT& rcPaint, CControlUI* pStopControl = NULL); // 返回要不要继续绘制
@@ -272,6 +283,8 @@ namespace DuiLib {
 
 		CStdStringPtrMap m_mCustomAttrHash;
 		CStdPtrArray m_mSaveAttrList;
+		CDuiString m_sStyleClass;
+		CssStyleState* m_pCssState;
 	};
 
 } // namespace DuiLib
@@ -1,4 +1,5 @@
 #include "StdAfx.h"
+#include <vector>
 
 namespace DuiLib {
 
@@ -63,6 +64,14 @@ namespace DuiLib {
 	}
 
 	CControlUI* CDialogBuilder::Create(IDialogBuilderCallback* pCallback, CPaintManagerUI* pManager, CControlUI* pParent)
+	{
+		// 创建出的控件加到pParent下，匹配css时pParent及其祖先接在文档内的祖先后面
+		m_aCssAncestors.clear();
+		if( pManager ) pManager->GetCssAncestors(pParent, m_aCssAncestors);
+		return _Create(pCallback, pManager, pParent);
+	}
+
+	CControlUI* CDialogBuilder::_Create(IDialogBuilderCallback* pCallback, CPaintManagerUI* pManager, CControlUI* pParent)
 	{
 		m_pCallback = pCallback;
 		CMarkupNode root = m_xml.GetRoot();
@@ -74,6 +83,7 @@ namespace DuiLib {
 			LPCTSTR pstrName = NULL;
 			LPCTSTR pstrValue = NULL;
 			LPTSTR pstr = NULL;
+			std::vector<std::pair<LPCTSTR, DWORD>> aSharedImages;
 			for( CMarkupNode node = root.GetChild() ; node.IsValid(); node = node.GetSibling() ) {
 				pstrClass = node.GetName();
 				if( _tcsicmp(pstrClass, _T("Image")) == 0 ) {
@@ -99,7 +109,14 @@ namespace DuiLib {
 							shared = (_tcsicmp(pstrValue, _T("true")) == 0);
 						}
 					}
-					if( pImageName ) pManager->AddImage(pImageName, pImageResType, mask, false, shared);
+					if( pImageName ) {
+						if( pImageResType != NULL && pImageResType[0] != _T('\0') ) pManager->AddImage(pImageName, pImageResType, mask, false, shared);
+						else {
+							// 文件图片在后台解码，第一次用到时才加入
+							pManager->PreloadImage(pImageName, mask);
+							if( shared ) aSharedImages.push_back(std::make_pair(pImageName, mask));
+						}
+					}
 				}
 				else if( _tcsicmp(pstrClass, _T("Font")) == 0 ) {
 					nAttributes = node.GetAttributeCount();
@@ -217,6 +234,14 @@ namespace DuiLib {
 				}
 			}
 
+			// 创建控件前提交控件属性和css中的全部图片，并行解码
+			_PreloadImages(&root, pManager);
+			pManager->PreloadCssImages();
+
+			// 共享图片要放入共享表供其他窗口使用，此时各图片已在并行解码
+			for( size_t i = 0; i < aSharedImages.size(); i++ ) {
+				pManager->AddImage(aSharedImages[i].first, NULL, aSharedImages[i].second, false, true);
+			}
 		}
 		CControlUI* pControl = _Parse(&root, pParent, pManager);
 
@@ -256,6 +281,39 @@ namespace DuiLib {
 		return m_xml.GetLastErrorLocation(pstrSource, cchMax);
 	}
 
+	void CDialogBuilder::_PreloadImages(CMarkupNode* pRoot, CPaintManagerUI* pManager)
+	{
+		int nAttributes = pRoot->GetAttributeCount();
+		for( int i = 0; i < nAttributes; i++ ) {
+			pManager->PreloadImageAttribute(pRoot->GetAttributeName(i), pRoot->GetAttributeValue(i));
+		}
+
+		for( CMarkupNode node = pRoot->GetChild() ; node.IsValid(); node = node.GetSibling() ) {
+			// Include的文件由它自己的builder预加载
+			LPCTSTR pstrClass = node.GetName();
+			if( _tcsicmp(pstrClass, _T("Image")) == 0 || _tcsicmp(pstrClass, _T("Font")) == 0 \
+				|| _tcsicmp(pstrClass, _T("Default")) == 0 || _tcsicmp(pstrClass, _T("Style")) == 0 \
+				|| _tcsicmp(pstrClass, _T("Import")) == 0 || _tcsicmp(pstrClass, _T("Include")) == 0 ) continue;
+			_PreloadImages(&node, pManager);
+		}
+	}
+
+	// xml中子控件先于父控件创建，祖先的标签、name和class从节点上取。
+	// 根节点（Window）不创建控件，不算祖先；文档外的祖先outer接在最后
+	static void GetCssAncestors(CMarkupNode node, const std::vector<CssElement>& outer, std::vector<CssElement>& ancestors)
+	{
+		for( CMarkupNode parent = node.GetParent(); parent.IsValid() && parent.GetParent().IsValid(); parent = parent.GetParent() ) {
+			ancestors.push_back(CssElement());
+			CssElement& element = ancestors.back();
+			element.tag = parent.GetName();
+			LPCTSTR pstrName = parent.GetAttributeValue(_T("name"));
+			if( pstrName ) element.id = pstrName;
+			LPCTSTR pstrClass = parent.GetAttributeValue(_T("class"));
+			if( pstrClass ) element.SetClasses(pstrClass);
+		}
+		ancestors.insert(ancestors.end(), outer.begin(), outer.end());
+	}
+
 	CControlUI* CDialogBuilder::_Parse(CMarkupNode* pRoot, CControlUI* pParent, CPaintManagerUI* pManager)
 	{
 		IContainerUI* pContainer = NULL;
@@ -279,14 +337,18 @@ namespace DuiLib {
 					count = _tcstol(szValue, &pstr, 10);
 				cchLen = lengthof(szValue) - 1;
 				if ( !node.GetAttributeValue(_T("source"), szValue, cchLen) ) continue;
+				// pParent此时还没有加到它的父控件上，被包含的内容接着用Include外面的祖先
+				std::vector<CssElement> ancestors;
+				if( pManager ) GetCssAncestors(node, m_aCssAncestors, ancestors);
 				for ( int i = 0; i < count; i++ ) {
 					CDialogBuilder builder;
+					builder.m_aCssAncestors = ancestors;
 					if( m_pstrtype != NULL ) { // 使用资源dll，从资源中读取
 						WORD id = (WORD)_tcstol(szValue, &pstr, 10); 
-						pControl = builder.Create((UINT)id, m_pstrtype, m_pCallback, pManager, pParent);
+						pControl = builder.Load((UINT)id, m_pstrtype) ? builder._Create(m_pCallback, pManager, pParent) : NULL;
 					}
 					else {
-						pControl = builder.Create((LPCTSTR)szValue, (UINT)0, m_pCallback, pManager, pParent);
+						pControl = builder.Load((LPCTSTR)szValue) ? builder._Create(m_pCallback, pManager, pParent) : NULL;
 					}
 				}
 				continue;
@@ -384,17 +446,26 @@ namespace DuiLib {
 				}
 
 				// Process css style
-				pManager->ApplyCss(pControl, pstrClass,node.GetAttributeValue(_T("class")), 
-					node.GetAttributeValue(_T("name")));
+				CssElement element;
+				element.tag = pstrClass;
+				LPCTSTR pstrName = node.GetAttributeValue(_T("name"));
+				if( pstrName ) element.id = pstrName;
+				LPCTSTR pstrCssClass = node.GetAttributeValue(_T("class"));
+				if( pstrCssClass ) element.SetClasses(pstrCssClass);
+				std::vector<CssElement> ancestors;
+				if( pManager->HasDescendantCss() ) GetCssAncestors(node, m_aCssAncestors, ancestors);
+				pManager->ApplyCss(pControl, element, ancestors);
 			}
 
 			// Process attributes
 			if( node.HasAttributes() ) {
 				TCHAR szValue[500] = { 0 };
 				SIZE_T cchLen = lengthof(szValue) - 1;
-				// Set ordinary attributes
+				// Set ordinary attributes, css changes or sheets loaded later won't override them
+				CssStyleState* pCssState = pControl->GetCssState(true);
 				int nAttributes = node.GetAttributeCount();
 				for( int i = 0; i < nAttributes; i++ ) {
+					pCssState->SetInline(node.GetAttributeName(i));
 					pControl->SetAttribute(node.GetAttributeName(i), node.GetAttributeValue(i));
 				}
 			}
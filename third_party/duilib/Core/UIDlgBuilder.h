@@ -28,12 +28,15 @@ namespace DuiLib {
 		void GetLastErrorLocation(LPTSTR pstrSource, SIZE_T cchMax) const;
 	    void SetInstance(HINSTANCE instance){ m_instance = instance;};
 	private:
+		CControlUI* _Create(IDialogBuilderCallback* pCallback, CPaintManagerUI* pManager, CControlUI* pParent);
 		CControlUI* _Parse(CMarkupNode* parent, CControlUI* pParent = NULL, CPaintManagerUI* pManager = NULL);
+		void _PreloadImages(CMarkupNode* pRoot, CPaintManagerUI* pManager);
 
 		CMarkup m_xml;
 		IDialogBuilderCallback* m_pCallback;
 		LPCTSTR m_pstrtype;
     	HINSTANCE m_instance;
+		std::vector<CssElement> m_aCssAncestors;	// 文档外的祖先，从近到远
 	};
 
 } // namespace DuiLib
@@ -1,5 +1,7 @@
 #include "StdAfx.h"
 #include <zmouse.h>
+#include <typeinfo>
+#include <algorithm>
 
 namespace DuiLib {
 
@@ -199,6 +201,15 @@ namespace DuiLib {
 	CStdPtrArray CPaintManagerUI::m_aPreMessages;
 	CStdPtrArray CPaintManagerUI::m_aPlugins;
 
+	// 在图片线程上读取预加载的图片
+	static std::unique_ptr<uint8_t[]> ReadPreloadImage(const image_string& name, size_t& size, int& scale)
+	{
+		DWORD dwSize = 0;
+		LPBYTE pData = CRenderEngine::ReadImage(name.c_str(), NULL, NULL, dwSize, scale);
+		size = dwSize;
+		return std::unique_ptr<uint8_t[]>(pData);
+	}
+
 	CPaintManagerUI::CPaintManagerUI() :
 	m_hWndPaint(NULL),
 		m_hDcPaint(NULL),
@@ -232,7 +243,9 @@ namespace DuiLib {
 		m_bDragMode(false),
 		m_hDragBitmap(NULL),
 		m_pDPI(NULL),
-		m_iHoverTime(400UL)
+		m_iHoverTime(400UL),
+		m_bCssUpdating(false),
+		m_ImagePreloader(&ReadPreloadImage)
 	{
 		if (m_SharedResInfo.m_DefaultFontInfo.sFontName.IsEmpty())
 		{
@@ -535,6 +548,7 @@ namespace DuiLib {
 		for( int i = 0; i < m_aPreMessages.GetSize(); i++ ) {
 			CPaintManagerUI* pManager = static_cast<CPaintManagerUI*>(m_aPreMessages[i]);
 			pManager->ReloadImages();
+			pManager->ReloadCss();
 		}
 	}
 
@@ -1023,6 +1037,9 @@ namespace DuiLib {
 				RECT rcPaint = { 0 };
 				if( !::GetUpdateRect(m_hWndPaint, &rcPaint, FALSE) ) return true;
 
+				// 先应用变化的样式，和其它修改一起布局
+				UpdateCss();
+
 				//if( m_bLayered ) {
 				//	m_bOffscreenPaint = true;
 				//	rcPaint = m_rcLayeredUpdate;
@@ -1889,6 +1906,7 @@ namespace DuiLib {
 
 	void CPaintManagerUI::Invalidate()
 	{
+		if( m_bCssUpdating ) return;
 		RECT rcClient = { 0 };
 		::GetClientRect(m_hWndPaint, &rcClient);
 		::UnionRect(&m_rcLayeredUpdate, &m_rcLayeredUpdate, &rcClient);
@@ -1897,6 +1915,7 @@ namespace DuiLib {
 
 	void CPaintManagerUI::Invalidate(const RECT& param)
 	{
+		if( m_bCssUpdating ) return;
 		RECT rcItem = param;
 		if( rcItem.left < 0 ) rcItem.left = 0;
 		if( rcItem .top < 0 ) rcItem.top = 0;
@@ -1958,6 +1977,12 @@ namespace DuiLib {
 			TNotifyUI* pMsg = static_cast<TNotifyUI*>(m_aAsyncNotify[i]);
 			if( pMsg->pSender == pControl ) pMsg->pSender = NULL;
 		}    
+		for( int i = m_aCssDirty.GetSize() - 1; i >= 0; i-- ) {
+			if( m_aCssDirty[i] == pControl ) m_aCssDirty.Remove(i);
+		}
+		for( int i = m_aCssDirtyTree.GetSize() - 1; i >= 0; i-- ) {
+			if( m_aCssDirtyTree[i] == pControl ) m_aCssDirtyTree.Remove(i);
+		}
 	}
 
 	bool CPaintManagerUI::AddOptionGroup(LPCTSTR pStrGroupName, CControlUI* pControl)
@@ -3174,6 +3199,11 @@ namespace DuiLib {
 	{
 		TImageInfo* data = static_cast<TImageInfo*>(m_ResInfo.m_ImageHash.Find(bitmap));
 		if( !data ) data = static_cast<TImageInfo*>(m_SharedResInfo.m_ImageHash.Find(bitmap));
+		if( !data ) {
+			// 预加载的图片第一次用到时才加入
+			uint32_t mask = 0;
+			if( bitmap != NULL && m_ImagePreloader.Lookup(bitmap, mask) ) return AddImage(bitmap, NULL, mask);
+		}
 		return data;
 	}
 
@@ -3203,7 +3233,9 @@ namespace DuiLib {
 			}
 		}
 		else {
-			data = CRenderEngine::LoadImage(bitmap, NULL, mask, instance);
+			CDecodedImage image;
+			if( instance == NULL && m_ImagePreloader.Take(bitmap, mask, image) ) data = CRenderEngine::CreateImage(image, mask);
+			else data = CRenderEngine::LoadImage(bitmap, NULL, mask, instance);
 		}
 
 		if( data == NULL ) {
@@ -3339,7 +3371,53 @@ namespace DuiLib {
 				}
 			}
 			m_ResInfo.m_ImageHash.RemoveAll();
+			m_ImagePreloader.Clear();
+		}
+	}
+
+	void CPaintManagerUI::PreloadImage(LPCTSTR bitmap, DWORD mask)
+	{
+		if( bitmap == NULL || bitmap[0] == _T('\0') ) return;
+		if( m_ResInfo.m_ImageHash.Find(bitmap) || m_SharedResInfo.m_ImageHash.Find(bitmap) ) return;
+
+		// svg由CSvgCache解析和栅格化，不经过预加载
+		if( CSvgCache::IsSvg(bitmap) ) return;
+
+		uint32_t pending = 0;
+		if( m_ImagePreloader.Lookup(bitmap, pending) ) return;
+
+		if( IsCachedResourceZip() ) {
+			// 缓存的zip句柄不能多线程使用，在界面线程读出数据，只把解码放到图片线程
+			DWORD dwSize = 0;
+			int scale = 100;
+			LPBYTE pData = CRenderEngine::ReadImage(bitmap, NULL, NULL, dwSize, scale);
+			if( pData ) m_ImagePreloader.Preload(bitmap, mask, std::unique_ptr<uint8_t[]>(pData), dwSize, scale);
 		}
+		else {
+			m_ImagePreloader.Preload(bitmap, mask);
+		}
+	}
+
+	void CPaintManagerUI::PreloadImageAttribute(LPCTSTR pstrName, LPCTSTR pstrValue)
+	{
+		if( pstrName == NULL || pstrValue == NULL || pstrValue[0] == _T('\0') ) return;
+		size_t len = _tcslen(pstrName);
+		if( len < 5 || _tcsicmp(pstrName + len - 5, _T("image")) != 0 ) return;
+
+		// 与绘制时使用同一份TDrawInfo，得到的文件名已按dpi调整
+		const TDrawInfo* pDrawInfo = GetDrawInfo(pstrValue, NULL);
+		if( pDrawInfo == NULL || !pDrawInfo->sResType.IsEmpty() ) return;
+		PreloadImage(pDrawInfo->sImageName, pDrawInfo->dwMask);
+	}
+
+	void CPaintManagerUI::PreloadCssImages()
+	{
+		m_cssSheets.EnumStyles([this](const CssStyles& styles) {
+			for (auto itr = styles.begin(); itr != styles.end(); ++itr)
+			{
+				PreloadImageAttribute(itr->first.c_str(), itr->second.c_str());
+			}
+		});
 	}
 
 	void CPaintManagerUI::AdjustSharedImagesHSL()
@@ -3378,6 +3456,9 @@ namespace DuiLib {
 	}
 	void CPaintManagerUI::ReloadSharedImages()
 	{
+		// 解析过的svg文档可能已过期
+		CSvgCache::GetInstance()->Clear();
+
 		TImageInfo* data = nullptr;
 		TImageInfo* pNewData = nullptr;
 		for( int i = 0; i< m_SharedResInfo.m_ImageHash.GetSize(); i++ ) {
@@ -3419,6 +3500,7 @@ namespace DuiLib {
 	void CPaintManagerUI::ReloadImages()
 	{
 		RemoveAllDrawInfos();
+		CSvgCache::GetInstance()->Clear();
 
 		TImageInfo* data = nullptr;
 		TImageInfo* pNewData = nullptr;
@@ -3755,6 +3837,12 @@ namespace DuiLib {
 		return NULL;
 	}
 
+	CControlUI* CALLBACK CPaintManagerUI::__FindControlsForCss(CControlUI* pThis, LPVOID pData)
+	{
+		static_cast<std::vector<CControlUI*>*>(pData)->push_back(pThis);
+		return NULL;
+	}
+
 	CControlUI* CALLBACK CPaintManagerUI::__FindControlsFromUpdate(CControlUI* pThis, LPVOID pData)
 	{
 		if( pThis->IsUpdateNeeded() ) {
@@ -3846,18 +3934,33 @@ namespace DuiLib {
 		m_bUsedVirtualWnd = bUsed;
 	}
 
-	bool CPaintManagerUI::LoadCss(LPCTSTR pStrCssFile) 
+	// 读取css文件，内容与缓存中的相同时不再转换和解析
+	static std::shared_ptr<const CssSheet> LoadSharedCss(LPCTSTR pStrCssFile, bool* pResult)
 	{
 		DWORD size;
 		TCHAR buf[128];
 		BYTE* pData = CResourceManager::LoadFile(pStrCssFile, &size, buf);
+		if (pData == NULL) return nullptr;
 
-		if (pData) 
-		{
-			wchar_t* css = a2w((const char*)pData);
-			bool rslt = ParseCss(css);
+		// LoadFile的数据以0结尾
+		std::shared_ptr<const CssSheet> sheet = CssSheetCache::GetInstance()->Load(pStrCssFile, pData, size, [](const uint8_t* data, size_t) {
+			wchar_t* css = a2w((const char*)data);
+			css_string text(css);
 			delete[] css;
-			delete[] pData;
+			return text;
+		}, pResult);
+		delete[] pData;
+		return sheet;
+	}
+
+	bool CPaintManagerUI::LoadCss(LPCTSTR pStrCssFile) 
+	{
+		bool rslt = false;
+		std::shared_ptr<const CssSheet> sheet = LoadSharedCss(pStrCssFile, &rslt);
+		if (sheet) 
+		{
+			// 已叠放的同一文件不再重新匹配整棵树
+			if (m_cssSheets.Add(pStrCssFile, sheet) && m_pRoot != NULL) InvalidateCss(m_pRoot, true);
 			return rslt;
 		}
 		return false;
@@ -3868,64 +3971,195 @@ namespace DuiLib {
 	{
 		if (pStrCss) 
 		{
-			return m_cssSheet.Parse(pStrCss);
+			bool rslt = false;
+			if (m_cssSheets.Add(_T(""), CssSheetCache::GetInstance()->Parse(pStrCss, &rslt)) && m_pRoot != NULL)
+				InvalidateCss(m_pRoot, true);
+			return rslt;
 		}
 		return false;
 	}
 
+	void CPaintManagerUI::ReloadCss()
+	{
+		bool bChanged = false;
+		std::vector<css_string> paths = m_cssSheets.GetPaths();
+		for (size_t i = 0; i < paths.size(); ++i)
+		{
+			std::shared_ptr<const CssSheet> sheet = LoadSharedCss(paths[i].c_str(), NULL);
+			if (sheet && m_cssSheets.Update(paths[i], sheet)) bChanged = true;
+		}
+		// 匹配结果没变的控件不会重新设置属性
+		if (bChanged && m_pRoot != NULL) InvalidateCss(m_pRoot, true);
+	}
 
-	void ApplyControlCss(CControlUI* pControl, std::shared_ptr<CssStyles> sheets) {
-		if (!sheets)
-			return;
 
-		for (auto itr = sheets->begin(); itr != sheets->end(); ++itr) 
-		{
-			pControl->SetAttribute(itr->first.c_str(), itr->second.c_str());
+	// 控件初始化前class和name还在保存的属性中，元素名沿用第一次样式化时的
+	static void GetControlCssElement(CControlUI* pControl, CssElement& element)
+	{
+		CssStyleState* pState = pControl->GetCssState();
+		if (pState != NULL && !pState->GetTag().empty()) {
+			element.tag = pState->GetTag();
+		}
+		else {
+			CDuiString sTag = pControl->GetClass();
+			if (sTag.Right(2) == _T("UI")) sTag = sTag.Left(sTag.GetLength() - 2);
+			element.tag = sTag.GetData();
+		}
+
+		CDuiString sName = pControl->GetName();
+		LPCTSTR pstrName = sName.IsEmpty() ? pControl->GetSaveAttribute(_T("name")) : sName.GetData();
+		if (pstrName) element.id = pstrName;
+
+		CDuiString sClass = pControl->GetStyleClass();
+		LPCTSTR pstrClass = sClass.IsEmpty() ? pControl->GetSaveAttribute(_T("class")) : sClass.GetData();
+		if (pstrClass) element.SetClasses(pstrClass);
+	}
+
+	static void GetControlCssAncestors(CControlUI* pControl, std::vector<CssElement>& ancestors)
+	{
+		for (CControlUI* pParent = pControl->GetParent(); pParent != NULL; pParent = pParent->GetParent()) {
+			ancestors.push_back(CssElement());
+			GetControlCssElement(pParent, ancestors.back());
 		}
 	}
 
 	void CPaintManagerUI::ApplyCss(CControlUI* pControl, LPCTSTR pStrElement, LPCTSTR pStrClass, LPCTSTR pStrName)
 	{
-		std::shared_ptr<CssStyles> sheets;
-		
-		if (pStrElement && pStrElement[0]) {
-			sheets = m_cssSheet.GetStylesByElement(pStrElement);
-			ApplyControlCss(pControl, sheets);
+		CssElement element;
+		if (pStrElement) element.tag = pStrElement;
+		if (pStrName) element.id = pStrName;
+		if (pStrClass) element.SetClasses(pStrClass);
+
+		std::vector<CssElement> ancestors;
+		if (m_cssSheets.HasDescendantSelectors()) GetControlCssAncestors(pControl, ancestors);
+		ApplyCss(pControl, element, ancestors);
+	}
+
+	void CPaintManagerUI::ApplyCss(CControlUI* pControl, const CssElement& element, const std::vector<CssElement>& ancestors)
+	{
+		// 没有样式表时也记下元素名，之后加载样式表时按同样的元素匹配
+		CssStyleState* pState = pControl->GetCssState(true);
+		if (pState->GetTag().empty()) pState->SetTag(element.tag);
+		if (m_cssSheets.IsEmpty()) return;
+
+		// 记下匹配结果，之后只应用变化的部分
+		std::shared_ptr<const CssRuleList> rules = m_cssSheets.Match(element, ancestors);
+		std::vector<CssStyleState::Declaration> changes = pState->Update(rules);
+		for (size_t i = 0; i < changes.size();)
+		{
+			// 每个控件类型只按名字查找一次setter，之后直接使用预解析的值
+			const CssRule* sheets = changes[i].first;
+			const std::vector<CssSetter>& setters = sheets->Resolve(&typeid(*pControl), [pControl](const CssDeclaration& declaration) {
+				return pControl->GetCssSetter(declaration.name.c_str());
+			});
+			for (; i < changes.size() && changes[i].first == sheets; ++i)
+			{
+				size_t index = changes[i].second;
+				const CssDeclaration& declaration = sheets->declarations[index];
+				if (setters[index])
+					setters[index](pControl, declaration);
+				else
+					pControl->SetAttribute(declaration.name.c_str(), declaration.value.c_str());
+			}
 		}
+	}
 
-		if (pStrClass && pStrClass[0]) {
-			sheets = m_cssSheet.GetStylesByClass(pStrClass);
-			ApplyControlCss(pControl, sheets);
+	void CPaintManagerUI::InvalidateCss(CControlUI* pControl, LPCTSTR pstrOldName, LPCTSTR pstrOldClass)
+	{
+		// 还在创建中的控件之后会匹配
+		if (m_cssSheets.IsEmpty() || pControl == NULL || pControl->GetManager() != this) return;
+		if (pControl != m_pRoot && pControl->GetParent() == NULL) return;
+
+		CssElement after;
+		GetControlCssElement(pControl, after);
+		CssElement before = after;
+		if (pstrOldName) before.id = pstrOldName;
+		if (pstrOldClass) before.SetClasses(pstrOldClass);
+		int flags = m_cssSheets.GetInvalidation(before, after);
+		if (flags & kCssInvalidateDescendants) InvalidateCss(pControl, true);
+		else if (flags & kCssInvalidateSelf) InvalidateCss(pControl, false);
+	}
+
+	void CPaintManagerUI::InvalidateCss(CControlUI* pControl, bool bDescendants)
+	{
+		if (pControl == NULL || m_bCssUpdating) return;
+		// 每批只请求一次重新布局
+		if (m_aCssDirty.IsEmpty() && m_aCssDirtyTree.IsEmpty()) {
+			NeedUpdate();
+			Invalidate();
 		}
+		if (bDescendants) m_aCssDirtyTree.Add(pControl);
+		else m_aCssDirty.Add(pControl);
+	}
+
+	void CPaintManagerUI::UpdateCss()
+	{
+		if (m_aCssDirty.IsEmpty() && m_aCssDirtyTree.IsEmpty()) return;
 
-		if (pStrName && pStrName[0]) {
-			sheets = m_cssSheet.GetStylesById(pStrName);
-			ApplyControlCss(pControl, sheets);
+		std::vector<CControlUI*> controls;
+		for (int i = 0; i < m_aCssDirty.GetSize(); i++) {
+			controls.push_back(static_cast<CControlUI*>(m_aCssDirty[i]));
 		}
+		for (int i = 0; i < m_aCssDirtyTree.GetSize(); i++) {
+			static_cast<CControlUI*>(m_aCssDirtyTree[i])->FindControl(__FindControlsForCss, &controls, UIFIND_ALL);
+		}
+		m_aCssDirty.Empty();
+		m_aCssDirtyTree.Empty();
+		std::sort(controls.begin(), controls.end());
+		controls.erase(std::unique(controls.begin(), controls.end()), controls.end());
+
+		// 属性变化引起的刷新合并到最后一次
+		m_bCssUpdating = true;
+		bool bAncestors = m_cssSheets.HasDescendantSelectors();
+		for (size_t i = 0; i < controls.size(); ++i) {
+			CControlUI* pControl = controls[i];
+			if (pControl->GetManager() != this) continue;
+			CssElement element;
+			GetControlCssElement(pControl, element);
+			std::vector<CssElement> ancestors;
+			if (bAncestors) GetControlCssAncestors(pControl, ancestors);
+			ApplyCss(pControl, element, ancestors);
+		}
+		m_bCssUpdating = false;
+		NeedUpdate();
+		Invalidate();
+	}
+
+	bool CPaintManagerUI::HasDescendantCss() const
+	{
+		return m_cssSheets.HasDescendantSelectors();
+	}
+
+	void CPaintManagerUI::GetCssAncestors(CControlUI* pParent, std::vector<CssElement>& ancestors)
+	{
+		if (pParent == NULL) return;
+		ancestors.push_back(CssElement());
+		GetControlCssElement(pParent, ancestors.back());
+		GetControlCssAncestors(pParent, ancestors);
 	}
 
 
-	void ApplyManagerCss(CPaintManagerUI* pManager, std::shared_ptr<CssStyles> sheets) {
+	void ApplyManagerCss(CPaintManagerUI* pManager, std::shared_ptr<const CssRule> sheets) {
 		if (!sheets)
 			return;
 
-		for (auto itr = sheets->begin(); itr != sheets->end(); ++itr)
+		for (auto itr = sheets->declarations.begin(); itr != sheets->declarations.end(); ++itr)
 		{
-			pManager->SetAttribute(itr->first.c_str(), itr->second.c_str());
+			pManager->SetAttribute(itr->name.c_str(), itr->value.c_str());
 		}
 	}
 
 	void CPaintManagerUI::ApplyCss(LPCTSTR pStrElement, LPCTSTR pStrClass)
 	{
-		std::shared_ptr<CssStyles> sheets;
+		std::shared_ptr<const CssRule> sheets;
 
 		if (pStrElement && pStrElement[0]) {
-			sheets = m_cssSheet.GetStylesByElement(pStrElement);
+			sheets = m_cssSheets.GetStylesByElement(pStrElement);
 			ApplyManagerCss(this, sheets);
 		}
 
 		if (pStrClass && pStrClass[0]) {
-			sheets = m_cssSheet.GetStylesByClass(pStrClass);
+			sheets = m_cssSheets.GetStylesByClass(pStrClass);
 			ApplyManagerCss(this, sheets);
 		}
 	}
@@ -329,6 +329,11 @@ namespace DuiLib {
 		const TImageInfo* AddImage(LPCTSTR bitmap, HBITMAP hBitmap, int iWidth, int iHeight, bool bAlpha, bool bShared = false);
 		void RemoveImage(LPCTSTR bitmap, bool bShared = false);
 		void RemoveAllImages(bool bShared = false);
+		// 在图片线程上预先解码图片，GetImage/GetImageEx第一次用到时才加入并只等待这一张
+		void PreloadImage(LPCTSTR bitmap, DWORD mask = 0);
+		// 属性名以image结尾时，按绘制字符串解析出文件名和mask后预加载
+		void PreloadImageAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+		void PreloadCssImages();
 		static void ReloadSharedImages();
 		void ReloadImages();
 
@@ -440,7 +445,23 @@ namespace DuiLib {
 
 		bool LoadCss(LPCTSTR pStrCssFile);
 		bool ParseCss(LPCTSTR pStrCss);
+		// 重新读取已加载的css文件，内容有变化的换成新版本，已有的控件在下次布局前更新
+		void ReloadCss();
+		// 祖先取自控件的GetParent()
 		void ApplyCss(CControlUI* pControl,LPCTSTR pStrElement, LPCTSTR pStrClass, LPCTSTR pStrName);
+		// 按优先级应用所有匹配的规则，ancestors从近到远
+		void ApplyCss(CControlUI* pControl, const CssElement& element, const std::vector<CssElement>& ancestors);
+		// 有后代选择器时才需要收集祖先
+		bool HasDescendantCss() const;
+		// pParent及其祖先，从近到远，用于还没有加到pParent上的子控件
+		void GetCssAncestors(CControlUI* pParent, std::vector<CssElement>& ancestors);
+		// 控件的name或class改变后调用，参数为改变前的值，没有改变的传NULL。
+		// 只有选择器用到的名字改变时才标记控件或其后代需要重新匹配
+		void InvalidateCss(CControlUI* pControl, LPCTSTR pstrOldName, LPCTSTR pstrOldClass);
+		// 标记控件需要重新匹配样式，在下次布局前一起更新
+		void InvalidateCss(CControlUI* pControl, bool bDescendants);
+		// 重新匹配标记过的控件，只设置值有变化的属性。WM_PAINT布局前自动调用
+		void UpdateCss();
 
 		void ApplyCss(LPCTSTR pStrElement, LPCTSTR pStrClass);
 		void SetAttribute(LPCTSTR pStrName, LPCTSTR pStrValue);
@@ -459,6 +480,7 @@ namespace DuiLib {
 		static CControlUI* CALLBACK __FindControlFromClass(CControlUI* pThis, LPVOID pData);
 		static CControlUI* CALLBACK __FindControlsFromClass(CControlUI* pThis, LPVOID pData);
 		static CControlUI* CALLBACK __FindControlsFromUpdate(CControlUI* pThis, LPVOID pData);
+		static CControlUI* CALLBACK __FindControlsForCss(CControlUI* pThis, LPVOID pData);
 
 		static void AdjustSharedImagesHSL();
 		void AdjustImagesHSL();
@@ -553,7 +575,13 @@ namespace DuiLib {
 		HBITMAP m_hDragBitmap;
 		
 		// css样式
-		CssSheet m_cssSheet;
+		CssSheetView m_cssSheets;	// 引用CssSheetCache中共享的样式表
+		CStdPtrArray m_aCssDirty;		// 需要重新匹配的控件
+		CStdPtrArray m_aCssDirtyTree;	// 自身及所有后代需要重新匹配的控件
+		bool m_bCssUpdating;			// 更新期间不逐个刷新控件
+
+		// 预加载的图片
+		CImagePreloader m_ImagePreloader;
 
 		//
 		static HINSTANCE m_hInstance;
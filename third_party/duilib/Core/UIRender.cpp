@@ -472,81 +472,93 @@ namespace DuiLib {
 		return memoryBmp;
 	}
 
-	TImageInfo* CRenderEngine::LoadImage(STRINGorID bitmap, LPCTSTR type, DWORD mask, HINSTANCE instance)
+	LPBYTE CRenderEngine::ReadImage(STRINGorID bitmap, LPCTSTR type, HINSTANCE instance, DWORD& dwSize, int& scale)
 	{
-		LPBYTE pData = NULL;
-		DWORD dwSize = 0;
+		scale = 100;
+		LPBYTE pData = ReadImageData(bitmap, type, instance, dwSize);
+		if (pData) return pData;
 
-		UINT dpi = 0;
-		pData = ReadImageData(bitmap, type, instance, dwSize);
+		//加载图片，如果dpi缩放，没有高清图片时，则加载原图片后进行缩放
+		LPCTSTR find = _tcschr(bitmap.m_lpstr, _T('@'));
+		if (!find) return NULL;
 
-		if (!pData) {
-			//加载图片，如果dpi缩放，没有高清图片时，则加载原图片后进行缩放
-			LPCTSTR find = _tcschr(bitmap.m_lpstr, _T('@'));
-			if (find) {
-				//加载原图再进行缩放
-				dpi = _ttoi(find + 1);
-
-				CDuiString sScale;
-				sScale.SmallFormat(_T("@%d."), dpi);
+		int dpi = _ttoi(find + 1);
+		CDuiString sScale;
+		sScale.SmallFormat(_T("@%d."), dpi);
 
-				CDuiString imgFile = bitmap.m_lpstr;
-				imgFile.Replace(sScale, _T("."));
+		CDuiString imgFile = bitmap.m_lpstr;
+		imgFile.Replace(sScale, _T("."));
 
-				pData = ReadImageData(STRINGorID(imgFile), type, instance, dwSize);
+		pData = ReadImageData(STRINGorID(imgFile), type, instance, dwSize);
+		if (pData) scale = dpi;
+		return pData;
+	}
 
-				if (!pData) {
-					return NULL;
-				}
+	TImageInfo* CRenderEngine::LoadImage(STRINGorID bitmap, LPCTSTR type, DWORD mask, HINSTANCE instance)
+	{
+		if (!IS_INTRESOURCE(bitmap.m_lpstr) && CSvgCache::IsSvg(bitmap.m_lpstr))
+			return LoadSvg(bitmap, type, mask, instance);
 
-				//if (pData) {
-				//	Gdiplus::Image* image = GdiplusLoadImage(pData, dwSize);
-				//	delete[] pData;
-				//	if (image) {
-				//		UINT w = image->GetWidth() * dpi / 100;
-				//		UINT h = image->GetHeight() * dpi / 100;
-				//		HBITMAP hBitmap = ToBitmap(image, w,h);
-				//		delete image;
-				//		TImageInfo* data = new TImageInfo;
-				//		data->pBits = NULL;
-				//		data->pSrcBits = NULL;
-				//		data->hBitmap = hBitmap;
-				//		data->nX = w;
-				//		data->nY = h;
-				//		data->bAlpha = true;
-				//		return data;
-				//	}
-				//}
-			} else {
-				return NULL;
-			}
-		}
+		DWORD dwSize = 0;
+		int scale = 100;
+		LPBYTE pData = ReadImage(bitmap, type, instance, dwSize, scale);
+		if (!pData) return NULL;
 
-		LPBYTE pImage = NULL;
-		int x,y,n;
-		pImage = stbi_load_from_memory(pData, dwSize, &x, &y, &n, 4);
+		CDecodedImage image;
+		bool bDecoded = image.Decode(pData, dwSize, scale);
 		delete[] pData;
-		if( !pImage ) {
-			return NULL;
-		}
-
-		if (dpi > 0 && dpi < 800) {
-			//进行缩放
-			int newx = x * dpi/100;
-			int newy = y * dpi/100;
+		if (!bDecoded) return NULL;
 
-			uint8_t* pixel_out = (uint8_t*)stbi_image_malloc(newx * newy * n);
-
-			//stbir_resize_uint8_generic(pImage, x, y, 0, pixel_out, newx, newy, 0, n, -1, 0, 
-			//	STBIR_EDGE_CLAMP, STBIR_FILTER_CUBICBSPLINE, STBIR_COLORSPACE_LINEAR, NULL);
+		return CreateImage(image, mask);
+	}
 
-			stbir_resize_uint8(pImage, x, y, 0, pixel_out, newx, newy, 0, n);
+	TImageInfo* CRenderEngine::LoadSvg(STRINGorID bitmap, LPCTSTR type, DWORD mask, HINSTANCE instance)
+	{
+		CDuiString sFile = bitmap.m_lpstr;
+		int scale = 100;
+		int find = sFile.Find(_T('@'));
+		if (find >= 0) {
+			scale = _ttoi(sFile.GetData() + find + 1);
+			CDuiString sScale;
+			sScale.SmallFormat(_T("@%d."), scale);
+			sFile.Replace(sScale, _T("."));
+		}
 
-			stbi_image_free(pImage);
-			pImage = pixel_out;
-			x = newx;
-			y = newy;
+		//文档按资源路径、zip或资源实例加原文件名缓存，各dpi共用；栅格化结果按尺寸缓存
+		CDuiString sKey;
+		if (type == NULL) {
+			sKey = CPaintManagerUI::GetResourcePath();
+			sKey += CPaintManagerUI::GetResourceZip();
+			sKey += _T("|");
+		}
+		else {
+			sKey.SmallFormat(_T("%p|"), instance ? instance : CPaintManagerUI::GetResourceDll());
+			if (IS_INTRESOURCE(type)) {
+				CDuiString sType;
+				sType.SmallFormat(_T("#%u"), (UINT)(UINT_PTR)type);
+				sKey += sType;
+			}
+			else sKey += type;
+			sKey += _T("|");
 		}
+		sKey += sFile;
+
+		CDecodedImage image;
+		bool bLoaded = CSvgCache::GetInstance()->Load(sKey.GetData(), scale, [&](size_t& size) {
+			DWORD dwSize = 0;
+			std::unique_ptr<uint8_t[]> data(ReadImageData(STRINGorID(sFile.GetData()), type, instance, dwSize));
+			size = dwSize;
+			return data;
+		}, image);
+		if (!bLoaded) return NULL;
+
+		return CreateImage(image, mask);
+	}
+
+	TImageInfo* CRenderEngine::CreateImage(CDecodedImage& image, DWORD mask)
+	{
+		int x = image.GetWidth();
+		int y = image.GetHeight();
 
 		BITMAPINFO bmi;
 		::ZeroMemory(&bmi, sizeof(BITMAPINFO));
@@ -558,40 +570,14 @@ namespace DuiLib {
 		bmi.bmiHeader.biCompression = BI_RGB;
 		bmi.bmiHeader.biSizeImage = x * y * 4;
 
-		bool bAlphaChannel = false;
 		LPBYTE pDest = NULL;
 		HBITMAP hBitmap = ::CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, (void**)&pDest, NULL, 0);
 		if( !hBitmap ) {
 			return NULL;
 		}
 
-		for( int i = 0; i < x * y; i++ ) 
-		{
-			pDest[i*4 + 3] = pImage[i*4 + 3];
-			if( pDest[i*4 + 3] < 255 )
-			{
-				pDest[i*4] = (BYTE)(DWORD(pImage[i*4 + 2])*pImage[i*4 + 3]/255);
-				pDest[i*4 + 1] = (BYTE)(DWORD(pImage[i*4 + 1])*pImage[i*4 + 3]/255);
-				pDest[i*4 + 2] = (BYTE)(DWORD(pImage[i*4])*pImage[i*4 + 3]/255); 
-				bAlphaChannel = true;
-			}
-			else
-			{
-				pDest[i*4] = pImage[i*4 + 2];
-				pDest[i*4 + 1] = pImage[i*4 + 1];
-				pDest[i*4 + 2] = pImage[i*4]; 
-			}
-
-			if( *(DWORD*)(&pDest[i*4]) == mask ) {
-				pDest[i*4] = (BYTE)0;
-				pDest[i*4 + 1] = (BYTE)0;
-				pDest[i*4 + 2] = (BYTE)0; 
-				pDest[i*4 + 3] = (BYTE)0;
-				bAlphaChannel = true;
-			}
-		}
-
-		stbi_image_free(pImage);
+		//RGBA转预乘alpha的BGRA，并清除颜色等于mask的像素；预加载的图片已在图片线程上转换，这里只拷贝
+		bool bAlphaChannel = image.Convert(mask, pDest);
 
 		TImageInfo* data = new TImageInfo;
 		data->pBits = NULL;
@@ -35,6 +35,12 @@ namespace DuiLib {
 		static HBITMAP CreateARGB32Bitmap(HDC hDC, int cx, int cy, BYTE** pBits);
 		static void AdjustImage(bool bUseHSL, TImageInfo* imageInfo, short H, short S, short L);
 		static TImageInfo* LoadImage(STRINGorID bitmap, LPCTSTR type = NULL, DWORD mask = 0, HINSTANCE instance = NULL);
+		// 读取图片文件数据，高dpi图片(xxx@150.png)缺失时读取原图，scale返回需要缩放的百分比；返回值用delete[]释放
+		static LPBYTE ReadImage(STRINGorID bitmap, LPCTSTR type, HINSTANCE instance, DWORD& dwSize, int& scale);
+		// 由CSvgCache解析和栅格化svg，名字中的@dpi决定栅格化的尺寸，不需要按dpi准备多份文件
+		static TImageInfo* LoadSvg(STRINGorID bitmap, LPCTSTR type, DWORD mask, HINSTANCE instance);
+		// 由解码后的图片创建DIB，未转换的图片直接转换到DIB中
+		static TImageInfo* CreateImage(CDecodedImage& image, DWORD mask);
 #ifdef USE_XIMAGE_EFFECT
 		static CxImage *LoadGifImageX(STRINGorID bitmap, LPCTSTR type = NULL, DWORD mask = 0);
 #endif
@@ -30,6 +30,11 @@ void CImageControlUI::SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue) {
 
 }
 
+CssSetter CImageControlUI::GetCssSetter(LPCTSTR pstrName) {
+	// SetAttributeκԣcssҲƹֱ
+	return NULL;
+}
+
 void CImageControlUI::PaintStatusImage(HDC hDC) {
 
 
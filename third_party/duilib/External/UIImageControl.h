@@ -24,6 +24,7 @@ public:
 	LPVOID GetInterface(LPCTSTR pstrName);
 
 	void SetAttribute(LPCTSTR pstrName, LPCTSTR pstrValue);
+	CssSetter GetCssSetter(LPCTSTR pstrName);
 	void PaintStatusImage(HDC hDC);
 
 	void Load(LPCTSTR file);
@@ -55,6 +55,10 @@ namespace DuiLib {
 
 
 #include "Utils/CssSheet.h"
+#include "Utils/AttributeTable.h"
+#include "Utils/ImageDecoder.h"
+#include "Utils/GifDecoder.h"
+#include "Utils/SvgImage.h"
 #include "Utils/Utils.h"
 #include "Utils/unzip.h"
 #include "Utils/VersionHelpers.h"
@@ -0,0 +1,163 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace DuiLib {
+
+	//属性名到id的完美哈希表，名字不区分大小写(只折叠ASCII字母)，id为名字在names中的下标。
+	//构造时为每个桶找一个位移，使所有名字落在不同的槽里(hash and displace)，
+	//查找只计算一次哈希、比较一次名字。names在表的生命周期内必须有效，一般为静态数组
+	template<typename Char>
+	class CAttributeTableT
+	{
+	public:
+		CAttributeTableT(const Char* const* names, int count) : m_names(names), m_count(count), m_mask(0)
+		{
+			Build();
+		}
+
+		//不存在时返回-1
+		int GetId(const Char* name) const
+		{
+			if (!name || m_slots.empty())
+				return -1;
+			uint32_t h1, h2;
+			Hash(name, h1, h2);
+			uint32_t slot = Slot(h2, m_displacements[h1 % m_displacements.size()], m_mask);
+			int id = m_slots[slot];
+			if (id < 0 || !Equal(m_names[id], name))
+				return -1;
+			return id;
+		}
+
+		int GetCount() const { return m_count; }
+
+	private:
+		static void Hash(const Char* name, uint32_t& h1, uint32_t& h2)
+		{
+			//FNV-1a，最后混合一次使高低32位都可用
+			typedef typename std::make_unsigned<Char>::type UChar;
+			uint64_t h = 14695981039346656037ull;
+			for (; *name; ++name) {
+				uint64_t c = (UChar)*name;
+				if (c >= 'A' && c <= 'Z')
+					c += 'a' - 'A';
+				h = (h ^ c) * 1099511628211ull;
+			}
+			h ^= h >> 33;
+			h *= 0xff51afd7ed558ccdull;
+			h ^= h >> 33;
+			h *= 0xc4ceb9fe1a85ec53ull;
+			h ^= h >> 33;
+			h1 = (uint32_t)h;
+			h2 = (uint32_t)(h >> 32);
+		}
+
+		static uint32_t Slot(uint32_t h2, uint32_t displacement, uint32_t mask)
+		{
+			uint32_t h = h2 ^ (displacement * 0x9e3779b9u);
+			h ^= h >> 16;
+			h *= 0x85ebca6bu;
+			h ^= h >> 13;
+			return h & mask;
+		}
+
+		static bool Equal(const Char* a, const Char* b)
+		{
+			for (;; ++a, ++b) {
+				Char x = *a, y = *b;
+				if (x >= 'A' && x <= 'Z')
+					x += 'a' - 'A';
+				if (y >= 'A' && y <= 'Z')
+					y += 'a' - 'A';
+				if (x != y)
+					return false;
+				if (x == 0)
+					return true;
+			}
+		}
+
+		void Build()
+		{
+			if (m_count <= 0)
+				return;
+
+			//重复的名字只保留第一个
+			std::vector<uint32_t> h1(m_count), h2(m_count);
+			std::vector<bool> skip(m_count);
+			for (int i = 0; i < m_count; ++i) {
+				Hash(m_names[i], h1[i], h2[i]);
+				for (int j = 0; j < i && !skip[i]; ++j)
+					skip[i] = h1[j] == h1[i] && h2[j] == h2[i] && Equal(m_names[j], m_names[i]);
+			}
+
+			size_t size = 1;
+			while (size < (size_t)m_count + m_count / 4)
+				size <<= 1;
+			for (;; size <<= 1) {
+				if (Place(h1, h2, skip, size))
+					return;
+			}
+		}
+
+		bool Place(const std::vector<uint32_t>& h1, const std::vector<uint32_t>& h2, const std::vector<bool>& skip, size_t size)
+		{
+			size_t nbuckets = (size_t)m_count;
+			std::vector<std::vector<int>> buckets(nbuckets);
+			for (int i = 0; i < m_count; ++i) {
+				if (!skip[i])
+					buckets[h1[i] % nbuckets].push_back(i);
+			}
+			std::vector<size_t> order(nbuckets);
+			for (size_t i = 0; i < nbuckets; ++i)
+				order[i] = i;
+			std::stable_sort(order.begin(), order.end(), [&buckets](size_t a, size_t b) {
+				return buckets[a].size() > buckets[b].size();
+			});
+
+			m_mask = (uint32_t)(size - 1);
+			m_slots.assign(size, -1);
+			m_displacements.assign(nbuckets, 0);
+			std::vector<uint32_t> taken;
+			for (size_t b = 0; b < nbuckets; ++b) {
+				const std::vector<int>& bucket = buckets[order[b]];
+				if (bucket.empty())
+					break;
+				uint32_t d = 0;
+				for (; d < 0xffff; ++d) {
+					taken.clear();
+					bool fits = true;
+					for (size_t k = 0; k < bucket.size() && fits; ++k) {
+						uint32_t slot = Slot(h2[bucket[k]], d, m_mask);
+						fits = m_slots[slot] < 0 && std::find(taken.begin(), taken.end(), slot) == taken.end();
+						taken.push_back(slot);
+					}
+					if (fits)
+						break;
+				}
+				if (d == 0xffff)
+					return false;
+				m_displacements[order[b]] = (uint16_t)d;
+				for (size_t k = 0; k < bucket.size(); ++k)
+					m_slots[Slot(h2[bucket[k]], d, m_mask)] = (int16_t)bucket[k];
+			}
+			return true;
+		}
+
+		const Char* const* m_names;
+		int m_count;
+		std::vector<uint16_t> m_displacements;	//每个桶的位移
+		std::vector<int16_t> m_slots;			//槽中名字的id，空槽为-1
+		uint32_t m_mask;
+	};
+
+#if _UNICODE
+	typedef CAttributeTableT<wchar_t> CAttributeTable;
+#else
+	typedef CAttributeTableT<char> CAttributeTable;
+#endif
+
+}
@@ -1,6 +1,168 @@
 #include "CssSheet.h"
+#include <stdlib.h>
+#include <wchar.h>
+#include <algorithm>
 
-CssSheet::CssSheet() {
+static inline long css_strtol(const char* s, char** end) { return strtol(s, end, 10); }
+static inline long css_strtol(const wchar_t* s, wchar_t** end) { return wcstol(s, end, 10); }
+static inline unsigned long css_strtoul(const char* s) { return strtoul(s, nullptr, 16); }
+static inline unsigned long css_strtoul(const wchar_t* s) { return wcstoul(s, nullptr, 16); }
+
+void CssValue::Parse(const css_string& value) {
+	const css_char* s = value.c_str();
+
+	//SetAttribute_tcstol(pstr + 1)дһ£βΪֹ
+	count = 0;
+	css_char* end = nullptr;
+	const css_char* p = s;
+	while (count < 4) {
+		numbers[count++] = css_strtol(p, &end);
+		if (*end == 0)
+			break;
+		p = end + 1;
+	}
+	for (int i = count; i < 4; ++i)
+		numbers[i] = 0;
+	list = value.find(',') != css_string::npos;
+
+	p = s;
+	while (*p > 0 && *p <= ' ')
+		++p;
+	if (*p == '#')
+		++p;
+	color = css_strtoul(p);
+
+	static const char kTrue[] = "true";
+	boolean = value.size() == 4;
+	for (size_t i = 0; boolean && i < 4; ++i) {
+		css_char c = s[i];
+		if (c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+		boolean = c == kTrue[i];
+	}
+}
+
+void CssRule::Compile() {
+	declarations.clear();
+	declarations.reserve(styles.size());
+	for (auto itr = styles.begin(); itr != styles.end(); ++itr) {
+		CssDeclaration declaration;
+		declaration.name = itr->first;
+		declaration.value = itr->second;
+		declaration.parsed.Parse(itr->second);
+		declarations.push_back(declaration);
+	}
+}
+
+const std::vector<CssSetter>& CssRule::Resolve(const void* type, const Resolver& resolver) const {
+	std::lock_guard<std::mutex> locker(lock_);
+	auto find = setters_.find(type);
+	if (find != setters_.end())
+		return find->second;
+
+	std::vector<CssSetter>& setters = setters_[type];
+	setters.reserve(declarations.size());
+	for (size_t i = 0; i < declarations.size(); ++i)
+		setters.push_back(resolver(declarations[i]));
+	return setters;
+}
+
+static inline bool css_space(css_char c) { return c > 0 && c <= ' '; }
+
+void CssElement::SetClasses(const css_string& value) {
+	classes.clear();
+	size_t i = 0;
+	while (i < value.size()) {
+		while (i < value.size() && css_space(value[i]))
+			++i;
+		size_t start = i;
+		while (i < value.size() && !css_space(value[i]))
+			++i;
+		if (i > start)
+			classes.push_back(value.substr(start, i - start));
+	}
+}
+
+bool CssCompound::Matches(const CssElement& element) const {
+	if (!tag.empty() && tag != element.tag)
+		return false;
+	if (!id.empty() && id != element.id)
+		return false;
+	for (size_t i = 0; i < classes.size(); ++i) {
+		if (std::find(element.classes.begin(), element.classes.end(), classes[i]) == element.classes.end())
+			return false;
+	}
+	return true;
+}
+
+//ֺֻ֧Ϸ>+~:[ѡƥ
+bool CssSelector::Parse(const css_string& text) {
+	compounds.clear();
+	specificity = 0;
+	unsigned ids = 0, classes = 0, tags = 0;
+	size_t i = 0;
+	while (i < text.size()) {
+		while (i < text.size() && css_space(text[i]))
+			++i;
+		if (i == text.size())
+			break;
+
+		CssCompound compound;
+		if (text[i] == '*')
+			++i;
+		while (i < text.size() && !css_space(text[i])) {
+			css_char c = text[i];
+			if (c == '>' || c == '+' || c == '~' || c == ':' || c == '[' || c == '*')
+				return false;
+			size_t start = (c == '.' || c == '#') ? i + 1 : i;
+			size_t end = start;
+			while (end < text.size() && !css_space(text[end]) && text[end] != '.' && text[end] != '#'
+				&& text[end] != '>' && text[end] != '+' && text[end] != '~' && text[end] != ':' && text[end] != '[')
+				++end;
+			if (end == start)
+				return false;
+			css_string name = text.substr(start, end - start);
+			if (c == '.') {
+				compound.classes.push_back(name);
+				++classes;
+			}
+			else if (c == '#') {
+				compound.id = name;
+				++ids;
+			}
+			else {
+				//ǩֻܳڿͷ
+				if (start != 0 && !css_space(text[start - 1]))
+					return false;
+				compound.tag = name;
+				++tags;
+			}
+			i = end;
+		}
+		compounds.push_back(compound);
+	}
+	if (compounds.empty())
+		return false;
+	specificity = (std::min(ids, 1023u) << 20) | (std::min(classes, 1023u) << 10) | std::min(tags, 1023u);
+	return true;
+}
+
+//ϷֻҪȰ˳֣̰ƥȼ
+bool CssSelector::Matches(const CssElement& element, const std::vector<CssElement>& ancestors) const {
+	if (compounds.empty() || !compounds.back().Matches(element))
+		return false;
+	size_t next = 0;
+	for (size_t i = compounds.size() - 1; i-- > 0;) {
+		while (next < ancestors.size() && !compounds[i].Matches(ancestors[next]))
+			++next;
+		if (next == ancestors.size())
+			return false;
+		++next;
+	}
+	return true;
+}
+
+CssSheet::CssSheet() : order_(0), has_descendant_(false), ancestor_universal_(false) {
 }
 
 CssSheet::~CssSheet() {
@@ -10,20 +172,16 @@ void CssSheet::OnParseSelector(CssSelectorMode mode, const css_str_t* str, void*
 	CssSheet* pThis = static_cast<CssSheet*>(ud);
 	switch (mode) {
 	case CssSelectorMode::kSelectorBegin:
-		pThis->current_ = std::make_shared<CssStyles>();
+		pThis->current_ = std::make_shared<CssRule>();
 		break;
 	case CssSelectorMode::kSelectorValue:
-		if (str->len && str->data[0] == '.') {
-			pThis->class_styles_[css_string(str->data + 1, str->len - 1)] = pThis->current_;
-		}
-		else if (str->len && str->data[0] == '#') {
-			pThis->id_styles_[css_string(str->data + 1, str->len - 1)] = pThis->current_;
-		}
-		else {
-			pThis->element_styles_[css_string(str->data, str->len)] = pThis->current_;
-		}
+		pThis->AddSelector(css_string(str->data, str->len));
 		break;
 	case CssSelectorMode::kSelectorEnd:
+		if (pThis->current_) {
+			pThis->current_->Compile();
+			pThis->current_ = nullptr;
+		}
 		break;
 	}
 }
@@ -31,23 +189,93 @@ void CssSheet::OnParseSelector(CssSelectorMode mode, const css_str_t* str, void*
 void CssSheet::OnParseValue(const css_str_t* key, const css_str_t* value, void* ud) {
 	CssSheet* pThis = static_cast<CssSheet*>(ud);
 	if (pThis->current_) {
-		(*pThis->current_)[css_string(key->data, key->len)] = css_string(value->data, value->len);
+		pThis->current_->styles[css_string(key->data, key->len)] = css_string(value->data, value->len);
+	}
+}
+
+void CssSheet::AddSelector(const css_string& text) {
+	CssSelector selector;
+	if (!selector.Parse(text))
+		return;
+
+	IndexEntry& entry = selectors_[text];
+	entry.selector = selector;
+	entry.rule = current_;
+	entry.order = order_++;
+
+	//ֻһֵļѡҲֱӰȡ
+	const CssCompound& compound = selector.compounds.back();
+	if (selector.compounds.size() != 1 || (compound.tag.size() != 0) + (compound.id.size() != 0) + compound.classes.size() != 1)
+		return;
+	if (!compound.classes.empty())
+		class_styles_[compound.classes[0]] = current_;
+	else if (!compound.id.empty())
+		id_styles_[compound.id] = current_;
+	else
+		element_styles_[compound.tag] = current_;
+}
+
+void CssSheet::RebuildIndex() {
+	by_id_.clear();
+	by_class_.clear();
+	by_tag_.clear();
+	universal_.clear();
+	subject_names_ = NameSet();
+	ancestor_names_ = NameSet();
+	has_descendant_ = false;
+	ancestor_universal_ = false;
+
+	for (auto itr = selectors_.begin(); itr != selectors_.end(); ++itr) {
+		const IndexEntry* entry = &itr->second;
+		const std::vector<CssCompound>& compounds = entry->selector.compounds;
+		const CssCompound& subject = compounds.back();
+		if (!subject.id.empty())
+			by_id_[subject.id].push_back(entry);
+		else if (!subject.classes.empty())
+			by_class_[subject.classes[0]].push_back(entry);
+		else if (!subject.tag.empty())
+			by_tag_[subject.tag].push_back(entry);
+		else
+			universal_.push_back(entry);
+
+		for (size_t i = 0; i < compounds.size(); ++i) {
+			const CssCompound& compound = compounds[i];
+			NameSet& names = i + 1 == compounds.size() ? subject_names_ : ancestor_names_;
+			if (!compound.tag.empty())
+				names.tags.insert(compound.tag);
+			if (!compound.id.empty())
+				names.ids.insert(compound.id);
+			names.classes.insert(compound.classes.begin(), compound.classes.end());
+			if (i + 1 < compounds.size() && compound.tag.empty() && compound.id.empty() && compound.classes.empty())
+				ancestor_universal_ = true;
+		}
+		if (compounds.size() > 1)
+			has_descendant_ = true;
 	}
+
+	std::lock_guard<std::mutex> locker(lock_);
+	matches_.clear();
 }
 
 bool CssSheet::Parse(const css_char* s) {
 	bool rslt = css_parse(s, OnParseSelector, OnParseValue,this);
+	if (current_)
+		current_->Compile();
 	current_ = nullptr;
+	RebuildIndex();
 	return rslt;
 }
 
 bool CssSheet::Parse(const css_string& s) {
 	bool rslt = css_parse(s.c_str(), OnParseSelector, OnParseValue, this);
+	if (current_)
+		current_->Compile();
 	current_ = nullptr;
+	RebuildIndex();
 	return rslt;
 }
 
-std::shared_ptr<CssStyles> CssSheet::GetStylesByClass(const css_string& key) {
+std::shared_ptr<const CssRule> CssSheet::GetStylesByClass(const css_string& key) const {
 	auto find = class_styles_.find(key);
 	if (find != class_styles_.end()) {
 		return find->second;
@@ -56,7 +284,7 @@ std::shared_ptr<CssStyles> CssSheet::GetStylesByClass(const css_string& key) {
 	}
 }
 
-std::shared_ptr<CssStyles> CssSheet::GetStylesById(const css_string& key) {
+std::shared_ptr<const CssRule> CssSheet::GetStylesById(const css_string& key) const {
 	auto find = id_styles_.find(key);
 	if (find != id_styles_.end()) {
 		return find->second;
@@ -65,7 +293,7 @@ std::shared_ptr<CssStyles> CssSheet::GetStylesById(const css_string& key) {
 	}
 }
 
-std::shared_ptr<CssStyles> CssSheet::GetStylesByElement(const css_string& key) {
+std::shared_ptr<const CssRule> CssSheet::GetStylesByElement(const css_string& key) const {
 	auto find = element_styles_.find(key);
 	if (find != element_styles_.end()) {
 		return find->second;
@@ -74,3 +302,469 @@ std::shared_ptr<CssStyles> CssSheet::GetStylesByElement(const css_string& key) {
 	}
 }
 
+//ֻѡõ֣ӰƥnameclassͬԪعһ
+void CssSheet::AppendKey(const CssElement& element, const NameSet& names, css_string& key) const {
+	if (names.tags.count(element.tag))
+		key += element.tag;
+	key += css_char(1);
+	if (names.ids.count(element.id))
+		key += element.id;
+	key += css_char(1);
+	std::vector<const css_string*> classes;
+	for (size_t i = 0; i < element.classes.size(); ++i) {
+		if (names.classes.count(element.classes[i]))
+			classes.push_back(&element.classes[i]);
+	}
+	std::sort(classes.begin(), classes.end(), [](const css_string* a, const css_string* b) { return *a < *b; });
+	for (size_t i = 0; i < classes.size(); ++i) {
+		if (i == 0 || *classes[i] != *classes[i - 1]) {
+			key += *classes[i];
+			key += css_char(2);
+		}
+	}
+}
+
+void CssSheet::Collect(const IndexBucket& bucket, const css_string& name, std::vector<const IndexEntry*>& candidates) const {
+	if (name.empty())
+		return;
+	auto find = bucket.find(name);
+	if (find != bucket.end())
+		candidates.insert(candidates.end(), find->second.begin(), find->second.end());
+}
+
+std::shared_ptr<const CssRuleList> CssSheet::Match(const CssElement& element, const std::vector<CssElement>& ancestors) const {
+	std::shared_ptr<const CssMatch> match = MatchRules(element, ancestors);
+	return std::shared_ptr<const CssRuleList>(match, &match->rules);
+}
+
+std::shared_ptr<const CssMatch> CssSheet::MatchRules(const CssElement& element, const std::vector<CssElement>& ancestors) const {
+	css_string key;
+	AppendKey(element, subject_names_, key);
+	if (has_descendant_) {
+		//κѡ޹صȲӰ
+		static const css_char kEmpty[] = { 1, 1, 0 };
+		for (size_t i = 0; i < ancestors.size(); ++i) {
+			size_t size = key.size();
+			key += css_char(3);
+			AppendKey(ancestors[i], ancestor_names_, key);
+			if (!ancestor_universal_ && key.compare(size + 1, css_string::npos, kEmpty) == 0)
+				key.resize(size);
+		}
+	}
+
+	std::lock_guard<std::mutex> locker(lock_);
+	auto find = matches_.find(key);
+	if (find != matches_.end())
+		return find->second;
+
+	std::vector<const IndexEntry*> candidates(universal_);
+	Collect(by_id_, element.id, candidates);
+	for (size_t i = 0; i < element.classes.size(); ++i)
+		Collect(by_class_, element.classes[i], candidates);
+	Collect(by_tag_, element.tag, candidates);
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+	std::vector<const IndexEntry*> matched;
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		if (candidates[i]->selector.Matches(element, ancestors))
+			matched.push_back(candidates[i]);
+	}
+	std::sort(matched.begin(), matched.end(), [](const IndexEntry* a, const IndexEntry* b) {
+		if (a->selector.specificity != b->selector.specificity)
+			return a->selector.specificity < b->selector.specificity;
+		return a->order < b->order;
+	});
+
+	//ѡõĹֻȼߵλӦһ
+	auto match = std::make_shared<CssMatch>();
+	for (size_t i = matched.size(); i-- > 0;) {
+		const CssRule* rule = matched[i]->rule.get();
+		bool seen = false;
+		for (size_t j = 0; j < match->rules.size() && !seen; ++j)
+			seen = match->rules[j].get() == rule;
+		if (!seen) {
+			match->rules.push_back(matched[i]->rule);
+			match->priorities.push_back(std::make_pair(matched[i]->selector.specificity, matched[i]->order));
+		}
+	}
+	std::reverse(match->rules.begin(), match->rules.end());
+	std::reverse(match->priorities.begin(), match->priorities.end());
+
+	if (matches_.size() >= 4096)
+		matches_.clear();
+	matches_[key] = match;
+	return match;
+}
+
+bool CssSheet::HasDescendantSelectors() const {
+	return has_descendant_;
+}
+
+int CssSheet::GetInvalidation(const CssElement& before, const CssElement& after) const {
+	int flags = 0;
+	auto check = [this, &flags](const css_string& name, const std::unordered_set<css_string> NameSet::* set) {
+		if ((subject_names_.*set).count(name))
+			flags |= kCssInvalidateSelf;
+		if ((ancestor_names_.*set).count(name))
+			flags |= kCssInvalidateDescendants;
+	};
+	if (before.tag != after.tag) {
+		check(before.tag, &NameSet::tags);
+		check(after.tag, &NameSet::tags);
+	}
+	if (before.id != after.id) {
+		check(before.id, &NameSet::ids);
+		check(after.id, &NameSet::ids);
+	}
+	for (size_t i = 0; i < before.classes.size(); ++i) {
+		if (std::find(after.classes.begin(), after.classes.end(), before.classes[i]) == after.classes.end())
+			check(before.classes[i], &NameSet::classes);
+	}
+	for (size_t i = 0; i < after.classes.size(); ++i) {
+		if (std::find(before.classes.begin(), before.classes.end(), after.classes[i]) == before.classes.end())
+			check(after.classes[i], &NameSet::classes);
+	}
+	return flags;
+}
+
+void CssSheet::EnumStyles(const std::function<void(const CssStyles&)>& visitor) const {
+	for (auto itr = selectors_.begin(); itr != selectors_.end(); ++itr)
+		visitor(itr->second.rule->styles);
+}
+
+bool CssSheetView::Add(const css_string& path, std::shared_ptr<const CssSheet> sheet) {
+	if (!sheet)
+		return false;
+	//Ӳÿδټͬʽͬһļֻ°汾
+	for (size_t i = 0; i < layers_.size(); ++i) {
+		if (layers_[i].path != path)
+			continue;
+		if (!path.empty())
+			return Update(path, sheet);
+		if (layers_[i].sheet == sheet)
+			return false;
+	}
+	Layer layer;
+	layer.path = path;
+	layer.sheet = sheet;
+	layers_.push_back(layer);
+	Reset();
+	return true;
+}
+
+bool CssSheetView::Update(const css_string& path, std::shared_ptr<const CssSheet> sheet) {
+	bool changed = false;
+	for (size_t i = 0; i < layers_.size(); ++i) {
+		if (layers_[i].path == path && sheet && layers_[i].sheet != sheet) {
+			layers_[i].sheet = sheet;
+			changed = true;
+		}
+	}
+	if (changed)
+		Reset();
+	return changed;
+}
+
+void CssSheetView::Clear() {
+	layers_.clear();
+	Reset();
+}
+
+void CssSheetView::Reset() {
+	std::lock_guard<std::mutex> locker(lock_);
+	matches_.clear();
+}
+
+std::vector<css_string> CssSheetView::GetPaths() const {
+	std::vector<css_string> paths;
+	for (size_t i = 0; i < layers_.size(); ++i) {
+		if (!layers_[i].path.empty() && std::find(paths.begin(), paths.end(), layers_[i].path) == paths.end())
+			paths.push_back(layers_[i].path);
+	}
+	return paths;
+}
+
+std::shared_ptr<const CssRuleList> CssSheetView::Match(const CssElement& element, const std::vector<CssElement>& ancestors) const {
+	if (layers_.empty())
+		return std::make_shared<CssRuleList>();
+	if (layers_.size() == 1)
+		return layers_[0].sheet->Match(element, ancestors);
+
+	//ĽѸԻ棬ͬʱϲҲͬ
+	std::vector<std::shared_ptr<const CssMatch>> key;
+	key.reserve(layers_.size());
+	for (size_t i = 0; i < layers_.size(); ++i)
+		key.push_back(layers_[i].sheet->MatchRules(element, ancestors));
+
+	std::lock_guard<std::mutex> locker(lock_);
+	auto find = matches_.find(key);
+	if (find != matches_.end())
+		return find->second;
+
+	struct Item {
+		unsigned specificity;
+		size_t layer;
+		size_t order;
+		const std::shared_ptr<const CssRule>* rule;
+	};
+	std::vector<Item> items;
+	for (size_t i = 0; i < key.size(); ++i) {
+		const CssMatch& match = *key[i];
+		for (size_t j = 0; j < match.rules.size(); ++j) {
+			Item item = { match.priorities[j].first, i, match.priorities[j].second, &match.rules[j] };
+			items.push_back(item);
+		}
+	}
+	std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+		if (a.specificity != b.specificity)
+			return a.specificity < b.specificity;
+		if (a.layer != b.layer)
+			return a.layer < b.layer;
+		return a.order < b.order;
+	});
+	auto rules = std::make_shared<CssRuleList>();
+	rules->reserve(items.size());
+	for (size_t i = 0; i < items.size(); ++i)
+		rules->push_back(*items[i].rule);
+
+	if (matches_.size() >= 4096)
+		matches_.clear();
+	matches_[key] = rules;
+	return rules;
+}
+
+bool CssSheetView::HasDescendantSelectors() const {
+	for (size_t i = 0; i < layers_.size(); ++i) {
+		if (layers_[i].sheet->HasDescendantSelectors())
+			return true;
+	}
+	return false;
+}
+
+int CssSheetView::GetInvalidation(const CssElement& before, const CssElement& after) const {
+	int flags = 0;
+	for (size_t i = 0; i < layers_.size(); ++i)
+		flags |= layers_[i].sheet->GetInvalidation(before, after);
+	return flags;
+}
+
+bool CssSheetView::IsEmpty() const {
+	return layers_.empty();
+}
+
+std::shared_ptr<const CssRule> CssSheetView::GetStylesByClass(const css_string& key) const {
+	for (size_t i = layers_.size(); i-- > 0;) {
+		std::shared_ptr<const CssRule> rule = layers_[i].sheet->GetStylesByClass(key);
+		if (rule)
+			return rule;
+	}
+	return nullptr;
+}
+
+std::shared_ptr<const CssRule> CssSheetView::GetStylesByElement(const css_string& key) const {
+	for (size_t i = layers_.size(); i-- > 0;) {
+		std::shared_ptr<const CssRule> rule = layers_[i].sheet->GetStylesByElement(key);
+		if (rule)
+			return rule;
+	}
+	return nullptr;
+}
+
+void CssSheetView::EnumStyles(const std::function<void(const CssStyles&)>& visitor) const {
+	for (size_t i = 0; i < layers_.size(); ++i)
+		layers_[i].sheet->EnumStyles(visitor);
+}
+
+void CssStyleState::SetInline(const css_string& name) {
+	if (!IsInline(name))
+		inline_.push_back(name);
+}
+
+bool CssStyleState::IsInline(const css_string& name) const {
+	return std::find(inline_.begin(), inline_.end(), name) != inline_.end();
+}
+
+void CssStyleState::GetFinals(const CssRuleList& rules, Finals& finals) {
+	//ȫռȶֻͬһĹ򸲸ǰ
+	finals.clear();
+	size_t count = 0;
+	for (size_t i = 0; i < rules.size(); ++i)
+		count += rules[i]->declarations.size();
+	finals.reserve(count);
+	for (size_t i = 0; i < rules.size(); ++i) {
+		const std::vector<CssDeclaration>& declarations = rules[i]->declarations;
+		for (size_t j = 0; j < declarations.size(); ++j) {
+			Final final = { &declarations[j], i, j };
+			finals.push_back(final);
+		}
+	}
+	//ÿѰ
+	if (rules.size() < 2)
+		return;
+	std::stable_sort(finals.begin(), finals.end(), [](const Final& a, const Final& b) {
+		return a.declaration->name < b.declaration->name;
+	});
+	size_t last = 0;
+	for (size_t i = 1; i < finals.size(); ++i) {
+		if (finals[i].declaration->name != finals[last].declaration->name)
+			++last;
+		finals[last] = finals[i];
+	}
+	finals.resize(last + 1);
+}
+
+const CssStyleState::Diff& CssStyleState::GetDiff(const std::shared_ptr<const CssRuleList>& from, const std::shared_ptr<const Finals>& finals,
+	const std::shared_ptr<const CssRuleList>& to) {
+	//ƿȽϣɽͷźַҲ
+	static const size_t kDiffs = 8;
+	static thread_local Diff diffs[kDiffs];
+	static thread_local size_t next = 0;
+	for (size_t i = 0; i < kDiffs; ++i) {
+		const Diff& diff = diffs[i];
+		if (diff.finals && !diff.to.owner_before(to) && !to.owner_before(diff.to)
+			&& !diff.from.owner_before(from) && !from.owner_before(diff.from))
+			return diff;
+	}
+
+	Diff& diff = diffs[next];
+	next = (next + 1) % kDiffs;
+	diff.from = from;
+	diff.to = to;
+	auto target = std::make_shared<Finals>();
+	GetFinals(*to, *target);
+	diff.finals = target;
+	diff.positions.clear();
+
+	//һԭһӦ
+	if (!from) {
+		for (size_t i = 0; i < to->size(); ++i) {
+			for (size_t j = 0; j < (*to)[i]->declarations.size(); ++j)
+				diff.positions.push_back(std::make_pair(i, j));
+		}
+		return diff;
+	}
+
+	//ԭֵȽϣ½ûеԱԭֵ
+	size_t old = 0;
+	for (size_t i = 0; i < target->size(); ++i) {
+		const CssDeclaration* declaration = (*target)[i].declaration;
+		while (old < finals->size() && (*finals)[old].declaration->name < declaration->name)
+			++old;
+		if (old < finals->size() && (*finals)[old].declaration->name == declaration->name
+			&& (*finals)[old].declaration->value == declaration->value)
+			continue;
+		diff.positions.push_back(std::make_pair((*target)[i].rule, (*target)[i].index));
+	}
+	std::sort(diff.positions.begin(), diff.positions.end());
+	return diff;
+}
+
+std::vector<CssStyleState::Declaration> CssStyleState::Update(const std::shared_ptr<const CssRuleList>& rules) {
+	std::vector<Declaration> changes;
+	if (rules == rules_ || !rules)
+		return changes;
+
+	//ʽڿؼżʱһҲ
+	const Diff& diff = GetDiff(rules_, finals_, rules);
+	changes.reserve(diff.positions.size());
+	for (size_t i = 0; i < diff.positions.size(); ++i) {
+		const CssRule* rule = (*rules)[diff.positions[i].first].get();
+		if (inline_.empty() || !IsInline(rule->declarations[diff.positions[i].second].name))
+			changes.push_back(Declaration(rule, diff.positions[i].second));
+	}
+	rules_ = rules;
+	finals_ = diff.finals;
+	return changes;
+}
+
+static uint64_t css_hash(const uint8_t* data, size_t size) {
+	uint64_t h = 14695981039346656037ull;
+	for (size_t i = 0; i < size; ++i)
+		h = (h ^ data[i]) * 1099511628211ull;
+	return h;
+}
+
+CssSheetCache* CssSheetCache::GetInstance() {
+	static CssSheetCache cache;
+	return &cache;
+}
+
+std::shared_ptr<const CssSheet> CssSheetCache::Load(const css_string& path, const uint8_t* data, size_t size, const Converter& convert, bool* pResult) {
+	uint64_t hash = css_hash(data, size);
+	{
+		std::lock_guard<std::mutex> locker(lock_);
+		auto find = files_.find(path);
+		if (find != files_.end() && find->second.hash == hash && find->second.size == size) {
+			++stats_.hits;
+			if (pResult)
+				*pResult = find->second.result;
+			return find->second.sheet;
+		}
+	}
+
+	//ɺ滻ɰ汾
+	auto sheet = std::make_shared<CssSheet>();
+	bool result = sheet->Parse(convert(data, size));
+
+	std::lock_guard<std::mutex> locker(lock_);
+	++stats_.parses;
+	Entry& entry = files_[path];
+	if (!entry.sheet || entry.hash != hash || entry.size != size) {
+		entry.hash = hash;
+		entry.size = size;
+		entry.result = result;
+		entry.sheet = sheet;
+	}
+	if (pResult)
+		*pResult = entry.result;
+	return entry.sheet;
+}
+
+std::shared_ptr<const CssSheet> CssSheetCache::Parse(const css_string& text, bool* pResult) {
+	{
+		std::lock_guard<std::mutex> locker(lock_);
+		auto find = inline_.find(text);
+		if (find != inline_.end()) {
+			++stats_.hits;
+			if (pResult)
+				*pResult = find->second.result;
+			return find->second.sheet;
+		}
+	}
+
+	auto sheet = std::make_shared<CssSheet>();
+	bool result = sheet->Parse(text);
+
+	std::lock_guard<std::mutex> locker(lock_);
+	++stats_.parses;
+	Entry& entry = inline_[text];
+	if (!entry.sheet) {
+		entry.hash = 0;
+		entry.size = text.size();
+		entry.result = result;
+		entry.sheet = sheet;
+	}
+	if (pResult)
+		*pResult = entry.result;
+	return entry.sheet;
+}
+
+std::shared_ptr<const CssSheet> CssSheetCache::Get(const css_string& path) {
+	std::lock_guard<std::mutex> locker(lock_);
+	auto find = files_.find(path);
+	return find != files_.end() ? find->second.sheet : nullptr;
+}
+
+void CssSheetCache::Clear() {
+	std::lock_guard<std::mutex> locker(lock_);
+	files_.clear();
+	inline_.clear();
+}
+
+CssSheetCacheStats CssSheetCache::GetStats() {
+	std::lock_guard<std::mutex> locker(lock_);
+	CssSheetCacheStats stats = stats_;
+	stats.sheets = files_.size() + inline_.size();
+	return stats;
+}
@@ -1,7 +1,13 @@
 #pragma once
+#include <functional>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <stdint.h>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "CssParser.h"
 
 #if _UNICODE
@@ -12,6 +18,87 @@ typedef std::string css_string;
 
 typedef std::map<css_string, css_string> CssStyles;
 
+//ʱԤתõֵؼԳõļдһ
+struct CssValue {
+	long numbers[4];		//ŷָpospaddingborderround
+	int count;				//numbersЧĸ
+	bool list;				//ֵкж
+	unsigned long color;	//ȥհ׺#16ƽɫ
+	bool boolean;			//ֵΪtrue(ִСд)
+
+	void Parse(const css_string& value);
+};
+
+struct CssDeclaration {
+	css_string name;
+	css_string value;
+	CssValue parsed;
+};
+
+//ֱһĺtargetΪĿ
+typedef void (*CssSetter)(void* target, const CssDeclaration& declaration);
+
+//Ĺ˳УֵԤ
+//ÿĿ͵setterֻһβ棬ҲΪգӦʱ˵
+class CssRule {
+public:
+	typedef std::function<CssSetter(const CssDeclaration&)> Resolver;
+
+	CssStyles styles;
+	std::vector<CssDeclaration> declarations;
+
+	void Compile();
+	//declarationsһһӦsettertypeʶĿ
+	const std::vector<CssSetter>& Resolve(const void* type, const Resolver& resolver) const;
+private:
+	mutable std::map<const void*, std::vector<CssSetter>> setters_;
+	mutable std::mutex lock_;
+};
+
+//ѡƥԪأǩΪؼȥUIidΪnameclassж
+struct CssElement {
+	css_string tag;
+	css_string id;
+	std::vector<css_string> classes;
+
+	//հײclassԣ"btn primary"
+	void SetClasses(const css_string& value);
+};
+
+//ѡButton#ok.btn.primaryյıʾ*
+struct CssCompound {
+	css_string tag;
+	css_string id;
+	std::vector<css_string> classes;
+
+	bool Matches(const CssElement& element) const;
+};
+
+//ԺϷӵĸѡList .row Label
+struct CssSelector {
+	std::vector<CssCompound> compounds;	//ңһΪƥԪر
+	unsigned specificity;				//idclassǩĸռ10λ
+
+	bool Parse(const css_string& text);
+	//ancestorsӽԶ
+	bool Matches(const CssElement& element, const std::vector<CssElement>& ancestors) const;
+};
+
+//ȼӵ͵еƥӦü
+typedef std::vector<std::shared_ptr<const CssRule>> CssRuleList;
+
+//Ԫصֱ仯ҪƥķΧ
+enum {
+	kCssInvalidateSelf = 1,			//Ԫر
+	kCssInvalidateDescendants = 2,	//к
+};
+
+//һʽƥprioritiesrulesһһӦںĽϲ
+struct CssMatch {
+	CssRuleList rules;
+	std::vector<std::pair<unsigned, size_t>> priorities;	//ѡspecificityͳ˳
+};
+
 class CssSheet {
 public:
 	CssSheet();
@@ -20,16 +107,176 @@ public:
 	bool Parse(const css_char* s);
 	bool Parse(const css_string& s);
 
-	std::shared_ptr<CssStyles> GetStylesByClass(const css_string& key);
-	std::shared_ptr<CssStyles> GetStylesById(const css_string& key);
-	std::shared_ptr<CssStyles> GetStylesByElement(const css_string& key);
+	std::shared_ptr<const CssRule> GetStylesByClass(const css_string& key) const;
+	std::shared_ptr<const CssRule> GetStylesById(const css_string& key) const;
+	std::shared_ptr<const CssRule> GetStylesByElement(const css_string& key) const;
+
+	//ƥԪصйancestorsӽԶûкѡʱΪա
+	//ԪؼбѡõĲֻ棬бظֻһ
+	std::shared_ptr<const CssRuleList> Match(const CssElement& element, const std::vector<CssElement>& ancestors) const;
+	//ͬMatchиȼ
+	std::shared_ptr<const CssMatch> MatchRules(const CssElement& element, const std::vector<CssElement>& ancestors) const;
+	//ǷйҪȲƥ䣬ûʱ÷ռ
+	bool HasDescendantSelectors() const;
+	//ԪصıǩidclassbeforeΪafterʱӰķΧֻб仯ұѡõ
+	int GetInvalidation(const CssElement& before, const CssElement& after) const;
+
+	//й򣬶ѡõĹᱻʶ
+	void EnumStyles(const std::function<void(const CssStyles&)>& visitor) const;
 private:
+	struct IndexEntry {
+		CssSelector selector;
+		std::shared_ptr<CssRule> rule;
+		size_t order;	//ֵȺȼͬʱֵĸǰ
+	};
+	typedef std::unordered_map<css_string, std::vector<const IndexEntry*>> IndexBucket;
+	struct NameSet {
+		std::unordered_set<css_string> tags;
+		std::unordered_set<css_string> ids;
+		std::unordered_set<css_string> classes;
+	};
+
+	void AddSelector(const css_string& text);
+	void RebuildIndex();
+	void AppendKey(const CssElement& element, const NameSet& names, css_string& key) const;
+	void Collect(const IndexBucket& bucket, const css_string& name, std::vector<const IndexEntry*>& candidates) const;
+
 	static void OnParseSelector(CssSelectorMode mode,const css_str_t* str, void* ud);
 	static void OnParseValue(const css_str_t* key, const css_str_t* value, void* ud);
 
-	std::shared_ptr<CssStyles> current_;
-	std::map<css_string,std::shared_ptr<CssStyles>> class_styles_;//.a{}
-	std::map<css_string,std::shared_ptr<CssStyles>> id_styles_;//#a{}
-	std::map<css_string,std::shared_ptr<CssStyles>> element_styles_;//a {}
+	std::shared_ptr<CssRule> current_;
+	std::map<css_string,std::shared_ptr<CssRule>> class_styles_;//.a{}
+	std::map<css_string,std::shared_ptr<CssRule>> id_styles_;//#a{}
+	std::map<css_string,std::shared_ptr<CssRule>> element_styles_;//a {}
+
+	//ѡұ߸ѡеidһclassǩͰûеķuniversal_
+	std::map<css_string, IndexEntry> selectors_;	//ͬһѡֵĹ滻ǰ
+	size_t order_;
+	IndexBucket by_id_;
+	IndexBucket by_class_;
+	IndexBucket by_tag_;
+	std::vector<const IndexEntry*> universal_;
+	//ѡгֵֻ֣ȡЩ֡ԪرӦұߵĸѡȶӦ
+	NameSet subject_names_;
+	NameSet ancestor_names_;
+	bool has_descendant_;
+	bool ancestor_universal_;	//*ÿһȶҪ뻺
+
+	mutable std::unordered_map<css_string, std::shared_ptr<const CssMatch>> matches_;
+	mutable std::mutex lock_;
+};
+
+//ʹõʽ˳ŵĹʽֻòơ
+//ƥspecificityϲͬʱصıں󣬺ϲĽ
+class CssSheetView {
+public:
+	//pathΪձʾʽѵŵıظӣļ·ʽͬһݱǷб仯
+	bool Add(const css_string& path, std::shared_ptr<const CssSheet> sheet);
+	//pathӦı°汾Ƿб仯
+	bool Update(const css_string& path, std::shared_ptr<const CssSheet> sheet);
+	void Clear();
+
+	//ļʽ·ͬһ·ֻһ
+	std::vector<css_string> GetPaths() const;
+
+	std::shared_ptr<const CssRuleList> Match(const CssElement& element, const std::vector<CssElement>& ancestors) const;
+	bool HasDescendantSelectors() const;
+	int GetInvalidation(const CssElement& before, const CssElement& after) const;
+	bool IsEmpty() const;
+	//صı
+	std::shared_ptr<const CssRule> GetStylesByClass(const css_string& key) const;
+	std::shared_ptr<const CssRule> GetStylesByElement(const css_string& key) const;
+	void EnumStyles(const std::function<void(const CssStyles&)>& visitor) const;
+private:
+	struct Layer {
+		css_string path;
+		std::shared_ptr<const CssSheet> sheet;
+	};
+
+	void Reset();
+
+	std::vector<Layer> layers_;
+	mutable std::map<std::vector<std::shared_ptr<const CssMatch>>, std::shared_ptr<const CssRuleList>> matches_;
+	mutable std::mutex lock_;
+};
+
+//ԪصǰӦõʽƥ䵽ĹԼʽǵԡ
+//ƥ仯ʱֵֻб仯ԣ½ûеԱԭֵ
+class CssStyleState {
+public:
+	typedef std::pair<const CssRule*, size_t> Declaration;	//±
+
+	//ʽ֮ãʽ仯ʱ
+	void SetInline(const css_string& name);
+	bool IsInline(const css_string& name) const;
+
+	//һʽʱԪؼͬVScrollBarƥʱ
+	void SetTag(const css_string& tag) { tag_ = tag; }
+	const css_string& GetTag() const { return tag_; }
+
+	const std::shared_ptr<const CssRuleList>& GetRules() const { return rules_; }
+	//µƥҪõӦ˳СһηȫʱΪ
+	std::vector<Declaration> Update(const std::shared_ptr<const CssRuleList>& rules);
+private:
+	//ÿЧ
+	struct Final {
+		const CssDeclaration* declaration;
+		size_t rule;
+		size_t index;
+	};
+	typedef std::vector<Final> Finals;
+	//һƥһʱҪõδȥ
+	struct Diff {
+		std::weak_ptr<const CssRuleList> from;
+		std::weak_ptr<const CssRuleList> to;
+		std::shared_ptr<const Finals> finals;				//toֵͬԪع
+		std::vector<std::pair<size_t, size_t>> positions;	//±꣬Ӧ˳
+	};
+	static void GetFinals(const CssRuleList& rules, Finals& finals);
+	//ͬһƥԪشͬĽͬ½ıȽϰ̻߳
+	static const Diff& GetDiff(const std::shared_ptr<const CssRuleList>& from, const std::shared_ptr<const Finals>& finals,
+		const std::shared_ptr<const CssRuleList>& to);
+
+	css_string tag_;
+	std::shared_ptr<const CssRuleList> rules_;
+	std::shared_ptr<const Finals> finals_;
+	std::vector<css_string> inline_;
+};
+
+struct CssSheetCacheStats {
+	int parses;		//Ĵ
+	int hits;		//δֱӷصĴ
+	size_t sheets;	//ı
+};
+
+//ڹѽʽļ·ݹϣ棬ʽݻ档
+//޸ģļݱ仯ʱ°汾ԭӵ滻þɰ汾ĴڲӰ
+class CssSheetCache {
+public:
+	//ļתΪcssıֻҪʱ
+	typedef std::function<css_string(const uint8_t* data, size_t size)> Converter;
+
+	static CssSheetCache* GetInstance();
+
+	//pResultؽǷɹʧܵĲֹȻЧ
+	std::shared_ptr<const CssSheet> Load(const css_string& path, const uint8_t* data, size_t size, const Converter& convert, bool* pResult = nullptr);
+	std::shared_ptr<const CssSheet> Parse(const css_string& text, bool* pResult = nullptr);
+	//·ǰİ汾ûмعؿ
+	std::shared_ptr<const CssSheet> Get(const css_string& path);
+
+	void Clear();
+	CssSheetCacheStats GetStats();
+private:
+	struct Entry {
+		uint64_t hash;
+		size_t size;
+		bool result;
+		std::shared_ptr<const CssSheet> sheet;
+	};
+
+	std::map<css_string, Entry> files_;
+	std::map<css_string, Entry> inline_;
+	CssSheetCacheStats stats_ = {};
+	std::mutex lock_;
 };
 
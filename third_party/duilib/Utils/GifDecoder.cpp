@@ -0,0 +1,490 @@
+#include "GifDecoder.h"
+#include "PixelKernel.h"
+#include "async/thread.h"
+#include <string.h>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+
+namespace DuiLib {
+
+	namespace {
+
+		//跳过一串数据子块，pos停在结束块之后
+		bool SkipBlocks(const uint8_t* p, size_t size, size_t& pos)
+		{
+			while (pos < size) {
+				size_t len = p[pos++];
+				if (len == 0)
+					return true;
+				pos += len;
+			}
+			return false;
+		}
+
+		//读取调色板，颜色按RGBA字节顺序存放，不足256项的部分为透明
+		void ReadPalette(const uint8_t* p, int count, uint32_t* palette)
+		{
+			memset(palette, 0, sizeof(uint32_t) * 256);
+			for (int i = 0; i < count; ++i, p += 3) {
+				uint8_t rgba[4] = { p[0], p[1], p[2], 255 };
+				memcpy(&palette[i], rgba, 4);
+			}
+		}
+
+		inline bool IsOpaque(uint32_t color)
+		{
+			return reinterpret_cast<const uint8_t*>(&color)[3] != 0;
+		}
+
+		//隔行扫描时第i个输出行对应的图像行
+		int InterlacedRow(int i, int h)
+		{
+			int n = (h + 7) / 8;
+			if (i < n) return i * 8;
+			i -= n;
+			n = (h + 3) / 8;
+			if (i < n) return i * 8 + 4;
+			i -= n;
+			n = (h + 1) / 4;
+			if (i < n) return i * 4 + 2;
+			return (i - n) * 2 + 1;
+		}
+
+	}
+
+	CGifDecoder::CGifDecoder() : m_nWidth(0), m_nHeight(0), m_nLoopCount(0), m_nBackground(0),
+		m_bGlobalPalette(false), m_nNext(0)
+	{
+		memset(m_aGlobalPalette, 0, sizeof(m_aGlobalPalette));
+	}
+
+	CGifDecoder::~CGifDecoder()
+	{
+	}
+
+	bool CGifDecoder::Open(const uint8_t* data, size_t size)
+	{
+		m_aData.assign(data, data + size);
+		m_aFrames.clear();
+		m_aSaved.clear();
+		m_aIndices.clear();
+		m_nNext = 0;
+		if (!Scan() || m_aFrames.empty()) {
+			m_aData.clear();
+			m_aFrames.clear();
+			m_aCanvas.clear();
+			m_nWidth = m_nHeight = 0;
+			return false;
+		}
+		m_aCanvas.assign((size_t)m_nWidth * m_nHeight * 4, 0);
+		return true;
+	}
+
+	bool CGifDecoder::Scan()
+	{
+		const uint8_t* p = m_aData.data();
+		size_t size = m_aData.size();
+		if (size < 13 || memcmp(p, "GIF8", 4) != 0 || (p[4] != '7' && p[4] != '9') || p[5] != 'a')
+			return false;
+
+		m_nWidth = p[6] | (p[7] << 8);
+		m_nHeight = p[8] | (p[9] << 8);
+		int flags = p[10];
+		m_nBackground = p[11];
+		m_nLoopCount = 0;
+		if (m_nWidth == 0 || m_nHeight == 0 || (size_t)m_nWidth * m_nHeight > (1 << 26))
+			return false;
+
+		size_t pos = 13;
+		m_bGlobalPalette = (flags & 0x80) != 0;
+		memset(m_aGlobalPalette, 0, sizeof(m_aGlobalPalette));
+		if (m_bGlobalPalette) {
+			int count = 2 << (flags & 7);
+			if (pos + count * 3 > size)
+				return false;
+			ReadPalette(p + pos, count, m_aGlobalPalette);
+			pos += count * 3;
+		}
+
+		//图形控制扩展只作用于紧随其后的一帧
+		int dispose = 0;
+		int transparent = -1;
+		int delay = 0;
+		while (pos < size) {
+			int tag = p[pos++];
+			if (tag == 0x21) {
+				if (pos >= size)
+					break;
+				int label = p[pos++];
+				if (label == 0xF9 && pos + 5 <= size && p[pos] == 4) {
+					int packed = p[pos + 1];
+					delay = p[pos + 2] | (p[pos + 3] << 8);
+					dispose = (packed >> 2) & 7;
+					transparent = (packed & 1) ? p[pos + 4] : -1;
+				}
+				else if (label == 0xFF && pos + 16 <= size && p[pos] == 11 && memcmp(p + pos + 1, "NETSCAPE2.0", 11) == 0
+					&& p[pos + 12] == 3 && p[pos + 13] == 1) {
+					m_nLoopCount = p[pos + 14] | (p[pos + 15] << 8);
+				}
+				if (!SkipBlocks(p, size, pos))
+					break;
+			}
+			else if (tag == 0x2C) {
+				if (pos + 9 > size)
+					break;
+				Frame frame;
+				frame.x = p[pos] | (p[pos + 1] << 8);
+				frame.y = p[pos + 2] | (p[pos + 3] << 8);
+				frame.w = p[pos + 4] | (p[pos + 5] << 8);
+				frame.h = p[pos + 6] | (p[pos + 7] << 8);
+				frame.flags = p[pos + 8];
+				frame.dispose = dispose;
+				frame.transparent = transparent;
+				frame.delay = delay;
+				pos += 9;
+				frame.offset = pos;
+				if (frame.flags & 0x80)
+					pos += (2 << (frame.flags & 7)) * 3;
+				else if (!m_bGlobalPalette)
+					break;
+				//LZW最小码长
+				if (pos >= size)
+					break;
+				pos++;
+				m_aFrames.push_back(frame);
+				dispose = 0;
+				transparent = -1;
+				delay = 0;
+				//截断的最后一帧解码出多少算多少
+				if (!SkipBlocks(p, size, pos))
+					break;
+			}
+			else {
+				//0x3B为结束标记，其他为损坏的数据
+				break;
+			}
+		}
+		return true;
+	}
+
+	int CGifDecoder::GetDelay(int frame) const
+	{
+		if (frame < 0 || frame >= (int)m_aFrames.size())
+			return 0;
+		return m_aFrames[frame].delay * 10;
+	}
+
+	void CGifDecoder::Rewind()
+	{
+		m_nNext = 0;
+	}
+
+	int CGifDecoder::DecodeNext()
+	{
+		if (m_aFrames.empty())
+			return -1;
+
+		if (m_nNext == 0)
+			memset(m_aCanvas.data(), 0, m_aCanvas.size());
+		else
+			Dispose(m_aFrames[m_nNext - 1]);
+
+		const Frame& frame = m_aFrames[m_nNext];
+		if (frame.dispose == 3) {
+			//保存将被覆盖的区域，下一帧之前恢复
+			int w = frame.x < m_nWidth ? (std::min)(frame.w, m_nWidth - frame.x) : 0;
+			int h = frame.y < m_nHeight ? (std::min)(frame.h, m_nHeight - frame.y) : 0;
+			m_aSaved.resize((size_t)w * h * 4);
+			for (int y = 0; y < h; ++y)
+				memcpy(&m_aSaved[(size_t)y * w * 4], &m_aCanvas[((size_t)(frame.y + y) * m_nWidth + frame.x) * 4], (size_t)w * 4);
+		}
+
+		if (!DecodeFrame(frame, m_nNext == 0))
+			return -1;
+
+		int decoded = m_nNext;
+		m_nNext = (m_nNext + 1) % (int)m_aFrames.size();
+		return decoded;
+	}
+
+	void CGifDecoder::Dispose(const Frame& frame)
+	{
+		if (frame.dispose != 2 && frame.dispose != 3)
+			return;
+
+		int w = frame.x < m_nWidth ? (std::min)(frame.w, m_nWidth - frame.x) : 0;
+		int h = frame.y < m_nHeight ? (std::min)(frame.h, m_nHeight - frame.y) : 0;
+		for (int y = 0; y < h; ++y) {
+			uint8_t* row = &m_aCanvas[((size_t)(frame.y + y) * m_nWidth + frame.x) * 4];
+			if (frame.dispose == 2)
+				memset(row, 0, (size_t)w * 4);
+			else if (m_aSaved.size() == (size_t)w * h * 4)
+				memcpy(row, &m_aSaved[(size_t)y * w * 4], (size_t)w * 4);
+		}
+	}
+
+	bool CGifDecoder::DecodeFrame(const Frame& frame, bool first)
+	{
+		uint32_t palette[256];
+		size_t offset = frame.offset;
+		if (frame.flags & 0x80) {
+			int count = 2 << (frame.flags & 7);
+			if (offset + count * 3 > m_aData.size())
+				return false;
+			ReadPalette(&m_aData[offset], count, palette);
+			offset += count * 3;
+		}
+		else {
+			memcpy(palette, m_aGlobalPalette, sizeof(palette));
+		}
+		if (frame.transparent >= 0)
+			palette[frame.transparent] = 0;
+
+		//与stb一致：第一帧没有画到的像素填背景色，透明像素保持透明
+		bool fill = first && m_nBackground > 0;
+		if (fill) {
+			uint32_t background = m_aGlobalPalette[m_nBackground];
+			reinterpret_cast<uint8_t*>(&background)[3] = 255;
+			uint32_t* canvas = reinterpret_cast<uint32_t*>(m_aCanvas.data());
+			for (size_t i = 0, n = (size_t)m_nWidth * m_nHeight; i < n; ++i)
+				canvas[i] = background;
+		}
+
+		int count = frame.w * frame.h;
+		int decoded = DecodeLzw(offset, count);
+
+		int w = frame.x < m_nWidth ? (std::min)(frame.w, m_nWidth - frame.x) : 0;
+		bool interlaced = (frame.flags & 0x40) != 0;
+		for (int i = 0; i < frame.h; ++i) {
+			int start = i * frame.w;
+			if (start >= decoded)
+				break;
+			int y = frame.y + (interlaced ? InterlacedRow(i, frame.h) : i);
+			if (y >= m_nHeight)
+				continue;
+
+			int n = (std::min)((std::min)(frame.w, decoded - start), w);
+			const uint8_t* index = &m_aIndices[start];
+			uint32_t* dst = reinterpret_cast<uint32_t*>(&m_aCanvas[((size_t)y * m_nWidth + frame.x) * 4]);
+			for (int x = 0; x < n; ++x) {
+				uint32_t color = palette[index[x]];
+				if (IsOpaque(color))
+					dst[x] = color;
+				else if (fill)
+					dst[x] = 0;
+			}
+		}
+		return true;
+	}
+
+	int CGifDecoder::DecodeLzw(size_t offset, int count)
+	{
+		const uint8_t* p = m_aData.data();
+		size_t size = m_aData.size();
+		if (count <= 0 || offset >= size)
+			return 0;
+		int min_size = p[offset++];
+		if (min_size < 1 || min_size > 11)
+			return 0;
+
+		m_aIndices.resize(count);
+		uint8_t* out = m_aIndices.data();
+
+		uint16_t prefix[4096];
+		uint8_t suffix[4096];
+		uint8_t first[4096];
+		uint16_t length[4096];
+		const int clear = 1 << min_size;
+		for (int i = 0; i < clear; ++i) {
+			prefix[i] = 0;
+			suffix[i] = first[i] = (uint8_t)i;
+			length[i] = 1;
+		}
+
+		int code_size = min_size + 1;
+		int avail = clear + 2;
+		int old = -1;
+		int pos = 0;
+		uint32_t bits = 0;
+		int valid = 0;
+		size_t block_end = offset;
+		while (pos < count) {
+			//按需从数据子块中读入字节
+			while (valid < code_size) {
+				if (offset == block_end) {
+					if (offset >= size || p[offset] == 0)
+						return pos;
+					block_end = offset + 1 + p[offset];
+					offset++;
+					if (block_end > size)
+						block_end = size;
+					if (offset == block_end)
+						return pos;
+				}
+				bits |= (uint32_t)p[offset++] << valid;
+				valid += 8;
+			}
+			int code = bits & ((1 << code_size) - 1);
+			bits >>= code_size;
+			valid -= code_size;
+
+			if (code == clear) {
+				code_size = min_size + 1;
+				avail = clear + 2;
+				old = -1;
+				continue;
+			}
+			if (code == clear + 1)
+				break;
+
+			if (old < 0) {
+				if (code >= clear)
+					break;
+			}
+			else {
+				if (code > avail || (code == avail && avail >= 4096))
+					break;
+				if (avail < 4096) {
+					prefix[avail] = (uint16_t)old;
+					first[avail] = first[old];
+					suffix[avail] = code == avail ? first[old] : first[code];
+					length[avail] = length[old] + 1;
+					avail++;
+					if (avail == (1 << code_size) && code_size < 12)
+						code_size++;
+				}
+			}
+			old = code;
+
+			//沿前缀链从后向前写出这个码的串，超出帧的部分丢弃
+			int len = length[code];
+			int end = pos + len;
+			int k = code;
+			int i = end - 1;
+			for (; i >= count; --i)
+				k = prefix[k];
+			for (; i >= pos; --i) {
+				out[i] = suffix[k];
+				k = prefix[k];
+			}
+			pos = (std::min)(end, count);
+		}
+		return pos;
+	}
+
+	size_t CGifDecoder::GetMemoryUsage() const
+	{
+		return m_aData.capacity() + m_aCanvas.capacity() + m_aSaved.capacity() + m_aIndices.capacity()
+			+ m_aFrames.capacity() * sizeof(Frame);
+	}
+
+	struct CGifFrameQueue::State
+	{
+		CGifDecoder decoder;
+		std::vector<uint8_t> ready;		//预先解码的帧，预乘alpha的BGRA
+		int ready_frame;
+		bool busy;
+		std::mutex lock;
+		std::condition_variable done;
+	};
+
+	CGifFrameQueue::CGifFrameQueue() : m_pState(std::make_shared<State>())
+	{
+		m_pState->ready_frame = -1;
+		m_pState->busy = false;
+	}
+
+	CGifFrameQueue::~CGifFrameQueue()
+	{
+	}
+
+	bool CGifFrameQueue::Open(const uint8_t* data, size_t size)
+	{
+		//正在进行的预解码使用旧的State，换一个新的
+		m_pState = std::make_shared<State>();
+		m_pState->ready_frame = -1;
+		m_pState->busy = true;
+		if (!m_pState->decoder.Open(data, size)) {
+			m_pState->busy = false;
+			return false;
+		}
+		Prefetch(m_pState);
+		return m_pState->ready_frame >= 0;
+	}
+
+	int CGifFrameQueue::GetWidth() const
+	{
+		return m_pState->decoder.GetWidth();
+	}
+
+	int CGifFrameQueue::GetHeight() const
+	{
+		return m_pState->decoder.GetHeight();
+	}
+
+	int CGifFrameQueue::GetFrameCount() const
+	{
+		return m_pState->decoder.GetFrameCount();
+	}
+
+	int CGifFrameQueue::GetDelay(int frame) const
+	{
+		return m_pState->decoder.GetDelay(frame);
+	}
+
+	int CGifFrameQueue::GetLoopCount() const
+	{
+		return m_pState->decoder.GetLoopCount();
+	}
+
+	void CGifFrameQueue::Prefetch(const std::shared_ptr<State>& state)
+	{
+		int frame = state->decoder.DecodeNext();
+		if (frame >= 0) {
+			size_t count = (size_t)state->decoder.GetWidth() * state->decoder.GetHeight();
+			state->ready.resize(count * 4);
+			CPixelKernel::RgbaToPremultipliedBgra(state->decoder.GetPixels(), state->ready.data(), count, 0);
+		}
+
+		std::lock_guard<std::mutex> locker(state->lock);
+		state->ready_frame = frame;
+		state->busy = false;
+		state->done.notify_all();
+	}
+
+	int CGifFrameQueue::NextFrame(uint8_t* dst)
+	{
+		std::shared_ptr<State> state = m_pState;
+		int frame;
+		{
+			std::unique_lock<std::mutex> locker(state->lock);
+			state->done.wait(locker, [&state]() { return !state->busy; });
+			frame = state->ready_frame;
+			if (frame < 0)
+				return -1;
+			memcpy(dst, state->ready.data(), state->ready.size());
+			state->busy = true;
+		}
+
+		ThreadManager::Instance()->PostTask(ThreadManager::kImage, [state]() {
+			Prefetch(state);
+		});
+		return frame;
+	}
+
+	void CGifFrameQueue::Rewind()
+	{
+		std::shared_ptr<State> state = m_pState;
+		{
+			std::unique_lock<std::mutex> locker(state->lock);
+			state->done.wait(locker, [&state]() { return !state->busy; });
+			if (state->ready_frame < 0)
+				return;
+			state->busy = true;
+		}
+		state->decoder.Rewind();
+		Prefetch(state);
+	}
+
+}
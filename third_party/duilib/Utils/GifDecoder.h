@@ -0,0 +1,99 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+namespace DuiLib {
+
+	//逐帧解码的gif，只保留压缩数据和一张合成后的画布，内存与帧数无关
+	//输出与stbi_load_gif_from_memory相同的RGBA；帧的处置方式按gif89a规范处理：
+	//2清除为透明，3恢复为绘制该帧之前的内容。不依赖windows头文件，可以在其他平台上测试
+	class CGifDecoder
+	{
+	public:
+		CGifDecoder();
+		~CGifDecoder();
+
+		//拷贝数据并扫描所有帧，不解码像素。至少有一帧时返回true
+		bool Open(const uint8_t* data, size_t size);
+
+		int GetWidth() const { return m_nWidth; }
+		int GetHeight() const { return m_nHeight; }
+		int GetFrameCount() const { return (int)m_aFrames.size(); }
+		//毫秒
+		int GetDelay(int frame) const;
+		//NETSCAPE2.0扩展中的循环次数，0为无限循环
+		int GetLoopCount() const { return m_nLoopCount; }
+
+		//把下一帧合成到画布上，最后一帧之后回到第一帧。返回刚解码的帧号，失败返回-1
+		int DecodeNext();
+		//下一次DecodeNext从第一帧开始
+		void Rewind();
+
+		//当前画布，RGBA
+		const uint8_t* GetPixels() const { return m_aCanvas.data(); }
+		//压缩数据和各缓冲区占用的字节数
+		size_t GetMemoryUsage() const;
+
+	private:
+		struct Frame {
+			size_t offset;		//局部调色板或LZW数据的位置
+			int x, y, w, h;
+			int flags;			//图像描述符的标志
+			int dispose;
+			int transparent;	//-1为没有透明色
+			int delay;
+		};
+
+		bool Scan();
+		bool DecodeFrame(const Frame& frame, bool first);
+		int DecodeLzw(size_t offset, int count);
+		void Dispose(const Frame& frame);
+
+		std::vector<uint8_t> m_aData;
+		std::vector<Frame> m_aFrames;
+		int m_nWidth;
+		int m_nHeight;
+		int m_nLoopCount;
+		int m_nBackground;
+		uint32_t m_aGlobalPalette[256];
+		bool m_bGlobalPalette;
+
+		int m_nNext;					//下一个要解码的帧
+		std::vector<uint8_t> m_aCanvas;
+		std::vector<uint8_t> m_aSaved;	//处置方式3要恢复的区域
+		std::vector<uint8_t> m_aIndices;	//当前帧的调色板索引
+	};
+
+	//在图片线程上提前解码下一帧的gif，界面线程每次取走一帧时预约再下一帧
+	//同一时刻只有一个任务使用解码器。对象释放时进行中的任务持有自己的状态
+	class CGifFrameQueue
+	{
+	public:
+		CGifFrameQueue();
+		~CGifFrameQueue();
+
+		//打开并同步解码第一帧
+		bool Open(const uint8_t* data, size_t size);
+
+		int GetWidth() const;
+		int GetHeight() const;
+		int GetFrameCount() const;
+		int GetDelay(int frame) const;
+		int GetLoopCount() const;
+
+		//取出预先解码的帧，转为预乘alpha的BGRA写入dst，并开始解码下一帧；解码未完成时等待
+		//返回帧号，失败返回-1
+		int NextFrame(uint8_t* dst);
+		//下一次NextFrame返回第一帧
+		void Rewind();
+
+	private:
+		struct State;
+		static void Prefetch(const std::shared_ptr<State>& state);
+
+		std::shared_ptr<State> m_pState;
+	};
+
+}
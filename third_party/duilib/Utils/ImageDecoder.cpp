@@ -0,0 +1,288 @@
+#include "ImageDecoder.h"
+#include "PixelKernel.h"
+#include "async/thread.h"
+#include "stbimage/stb_image.h"
+#include "stbimage/stb_image_resize.h"
+#include <string.h>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+namespace DuiLib {
+
+	CDecodedImage::CDecodedImage() : m_pBits(NULL), m_nX(0), m_nY(0), m_bConverted(false), m_bAlpha(false)
+	{
+	}
+
+	CDecodedImage::~CDecodedImage()
+	{
+		Free();
+	}
+
+	CDecodedImage::CDecodedImage(CDecodedImage&& other) : m_pBits(NULL)
+	{
+		*this = std::move(other);
+	}
+
+	CDecodedImage& CDecodedImage::operator=(CDecodedImage&& other)
+	{
+		if (this != &other) {
+			Free();
+			m_pBits = other.m_pBits;
+			m_nX = other.m_nX;
+			m_nY = other.m_nY;
+			m_bConverted = other.m_bConverted;
+			m_bAlpha = other.m_bAlpha;
+			other.m_pBits = NULL;
+			other.m_nX = other.m_nY = 0;
+			other.m_bConverted = other.m_bAlpha = false;
+		}
+		return *this;
+	}
+
+	void CDecodedImage::Free()
+	{
+		if (m_pBits) {
+			stbi_image_free(m_pBits);
+			m_pBits = NULL;
+		}
+	}
+
+	bool CDecodedImage::Decode(const uint8_t* data, size_t size, int scale)
+	{
+		Free();
+		m_nX = m_nY = 0;
+		m_bConverted = m_bAlpha = false;
+
+		int x, y, n;
+		uint8_t* pixel = stbi_load_from_memory(data, (int)size, &x, &y, &n, 4);
+		if (!pixel)
+			return false;
+
+		if (scale > 0 && scale < 800 && scale != 100) {
+			int newx = x * scale / 100;
+			int newy = y * scale / 100;
+			if (newx < 1) newx = 1;
+			if (newy < 1) newy = 1;
+			//stbi按4通道输出，缩放也必须按4通道
+			uint8_t* pixel_out = (uint8_t*)stbi_image_malloc((size_t)newx * newy * 4);
+			if (!pixel_out) {
+				stbi_image_free(pixel);
+				return false;
+			}
+			stbir_resize_uint8(pixel, x, y, 0, pixel_out, newx, newy, 0, 4);
+			stbi_image_free(pixel);
+			pixel = pixel_out;
+			x = newx;
+			y = newy;
+		}
+
+		m_pBits = pixel;
+		m_nX = x;
+		m_nY = y;
+		return true;
+	}
+
+	bool CDecodedImage::Assign(const uint8_t* rgba, int width, int height)
+	{
+		Free();
+		m_nX = m_nY = 0;
+		m_bConverted = m_bAlpha = false;
+		if (width <= 0 || height <= 0)
+			return false;
+
+		size_t size = (size_t)width * height * 4;
+		m_pBits = (uint8_t*)stbi_image_malloc(size);
+		if (!m_pBits)
+			return false;
+		memcpy(m_pBits, rgba, size);
+		m_nX = width;
+		m_nY = height;
+		return true;
+	}
+
+	bool CDecodedImage::Convert(uint32_t mask, uint8_t* dst)
+	{
+		if (!m_pBits)
+			return false;
+
+		size_t count = (size_t)m_nX * m_nY;
+		if (m_bConverted) {
+			if (dst)
+				memcpy(dst, m_pBits, count * 4);
+			return m_bAlpha;
+		}
+
+		if (dst) {
+			m_bAlpha = CPixelKernel::RgbaToPremultipliedBgra(m_pBits, dst, count, mask);
+		}
+		else {
+			m_bAlpha = CPixelKernel::RgbaToPremultipliedBgra(m_pBits, m_pBits, count, mask);
+			m_bConverted = true;
+		}
+		return m_bAlpha;
+	}
+
+	struct CImagePreloader::Entry
+	{
+		enum Status {
+			kQueued,	//等待图片线程
+			kRunning,	//正在读取解码
+			kDone,		//已完成或已放弃
+		};
+
+		image_string name;
+		uint32_t mask;
+		Status status;
+		bool ok;
+		std::unique_ptr<uint8_t[]> data;
+		size_t size;
+		int scale;
+		CDecodedImage image;
+	};
+
+	struct CImagePreloader::State
+	{
+		Reader reader;
+		std::mutex lock;
+		std::condition_variable done;
+		std::map<image_string, std::shared_ptr<Entry>> entries;
+	};
+
+	CImagePreloader::CImagePreloader(Reader reader) : m_pState(std::make_shared<State>())
+	{
+		m_pState->reader = reader;
+	}
+
+	CImagePreloader::~CImagePreloader()
+	{
+		//进行中的任务持有State和Entry，结束后自行释放
+		Clear();
+	}
+
+	void CImagePreloader::Preload(const image_string& name, uint32_t mask)
+	{
+		Preload(name, mask, nullptr, 0);
+	}
+
+	void CImagePreloader::Preload(const image_string& name, uint32_t mask, std::unique_ptr<uint8_t[]> data, size_t size, int scale)
+	{
+		if (name.empty())
+			return;
+
+		std::shared_ptr<Entry> entry = std::make_shared<Entry>();
+		entry->name = name;
+		entry->mask = mask;
+		entry->status = Entry::kQueued;
+		entry->ok = false;
+		entry->data = std::move(data);
+		entry->size = size;
+		entry->scale = scale;
+		{
+			std::lock_guard<std::mutex> locker(m_pState->lock);
+			if (!m_pState->entries.insert(std::make_pair(name, entry)).second)
+				return;
+		}
+
+		std::shared_ptr<State> state = m_pState;
+		ThreadManager::Instance()->PostTask(ThreadManager::kImage, [state, entry]() {
+			Run(state, entry);
+		});
+	}
+
+	void CImagePreloader::Run(const std::shared_ptr<State>& state, const std::shared_ptr<Entry>& entry)
+	{
+		{
+			std::lock_guard<std::mutex> locker(state->lock);
+			if (entry->status != Entry::kQueued)
+				return;
+			entry->status = Entry::kRunning;
+		}
+
+		Decode(*state, *entry);
+
+		{
+			std::lock_guard<std::mutex> locker(state->lock);
+			entry->status = Entry::kDone;
+		}
+		state->done.notify_all();
+	}
+
+	void CImagePreloader::Decode(const State& state, Entry& entry)
+	{
+		if (!entry.data && state.reader)
+			entry.data = state.reader(entry.name, entry.size, entry.scale);
+		if (entry.data && entry.image.Decode(entry.data.get(), entry.size, entry.scale)) {
+			entry.image.Convert(entry.mask);
+			entry.ok = true;
+		}
+		entry.data.reset();
+	}
+
+	bool CImagePreloader::Lookup(const image_string& name, uint32_t& mask)
+	{
+		std::lock_guard<std::mutex> locker(m_pState->lock);
+		auto find = m_pState->entries.find(name);
+		if (find == m_pState->entries.end())
+			return false;
+		mask = find->second->mask;
+		return true;
+	}
+
+	bool CImagePreloader::Take(const image_string& name, uint32_t mask, CDecodedImage& image)
+	{
+		std::shared_ptr<Entry> entry;
+		bool claimed = false;
+		{
+			std::unique_lock<std::mutex> locker(m_pState->lock);
+			auto find = m_pState->entries.find(name);
+			if (find == m_pState->entries.end())
+				return false;
+			entry = find->second;
+			m_pState->entries.erase(find);
+
+			if (entry->mask != mask) {
+				//调用者会按自己的mask重新加载，还在排队的不必再解码
+				if (entry->status == Entry::kQueued)
+					entry->status = Entry::kDone;
+				return false;
+			}
+
+			if (entry->status == Entry::kQueued) {
+				entry->status = Entry::kRunning;
+				claimed = true;
+			}
+			else {
+				m_pState->done.wait(locker, [&entry]() { return entry->status == Entry::kDone; });
+			}
+		}
+
+		if (claimed) {
+			Decode(*m_pState, *entry);
+			std::lock_guard<std::mutex> locker(m_pState->lock);
+			entry->status = Entry::kDone;
+		}
+
+		if (!entry->ok)
+			return false;
+		image = std::move(entry->image);
+		return true;
+	}
+
+	void CImagePreloader::Clear()
+	{
+		std::lock_guard<std::mutex> locker(m_pState->lock);
+		for (auto itr = m_pState->entries.begin(); itr != m_pState->entries.end(); ++itr) {
+			if (itr->second->status == Entry::kQueued)
+				itr->second->status = Entry::kDone;
+		}
+		m_pState->entries.clear();
+	}
+
+	size_t CImagePreloader::GetCount()
+	{
+		std::lock_guard<std::mutex> locker(m_pState->lock);
+		return m_pState->entries.size();
+	}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace DuiLib {
+
+#if _UNICODE
+	typedef std::wstring image_string;
+#else
+	typedef std::string image_string;
+#endif
+
+	//解码后的图片。Decode得到RGBA，Convert转为DIB使用的预乘alpha的BGRA
+	//不依赖windows头文件，可以在其他平台上测试
+	class CDecodedImage
+	{
+	public:
+		CDecodedImage();
+		~CDecodedImage();
+		CDecodedImage(CDecodedImage&& other);
+		CDecodedImage& operator=(CDecodedImage&& other);
+
+		//解码内存中的图片，scale为缩放百分比(高dpi图片缺失时由原图缩放)，不在(0,800)内或为100时不缩放
+		bool Decode(const uint8_t* data, size_t size, int scale = 100);
+
+		//拷贝其他来源(如svg栅格化)得到的RGBA像素
+		bool Assign(const uint8_t* rgba, int width, int height);
+
+		//转为预乘alpha的BGRA写入dst，dst为NULL时原地转换，颜色等于mask的像素清零
+		//已经转换过时只拷贝到dst。返回是否需要alpha通道
+		bool Convert(uint32_t mask, uint8_t* dst = NULL);
+
+		int GetWidth() const { return m_nX; }
+		int GetHeight() const { return m_nY; }
+		bool IsConverted() const { return m_bConverted; }
+		bool HasAlpha() const { return m_bAlpha; }
+		const uint8_t* GetBits() const { return m_pBits; }
+
+	private:
+		CDecodedImage(const CDecodedImage&) = delete;
+		CDecodedImage& operator=(const CDecodedImage&) = delete;
+		void Free();
+
+		uint8_t* m_pBits;
+		int m_nX;
+		int m_nY;
+		bool m_bConverted;
+		bool m_bAlpha;
+	};
+
+	//在图片线程上并行读取、解码并转换一批图片，结果保留到界面线程取用
+	//取用时只等待需要的那一张；还在排队的由取用的线程直接解码，不等待排在前面的任务
+	class CImagePreloader
+	{
+	public:
+		//读取图片数据，在图片线程上调用。scale返回需要缩放的百分比，失败返回空
+		typedef std::function<std::unique_ptr<uint8_t[]>(const image_string& name, size_t& size, int& scale)> Reader;
+
+		explicit CImagePreloader(Reader reader = Reader());
+		~CImagePreloader();
+
+		//已经在预加载的图片忽略
+		void Preload(const image_string& name, uint32_t mask);
+
+		//数据已经读入内存时只在图片线程上解码
+		void Preload(const image_string& name, uint32_t mask, std::unique_ptr<uint8_t[]> data, size_t size, int scale = 100);
+
+		//图片是否已提交预加载且未被取走，mask返回提交时的mask
+		bool Lookup(const image_string& name, uint32_t& mask);
+
+		//取走预加载的结果，解码未完成时等待。没有预加载、mask不同或解码失败时返回false，
+		//调用者应按原来的方式加载
+		bool Take(const image_string& name, uint32_t mask, CDecodedImage& image);
+
+		//丢弃所有结果，还未开始的解码不再执行
+		void Clear();
+
+		//还未被取走的图片数
+		size_t GetCount();
+
+	private:
+		struct Entry;
+		struct State;
+		static void Run(const std::shared_ptr<State>& state, const std::shared_ptr<Entry>& entry);
+		static void Decode(const State& state, Entry& entry);
+
+		std::shared_ptr<State> m_pState;
+	};
+
+}
@@ -0,0 +1,199 @@
+#include "PixelKernel.h"
+#include <string.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define PIXEL_KERNEL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_SSSE3
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace DuiLib {
+
+	namespace {
+
+		//逐像素的参考实现，其他实现必须与它逐字节一致
+		bool RgbaToBgraScalar(const uint8_t* src, uint8_t* dst, size_t count, uint32_t mask)
+		{
+			bool alpha = false;
+			for (size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+				uint32_t r = src[0], g = src[1], b = src[2], a = src[3];
+				dst[0] = (uint8_t)(b * a / 255);
+				dst[1] = (uint8_t)(g * a / 255);
+				dst[2] = (uint8_t)(r * a / 255);
+				dst[3] = (uint8_t)a;
+				if (a < 255)
+					alpha = true;
+
+				uint32_t pixel;
+				memcpy(&pixel, dst, 4);
+				if (pixel == mask) {
+					memset(dst, 0, 4);
+					alpha = true;
+				}
+			}
+			return alpha;
+		}
+
+#ifdef PIXEL_KERNEL_X86
+
+		//8个16位值除以255向下取整：x*0x8081>>23在0..255*255上是精确的
+		TARGET_SSE2 inline __m128i Div255SSE2(__m128i x)
+		{
+			return _mm_srli_epi16(_mm_mulhi_epu16(x, _mm_set1_epi16((short)0x8081)), 7);
+		}
+
+		//两个BGRA像素展开成16位，颜色乘以各自的alpha
+		TARGET_SSE2 inline __m128i PremultiplySSE2(__m128i bgra16)
+		{
+			__m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(bgra16, 0xff), 0xff);
+			return Div255SSE2(_mm_mullo_epi16(bgra16, alpha));
+		}
+
+		//四个已交换通道的像素：预乘、恢复alpha、清除等于mask的像素，flags记录需要alpha通道的像素
+		TARGET_SSE2 inline __m128i FinishSSE2(__m128i bgra, __m128i mask, __m128i* flags)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i alpha_bits = _mm_set1_epi32((int)0xff000000);
+			__m128i lo = PremultiplySSE2(_mm_unpacklo_epi8(bgra, zero));
+			__m128i hi = PremultiplySSE2(_mm_unpackhi_epi8(bgra, zero));
+			__m128i out = _mm_or_si128(_mm_andnot_si128(alpha_bits, _mm_packus_epi16(lo, hi)), _mm_and_si128(bgra, alpha_bits));
+
+			__m128i opaque = _mm_cmpeq_epi32(_mm_or_si128(bgra, _mm_set1_epi32(0x00ffffff)), _mm_set1_epi32(-1));
+			__m128i masked = _mm_cmpeq_epi32(out, mask);
+			*flags = _mm_or_si128(*flags, _mm_or_si128(_mm_andnot_si128(opaque, _mm_set1_epi32(-1)), masked));
+			return _mm_andnot_si128(masked, out);
+		}
+
+		//SSE2没有字节重排，用移位交换R和B
+		TARGET_SSE2 bool RgbaToBgraSSE2(const uint8_t* src, uint8_t* dst, size_t count, uint32_t mask)
+		{
+			const __m128i rb_bits = _mm_set1_epi32(0x00ff00ff);
+			const __m128i mask4 = _mm_set1_epi32((int)mask);
+			__m128i flags = _mm_setzero_si128();
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4) {
+				__m128i rgba = _mm_loadu_si128((const __m128i*)(src + i * 4));
+				__m128i rb = _mm_and_si128(rgba, rb_bits);
+				__m128i bgra = _mm_or_si128(_mm_andnot_si128(rb_bits, rgba),
+					_mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16)));
+				_mm_storeu_si128((__m128i*)(dst + i * 4), FinishSSE2(bgra, mask4, &flags));
+			}
+			bool alpha = RgbaToBgraScalar(src + i * 4, dst + i * 4, count - i, mask);
+			return _mm_movemask_epi8(flags) != 0 || alpha;
+		}
+
+		TARGET_SSSE3 bool RgbaToBgraSSSE3(const uint8_t* src, uint8_t* dst, size_t count, uint32_t mask)
+		{
+			const __m128i swap = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+			const __m128i mask4 = _mm_set1_epi32((int)mask);
+			__m128i flags = _mm_setzero_si128();
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4) {
+				__m128i bgra = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i * 4)), swap);
+				_mm_storeu_si128((__m128i*)(dst + i * 4), FinishSSE2(bgra, mask4, &flags));
+			}
+			bool alpha = RgbaToBgraScalar(src + i * 4, dst + i * 4, count - i, mask);
+			return _mm_movemask_epi8(flags) != 0 || alpha;
+		}
+
+		TARGET_AVX2 inline __m256i PremultiplyAVX2(__m256i bgra16)
+		{
+			__m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(bgra16, 0xff), 0xff);
+			__m256i x = _mm256_mullo_epi16(bgra16, alpha);
+			return _mm256_srli_epi16(_mm256_mulhi_epu16(x, _mm256_set1_epi16((short)0x8081)), 7);
+		}
+
+		//一次8个像素；unpack和pack都在128位通道内进行，像素顺序不变
+		TARGET_AVX2 bool RgbaToBgraAVX2(const uint8_t* src, uint8_t* dst, size_t count, uint32_t mask)
+		{
+			const __m256i swap = _mm256_setr_epi8(
+				2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+				2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+			const __m256i zero = _mm256_setzero_si256();
+			const __m256i ones = _mm256_set1_epi32(-1);
+			const __m256i alpha_bits = _mm256_set1_epi32((int)0xff000000);
+			const __m256i rgb_bits = _mm256_set1_epi32(0x00ffffff);
+			const __m256i mask8 = _mm256_set1_epi32((int)mask);
+			__m256i flags = _mm256_setzero_si256();
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256i bgra = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src + i * 4)), swap);
+				__m256i lo = PremultiplyAVX2(_mm256_unpacklo_epi8(bgra, zero));
+				__m256i hi = PremultiplyAVX2(_mm256_unpackhi_epi8(bgra, zero));
+				__m256i out = _mm256_or_si256(_mm256_andnot_si256(alpha_bits, _mm256_packus_epi16(lo, hi)), _mm256_and_si256(bgra, alpha_bits));
+
+				__m256i opaque = _mm256_cmpeq_epi32(_mm256_or_si256(bgra, rgb_bits), ones);
+				__m256i masked = _mm256_cmpeq_epi32(out, mask8);
+				flags = _mm256_or_si256(flags, _mm256_or_si256(_mm256_andnot_si256(opaque, ones), masked));
+				_mm256_storeu_si256((__m256i*)(dst + i * 4), _mm256_andnot_si256(masked, out));
+			}
+			bool alpha = RgbaToBgraSSSE3(src + i * 4, dst + i * 4, count - i, mask);
+			return _mm256_movemask_epi8(flags) != 0 || alpha;
+		}
+
+		CPixelKernel::Level DetectLevel()
+		{
+#if defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			int ids = info[0];
+			__cpuid(info, 1);
+			if ((info[2] & (1 << 9)) == 0)
+				return CPixelKernel::kSSE2;
+			//AVX2还需要系统保存YMM寄存器
+			if (ids < 7 || (info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6)
+				return CPixelKernel::kSSSE3;
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) ? CPixelKernel::kAVX2 : CPixelKernel::kSSSE3;
+#else
+			if (__builtin_cpu_supports("avx2"))
+				return CPixelKernel::kAVX2;
+			if (__builtin_cpu_supports("ssse3"))
+				return CPixelKernel::kSSSE3;
+			return CPixelKernel::kSSE2;
+#endif
+		}
+
+#endif // PIXEL_KERNEL_X86
+
+	}
+
+	CPixelKernel::Level CPixelKernel::Best()
+	{
+#ifdef PIXEL_KERNEL_X86
+		static const Level best = DetectLevel();
+		return best;
+#else
+		return kScalar;
+#endif
+	}
+
+	bool CPixelKernel::RgbaToPremultipliedBgra(const uint8_t* src, uint8_t* dst, size_t count, uint32_t mask, Level level)
+	{
+		if (level > Best())
+			level = Best();
+
+		switch (level) {
+#ifdef PIXEL_KERNEL_X86
+		case kAVX2:
+			return RgbaToBgraAVX2(src, dst, count, mask);
+		case kSSSE3:
+			return RgbaToBgraSSSE3(src, dst, count, mask);
+		case kSSE2:
+			return RgbaToBgraSSE2(src, dst, count, mask);
+#endif
+		default:
+			return RgbaToBgraScalar(src, dst, count, mask);
+		}
+	}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DuiLib {
+
+	//加载图片时逐像素处理的内核，按运行时检测到的指令集选择实现，各实现结果逐字节一致
+	//不依赖windows头文件，可以在其他平台上测试
+	class CPixelKernel
+	{
+	public:
+		enum Level {
+			kScalar,
+			kSSE2,
+			kSSSE3,
+			kAVX2,
+		};
+
+		//当前CPU支持的最快实现
+		static Level Best();
+
+		//RGBA转为预乘alpha的BGRA(DIB格式)，颜色按c*a/255截断；转换后等于mask的像素清零
+		//src和dst可以相同(原地转换)。返回是否有半透明或被mask清除的像素。level超出CPU支持时使用Best()
+		static bool RgbaToPremultipliedBgra(const uint8_t* src, uint8_t* dst, size_t count, uint32_t mask, Level level = Best());
+	};
+
+}
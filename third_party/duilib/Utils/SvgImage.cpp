@@ -0,0 +1,238 @@
+#include "SvgImage.h"
+#include <string.h>
+#include <algorithm>
+
+#define NANOSVG_ALL_COLOR_KEYWORDS
+#define NANOSVG_IMPLEMENTATION
+#define NANOSVGRAST_IMPLEMENTATION
+#include "nanosvg/src/nanosvg.h"
+#include "nanosvg/src/nanosvgrast.h"
+
+namespace DuiLib {
+
+	CSvgDocument::CSvgDocument() : m_pImage(NULL), m_pRasterizer(NULL)
+	{
+	}
+
+	CSvgDocument::~CSvgDocument()
+	{
+		if (m_pRasterizer)
+			nsvgDeleteRasterizer(m_pRasterizer);
+		if (m_pImage)
+			nsvgDelete(m_pImage);
+	}
+
+	std::shared_ptr<CSvgDocument> CSvgDocument::Parse(const uint8_t* data, size_t size)
+	{
+		if (!data || size == 0)
+			return nullptr;
+
+		//nsvgParse会修改输入，并且要求以0结尾
+		std::vector<char> text(size + 1);
+		memcpy(text.data(), data, size);
+		text[size] = 0;
+
+		NSVGimage* image = nsvgParse(text.data(), "px", 96.0f);
+		if (!image)
+			return nullptr;
+		if (image->width <= 0 || image->height <= 0) {
+			nsvgDelete(image);
+			return nullptr;
+		}
+
+		std::shared_ptr<CSvgDocument> document(new CSvgDocument);
+		document->m_pImage = image;
+		return document;
+	}
+
+	float CSvgDocument::GetWidth() const
+	{
+		return m_pImage->width;
+	}
+
+	float CSvgDocument::GetHeight() const
+	{
+		return m_pImage->height;
+	}
+
+	bool CSvgDocument::Rasterize(int width, int height, uint8_t* rgba) const
+	{
+		if (width <= 0 || height <= 0)
+			return false;
+
+		std::lock_guard<std::mutex> locker(m_lock);
+		if (!m_pRasterizer)
+			m_pRasterizer = nsvgCreateRasterizer();
+		if (!m_pRasterizer)
+			return false;
+
+		float scale = (std::min)(width / m_pImage->width, height / m_pImage->height);
+		float tx = (width - m_pImage->width * scale) / 2;
+		float ty = (height - m_pImage->height * scale) / 2;
+		nsvgRasterize(m_pRasterizer, m_pImage, tx, ty, scale, rgba, width, height, width * 4);
+		return true;
+	}
+
+	bool CSvgCache::Key::operator<(const Key& other) const
+	{
+		if (width != other.width)
+			return width < other.width;
+		if (height != other.height)
+			return height < other.height;
+		return name < other.name;
+	}
+
+	CSvgCache::CSvgCache(size_t capacity, size_t maxDocuments) : m_maxDocuments((std::max)(maxDocuments, (size_t)1)), m_capacity(capacity)
+	{
+		memset(&m_stats, 0, sizeof(m_stats));
+	}
+
+	CSvgCache* CSvgCache::GetInstance()
+	{
+		static CSvgCache cache;
+		return &cache;
+	}
+
+	bool CSvgCache::IsSvg(const image_string& name)
+	{
+		static const char ext[] = ".svg";
+		if (name.size() < 4)
+			return false;
+		for (size_t i = 0; i < 4; ++i) {
+			int c = name[name.size() - 4 + i];
+			if (c >= 'A' && c <= 'Z')
+				c += 'a' - 'A';
+			if (c != ext[i])
+				return false;
+		}
+		return true;
+	}
+
+	bool CSvgCache::Load(const image_string& name, int scale, const Reader& reader, CDecodedImage& image)
+	{
+		std::shared_ptr<CSvgDocument> document = GetDocument(name, reader);
+		if (!document)
+			return false;
+
+		if (scale <= 0)
+			scale = 100;
+		int width = (std::max)(1, (int)(document->GetWidth() * scale / 100 + 0.5f));
+		int height = (std::max)(1, (int)(document->GetHeight() * scale / 100 + 0.5f));
+		return Load(name, width, height, reader, image);
+	}
+
+	bool CSvgCache::Load(const image_string& name, int width, int height, const Reader& reader, CDecodedImage& image)
+	{
+		if (width <= 0 || height <= 0)
+			return false;
+
+		Key key = { name, width, height };
+		std::shared_ptr<std::vector<uint8_t>> pixels;
+		{
+			std::lock_guard<std::mutex> locker(m_lock);
+			auto found = m_index.find(key);
+			if (found != m_index.end()) {
+				++m_stats.hits;
+				m_entries.splice(m_entries.begin(), m_entries, found->second);
+				pixels = found->second->pixels;
+			}
+		}
+		if (pixels)
+			return image.Assign(pixels->data(), width, height);
+
+		std::shared_ptr<CSvgDocument> document = GetDocument(name, reader);
+		if (!document)
+			return false;
+
+		pixels = std::make_shared<std::vector<uint8_t>>((size_t)width * height * 4);
+		if (!document->Rasterize(width, height, pixels->data()))
+			return false;
+
+		{
+			std::lock_guard<std::mutex> locker(m_lock);
+			++m_stats.rasterizations;
+			if (pixels->size() <= m_capacity && !m_index.count(key)) {
+				m_entries.push_front(Entry{ key, pixels });
+				m_index[key] = m_entries.begin();
+				m_stats.bytes += pixels->size();
+				Evict();
+			}
+		}
+		return image.Assign(pixels->data(), width, height);
+	}
+
+	std::shared_ptr<CSvgDocument> CSvgCache::GetDocument(const image_string& name, const Reader& reader)
+	{
+		{
+			std::lock_guard<std::mutex> locker(m_lock);
+			auto found = m_documents.find(name);
+			if (found != m_documents.end()) {
+				m_documentList.splice(m_documentList.begin(), m_documentList, found->second);
+				return found->second->document;
+			}
+		}
+
+		//在锁外读取和解析，同时请求同一文档时先完成的被保留
+		size_t size = 0;
+		std::unique_ptr<uint8_t[]> data;
+		if (reader)
+			data = reader(size);
+		if (!data)
+			return nullptr;
+		std::shared_ptr<CSvgDocument> document = CSvgDocument::Parse(data.get(), size);
+		if (!document)
+			return nullptr;
+
+		std::lock_guard<std::mutex> locker(m_lock);
+		++m_stats.parses;
+		auto found = m_documents.find(name);
+		if (found != m_documents.end())
+			return found->second->document;
+
+		m_documentList.push_front(Document{ name, document });
+		m_documents[name] = m_documentList.begin();
+		while (m_documentList.size() > m_maxDocuments) {
+			m_documents.erase(m_documentList.back().name);
+			m_documentList.pop_back();
+		}
+		return document;
+	}
+
+	void CSvgCache::SetCapacity(size_t bytes)
+	{
+		std::lock_guard<std::mutex> locker(m_lock);
+		m_capacity = bytes;
+		Evict();
+	}
+
+	void CSvgCache::Clear()
+	{
+		std::lock_guard<std::mutex> locker(m_lock);
+		m_documents.clear();
+		m_documentList.clear();
+		m_entries.clear();
+		m_index.clear();
+		m_stats.bytes = 0;
+	}
+
+	TSvgCacheStats CSvgCache::GetStats()
+	{
+		std::lock_guard<std::mutex> locker(m_lock);
+		TSvgCacheStats stats = m_stats;
+		stats.documents = m_documents.size();
+		stats.rasters = m_entries.size();
+		return stats;
+	}
+
+	void CSvgCache::Evict()
+	{
+		while (m_stats.bytes > m_capacity && !m_entries.empty()) {
+			Entry& last = m_entries.back();
+			m_stats.bytes -= last.pixels->size();
+			++m_stats.evictions;
+			m_index.erase(last.key);
+			m_entries.pop_back();
+		}
+	}
+
+}
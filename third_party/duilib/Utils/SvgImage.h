@@ -0,0 +1,111 @@
+#pragma once
+#include "ImageDecoder.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct NSVGimage;
+struct NSVGrasterizer;
+
+namespace DuiLib {
+
+	//解析后的svg文档，只读，可被多个尺寸的栅格化共享
+	class CSvgDocument
+	{
+	public:
+		~CSvgDocument();
+
+		//解析失败返回空
+		static std::shared_ptr<CSvgDocument> Parse(const uint8_t* data, size_t size);
+
+		//文档的原始尺寸，像素
+		float GetWidth() const;
+		float GetHeight() const;
+
+		//等比缩放后居中栅格化为width*height的RGBA(未预乘)
+		bool Rasterize(int width, int height, uint8_t* rgba) const;
+
+	private:
+		CSvgDocument();
+		CSvgDocument(const CSvgDocument&) = delete;
+		CSvgDocument& operator=(const CSvgDocument&) = delete;
+
+		NSVGimage* m_pImage;
+		mutable NSVGrasterizer* m_pRasterizer;	//栅格化时的临时缓冲区，复用以减少分配
+		mutable std::mutex m_lock;
+	};
+
+	struct TSvgCacheStats
+	{
+		size_t documents;	//已解析的文档数，超过上限时淘汰最久未用的
+		size_t rasters;		//缓存的位图数
+		size_t bytes;		//缓存的位图字节数
+		int parses;
+		int rasterizations;
+		int hits;
+		int evictions;
+	};
+
+	//svg图片缓存：文档按名字只解析一次，按像素尺寸栅格化的结果放在容量有限的位图缓存中，
+	//超出容量时淘汰最久未用的。dpi切换后只有重新绘制到的图片才会按新尺寸栅格化。线程安全
+	class CSvgCache
+	{
+	public:
+		//读取svg文件数据，只在文档还未解析时调用，失败返回空
+		typedef std::function<std::unique_ptr<uint8_t[]>(size_t& size)> Reader;
+
+		//name应包含资源路径、zip或资源实例，不同皮肤的同名文件不会混用
+		explicit CSvgCache(size_t capacity = 16 * 1024 * 1024, size_t maxDocuments = 256);
+		static CSvgCache* GetInstance();
+
+		//名字以.svg结尾(不区分大小写)
+		static bool IsSvg(const image_string& name);
+
+		//按缩放百分比栅格化，尺寸为文档原始尺寸乘以scale/100，结果为RGBA写入image
+		bool Load(const image_string& name, int scale, const Reader& reader, CDecodedImage& image);
+		//按指定像素尺寸栅格化
+		bool Load(const image_string& name, int width, int height, const Reader& reader, CDecodedImage& image);
+
+		void SetCapacity(size_t bytes);
+		//清除文档和位图，文件更新或重新加载皮肤后需要调用
+		void Clear();
+		TSvgCacheStats GetStats();
+
+	private:
+		struct Key {
+			image_string name;
+			int width;
+			int height;
+
+			bool operator<(const Key& other) const;
+		};
+
+		struct Entry {
+			Key key;
+			std::shared_ptr<std::vector<uint8_t>> pixels;
+		};
+
+		struct Document {
+			image_string name;
+			std::shared_ptr<CSvgDocument> document;
+		};
+
+		std::shared_ptr<CSvgDocument> GetDocument(const image_string& name, const Reader& reader);
+		void Evict();
+
+		std::list<Document> m_documentList;	//最近使用的在前
+		std::map<image_string, std::list<Document>::iterator> m_documents;
+		size_t m_maxDocuments;
+		std::list<Entry> m_entries;		//最近使用的在前
+		std::map<Key, std::list<Entry>::iterator> m_index;
+		size_t m_capacity;
+		TSvgCacheStats m_stats;
+		std::mutex m_lock;
+	};
+
+}
@@ -0,0 +1,477 @@
+#include "AssetCache.h"
+#include "FileDownload.h"
+#include "FileUtil.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace network {
+
+typedef std::lock_guard<std::mutex> LockHolder;
+
+static const char* kIndexMagic = "DJAC 1";
+static const size_t kReadSize = 64 * 1024;
+
+static std::mutex s_defaultMutex;
+static AssetCachePtr s_default;
+
+static std::string trim(const std::string& value)
+{
+    size_t begin = value.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+        return std::string();
+    size_t end = value.find_last_not_of(" \t\r\n");
+    return value.substr(begin, end - begin + 1);
+}
+
+// FNV-1a of the file content, files with equal hashes are still compared byte by byte
+// before they are merged.
+static bool hashFile(const std::string& file, uint64_t* hash, int64_t* size)
+{
+    FILE* fp = openFile(file.c_str(), "rb");
+    if (!fp)
+        return false;
+
+    std::vector<unsigned char> buffer(kReadSize);
+    uint64_t value = 14695981039346656037ULL;
+    int64_t total = 0;
+    size_t read = 0;
+    while ((read = fread(buffer.data(), 1, buffer.size(), fp)) > 0) {
+        for (size_t i = 0; i < read; ++i) {
+            value ^= buffer[i];
+            value *= 1099511628211ULL;
+        }
+        total += read;
+    }
+    bool ok = !ferror(fp);
+    fclose(fp);
+
+    *hash = value;
+    *size = total;
+    return ok;
+}
+
+static bool sameContent(const std::string& file1, const std::string& file2)
+{
+    FILE* fp1 = openFile(file1.c_str(), "rb");
+    FILE* fp2 = openFile(file2.c_str(), "rb");
+    bool same = fp1 && fp2;
+
+    std::vector<char> buffer1(kReadSize);
+    std::vector<char> buffer2(kReadSize);
+    while (same) {
+        size_t read1 = fread(buffer1.data(), 1, buffer1.size(), fp1);
+        size_t read2 = fread(buffer2.data(), 1, buffer2.size(), fp2);
+        same = read1 == read2 && memcmp(buffer1.data(), buffer2.data(), read1) == 0;
+        if (read1 == 0)
+            break;
+    }
+
+    if (fp1)
+        fclose(fp1);
+    if (fp2)
+        fclose(fp2);
+    return same;
+}
+
+static bool fileExists(const std::string& file)
+{
+    FILE* fp = openFile(file.c_str(), "rb");
+    if (!fp)
+        return false;
+    fclose(fp);
+    return true;
+}
+
+bool Asset::read(std::vector<char>* data) const
+{
+    FILE* fp = openFile(path.c_str(), "rb");
+    if (!fp)
+        return false;
+
+    data->resize((size_t)size);
+    bool ok = size == 0 || fread(data->data(), 1, data->size(), fp) == data->size();
+    fclose(fp);
+    if (!ok)
+        data->clear();
+    return ok;
+}
+
+// Downloads one url into the cache directory, deletes itself when done.
+class AssetCache::Fetch final : public CurlDownloadListener
+{
+public:
+    Fetch(const AssetCachePtr& cache, const std::string& url, const std::string& file)
+        : _cache(cache)
+        , _url(url)
+        , _file(file)
+    {
+        _download = CurlDownload::create(this, url, file);
+        _download->setDeletesFileUponFailure(true);
+    }
+
+    bool start()
+    {
+        return _download->start();
+    }
+
+    void didFinish() override
+    {
+        long code = _download->getResponseCode();
+        finish(code >= 200 && code < 300);
+    }
+
+    void didFail() override
+    {
+        finish(false);
+    }
+
+private:
+    void finish(bool succeed)
+    {
+        _cache->didFetch(_url, _file, succeed);
+        delete this;
+    }
+
+    AssetCachePtr _cache;
+    std::string _url;
+    std::string _file;
+    RefCountedPtr<CurlDownload> _download;
+};
+
+AssetCachePtr AssetCache::create(const std::string& directory, int64_t limit)
+{
+    return AssetCachePtr(new AssetCache(directory, limit));
+}
+
+AssetCache::AssetCache(const std::string& directory, int64_t limit)
+    : _directory(directory)
+    , _limit(limit)
+    , _nextDownload(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+
+    while (!_directory.empty() && (_directory.back() == '/' || _directory.back() == '\\'))
+        _directory.pop_back();
+    createDirectory(_directory.c_str());
+    loadIndex();
+}
+
+AssetCache::~AssetCache()
+{
+    LockHolder locker(_mutex);
+    saveIndex();
+}
+
+void AssetCache::setDefault(const AssetCachePtr& cache)
+{
+    LockHolder locker(s_defaultMutex);
+    s_default = cache;
+}
+
+AssetCachePtr AssetCache::getDefault()
+{
+    LockHolder locker(s_defaultMutex);
+    return s_default;
+}
+
+void AssetCache::fetch(const std::string& url, const AssetCallback& callback)
+{
+    AssetPtr asset;
+    Fetch* fetch = nullptr;
+    {
+        LockHolder locker(_mutex);
+
+        asset = findLocked(url);
+        if (asset) {
+            ++_stats.hits;
+        } else {
+            auto fetching = _fetching.find(url);
+            if (fetching != _fetching.end()) {
+                ++_stats.coalesced;
+                fetching->second.push_back(callback);
+                return;
+            }
+
+            ++_stats.misses;
+            _fetching[url].push_back(callback);
+            char name[32];
+            snprintf(name, sizeof(name), "/%d.download", _nextDownload++);
+            fetch = new Fetch(shared_from_this(), url, _directory + name);
+        }
+    }
+
+    if (asset) {
+        if (callback)
+            callback(asset);
+        return;
+    }
+
+    // the download only calls back once it has been added
+    if (!fetch->start()) {
+        delete fetch;
+        didFetch(url, std::string(), false);
+    }
+}
+
+AssetPtr AssetCache::find(const std::string& url)
+{
+    LockHolder locker(_mutex);
+    return findLocked(url);
+}
+
+AssetPtr AssetCache::findLocked(const std::string& url)
+{
+    auto found = _urlIndex.find(url);
+    if (found == _urlIndex.end())
+        return nullptr;
+
+    FileIterator file = found->second;
+    std::string path = getPath(file->hash);
+    if (!fileExists(path)) {
+        removeFile(file);
+        saveIndex();
+        return nullptr;
+    }
+
+    _fileList.splice(_fileList.begin(), _fileList, file);
+
+    std::shared_ptr<Asset> asset(new Asset());
+    asset->url = url;
+    asset->path = path;
+    asset->hash = file->hash;
+    asset->size = file->size;
+    return asset;
+}
+
+void AssetCache::didFetch(const std::string& url, const std::string& file, bool succeed)
+{
+    uint64_t hash = 0;
+    int64_t size = 0;
+    if (succeed) {
+        // an empty body leaves no file behind
+        if (!fileExists(file)) {
+            FILE* fp = openFile(file.c_str(), "wb");
+            if (fp)
+                fclose(fp);
+        }
+        succeed = hashFile(file, &hash, &size);
+    }
+
+    AssetPtr asset;
+    std::vector<AssetCallback> callbacks;
+    {
+        LockHolder locker(_mutex);
+
+        if (succeed) {
+            char name[32];
+            snprintf(name, sizeof(name), "%016llx", (unsigned long long)hash);
+            std::string stored = store(url, file, size, name);
+            if (!stored.empty()) {
+                std::shared_ptr<Asset> result(new Asset());
+                result->url = url;
+                result->path = getPath(stored);
+                result->hash = stored;
+                result->size = size;
+                asset = result;
+            }
+        }
+
+        auto fetching = _fetching.find(url);
+        if (fetching != _fetching.end()) {
+            callbacks.swap(fetching->second);
+            _fetching.erase(fetching);
+        }
+    }
+
+    if (!asset && !file.empty())
+        deleteFile(file.c_str());
+
+    for (auto& callback : callbacks) {
+        if (callback)
+            callback(asset);
+    }
+}
+
+// Called with _mutex held, return the name of the stored file or an empty string.
+std::string AssetCache::store(const std::string& url, const std::string& file, int64_t size, const std::string& hash)
+{
+    removeUrl(url);
+
+    std::string name = hash;
+    for (int suffix = 1; ; ++suffix) {
+        auto existing = _fileIndex.find(name);
+        if (existing == _fileIndex.end())
+            break;
+
+        FileIterator record = existing->second;
+        if (!fileExists(getPath(name))) {
+            removeFile(record);
+            break;
+        }
+        if (record->size == size && sameContent(getPath(name), file)) {
+            ++_stats.deduplicated;
+            deleteFile(file.c_str());
+            record->urls.push_back(url);
+            _urlIndex[url] = record;
+            _fileList.splice(_fileList.begin(), _fileList, record);
+            saveIndex();
+            return name;
+        }
+        name = hash + "-" + std::to_string(suffix);
+    }
+
+    if (size > _limit || !moveFile(file.c_str(), getPath(name).c_str()))
+        return std::string();
+
+    FileRecord record;
+    record.hash = name;
+    record.size = size;
+    record.urls.push_back(url);
+    _fileList.push_front(record);
+    _fileIndex[name] = _fileList.begin();
+    _urlIndex[url] = _fileList.begin();
+    _stats.bytes += size;
+
+    evict();
+    saveIndex();
+    return name;
+}
+
+void AssetCache::remove(const std::string& url)
+{
+    LockHolder locker(_mutex);
+    removeUrl(url);
+    saveIndex();
+}
+
+void AssetCache::clear()
+{
+    LockHolder locker(_mutex);
+    for (auto& record : _fileList) {
+        deleteFile(getPath(record.hash).c_str());
+    }
+    _fileList.clear();
+    _fileIndex.clear();
+    _urlIndex.clear();
+    _stats.bytes = 0;
+    saveIndex();
+}
+
+AssetCacheStats AssetCache::getStats()
+{
+    LockHolder locker(_mutex);
+    AssetCacheStats stats = _stats;
+    stats.urls = (int)_urlIndex.size();
+    stats.files = (int)_fileList.size();
+    return stats;
+}
+
+// A file is deleted with its last url.
+void AssetCache::removeUrl(const std::string& url)
+{
+    auto found = _urlIndex.find(url);
+    if (found == _urlIndex.end())
+        return;
+
+    FileIterator record = found->second;
+    _urlIndex.erase(found);
+    auto& urls = record->urls;
+    for (auto itr = urls.begin(); itr != urls.end(); ++itr) {
+        if (*itr == url) {
+            urls.erase(itr);
+            break;
+        }
+    }
+    if (urls.empty())
+        removeFile(record);
+}
+
+void AssetCache::removeFile(FileIterator record)
+{
+    deleteFile(getPath(record->hash).c_str());
+    for (auto& url : record->urls) {
+        _urlIndex.erase(url);
+    }
+    _stats.bytes -= record->size;
+    _fileIndex.erase(record->hash);
+    _fileList.erase(record);
+}
+
+void AssetCache::evict()
+{
+    while (_stats.bytes > _limit && !_fileList.empty()) {
+        removeFile(std::prev(_fileList.end()));
+    }
+}
+
+std::string AssetCache::getPath(const std::string& hash) const
+{
+    return _directory + "/" + hash;
+}
+
+// Index:
+//   DJAC 1
+//   <hash> <size> <url>      one line per url, files most recently used first
+void AssetCache::loadIndex()
+{
+    FILE* fp = openFile((_directory + "/index").c_str(), "rb");
+    if (!fp)
+        return;
+
+    char line[4096];
+    if (!fgets(line, sizeof(line), fp) || trim(line) != kIndexMagic) {
+        fclose(fp);
+        return;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        std::string text = trim(line);
+        size_t sp1 = text.find(' ');
+        size_t sp2 = sp1 != std::string::npos ? text.find(' ', sp1 + 1) : std::string::npos;
+        if (sp2 == std::string::npos)
+            continue;
+
+        std::string hash = text.substr(0, sp1);
+        int64_t size = atoll(text.substr(sp1 + 1, sp2 - sp1 - 1).c_str());
+        std::string url = text.substr(sp2 + 1);
+        if (_urlIndex.count(url))
+            continue;
+
+        auto existing = _fileIndex.find(hash);
+        if (existing == _fileIndex.end()) {
+            FileRecord record;
+            record.hash = hash;
+            record.size = size;
+            _fileList.push_back(record);
+            existing = _fileIndex.insert(std::make_pair(hash, std::prev(_fileList.end()))).first;
+            _stats.bytes += size;
+        }
+        existing->second->urls.push_back(url);
+        _urlIndex[url] = existing->second;
+    }
+    fclose(fp);
+
+    evict();
+}
+
+void AssetCache::saveIndex()
+{
+    std::string file = _directory + "/index";
+    std::string temp = file + ".tmp";
+    FILE* fp = openFile(temp.c_str(), "wb");
+    if (!fp)
+        return;
+
+    bool ok = fprintf(fp, "%s\n", kIndexMagic) > 0;
+    for (auto& record : _fileList) {
+        for (auto& url : record.urls) {
+            ok = ok && fprintf(fp, "%s %lld %s\n", record.hash.c_str(), (long long)record.size, url.c_str()) > 0;
+        }
+    }
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || !moveFile(temp.c_str(), file.c_str()))
+        deleteFile(temp.c_str());
+}
+
+} // namespace network
@@ -0,0 +1,136 @@
+#pragma once
+#include <stdint.h>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace network {
+
+/**
+ * A cached remote file.
+ */
+struct Asset
+{
+    std::string url;
+    std::string path;       /// local file, shared by every url with the same content
+    std::string hash;       /// content hash, also the file name
+    int64_t size;
+
+    /**
+     * Read the whole file.
+     */
+    bool read(std::vector<char>* data) const;
+};
+
+typedef std::shared_ptr<const Asset> AssetPtr;
+typedef std::function<void(AssetPtr asset)> AssetCallback;
+
+/**
+ * Counters of the asset cache.
+ */
+struct AssetCacheStats
+{
+    int64_t hits;           /// fetches answered from disk
+    int64_t misses;         /// fetches that started a transfer
+    int64_t coalesced;      /// fetches that joined a transfer of the same url already running
+    int64_t deduplicated;   /// transfers whose content was already stored under another url
+    int64_t bytes;          /// size of the stored files
+    int urls;
+    int files;
+};
+
+class AssetCache;
+typedef std::shared_ptr<AssetCache> AssetCachePtr;
+
+/**
+ * Content addressed disk cache of remote files, shared by HttpClient, CurlDownload and ImageLoader.
+ *
+ * Every url maps to a file named by the hash of its content, so the same avatar or icon served
+ * under different urls is stored once. Downloads are written next to the cache and renamed into
+ * place when complete, so a file in the cache is never partial. The url index is kept in memory
+ * and saved to the directory, files are evicted least recently used first when the total size
+ * exceeds the limit. Concurrent fetches of one url share a single transfer.
+ * All methods are thread safe.
+ */
+class AssetCache : public std::enable_shared_from_this<AssetCache>
+{
+public:
+    /**
+     * @param directory where the files and the index are stored, it is created if missing.
+     * @param limit bytes of files kept on disk.
+     */
+    static AssetCachePtr create(const std::string& directory, int64_t limit);
+    ~AssetCache();
+
+    /**
+     * The cache used by HttpClient requests and downloads that opt in, and by ImageLoader for urls.
+     */
+    static void setDefault(const AssetCachePtr& cache);
+    static AssetCachePtr getDefault();
+
+    /**
+     * Get the local file of an url, downloading it if it is not cached.
+     *
+     * @param callback called with the asset, or nullptr if the transfer failed. It runs on the
+     *                 download thread, or before fetch() returns if the url is cached.
+     */
+    void fetch(const std::string& url, const AssetCallback& callback);
+
+    /**
+     * Get the local file of an url without touching the network.
+     *
+     * @return the asset, nullptr if it is not cached.
+     */
+    AssetPtr find(const std::string& url);
+
+    void remove(const std::string& url);
+    void clear();
+
+    AssetCacheStats getStats();
+
+    const std::string& getDirectory() const { return _directory; }
+
+private:
+    class Fetch;
+
+    struct FileRecord
+    {
+        std::string hash;
+        int64_t size;
+        std::vector<std::string> urls;
+    };
+
+    typedef std::list<FileRecord>::iterator FileIterator;
+
+    AssetCache(const std::string& directory, int64_t limit);
+
+    AssetPtr findLocked(const std::string& url);
+    void didFetch(const std::string& url, const std::string& file, bool succeed);
+    std::string store(const std::string& url, const std::string& file, int64_t size, const std::string& hash);
+    void removeUrl(const std::string& url);
+    void removeFile(FileIterator file);
+    void evict();
+
+    std::string getPath(const std::string& hash) const;
+    void loadIndex();
+    void saveIndex();
+
+    std::string _directory;
+    int64_t _limit;
+    int _nextDownload;
+
+    std::list<FileRecord> _fileList;                            /// most recently used first
+    std::unordered_map<std::string, FileIterator> _fileIndex;   /// keyed by hash
+    std::unordered_map<std::string, FileIterator> _urlIndex;
+    std::map<std::string, std::vector<AssetCallback>> _fetching; /// callbacks waiting for a transfer, keyed by url
+
+    AssetCacheStats _stats;
+    std::mutex _mutex;
+};
+
+} // namespace network
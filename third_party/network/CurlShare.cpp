@@ -0,0 +1,75 @@
+#include "CurlShare.h"
+#include <curl/curl.h>
+#include <mutex>
+#include <string.h>
+
+namespace network {
+
+class CurlShare {
+public:
+    CurlShare()
+        : _shareHandle(nullptr)
+    {
+        curl_global_init(CURL_GLOBAL_ALL);
+        _shareHandle = curl_share_init();
+        if (!_shareHandle)
+            return;
+
+        curl_share_setopt(_shareHandle, CURLSHOPT_LOCKFUNC, lockCallback);
+        curl_share_setopt(_shareHandle, CURLSHOPT_UNLOCKFUNC, unlockCallback);
+        curl_share_setopt(_shareHandle, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    }
+
+    ~CurlShare()
+    {
+        if (_shareHandle)
+            curl_share_cleanup(_shareHandle);
+        curl_global_cleanup();
+    }
+
+    CURLSH* getHandle() const { return _shareHandle; }
+
+private:
+    static void lockCallback(CURL*, curl_lock_data data, curl_lock_access, void* userptr)
+    {
+        auto share = (CurlShare*)userptr;
+        share->_mutex[data].lock();
+    }
+
+    static void unlockCallback(CURL*, curl_lock_data data, void* userptr)
+    {
+        auto share = (CurlShare*)userptr;
+        share->_mutex[data].unlock();
+    }
+
+    CURLSH* _shareHandle;
+    std::mutex _mutex[CURL_LOCK_DATA_LAST];
+};
+
+CURLSH* getCurlShareHandle()
+{
+    static CurlShare share;
+    return share.getHandle();
+}
+
+std::string getHostKey(const char* url)
+{
+    const char* scheme = strstr(url, "://");
+    const char* host = scheme ? scheme + 3 : url;
+    const char* end = host + strcspn(host, "/?#");
+
+    // drop user:password@
+    const char* at = (const char*)memchr(host, '@', end - host);
+    std::string key(url, host);
+    key.append(at ? at + 1 : host, end);
+    for (auto& c : key) {
+        if (c >= 'A' && c <= 'Z')
+            c = c - 'A' + 'a';
+    }
+    return key;
+}
+
+}//namespace
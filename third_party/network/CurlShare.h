@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+
+typedef void CURLSH;
+
+namespace network {
+
+/**
+ * Get the process wide curl share handle.
+ *
+ * DNS cache, connection cache and TLS sessions are shared by every easy handle
+ * that sets CURLOPT_SHARE to this handle, so requests to a host that has been
+ * visited before skip the lookup, the TCP connect and the TLS handshake.
+ *
+ * @return the share handle, or nullptr if it could not be created.
+ */
+CURLSH* getCurlShareHandle();
+
+/**
+ * Get the lower case scheme://host:port of an url, without user info.
+ *
+ * Transfers with the same key count against the same per host limit.
+ */
+std::string getHostKey(const char* url);
+
+}//namespace
@@ -1,17 +1,40 @@
 #include "FileDownload.h"
+#include "CurlShare.h"
+#include "AssetCache.h"
 #include <curl/curl.h>
+#include <algorithm>
 #include <functional>
 
 namespace network {
 
 typedef std::lock_guard<std::mutex> LockHolder;
 
+// Files smaller than two segments are downloaded over one connection.
+static const int64_t kMinSegmentSize = 256 * 1024;
+// Bytes received by all segments between two saves of the journal.
+static const int64_t kJournalInterval = 4 * 1024 * 1024;
+// Upper bound of one curl_multi_poll, curl wakes earlier for its own timers
+// and add/remove wake it through curl_multi_wakeup.
+static const int kPollTimeoutMs = 60 * 1000;
+// Period of the bandwidth token bucket.
+static const int kBandwidthUpdateMs = 100;
+// Share of the bandwidth of a transfer by DownloadPriority.
+static const int kPriorityWeight[] = { 1, 2, 4 };
+
+static const int kDefaultMaxConcurrency = 16;
+static const int kDefaultMaxPerHost = 6;
+
 
 // CurlDownloadManager -------------------------------------------------------------------
 
 CurlDownloadManager::CurlDownloadManager()
     : m_curlMultiHandle(0)
     , m_runThread(false)
+    , m_maxConcurrency(kDefaultMaxConcurrency)
+    , m_maxPerHost(kDefaultMaxPerHost)
+    , m_maxRecvSpeed(0)
+    , m_tokens(0)
+    , m_bandwidthChanged(false)
 {
     curl_global_init(CURL_GLOBAL_ALL);
     m_curlMultiHandle = curl_multi_init();
@@ -24,27 +47,113 @@ CurlDownloadManager::~CurlDownloadManager()
     curl_global_cleanup();
 }
 
-bool CurlDownloadManager::add(CURL* curlHandle)
+bool CurlDownloadManager::add(CURL* curlHandle, DownloadPriority priority, const std::string& host, int64_t maxRecvSpeed)
 {
+    HandleInfo info;
+    info.curlHandle = curlHandle;
+    info.download = nullptr;
+    curl_easy_getinfo(curlHandle, CURLINFO_PRIVATE, &info.download);
+    info.host = host;
+    info.priority = priority;
+    info.maxRecvSpeed = maxRecvSpeed;
+    info.lastSize = 0;
+    info.recvSpeed = 0;
+
     {
         LockHolder locker(m_mutex);
-        m_pendingHandleList.push_back(curlHandle);
+        m_pendingHandleList[(int)priority].push_back(info);
     }
 
     startThreadIfNeeded();
+    wakeup();
 
     return true;
 }
 
 bool CurlDownloadManager::remove(CURL* curlHandle)
 {
-    LockHolder locker(m_mutex);
+    {
+        LockHolder locker(m_mutex);
+        m_removedHandleList.push_back(curlHandle);
+    }
 
-    m_removedHandleList.push_back(curlHandle);
+    wakeup();
 
     return true;
 }
 
+void CurlDownloadManager::reschedule(CURL* curlHandle, DownloadPriority priority, int64_t maxRecvSpeed)
+{
+    {
+        LockHolder locker(m_mutex);
+
+        auto active = m_activeHandleList.find(curlHandle);
+        if (active != m_activeHandleList.end()) {
+            active->second.priority = priority;
+            active->second.maxRecvSpeed = maxRecvSpeed;
+            m_bandwidthChanged = true;
+        } else {
+            // Move to the end of the new priority, as if it had been added now.
+            HandleInfo info;
+            if (!takeQueuedHandle(curlHandle, &info))
+                return;
+            info.priority = priority;
+            info.maxRecvSpeed = maxRecvSpeed;
+            m_pendingHandleList[(int)priority].push_back(info);
+        }
+    }
+
+    wakeup();
+}
+
+void CurlDownloadManager::setMaxConcurrency(int count)
+{
+    {
+        LockHolder locker(m_mutex);
+        m_maxConcurrency = count;
+    }
+    wakeup();
+}
+
+int CurlDownloadManager::getMaxConcurrency() const
+{
+    LockHolder locker(m_mutex);
+    return m_maxConcurrency;
+}
+
+void CurlDownloadManager::setMaxPerHost(int count)
+{
+    {
+        LockHolder locker(m_mutex);
+        m_maxPerHost = count;
+    }
+    wakeup();
+}
+
+int CurlDownloadManager::getMaxPerHost() const
+{
+    LockHolder locker(m_mutex);
+    return m_maxPerHost;
+}
+
+void CurlDownloadManager::setMaxRecvSpeed(int64_t bytesPerSecond)
+{
+    {
+        LockHolder locker(m_mutex);
+        m_maxRecvSpeed = bytesPerSecond;
+        m_tokens = 0;
+        m_lastBandwidthUpdate = std::chrono::steady_clock::now();
+        m_bandwidthChanged = true;
+    }
+    wakeup();
+}
+
+int64_t CurlDownloadManager::getMaxRecvSpeed() const
+{
+    LockHolder locker(m_mutex);
+    return m_maxRecvSpeed;
+}
+
 int CurlDownloadManager::getActiveDownloadCount() const
 {
     LockHolder locker(m_mutex);
@@ -54,11 +163,21 @@ int CurlDownloadManager::getActiveDownloadCount() const
 int CurlDownloadManager::getPendingDownloadCount() const
 {
     LockHolder locker(m_mutex);
-    return m_pendingHandleList.size();
+    size_t count = 0;
+    for (auto& queue : m_pendingHandleList)
+        count += queue.size();
+    return count;
+}
+
+void CurlDownloadManager::wakeup()
+{
+    curl_multi_wakeup(m_curlMultiHandle);
 }
 
 void CurlDownloadManager::startThreadIfNeeded()
 {
+    std::lock_guard<std::mutex> locker(m_threadMutex);
+
     if (!runThread()) {
         if (m_thread) {
             m_thread->join();
@@ -71,7 +190,10 @@ void CurlDownloadManager::startThreadIfNeeded()
 
 void CurlDownloadManager::stopThread()
 {
+    std::lock_guard<std::mutex> locker(m_threadMutex);
+
     setRunThread(false);
+    wakeup();
     if (m_thread) {
         m_thread->join();
         m_thread = nullptr;
@@ -80,34 +202,83 @@ void CurlDownloadManager::stopThread()
 
 void CurlDownloadManager::stopThreadIfIdle()
 {
-    if (!getActiveDownloadCount() && !getPendingDownloadCount())
-        setRunThread(false);
+    // Checked under the same lock add() queues with, so a handle added
+    // concurrently either keeps this thread running or starts a new one.
+    LockHolder locker(m_mutex);
+    if (!m_activeHandleList.empty() || !m_removedHandleList.empty())
+        return;
+    for (auto& queue : m_pendingHandleList) {
+        if (!queue.empty())
+            return;
+    }
+    m_runThread = false;
 }
 
 void CurlDownloadManager::updateHandleList()
 {
-    LockHolder locker(m_mutex);
+    std::vector<CURL*> cancelledHandles;
+    std::vector<CURL*> failedHandles;
+    {
+        LockHolder locker(m_mutex);
+
+        // Take cancelled handles out of the queues and the active list, handles that
+        // already finished are not found and were cleaned up by completeHandle.
+        for (CURL* curlHandle : m_removedHandleList) {
+            if (takeQueuedHandle(curlHandle, nullptr) || m_activeHandleList.count(curlHandle))
+                cancelledHandles.push_back(curlHandle);
+        }
+        m_removedHandleList.clear();
+
+        // Start queued handles highest priority first while the limits allow,
+        // a handle whose host is at its limit does not hold back the others.
+        for (int priority = (int)DownloadPriority::kHigh; priority >= (int)DownloadPriority::kLow; --priority) {
+            auto& queue = m_pendingHandleList[priority];
+            for (auto it = queue.begin(); it != queue.end();) {
+                if (m_maxConcurrency > 0 && (int)m_activeHandleList.size() >= m_maxConcurrency)
+                    break;
+
+                auto count = m_hostCount.find(it->host);
+                if (m_maxPerHost > 0 && count != m_hostCount.end() && count->second >= m_maxPerHost) {
+                    ++it;
+                    continue;
+                }
 
-    // Remove curl easy handles from multi list 
-    int size = m_removedHandleList.size();
-    for (int i = 0; i < size; i++) {
-        removeFromCurl(m_removedHandleList[0]);
-        m_removedHandleList.erase(m_removedHandleList.begin());
+                if (!addToCurl(*it))
+                    failedHandles.push_back(it->curlHandle);
+                it = queue.erase(it);
+            }
+        }
     }
 
-    // Add pending curl easy handles to multi list 
-    size = m_pendingHandleList.size();
-    for (int i = 0; i < size; i++) {
-        addToCurl(m_pendingHandleList[0]);
-        m_pendingHandleList.erase(m_pendingHandleList.begin());
+    // Downloads may add or cancel handles from these callbacks, so the lock is not held.
+    for (CURL* curlHandle : cancelledHandles)
+        completeHandle(curlHandle, CURLE_ABORTED_BY_CALLBACK);
+    for (CURL* curlHandle : failedHandles)
+        completeHandle(curlHandle, CURLE_FAILED_INIT);
+}
+
+bool CurlDownloadManager::takeQueuedHandle(CURL* curlHandle, HandleInfo* info)
+{
+    for (auto& queue : m_pendingHandleList) {
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (it->curlHandle == curlHandle) {
+                if (info)
+                    *info = *it;
+                queue.erase(it);
+                return true;
+            }
+        }
     }
+    return false;
 }
 
-bool CurlDownloadManager::addToCurl(CURL* curlHandle)
+bool CurlDownloadManager::addToCurl(const HandleInfo& info)
 {
-    CURLMcode retval = curl_multi_add_handle(m_curlMultiHandle, curlHandle);
+    CURLMcode retval = curl_multi_add_handle(m_curlMultiHandle, info.curlHandle);
     if (retval == CURLM_OK) {
-        m_activeHandleList.push_back(curlHandle);
+        m_activeHandleList[info.curlHandle] = info;
+        ++m_hostCount[info.host];
+        m_bandwidthChanged = true;
         return true;
     }
     return false;
@@ -115,87 +286,130 @@ bool CurlDownloadManager::addToCurl(CURL* curlHandle)
 
 bool CurlDownloadManager::removeFromCurl(CURL* curlHandle)
 {
-    auto handlePos = m_activeHandleList.end();
-    for (auto itr = m_activeHandleList.begin(); itr != m_activeHandleList.end(); ++itr) {
-        if (*itr == curlHandle) {
-            handlePos == itr;
-            break;
-        }
+    auto handlePos = m_activeHandleList.find(curlHandle);
+    if (handlePos != m_activeHandleList.end()) {
+        CURLMcode retval = curl_multi_remove_handle(m_curlMultiHandle, curlHandle);
+        if (retval != CURLM_OK)
+            return false;
+
+        auto count = m_hostCount.find(handlePos->second.host);
+        if (count != m_hostCount.end() && --count->second <= 0)
+            m_hostCount.erase(count);
+        m_activeHandleList.erase(handlePos);
+        m_bandwidthChanged = true;
     }
 
-    if (handlePos == m_activeHandleList.end())
-        return true;
+    curl_easy_cleanup(curlHandle);
+    return true;
+}
 
-    CURLMcode retval = curl_multi_remove_handle(m_curlMultiHandle, curlHandle);
-    if (retval == CURLM_OK) {
-        m_activeHandleList.erase(handlePos);
-        curl_easy_cleanup(curlHandle);
-        return true;
+void CurlDownloadManager::completeHandle(CURL* curlHandle, int result)
+{
+    CurlDownload* download = nullptr;
+    curl_easy_getinfo(curlHandle, CURLINFO_PRIVATE, &download);
+
+    if (download)
+        download->didCompleteTransfer(curlHandle, result);
+
+    {
+        LockHolder locker(m_mutex);
+        removeFromCurl(curlHandle);
     }
-    return false;
+
+    if (download)
+        download->Release(); // This matches the AddRef() in CurlDownload::addHandle().
 }
 
-void CurlDownloadManager::downloadThread()
+void CurlDownloadManager::updateBandwidth()
 {
-    CurlDownloadManager* downloadManager = this;
+    LockHolder locker(m_mutex);
 
-    while (downloadManager->runThread()) {
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - m_lastBandwidthUpdate).count();
+    if (!m_bandwidthChanged && elapsed * 1000 < kBandwidthUpdateMs)
+        return;
+    m_lastBandwidthUpdate = now;
+    m_bandwidthChanged = false;
+
+    int64_t received = 0;
+    int totalWeight = 0;
+    std::map<CurlDownload*, int> transfers;
+    for (auto& item : m_activeHandleList) {
+        HandleInfo& info = item.second;
+        curl_off_t size = 0;
+        curl_easy_getinfo(info.curlHandle, CURLINFO_SIZE_DOWNLOAD_T, &size);
+        received += size - info.lastSize;
+        info.lastSize = size;
+        totalWeight += kPriorityWeight[(int)info.priority];
+        ++transfers[info.download];
+    }
 
-        downloadManager->updateHandleList();
+    // Token bucket of the global cap: it fills at the capped rate up to one second
+    // of data and drains by what was received. The rate handed out for the next
+    // period spends saved tokens, or pays back an overshoot of the curl limiters.
+    double rate = 0;
+    if (m_maxRecvSpeed > 0) {
+        m_tokens = std::min<double>(m_tokens + m_maxRecvSpeed * elapsed, (double)m_maxRecvSpeed) - received;
+        rate = std::max<double>(m_maxRecvSpeed + m_tokens, m_maxRecvSpeed / 8.0);
+    }
 
-        // Retry 'select' if it was interrupted by a process signal.
-        int rc = 0;
-        do {
-            fd_set fdread;
-            fd_set fdwrite;
-            fd_set fdexcep;
+    for (auto& item : m_activeHandleList) {
+        HandleInfo& info = item.second;
+        int64_t speed = 0;
+        if (rate > 0)
+            speed = (int64_t)(rate * kPriorityWeight[(int)info.priority] / totalWeight);
+        if (info.maxRecvSpeed > 0) {
+            int64_t share = info.maxRecvSpeed / transfers[info.download];
+            speed = speed > 0 ? std::min(speed, share) : share;
+        }
+        if (rate > 0 || info.maxRecvSpeed > 0)
+            speed = std::max<int64_t>(speed, 1);
 
-            int maxfd = 0;
+        if (speed != info.recvSpeed) {
+            curl_easy_setopt(info.curlHandle, CURLOPT_MAX_RECV_SPEED_LARGE, (curl_off_t)speed);
+            info.recvSpeed = speed;
+        }
+    }
+}
 
-            const int selectTimeoutMS = 5;
+int CurlDownloadManager::getPollTimeout() const
+{
+    LockHolder locker(m_mutex);
 
-            struct timeval timeout;
-            timeout.tv_sec = 0;
-            timeout.tv_usec = selectTimeoutMS * 1000; // select waits microseconds
+    // The token bucket is refilled while capped transfers run.
+    if (m_maxRecvSpeed > 0 && !m_activeHandleList.empty())
+        return kBandwidthUpdateMs;
+    return kPollTimeoutMs;
+}
 
-            FD_ZERO(&fdread);
-            FD_ZERO(&fdwrite);
-            FD_ZERO(&fdexcep);
-            curl_multi_fdset(downloadManager->getMultiHandle(), &fdread, &fdwrite, &fdexcep, &maxfd);
-            // When the 3 file descriptors are empty, winsock will return -1
-            // and bail out, stopping the file download. So make sure we
-            // have valid file descriptors before calling select.
-            if (maxfd >= 0)
-                rc = ::select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &timeout);
-        } while (rc == -1 && errno == EINTR);
+void CurlDownloadManager::downloadThread()
+{
+    while (runThread()) {
+        updateHandleList();
+        updateBandwidth();
 
         int activeDownloadCount = 0;
-        while (curl_multi_perform(downloadManager->getMultiHandle(), &activeDownloadCount) == CURLM_CALL_MULTI_PERFORM) {}
+        curl_multi_perform(m_curlMultiHandle, &activeDownloadCount);
 
+        // Retire every finished transfer at once, a burst of completions
+        // must not wait for further socket activity.
+        bool completed = false;
         int messagesInQueue = 0;
-        CURLMsg* msg = curl_multi_info_read(downloadManager->getMultiHandle(), &messagesInQueue);
-
-        if (!msg)
-            continue;
-
-        CurlDownload* download = 0;
-        CURLcode err = curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &download);
-
-        if (msg->msg == CURLMSG_DONE) {
-            if (download) {
-                if (msg->data.result == CURLE_OK) {
-                    download->didFinish();
-                    download->Release(); // This matches the ref() in CurlDownload::start().
-                }
-                else {
-                    download->didFail();
-                    download->Release(); // This matches the ref() in CurlDownload::start().
-                }
+        while (CURLMsg* msg = curl_multi_info_read(m_curlMultiHandle, &messagesInQueue)) {
+            if (msg->msg == CURLMSG_DONE) {
+                completeHandle(msg->easy_handle, msg->data.result);
+                completed = true;
             }
-            downloadManager->removeFromCurl(msg->easy_handle);
         }
 
-        downloadManager->stopThreadIfIdle();
+        stopThreadIfIdle();
+
+        // Finished downloads free slots and may have started new ones, schedule before sleeping.
+        if (completed || !runThread())
+            continue;
+
+        // Sleep until a socket is ready, a curl timer expires or add/remove wake us.
+        curl_multi_poll(m_curlMultiHandle, nullptr, 0, getPollTimeout(), nullptr);
     }
 }
 
@@ -220,6 +434,19 @@ CurlDownload::CurlDownload()
     , m_fileSize(-1)
     , m_download(0)
     , m_rateTracker(100,10)
+    , m_segmentCount(0)
+    , m_priority(DownloadPriority::kNormal)
+    , m_maxRecvSpeed(0)
+    , m_useAssetCache(false)
+    , m_fetching(false)
+    , m_responseCode(0)
+    , m_probing(false)
+    , m_cancelled(false)
+    , m_failed(false)
+    , m_acceptRanges(false)
+    , m_runningSegments(0)
+    , m_partHandle(nullptr)
+    , m_unsavedBytes(0)
 {
 }
 
@@ -231,6 +458,8 @@ CurlDownload::~CurlDownload()
 
         if (m_customHeaders)
             curl_slist_free_all(m_customHeaders);
+
+        closePartFile();
     }
 
     closeFile();
@@ -244,46 +473,223 @@ void CurlDownload::init(CurlDownloadListener* listener, const std::string& url,c
 
     LockHolder locker(m_mutex);
 
-    m_curlHandle = curl_easy_init();
     m_url = url;
     m_destination = path;
+    m_listener = listener;
+}
+
+CURL* CurlDownload::createHandle()
+{
+    CURL* curlHandle = curl_easy_init();
 
     //ȡhttps֤֤
-    curl_easy_setopt(m_curlHandle, CURLOPT_SSL_VERIFYPEER, 0);
-    curl_easy_setopt(m_curlHandle, CURLOPT_SSL_VERIFYHOST, 0);
+    curl_easy_setopt(curlHandle, CURLOPT_SSL_VERIFYPEER, 0);
+    curl_easy_setopt(curlHandle, CURLOPT_SSL_VERIFYHOST, 0);
 
-    curl_easy_setopt(m_curlHandle, CURLOPT_URL, m_url.c_str());
-    curl_easy_setopt(m_curlHandle, CURLOPT_PRIVATE, this);
-    curl_easy_setopt(m_curlHandle, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(m_curlHandle, CURLOPT_WRITEDATA, this);
-    curl_easy_setopt(m_curlHandle, CURLOPT_HEADERFUNCTION, headerCallback);
-    curl_easy_setopt(m_curlHandle, CURLOPT_WRITEHEADER, this);
-    curl_easy_setopt(m_curlHandle, CURLOPT_FOLLOWLOCATION, 1);
-    curl_easy_setopt(m_curlHandle, CURLOPT_MAXREDIRS, 10);
-    curl_easy_setopt(m_curlHandle, CURLOPT_HTTPAUTH, CURLAUTH_ANY);
+    curl_easy_setopt(curlHandle, CURLOPT_URL, m_url.c_str());
+    curl_easy_setopt(curlHandle, CURLOPT_PRIVATE, this);
+    curl_easy_setopt(curlHandle, CURLOPT_FOLLOWLOCATION, 1);
+    curl_easy_setopt(curlHandle, CURLOPT_MAXREDIRS, 10);
+    curl_easy_setopt(curlHandle, CURLOPT_HTTPAUTH, CURLAUTH_ANY);
+
+    if (m_customHeaders)
+        curl_easy_setopt(curlHandle, CURLOPT_HTTPHEADER, m_customHeaders);
 
     //const char* certPath = getenv("CURL_CA_BUNDLE_PATH");
     //if (certPath)
-    //    curl_easy_setopt(m_curlHandle, CURLOPT_CAINFO, certPath);
+    //    curl_easy_setopt(curlHandle, CURLOPT_CAINFO, certPath);
 
     //CURLSH* curlsh = ResourceHandleManager::sharedInstance()->getCurlShareHandle();
     //if (curlsh)
-    //    curl_easy_setopt(m_curlHandle, CURLOPT_SHARE, curlsh);
+    //    curl_easy_setopt(curlHandle, CURLOPT_SHARE, curlsh);
 
-    m_listener = listener;
+    return curlHandle;
+}
+
+bool CurlDownload::addHandle(CURL* curlHandle)
+{
+    AddRef(); // CurlDownloadManager::completeHandle will call Release when the transfer has finished.
+    return m_downloadManager.add(curlHandle, m_priority, getHostKey(m_url.c_str()), m_maxRecvSpeed);
+}
+
+// Called with m_mutex held.
+void CurlDownload::rescheduleHandles()
+{
+    if (m_curlHandle)
+        m_downloadManager.reschedule(m_curlHandle, m_priority, m_maxRecvSpeed);
+    for (auto& segment : m_segments) {
+        if (segment->curlHandle)
+            m_downloadManager.reschedule(segment->curlHandle, m_priority, m_maxRecvSpeed);
+    }
+}
+
+void CurlDownload::setSegments(int count)
+{
+    LockHolder locker(m_mutex);
+    m_segmentCount = count;
+}
+
+int CurlDownload::getSegments() const
+{
+    LockHolder locker(m_mutex);
+    return m_segmentCount;
+}
+
+void CurlDownload::setPriority(DownloadPriority priority)
+{
+    LockHolder locker(m_mutex);
+    m_priority = priority;
+    rescheduleHandles();
+}
+
+DownloadPriority CurlDownload::getPriority() const
+{
+    LockHolder locker(m_mutex);
+    return m_priority;
+}
+
+void CurlDownload::setMaxRecvSpeed(int64_t bytesPerSecond)
+{
+    LockHolder locker(m_mutex);
+    m_maxRecvSpeed = bytesPerSecond;
+    rescheduleHandles();
+}
+
+int64_t CurlDownload::getMaxRecvSpeed() const
+{
+    LockHolder locker(m_mutex);
+    return m_maxRecvSpeed;
+}
+
+void CurlDownload::setUseAssetCache(bool useAssetCache)
+{
+    LockHolder locker(m_mutex);
+    m_useAssetCache = useAssetCache;
+}
+
+bool CurlDownload::getUseAssetCache() const
+{
+    LockHolder locker(m_mutex);
+    return m_useAssetCache;
+}
+
+long CurlDownload::getResponseCode() const
+{
+    LockHolder locker(m_mutex);
+    return m_responseCode;
 }
 
 bool CurlDownload::start()
 {
+    AssetCachePtr cache = getUseAssetCache() ? AssetCache::getDefault() : nullptr;
+    if (cache)
+        return fetchFromCache(cache);
+
+    LockHolder locker(m_mutex);
+
+    if (m_url.empty() || m_curlHandle || m_runningSegments || m_fetching)
+        return false;
+
     m_download = 0;
+    m_responseCode = 0;
     m_fileSize = -1;
-    AddRef(); // CurlDownloadManager::downloadThread will call deref when the download has finished.
-    return m_downloadManager.add(m_curlHandle);
+    m_cancelled = false;
+    m_failed = false;
+    m_acceptRanges = false;
+    m_validator.clear();
+    if (!m_tempHandle)
+        m_tempPath.clear();
+
+    //ֶHEADȡļСǷ֧Range
+    m_probing = m_segmentCount > 1;
+    m_curlHandle = createHandle();
+    curl_easy_setopt(m_curlHandle, CURLOPT_HEADERFUNCTION, headerCallback);
+    curl_easy_setopt(m_curlHandle, CURLOPT_WRITEHEADER, this);
+    if (m_probing) {
+        curl_easy_setopt(m_curlHandle, CURLOPT_NOBODY, 1L);
+    } else {
+        curl_easy_setopt(m_curlHandle, CURLOPT_WRITEFUNCTION, writeCallback);
+        curl_easy_setopt(m_curlHandle, CURLOPT_WRITEDATA, this);
+    }
+    return addHandle(m_curlHandle);
 }
 
 bool CurlDownload::cancel()
 {
-    return m_downloadManager.remove(m_curlHandle);
+    LockHolder locker(m_mutex);
+
+    if (!m_curlHandle && !m_runningSegments && !m_fetching)
+        return false;
+
+    m_cancelled = true;
+    if (m_curlHandle)
+        m_downloadManager.remove(m_curlHandle);
+    for (auto& segment : m_segments) {
+        if (segment->curlHandle)
+            m_downloadManager.remove(segment->curlHandle);
+    }
+    return true;
+}
+
+bool CurlDownload::fetchFromCache(const AssetCachePtr& cache)
+{
+    std::string url;
+    {
+        LockHolder locker(m_mutex);
+
+        if (m_url.empty() || m_curlHandle || m_runningSegments || m_fetching)
+            return false;
+
+        m_download = 0;
+        m_fileSize = -1;
+        m_responseCode = 0;
+        m_cancelled = false;
+        m_fetching = true;
+        url = m_url;
+    }
+
+    //ʱصfetch()ǰִУܳm_mutex
+    RefCountedPtr<CurlDownload> download(this);
+    cache->fetch(url, [download](AssetPtr asset) {
+        download->didFetchAsset(asset);
+    });
+    return true;
+}
+
+void CurlDownload::didFetchAsset(const AssetPtr& asset)
+{
+    bool copied = false;
+    {
+        LockHolder locker(m_mutex);
+        m_fetching = false;
+        if (m_cancelled)
+            return;
+
+        //ȸƵʱļƶĿļǲ
+        if (asset) {
+            std::string tempPath = openTemporaryFile(m_destination);
+            copied = !tempPath.empty() && copyFile(asset->path.c_str(), tempPath.c_str())
+                && moveFile(tempPath.c_str(), m_destination.c_str());
+            if (!copied && !tempPath.empty())
+                deleteFile(tempPath.c_str());
+        }
+        if (copied) {
+            m_responseCode = 200;
+            m_fileSize = asset->size;
+            m_download = asset->size;
+        }
+    }
+
+    if (!copied) {
+        if (m_listener)
+            m_listener->didFail();
+        return;
+    }
+
+    if (m_listener) {
+        m_listener->didProgress((int)asset->size, (int)asset->size);
+        m_listener->didFinish();
+    }
 }
 
 std::string CurlDownload::getTempPath() const
@@ -304,6 +710,12 @@ std::string CurlDownload::getDestination() const
     return m_destination;
 }
 
+double CurlDownload::getDownloadRate() const
+{
+    LockHolder locker(m_mutex);
+    return m_rateTracker.ComputeRate();
+}
+
 void CurlDownload::closeFile()
 {
     LockHolder locker(m_mutex);
@@ -318,7 +730,7 @@ void CurlDownload::moveFileToDestination()
 {
     LockHolder locker(m_mutex);
 
-    if (m_destination.empty())
+    if (m_destination.empty() || m_tempPath.empty())
         return;
 
     moveFile(m_tempPath.c_str(), m_destination.c_str());
@@ -335,6 +747,173 @@ void CurlDownload::writeDataToFile(const char* data, int size)
         fwrite(data, size,1 ,m_tempHandle);
 }
 
+// Called with m_mutex held.
+bool CurlDownload::startSegments()
+{
+    m_partPath = m_destination + ".part";
+    m_journalPath = m_destination + ".journal";
+
+    //־ļһʱδɵĲ
+    if (loadJournal())
+        m_partHandle = openFile(m_partPath.c_str(), "r+b");
+
+    if (!m_partHandle) {
+        int count = (int)std::min<int64_t>(m_segmentCount, m_fileSize / kMinSegmentSize);
+        m_segments.clear();
+        for (int i = 0; i < count; ++i) {
+            std::unique_ptr<Segment> segment(new Segment());
+            segment->download = this;
+            segment->curlHandle = nullptr;
+            segment->begin = m_fileSize * i / count;
+            segment->end = m_fileSize * (i + 1) / count;
+            segment->received = 0;
+            segment->checked = false;
+            m_segments.push_back(std::move(segment));
+        }
+
+        m_partHandle = openFile(m_partPath.c_str(), "w+b");
+        if (!m_partHandle || !resizeFile(m_partHandle, m_fileSize)) {
+            closePartFile();
+            return false;
+        }
+        saveJournal();
+    }
+
+    m_download = 0;
+    m_unsavedBytes = 0;
+    for (auto& segment : m_segments) {
+        m_download += segment->received;
+        if (segment->received < segment->end - segment->begin)
+            startSegment(segment.get());
+    }
+    return true;
+}
+
+// Called with m_mutex held.
+bool CurlDownload::startSegment(Segment* segment)
+{
+    char range[64];
+    snprintf(range, sizeof(range), "%lld-%lld",
+        (long long)(segment->begin + segment->received), (long long)(segment->end - 1));
+
+    segment->checked = false;
+    segment->curlHandle = createHandle();
+    curl_easy_setopt(segment->curlHandle, CURLOPT_RANGE, range);
+    curl_easy_setopt(segment->curlHandle, CURLOPT_WRITEFUNCTION, segmentWriteCallback);
+    curl_easy_setopt(segment->curlHandle, CURLOPT_WRITEDATA, segment);
+    ++m_runningSegments;
+    return addHandle(segment->curlHandle);
+}
+
+void CurlDownload::finishSegments()
+{
+    bool moved = false;
+    {
+        LockHolder locker(m_mutex);
+        closePartFile();
+        moved = moveFile(m_partPath.c_str(), m_destination.c_str());
+        if (moved) {
+            deleteFile(m_journalPath.c_str());
+            m_segments.clear();
+        }
+    }
+
+    if (!moved) {
+        if (m_listener)
+            m_listener->didFail();
+        return;
+    }
+
+    if (m_listener)
+        m_listener->didFinish();
+}
+
+void CurlDownload::closePartFile()
+{
+    if (m_partHandle != nullptr) {
+        fclose(m_partHandle);
+        m_partHandle = nullptr;
+    }
+}
+
+// Journal:
+//   DJDL 1
+//   <url>
+//   <file size>
+//   <validator>
+//   <segment count>
+//   <begin> <end> <received>     one line per segment
+//
+// Called with m_mutex held.
+bool CurlDownload::loadJournal()
+{
+    FILE* file = openFile(m_journalPath.c_str(), "rb");
+    if (!file)
+        return false;
+
+    std::vector<std::string> lines;
+    char buffer[4096];
+    while (fgets(buffer, sizeof(buffer), file)) {
+        std::string line(buffer);
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+            line.pop_back();
+        lines.push_back(line);
+    }
+    fclose(file);
+
+    if (lines.size() < 5 || lines[0] != "DJDL 1" || lines[1] != m_url
+        || strtoll(lines[2].c_str(), nullptr, 10) != m_fileSize || lines[3] != m_validator)
+        return false;
+
+    int count = atoi(lines[4].c_str());
+    if (count <= 0 || lines.size() != 5 + (size_t)count)
+        return false;
+
+    std::vector<std::unique_ptr<Segment>> segments;
+    int64_t offset = 0;
+    for (int i = 0; i < count; ++i) {
+        long long begin = 0, end = 0, received = 0;
+        if (sscanf(lines[5 + i].c_str(), "%lld %lld %lld", &begin, &end, &received) != 3
+            || begin != offset || end <= begin || received < 0 || received > end - begin)
+            return false;
+
+        std::unique_ptr<Segment> segment(new Segment());
+        segment->download = this;
+        segment->curlHandle = nullptr;
+        segment->begin = begin;
+        segment->end = end;
+        segment->received = received;
+        segment->checked = false;
+        segments.push_back(std::move(segment));
+        offset = end;
+    }
+    if (offset != m_fileSize)
+        return false;
+
+    m_segments.swap(segments);
+    return true;
+}
+
+// Called with m_mutex held.
+void CurlDownload::saveJournal()
+{
+    std::string tempPath = m_journalPath + ".tmp";
+    FILE* file = openFile(tempPath.c_str(), "wb");
+    if (!file)
+        return;
+
+    fprintf(file, "DJDL 1\n%s\n%lld\n%s\n%d\n", m_url.c_str(), (long long)m_fileSize,
+        m_validator.c_str(), (int)m_segments.size());
+    for (auto& segment : m_segments) {
+        fprintf(file, "%lld %lld %lld\n", (long long)segment->begin,
+            (long long)segment->end, (long long)segment->received);
+    }
+    fclose(file);
+
+    //дʱļ滻ʱ°־
+    moveFile(tempPath.c_str(), m_journalPath.c_str());
+}
+
 void CurlDownload::addHeaders(const HeaderMap& header)
 {
     LockHolder locker(m_mutex);
@@ -355,7 +934,8 @@ void CurlDownload::addHeaders(const HeaderMap& header)
         }
 
         if (headers) {
-            curl_easy_setopt(m_curlHandle, CURLOPT_HTTPHEADER, headers);
+            if (m_customHeaders)
+                curl_slist_free_all(m_customHeaders);
             m_customHeaders = headers;
         }
     }
@@ -367,14 +947,31 @@ void CurlDownload::didReceiveHeader(const std::string& header)
         return;
     }
 
+    //ضʱÿӦԼͷ
+    if (header.compare(0, 5, "HTTP/") == 0) {
+        m_fileSize = -1;
+        m_acceptRanges = false;
+        m_validator.clear();
+        return;
+    }
+
     size_t splitPos = header.find(":");
     if (splitPos != std::string::npos) {
         auto key = header.substr(0, splitPos);
         auto value = header.substr(splitPos + 1);
+        size_t begin = value.find_first_not_of(" \t");
+        size_t end = value.find_last_not_of(" \t\r\n");
+        value = begin != std::string::npos ? value.substr(begin, end - begin + 1) : std::string();
 
         //headerȡļС
         if (stricmp(key.c_str(), "Content-Length") == 0) {
-            m_fileSize = strtol(value.c_str(),nullptr,10);
+            m_fileSize = strtoll(value.c_str(), nullptr, 10);
+        } else if (stricmp(key.c_str(), "Accept-Ranges") == 0) {
+            m_acceptRanges = stricmp(value.c_str(), "bytes") == 0;
+        } else if (stricmp(key.c_str(), "ETag") == 0) {
+            m_validator = value;
+        } else if (stricmp(key.c_str(), "Last-Modified") == 0 && m_validator.empty()) {
+            m_validator = value;
         }
     }
 }
@@ -386,12 +983,163 @@ void CurlDownload::didReceiveData(void* data, int size)
     writeDataToFile(static_cast<const char*>(data), size);
 }
 
+bool CurlDownload::didReceiveSegmentData(Segment* segment, const char* data, size_t size)
+{
+    //˺Range200ʱļдֶ
+    if (!segment->checked) {
+        long responseCode = 0;
+        curl_easy_getinfo(segment->curlHandle, CURLINFO_RESPONSE_CODE, &responseCode);
+        if (responseCode != 206)
+            return false;
+        segment->checked = true;
+    }
+
+    if ((int64_t)size > segment->end - segment->begin - segment->received)
+        return false;
+
+    if (!writeFileAt(m_partHandle, data, size, segment->begin + segment->received))
+        return false;
+
+    LockHolder locker(m_mutex);
+    segment->received += size;
+    m_unsavedBytes += size;
+    if (m_unsavedBytes >= kJournalInterval) {
+        saveJournal();
+        m_unsavedBytes = 0;
+    }
+    didReceiveDataOfLength((int)size);
+    return true;
+}
+
+void CurlDownload::didCompleteTransfer(CURL* curlHandle, int result)
+{
+    if (curlHandle != m_curlHandle) {
+        for (auto& segment : m_segments) {
+            if (segment->curlHandle == curlHandle) {
+                didCompleteSegment(segment.get(), result);
+                return;
+            }
+        }
+        return;
+    }
+
+    {
+        long responseCode = 0;
+        curl_easy_getinfo(curlHandle, CURLINFO_RESPONSE_CODE, &responseCode);
+        LockHolder locker(m_mutex);
+        m_responseCode = responseCode;
+    }
+
+    if (m_probing) {
+        didProbe(curlHandle, result);
+        return;
+    }
+
+    {
+        LockHolder locker(m_mutex);
+        m_curlHandle = nullptr;
+    }
+
+    if (m_cancelled) {
+        //ȡĵزʱļ
+        closeFile();
+        LockHolder locker(m_mutex);
+        if (!m_tempPath.empty()) {
+            deleteFile(m_tempPath.c_str());
+            m_tempPath.clear();
+        }
+        return;
+    }
+
+    if (result == CURLE_OK)
+        didFinish();
+    else
+        didFail();
+}
+
+void CurlDownload::didProbe(CURL* curlHandle, int result)
+{
+    long responseCode = 0;
+    curl_easy_getinfo(curlHandle, CURLINFO_RESPONSE_CODE, &responseCode);
+
+    bool started = false;
+    bool finished = false;
+    {
+        LockHolder locker(m_mutex);
+        m_curlHandle = nullptr;
+        m_probing = false;
+
+        if (m_cancelled)
+            return;
+
+        if (result != CURLE_OK) {
+            started = false;
+        } else if (responseCode == 200 && m_acceptRanges && m_fileSize >= 2 * kMinSegmentSize) {
+            started = startSegments();
+            finished = started && m_runningSegments == 0;
+        } else {
+            //֧Rangeļ̫С˻ص
+            m_fileSize = -1;
+            m_curlHandle = createHandle();
+            curl_easy_setopt(m_curlHandle, CURLOPT_HEADERFUNCTION, headerCallback);
+            curl_easy_setopt(m_curlHandle, CURLOPT_WRITEHEADER, this);
+            curl_easy_setopt(m_curlHandle, CURLOPT_WRITEFUNCTION, writeCallback);
+            curl_easy_setopt(m_curlHandle, CURLOPT_WRITEDATA, this);
+            started = addHandle(m_curlHandle);
+        }
+    }
+
+    if (finished)
+        finishSegments();
+    else if (!started && m_listener)
+        m_listener->didFail();
+}
+
+void CurlDownload::didCompleteSegment(Segment* segment, int result)
+{
+    bool failed = false;
+    {
+        LockHolder locker(m_mutex);
+        segment->curlHandle = nullptr;
+        --m_runningSegments;
+
+        //һֶʧʱֶֹͣΣصĲ´start()
+        if (segment->received < segment->end - segment->begin && !m_cancelled && !m_failed) {
+            m_failed = true;
+            for (auto& other : m_segments) {
+                if (other->curlHandle)
+                    m_downloadManager.remove(other->curlHandle);
+            }
+        }
+
+        if (m_runningSegments > 0)
+            return;
+
+        saveJournal();
+        if (m_cancelled || m_failed) {
+            closePartFile();
+            failed = m_failed && !m_cancelled;
+            if (failed && m_deletesFileUponFailure) {
+                deleteFile(m_partPath.c_str());
+                deleteFile(m_journalPath.c_str());
+            }
+        }
+    }
+
+    if (failed) {
+        if (m_listener)
+            m_listener->didFail();
+    } else if (!m_cancelled) {
+        finishSegments();
+    }
+}
+
 void CurlDownload::didReceiveDataOfLength(int size)
 {
     m_download += size;
     m_rateTracker.AddSamples(size);
     if (m_listener)
-        m_listener->didProgress(m_fileSize,m_download);
+        m_listener->didProgress((int)m_fileSize,(int)m_download);
 }
 
 void CurlDownload::didFinish()
@@ -427,6 +1175,17 @@ size_t CurlDownload::writeCallback(void* ptr, size_t size, size_t nmemb, void* d
     return totalSize;
 }
 
+size_t CurlDownload::segmentWriteCallback(void* ptr, size_t size, size_t nmemb, void* data)
+{
+    size_t totalSize = size * nmemb;
+    Segment* segment = reinterpret_cast<Segment*>(data);
+
+    if (!segment->download->didReceiveSegmentData(segment, static_cast<const char*>(ptr), totalSize))
+        return 0;
+
+    return totalSize;
+}
+
 size_t CurlDownload::headerCallback(char* ptr, size_t size, size_t nmemb, void* data)
 {
     size_t totalSize = size * nmemb;
@@ -453,4 +1212,3 @@ void CurlDownload::downloadFailedCallback(CurlDownload* download)
 }
 
 }//namespace
-
@@ -1,6 +1,9 @@
 #ifndef CurlDownload_h
 #define CurlDownload_h
 
+#include <stdint.h>
+#include <chrono>
+#include <list>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -17,14 +20,56 @@ struct curl_slist;
 
 namespace network {
 
+class CurlDownload;
+class AssetCache;
+struct Asset;
+
+enum class DownloadPriority {
+    kLow = 0,
+    kNormal = 1,
+    kHigh = 2,
+};
+
+/**
+ * Schedules the transfers of all downloads on one multi handle.
+ *
+ * Added handles wait in a queue per priority and are started highest priority first,
+ * in the order they were added, while the global and per host limits allow. Queued
+ * handles can be moved to another priority. The received bandwidth can be capped for
+ * all downloads with a token bucket and per download, the caps are applied to each
+ * transfer through CURLOPT_MAX_RECV_SPEED_LARGE and higher priorities get a larger share.
+ */
 class CurlDownloadManager {
 public:
     CurlDownloadManager();
     ~CurlDownloadManager();
 
-    bool add(CURL* curlHandle);
+    /**
+     * Queue a transfer.
+     *
+     * @param host key of the per host limit, see getHostKey().
+     * @param maxRecvSpeed bytes per second of the whole download, split among its transfers, 0 is unlimited.
+     */
+    bool add(CURL* curlHandle, DownloadPriority priority, const std::string& host, int64_t maxRecvSpeed);
     bool remove(CURL* curlHandle);
 
+    /**
+     * Change the priority and bandwidth cap of a queued or running transfer.
+     */
+    void reschedule(CURL* curlHandle, DownloadPriority priority, int64_t maxRecvSpeed);
+
+    /** Transfers running at the same time, 0 is unlimited. */
+    void setMaxConcurrency(int count);
+    int getMaxConcurrency() const;
+
+    /** Transfers running at the same time to one host, 0 is unlimited. */
+    void setMaxPerHost(int count);
+    int getMaxPerHost() const;
+
+    /** Bytes per second received by all transfers together, 0 is unlimited. */
+    void setMaxRecvSpeed(int64_t bytesPerSecond);
+    int64_t getMaxRecvSpeed() const;
+
     int getActiveDownloadCount() const;
     int getPendingDownloadCount() const;
 
@@ -40,18 +85,46 @@ private:
     bool runThread() const { std::lock_guard<std::mutex> locker(m_mutex); return m_runThread; }
     void setRunThread(bool runThread) { std::lock_guard<std::mutex> locker(m_mutex); m_runThread = runThread; }
 
-    bool addToCurl(CURL* curlHandle);
+    struct HandleInfo {
+        CURL* curlHandle;
+        CurlDownload* download;
+        std::string host;
+        DownloadPriority priority;
+        int64_t maxRecvSpeed;       // cap of the whole download
+        int64_t lastSize;           // bytes received at the last bandwidth update
+        int64_t recvSpeed;          // CURLOPT_MAX_RECV_SPEED_LARGE currently applied
+    };
+
+    bool addToCurl(const HandleInfo& info);
     bool removeFromCurl(CURL* curlHandle);
+    bool takeQueuedHandle(CURL* curlHandle, HandleInfo* info);
+    void wakeup();
+
+    // Refill the token bucket and share the bandwidth among the running transfers.
+    void updateBandwidth();
+    int getPollTimeout() const;
+
+    // Hand a finished or cancelled handle back to its download, then clean it up.
+    void completeHandle(CURL* curlHandle, int result);
 
     void downloadThread();
 
     std::unique_ptr<std::thread> m_thread;
+    std::mutex m_threadMutex;       // serializes starting and stopping m_thread
     CURLM* m_curlMultiHandle;
-    std::vector<CURL*> m_pendingHandleList;
-    std::vector<CURL*> m_activeHandleList;
+    std::list<HandleInfo> m_pendingHandleList[3];     // indexed by DownloadPriority
+    std::map<CURL*, HandleInfo> m_activeHandleList;
+    std::map<std::string, int> m_hostCount;
     std::vector<CURL*> m_removedHandleList;
     mutable std::mutex m_mutex;
     bool m_runThread;
+
+    int m_maxConcurrency;
+    int m_maxPerHost;
+    int64_t m_maxRecvSpeed;
+    double m_tokens;                // bytes that may still be received beyond the steady rate
+    std::chrono::steady_clock::time_point m_lastBandwidthUpdate;
+    bool m_bandwidthChanged;        // running transfers, priorities or caps changed
 };
 
 class CurlDownloadListener {
@@ -76,6 +149,36 @@ public:
 
     void setListener(CurlDownloadListener* listener) { m_listener = listener; }
 
+    /**
+     * Download with up to count ranged transfers in parallel, 0 or 1 keeps a single connection.
+     *
+     * The size and Accept-Ranges are probed with a HEAD request first, servers without range
+     * support and small files fall back to a single transfer. Segments are written in place
+     * into "<destination>.part" and their progress is kept in "<destination>.journal", so
+     * start() after a failure, cancel or crash only requests the missing ranges.
+     */
+    void setSegments(int count);
+    int getSegments() const;
+
+    /** Queued downloads start highest priority first, can be changed while queued or running. */
+    void setPriority(DownloadPriority priority);
+    DownloadPriority getPriority() const;
+
+    /** Bytes per second of this download over all its segments, 0 is unlimited. */
+    void setMaxRecvSpeed(int64_t bytesPerSecond);
+    int64_t getMaxRecvSpeed() const;
+
+    /**
+     * Take the file from AssetCache::getDefault() and copy it to the destination, the cache
+     * downloads it if needed and shares the transfer with other users of the same url.
+     * Has no effect without a default cache.
+     */
+    void setUseAssetCache(bool useAssetCache);
+    bool getUseAssetCache() const;
+
+    /** The scheduler shared by all downloads. */
+    static CurlDownloadManager& getDownloadManager() { return m_downloadManager; }
+
     bool start();
     bool cancel();
 
@@ -83,30 +186,63 @@ public:
     std::string getUrl() const;
     std::string getDestination() const;
 
+    /** HTTP status of the finished transfer, 0 before a response was received. */
+    long getResponseCode() const;
+
+    /** Bytes per second over the last second, summed over all segments. */
+    double getDownloadRate() const;
+
     bool deletesFileUponFailure() const { return m_deletesFileUponFailure; }
     void setDeletesFileUponFailure(bool deletesFileUponFailure) { m_deletesFileUponFailure = deletesFileUponFailure; }
 
 private:
+    struct Segment {
+        CurlDownload* download;
+        CURL* curlHandle;
+        int64_t begin;      // offset of the first byte
+        int64_t end;        // offset after the last byte
+        int64_t received;   // bytes written from begin
+        bool checked;       // the response of the current transfer was checked to be 206
+    };
+
+    CURL* createHandle();
+    bool addHandle(CURL* curlHandle);
+    void rescheduleHandles();
+
+    bool fetchFromCache(const std::shared_ptr<AssetCache>& cache);
+    void didFetchAsset(const std::shared_ptr<const Asset>& asset);
+
     void closeFile();
     void moveFileToDestination();
     void writeDataToFile(const char* data, int size);
 
+    bool startSegments();
+    bool startSegment(Segment* segment);
+    void finishSegments();
+    void closePartFile();
+    bool loadJournal();
+    void saveJournal();
+
     // Called on download thread.
     void didReceiveHeader(const std::string& header);
     void didReceiveData(void* data, int size);
-
+    bool didReceiveSegmentData(Segment* segment, const char* data, size_t size);
+    void didCompleteTransfer(CURL* curlHandle, int result);
+    void didProbe(CURL* curlHandle, int result);
+    void didCompleteSegment(Segment* segment, int result);
 
     void didReceiveDataOfLength(int size);
     void didFinish();
     void didFail();
 
     static size_t writeCallback(void* ptr, size_t, size_t nmemb, void* data);
+    static size_t segmentWriteCallback(void* ptr, size_t, size_t nmemb, void* data);
     static size_t headerCallback(char* ptr, size_t, size_t nmemb, void* data);
 
     static void downloadFinishedCallback(CurlDownload*);
     static void downloadFailedCallback(CurlDownload*);
 
-    CURL* m_curlHandle;
+    CURL* m_curlHandle;             // the probe or the single transfer in flight
     curl_slist* m_customHeaders;
     std::string m_url;
     std::string m_tempPath;
@@ -115,10 +251,28 @@ private:
     bool m_deletesFileUponFailure;
     mutable std::mutex m_mutex;
     CurlDownloadListener *m_listener;
-    int m_fileSize;
-    int m_download;
+    int64_t m_fileSize;
+    int64_t m_download;
     RateTracker m_rateTracker;
 
+    int m_segmentCount;
+    DownloadPriority m_priority;
+    int64_t m_maxRecvSpeed;
+    bool m_useAssetCache;
+    bool m_fetching;                // waiting for the asset cache
+    long m_responseCode;
+    bool m_probing;
+    bool m_cancelled;
+    bool m_failed;
+    bool m_acceptRanges;
+    std::string m_validator;        // ETag or Last-Modified of the probed file
+    std::vector<std::unique_ptr<Segment>> m_segments;
+    int m_runningSegments;
+    std::string m_partPath;
+    std::string m_journalPath;
+    FILE* m_partHandle;
+    int64_t m_unsavedBytes;         // received since the journal was last saved
+
     static CurlDownloadManager m_downloadManager;
 
     friend class CurlDownloadManager;
@@ -1,10 +1,20 @@
 #include "FileUtil.h"
 
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN 1
 #include <Windows.h>
+#include <io.h>
+#else
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
 
 namespace network {
 
+#ifdef _WIN32
+
 std::wstring toUnicode(const std::string& str)
 {
 	int  len = 0;
@@ -71,6 +81,32 @@ bool deleteFile(const char* file) {
 	return !! ::DeleteFileW(wfile.c_str());
 }
 
+bool createDirectory(const char* dir) {
+	std::wstring wdir = toUnicode(dir);
+	return ::CreateDirectoryW(wdir.c_str(), NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+
+bool copyFile(const char* srcfile, const char* destfile) {
+	std::wstring wsrcfile = toUnicode(srcfile);
+	std::wstring wdestfile = toUnicode(destfile);
+	return !! ::CopyFileW(wsrcfile.c_str(), wdestfile.c_str(), FALSE);
+}
+
+bool resizeFile(FILE* file, int64_t size) {
+	return _chsize_s(_fileno(file), size) == 0;
+}
+
+bool writeFileAt(FILE* file, const void* data, size_t size, int64_t offset) {
+	HANDLE handle = (HANDLE)_get_osfhandle(_fileno(file));
+	OVERLAPPED overlapped = { 0 };
+	overlapped.Offset = (DWORD)offset;
+	overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+	DWORD written = 0;
+	return ::WriteFile(handle, data, (DWORD)size, &written, &overlapped) && written == size;
+}
+
 
 bool moveFile(const char* srcfile, const char* destfile) {
 	std::wstring wsrcfile = toUnicode(srcfile);
@@ -107,5 +143,81 @@ std::string openTemporaryFile(const std::string& filepath) {
 	}
 }
 
+#else
+
+FILE* openFile(const char* file, const char* mode) {
+	return fopen(file, mode);
+}
+
+bool deleteFile(const char* file) {
+	return unlink(file) == 0;
+}
+
+bool createDirectory(const char* dir) {
+	return mkdir(dir, 0755) == 0 || errno == EEXIST;
+}
+
+bool copyFile(const char* srcfile, const char* destfile) {
+	FILE* src = fopen(srcfile, "rb");
+	if (!src)
+		return false;
+	FILE* dest = fopen(destfile, "wb");
+	if (!dest) {
+		fclose(src);
+		return false;
+	}
+
+	char buffer[64 * 1024];
+	bool ok = true;
+	size_t read = 0;
+	while (ok && (read = fread(buffer, 1, sizeof(buffer), src)) > 0) {
+		ok = fwrite(buffer, 1, read, dest) == read;
+	}
+	ok = ok && !ferror(src);
+	fclose(src);
+	ok = fclose(dest) == 0 && ok;
+	return ok;
+}
+
+bool resizeFile(FILE* file, int64_t size) {
+	return ftruncate(fileno(file), size) == 0;
+}
+
+bool writeFileAt(FILE* file, const void* data, size_t size, int64_t offset) {
+	const char* buffer = static_cast<const char*>(data);
+	while (size > 0) {
+		ssize_t written = pwrite(fileno(file), buffer, size, offset);
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		buffer += written;
+		offset += written;
+		size -= written;
+	}
+	return true;
+}
+
+bool moveFile(const char* srcfile, const char* destfile) {
+	return rename(srcfile, destfile) == 0;
+}
+
+std::string openTemporaryFile(const std::string& filepath) {
+	std::string dir = "/tmp";
+	auto find = filepath.rfind('/');
+	if (find != std::string::npos)
+		dir = filepath.substr(0, find);
+
+	std::string path = dir + "/FILEXXXXXX";
+	int fd = mkstemp(&path[0]);
+	if (fd < 0)
+		return std::string();
+	close(fd);
+	return path;
+}
+
+#endif
+
 }//namespace
 
@@ -1,5 +1,6 @@
 #pragma once
 #include <stdio.h>
+#include <stdint.h>
 #include <string>
 
 namespace network {
@@ -8,6 +9,14 @@ FILE* openFile(const char* file,const char* mode);
 
 bool deleteFile(const char* file);
 bool moveFile(const char* srcfile, const char* destfile);
+bool createDirectory(const char* dir);
+// Copy a file, an existing destination is replaced.
+bool copyFile(const char* srcfile, const char* destfile);
+
+// Grow or truncate an open file, used to preallocate segmented downloads.
+bool resizeFile(FILE* file, int64_t size);
+// Positional write that bypasses the FILE buffer and leaves its position alone.
+bool writeFileAt(FILE* file, const void* data, size_t size, int64_t offset);
 
 std::string openTemporaryFile(const std::string& filepath);
 
@@ -0,0 +1,682 @@
+#include "HttpCache.h"
+#include "HttpRequest.h"
+#include "FileUtil.h"
+#include <curl/curl.h>
+#include <algorithm>
+#include <iterator>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace network {
+
+typedef std::lock_guard<std::mutex> LockHolder;
+typedef std::map<std::string, std::string> HeaderMap;
+
+static const char* kEntryMagic = "DJHC 1";
+
+static std::string toLower(std::string value)
+{
+    for (auto& c : value) {
+        if (c >= 'A' && c <= 'Z')
+            c = c - 'A' + 'a';
+    }
+    return value;
+}
+
+static std::string trim(const std::string& value)
+{
+    size_t begin = value.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+        return std::string();
+    size_t end = value.find_last_not_of(" \t\r\n");
+    return value.substr(begin, end - begin + 1);
+}
+
+static std::vector<std::string> split(const std::string& value, char sep)
+{
+    std::vector<std::string> items;
+    size_t begin = 0;
+    while (begin <= value.size()) {
+        size_t end = value.find(sep, begin);
+        if (end == std::string::npos)
+            end = value.size();
+        std::string item = trim(value.substr(begin, end - begin));
+        if (!item.empty())
+            items.push_back(item);
+        begin = end + 1;
+    }
+    return items;
+}
+
+static void addHeader(HeaderMap& headers, const std::string& line)
+{
+    size_t colon = line.find(':');
+    if (colon == std::string::npos)
+        return;
+
+    std::string name = toLower(trim(line.substr(0, colon)));
+    std::string value = trim(line.substr(colon + 1));
+    if (name.empty())
+        return;
+
+    auto find = headers.find(name);
+    if (find == headers.end())
+        headers[name] = value;
+    else
+        find->second.append(", ").append(value);
+}
+
+static HeaderMap getRequestHeaders(HttpRequest* request)
+{
+    HeaderMap headers;
+    for (auto& header : request->getHeaders()) {
+        addHeader(headers, header);
+    }
+    return headers;
+}
+
+// Cache-Control directives, "max-age=10" is stored as max-age -> 10
+static HeaderMap getCacheControl(const HeaderMap& headers)
+{
+    HeaderMap directives;
+    auto find = headers.find("cache-control");
+    if (find == headers.end())
+        return directives;
+
+    for (auto& item : split(find->second, ',')) {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            directives[toLower(item)] = std::string();
+        } else {
+            std::string value = trim(item.substr(eq + 1));
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+                value = value.substr(1, value.size() - 2);
+            directives[toLower(trim(item.substr(0, eq)))] = value;
+        }
+    }
+    return directives;
+}
+
+static time_t getDate(const HeaderMap& headers, const char* name)
+{
+    auto find = headers.find(name);
+    if (find == headers.end())
+        return -1;
+    return curl_getdate(find->second.c_str(), nullptr);
+}
+
+// Time at which a response received now becomes stale
+static time_t getExpires(const HeaderMap& headers, time_t now)
+{
+    HeaderMap directives = getCacheControl(headers);
+    if (directives.count("no-cache") || directives.count("no-store"))
+        return now;
+
+    long long lifetime = 0;
+    auto maxAge = directives.find("max-age");
+    if (maxAge != directives.end()) {
+        lifetime = atoll(maxAge->second.c_str());
+    } else {
+        // a missing or invalid Expires such as "0" means already expired
+        time_t expires = getDate(headers, "expires");
+        if (expires < 0)
+            return now;
+        time_t date = getDate(headers, "date");
+        lifetime = (long long)expires - (long long)(date >= 0 ? date : now);
+    }
+
+    auto age = headers.find("age");
+    if (age != headers.end())
+        lifetime -= atoll(age->second.c_str());
+
+    return lifetime > 0 ? now + (time_t)lifetime : now;
+}
+
+// FNV-1a, names the entry file of a key
+static uint64_t hashKey(const std::string& key)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+size_t HttpCacheEntry::size() const
+{
+    size_t size = key.size() + header.size() + body.size() + etag.size() + lastModified.size();
+    for (auto& item : vary) {
+        size += item.size();
+    }
+    return size;
+}
+
+HttpCache::HttpCache(const std::string& directory, size_t memoryLimit, size_t diskLimit)
+    : _directory(directory)
+    , _memoryLimit(memoryLimit)
+    , _diskLimit(diskLimit)
+    , _memoryBytes(0)
+    , _diskBytes(0)
+    , _journal(nullptr)
+    , _journalLines(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+
+    while (!_directory.empty() && (_directory.back() == '/' || _directory.back() == '\\')) {
+        _directory.pop_back();
+    }
+    if (!_directory.empty()) {
+        if (createDirectory(_directory.c_str())) {
+            loadIndex();
+            saveIndex();
+        } else
+            _directory.clear();
+    }
+}
+
+HttpCache::~HttpCache()
+{
+    LockHolder locker(_mutex);
+    saveIndex();
+    if (_journal)
+        fclose(_journal);
+}
+
+std::string HttpCache::getKey(HttpRequest* request)
+{
+    if (request->getRequestType() != HttpRequest::Type::kGET || request->getDataCallback())
+        return std::string();
+
+    // requests that ask for something else than the full stored response
+    HeaderMap headers = getRequestHeaders(request);
+    if (headers.count("authorization") || headers.count("range")
+        || headers.count("if-none-match") || headers.count("if-modified-since"))
+        return std::string();
+    if (getCacheControl(headers).count("no-store"))
+        return std::string();
+
+    return std::string("GET ") + request->getUrl();
+}
+
+HttpCacheEntryPtr HttpCache::find(HttpRequest* request, bool* fresh)
+{
+    *fresh = false;
+    std::string key = getKey(request);
+    if (key.empty())
+        return nullptr;
+
+    HeaderMap headers = getRequestHeaders(request);
+
+    LockHolder locker(_mutex);
+    HttpCacheEntryPtr entry = findEntry(key);
+    if (!entry)
+        return nullptr;
+
+    for (auto& item : entry->vary) {
+        size_t colon = item.find(':');
+        auto find = headers.find(item.substr(0, colon));
+        std::string value = find != headers.end() ? find->second : std::string();
+        if (value != item.substr(colon + 1))
+            return nullptr;
+    }
+
+    HeaderMap directives = getCacheControl(headers);
+    auto maxAge = directives.find("max-age");
+    bool revalidate = directives.count("no-cache")
+        || (maxAge != directives.end() && atoll(maxAge->second.c_str()) <= 0)
+        || toLower(headers["pragma"]) == "no-cache";
+
+    *fresh = !revalidate && entry->expires > time(nullptr);
+    return entry;
+}
+
+void HttpCache::store(HttpRequest* request, long responseCode, const std::vector<char>& header, const std::vector<char>& body)
+{
+    std::string key = getKey(request);
+    if (key.empty())
+        return;
+
+    HeaderMap headers = parseHeaders(header);
+    HeaderMap directives = getCacheControl(headers);
+    std::string vary = headers["vary"];
+
+    HttpCacheEntryPtr entry(new HttpCacheEntry());
+    entry->key = key;
+    entry->responseCode = responseCode;
+    entry->etag = headers["etag"];
+    entry->lastModified = headers["last-modified"];
+    entry->expires = getExpires(headers, time(nullptr));
+
+    bool storable = responseCode == 200
+        && !directives.count("no-store")
+        && trim(vary) != "*"
+        && (entry->expires > time(nullptr) || !entry->etag.empty() || !entry->lastModified.empty());
+
+    LockHolder locker(_mutex);
+    if (!storable) {
+        removeEntry(key);
+        return;
+    }
+
+    HeaderMap requestHeaders = getRequestHeaders(request);
+    for (auto& name : split(vary, ',')) {
+        std::string lower = toLower(name);
+        entry->vary.push_back(lower + ":" + requestHeaders[lower]);
+    }
+    entry->header = header;
+    entry->body = body;
+
+    putMemory(entry);
+    putDisk(entry);
+}
+
+void HttpCache::refresh(const HttpCacheEntryPtr& entry, const std::vector<char>& header)
+{
+    HeaderMap headers = parseHeaders(header);
+
+    LockHolder locker(_mutex);
+
+    // a 304 may leave out the freshness headers of the stored response
+    HeaderMap merged = parseHeaders(entry->header);
+    for (auto& item : headers) {
+        merged[item.first] = item.second;
+    }
+    entry->expires = getExpires(merged, time(nullptr));
+    if (headers.count("etag"))
+        entry->etag = headers["etag"];
+    if (headers.count("last-modified"))
+        entry->lastModified = headers["last-modified"];
+
+    if (_memoryIndex.count(entry->key) || _diskIndex.count(entry->key))
+        putDisk(entry);
+}
+
+void HttpCache::invalidate(const std::string& url)
+{
+    LockHolder locker(_mutex);
+    removeEntry(std::string("GET ") + url);
+}
+
+void HttpCache::clear()
+{
+    LockHolder locker(_mutex);
+    for (auto& record : _diskList) {
+        deleteFile(getFileName(record.key).c_str());
+    }
+    _diskList.clear();
+    _diskIndex.clear();
+    _diskBytes = 0;
+    _memoryList.clear();
+    _memoryIndex.clear();
+    _memoryBytes = 0;
+    saveIndex();
+}
+
+void HttpCache::addHit(size_t bytes)
+{
+    LockHolder locker(_mutex);
+    ++_stats.hits;
+    _stats.bytesSaved += bytes;
+}
+
+void HttpCache::addRevalidated(size_t bytes)
+{
+    LockHolder locker(_mutex);
+    ++_stats.revalidated;
+    _stats.bytesSaved += bytes;
+}
+
+void HttpCache::addMiss()
+{
+    LockHolder locker(_mutex);
+    ++_stats.misses;
+}
+
+HttpCacheStats HttpCache::getStats()
+{
+    LockHolder locker(_mutex);
+    HttpCacheStats stats = _stats;
+    stats.memoryBytes = _memoryBytes;
+    stats.diskBytes = _diskBytes;
+    stats.entries = (int)(_directory.empty() ? _memoryList.size() : _diskList.size());
+    return stats;
+}
+
+HeaderMap HttpCache::parseHeaders(const std::vector<char>& header)
+{
+    // redirects and 100-continue leave several blocks, the last one belongs to the final response
+    std::string text(header.begin(), header.end());
+    size_t begin = 0;
+    size_t pos = 0;
+    while ((pos = text.find("HTTP/", pos)) != std::string::npos) {
+        if (pos == 0 || text[pos - 1] == '\n')
+            begin = pos;
+        pos += 5;
+    }
+
+    HeaderMap headers;
+    size_t lineEnd = text.find('\n', begin);
+    while (lineEnd != std::string::npos) {
+        size_t next = text.find('\n', lineEnd + 1);
+        std::string line = text.substr(lineEnd + 1, (next == std::string::npos ? text.size() : next) - lineEnd - 1);
+        addHeader(headers, line);
+        lineEnd = next;
+    }
+    return headers;
+}
+
+// Called with _mutex held.
+HttpCacheEntryPtr HttpCache::findEntry(const std::string& key)
+{
+    auto memory = _memoryIndex.find(key);
+    if (memory != _memoryIndex.end()) {
+        _memoryList.splice(_memoryList.begin(), _memoryList, memory->second);
+        auto disk = _diskIndex.find(key);
+        if (disk != _diskIndex.end())
+            _diskList.splice(_diskList.begin(), _diskList, disk->second);
+        return *memory->second;
+    }
+
+    auto disk = _diskIndex.find(key);
+    if (disk == _diskIndex.end())
+        return nullptr;
+
+    HttpCacheEntryPtr entry = readEntry(getFileName(key));
+    if (!entry || entry->key != key) {
+        removeEntry(key);
+        return nullptr;
+    }
+
+    _diskList.splice(_diskList.begin(), _diskList, disk->second);
+    putMemory(entry);
+    return entry;
+}
+
+void HttpCache::putMemory(const HttpCacheEntryPtr& entry)
+{
+    auto find = _memoryIndex.find(entry->key);
+    if (find != _memoryIndex.end()) {
+        _memoryBytes -= (*find->second)->size();
+        _memoryList.erase(find->second);
+        _memoryIndex.erase(find);
+    }
+
+    size_t size = entry->size();
+    if (size > _memoryLimit)
+        return;
+
+    _memoryList.push_front(entry);
+    _memoryIndex[entry->key] = _memoryList.begin();
+    _memoryBytes += size;
+
+    while (_memoryBytes > _memoryLimit) {
+        HttpCacheEntryPtr last = _memoryList.back();
+        _memoryBytes -= last->size();
+        _memoryIndex.erase(last->key);
+        _memoryList.pop_back();
+    }
+}
+
+void HttpCache::putDisk(const HttpCacheEntryPtr& entry)
+{
+    if (_directory.empty())
+        return;
+
+    auto find = _diskIndex.find(entry->key);
+    if (find != _diskIndex.end()) {
+        _diskBytes -= find->second->size;
+        _diskList.erase(find->second);
+        _diskIndex.erase(find);
+    }
+
+    std::string file = getFileName(entry->key);
+    size_t size = entry->size();
+    DiskRecord record;
+    record.key = entry->key;
+    record.file = file.substr(_directory.size() + 1);
+    record.size = size;
+    if (size > _diskLimit || !writeEntry(*entry, file)) {
+        deleteFile(file.c_str());
+        appendJournal('-', record);
+        return;
+    }
+
+    _diskList.push_front(record);
+    _diskIndex[entry->key] = _diskList.begin();
+    _diskBytes += size;
+    appendJournal('+', record);
+
+    evict();
+}
+
+void HttpCache::removeEntry(const std::string& key)
+{
+    auto memory = _memoryIndex.find(key);
+    if (memory != _memoryIndex.end()) {
+        _memoryBytes -= (*memory->second)->size();
+        _memoryList.erase(memory->second);
+        _memoryIndex.erase(memory);
+    }
+
+    auto disk = _diskIndex.find(key);
+    if (disk != _diskIndex.end()) {
+        DiskRecord record = *disk->second;
+        deleteFile(getFileName(key).c_str());
+        _diskBytes -= record.size;
+        _diskList.erase(disk->second);
+        _diskIndex.erase(disk);
+        appendJournal('-', record);
+    }
+}
+
+void HttpCache::evict()
+{
+    while (_diskBytes > _diskLimit && !_diskList.empty()) {
+        DiskRecord last = _diskList.back();
+        deleteFile((_directory + "/" + last.file).c_str());
+        _diskBytes -= last.size;
+
+        // the memory copy can not outlive the disk one, a restart would lose it anyway
+        auto memory = _memoryIndex.find(last.key);
+        if (memory != _memoryIndex.end()) {
+            _memoryBytes -= (*memory->second)->size();
+            _memoryList.erase(memory->second);
+            _memoryIndex.erase(memory);
+        }
+
+        _diskIndex.erase(last.key);
+        _diskList.pop_back();
+        appendJournal('-', last);
+    }
+}
+
+std::string HttpCache::getFileName(const std::string& key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.cache", (unsigned long long)hashKey(key));
+    return _directory + "/" + name;
+}
+
+bool HttpCache::writeEntry(const HttpCacheEntry& entry, const std::string& file)
+{
+    std::string temp = file + ".tmp";
+    FILE* fp = openFile(temp.c_str(), "wb");
+    if (!fp)
+        return false;
+
+    std::string meta;
+    meta.append(kEntryMagic).append("\n");
+    meta.append(entry.key).append("\n");
+    meta.append(std::to_string(entry.responseCode)).append("\n");
+    meta.append(std::to_string((long long)entry.expires)).append("\n");
+    meta.append(entry.etag).append("\n");
+    meta.append(entry.lastModified).append("\n");
+    meta.append(std::to_string(entry.vary.size())).append("\n");
+    for (auto& item : entry.vary) {
+        meta.append(item).append("\n");
+    }
+    meta.append(std::to_string(entry.header.size())).append(" ");
+    meta.append(std::to_string(entry.body.size())).append("\n");
+
+    bool ok = fwrite(meta.data(), 1, meta.size(), fp) == meta.size()
+        && fwrite(entry.header.data(), 1, entry.header.size(), fp) == entry.header.size()
+        && fwrite(entry.body.data(), 1, entry.body.size(), fp) == entry.body.size();
+    ok = fclose(fp) == 0 && ok;
+
+    if (!ok || !moveFile(temp.c_str(), file.c_str())) {
+        deleteFile(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+HttpCacheEntryPtr HttpCache::readEntry(const std::string& file)
+{
+    FILE* fp = openFile(file.c_str(), "rb");
+    if (!fp)
+        return nullptr;
+
+    std::vector<char> data;
+    char buffer[16 * 1024];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+        data.insert(data.end(), buffer, buffer + size);
+    }
+    fclose(fp);
+
+    size_t pos = 0;
+    auto readLine = [&](std::string& line) {
+        auto end = std::find(data.begin() + pos, data.end(), '\n');
+        if (end == data.end())
+            return false;
+        line.assign(data.begin() + pos, end);
+        pos = end - data.begin() + 1;
+        return true;
+    };
+
+    HttpCacheEntryPtr entry(new HttpCacheEntry());
+    std::string magic, code, expires, count, sizes;
+    if (!readLine(magic) || magic != kEntryMagic
+        || !readLine(entry->key) || !readLine(code) || !readLine(expires)
+        || !readLine(entry->etag) || !readLine(entry->lastModified) || !readLine(count))
+        return nullptr;
+
+    entry->responseCode = atol(code.c_str());
+    entry->expires = (time_t)atoll(expires.c_str());
+    int varyCount = atoi(count.c_str());
+    for (int i = 0; i < varyCount; ++i) {
+        std::string item;
+        if (!readLine(item))
+            return nullptr;
+        entry->vary.push_back(item);
+    }
+
+    unsigned long long headerSize = 0, bodySize = 0;
+    if (!readLine(sizes) || sscanf(sizes.c_str(), "%llu %llu", &headerSize, &bodySize) != 2
+        || pos + headerSize + bodySize != data.size())
+        return nullptr;
+
+    entry->header.assign(data.begin() + pos, data.begin() + pos + headerSize);
+    entry->body.assign(data.begin() + pos + headerSize, data.end());
+    return entry;
+}
+
+void HttpCache::loadIndex()
+{
+    loadJournal(_directory + "/index");
+    loadJournal(_directory + "/journal");
+    evict();
+}
+
+// The index holds "size file key" lines, most recently used first. The journal holds
+// "+ size file key" for a record moved to the front and "- size file key" for a removed one.
+void HttpCache::loadJournal(const std::string& file)
+{
+    FILE* fp = openFile(file.c_str(), "rb");
+    if (!fp)
+        return;
+
+    char line[4096];
+    while (fgets(line, sizeof(line), fp)) {
+        std::string text = trim(line);
+        char op = 0;
+        if (text.size() > 2 && (text[0] == '+' || text[0] == '-') && text[1] == ' ') {
+            op = text[0];
+            text = text.substr(2);
+        }
+
+        size_t sp1 = text.find(' ');
+        size_t sp2 = sp1 != std::string::npos ? text.find(' ', sp1 + 1) : std::string::npos;
+        if (sp2 == std::string::npos)
+            continue;
+
+        DiskRecord record;
+        record.size = (size_t)atoll(text.substr(0, sp1).c_str());
+        record.file = text.substr(sp1 + 1, sp2 - sp1 - 1);
+        record.key = text.substr(sp2 + 1);
+
+        auto find = _diskIndex.find(record.key);
+        if (find != _diskIndex.end()) {
+            if (!op)
+                continue;
+            _diskBytes -= find->second->size;
+            _diskList.erase(find->second);
+            _diskIndex.erase(find);
+        }
+        if (op == '-')
+            continue;
+
+        auto pos = op == '+' ? _diskList.begin() : _diskList.end();
+        _diskIndex[record.key] = _diskList.insert(pos, record);
+        _diskBytes += record.size;
+    }
+    fclose(fp);
+}
+
+void HttpCache::saveIndex()
+{
+    if (_directory.empty())
+        return;
+
+    std::string file = _directory + "/index";
+    std::string temp = file + ".tmp";
+    FILE* fp = openFile(temp.c_str(), "wb");
+    if (!fp)
+        return;
+
+    bool ok = true;
+    for (auto& record : _diskList) {
+        ok = fprintf(fp, "%llu %s %s\n", (unsigned long long)record.size,
+            record.file.c_str(), record.key.c_str()) > 0 && ok;
+    }
+    ok = fclose(fp) == 0 && ok;
+
+    if (!ok || !moveFile(temp.c_str(), file.c_str())) {
+        deleteFile(temp.c_str());
+        return;
+    }
+
+    // the index now holds everything the journal recorded
+    if (_journal)
+        fclose(_journal);
+    _journal = openFile((_directory + "/journal").c_str(), "wb");
+    _journalLines = 0;
+}
+
+void HttpCache::appendJournal(char op, const DiskRecord& record)
+{
+    if (!_journal)
+        return;
+
+    fprintf(_journal, "%c %llu %s %s\n", op, (unsigned long long)record.size,
+        record.file.c_str(), record.key.c_str());
+    fflush(_journal);
+
+    // fold the journal into the index once it outgrows the entries it describes
+    if (++_journalLines > _diskList.size() * 2 + 64)
+        saveIndex();
+}
+
+} // namespace network
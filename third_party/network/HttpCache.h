@@ -0,0 +1,156 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace network {
+
+class HttpRequest;
+
+/**
+ * Counters of the response cache.
+ */
+struct HttpCacheStats
+{
+    int64_t hits;           /// fresh responses served without touching the network
+    int64_t revalidated;    /// stale responses confirmed by a 304 and served from the cache
+    int64_t misses;         /// cacheable requests that downloaded the body
+    int64_t bytesSaved;     /// body bytes that were not downloaded because of hits and 304s
+    int64_t memoryBytes;
+    int64_t diskBytes;
+    int entries;
+};
+
+/**
+ * A stored response.
+ */
+struct HttpCacheEntry
+{
+    std::string key;
+    long responseCode;
+    std::vector<char> header;               /// raw header block of the response
+    std::vector<char> body;
+    std::string etag;
+    std::string lastModified;
+    std::vector<std::string> vary;          /// "name:value" of the request headers listed in Vary
+    time_t expires;                         /// the entry is stale after this time
+
+    size_t size() const;
+};
+
+typedef std::shared_ptr<HttpCacheEntry> HttpCacheEntryPtr;
+
+/**
+ * Response cache of HttpClient, keyed by method, url and the request headers named by Vary.
+ *
+ * Entries are kept in a memory LRU and, if a directory is given, written through to a disk LRU
+ * that survives restarts. Disk changes are appended to a journal that is folded into the index
+ * file when it grows, so storing a response costs O(1) index I/O. Freshness follows Cache-Control max-age / no-cache / no-store and Expires,
+ * stale entries with an ETag or Last-Modified are revalidated with a conditional request.
+ * All methods are thread safe.
+ */
+class HttpCache
+{
+public:
+    /**
+     * @param directory where responses are persisted, empty to keep them in memory only.
+     * @param memoryLimit bytes of responses kept in memory.
+     * @param diskLimit bytes of responses kept on disk.
+     */
+    HttpCache(const std::string& directory, size_t memoryLimit, size_t diskLimit);
+    ~HttpCache();
+
+    /**
+     * Get the cache key of a request.
+     *
+     * @return the key, empty if the request must bypass the cache.
+     */
+    static std::string getKey(HttpRequest* request);
+
+    /**
+     * Find the stored response of a request.
+     *
+     * @param fresh set to true if the entry can be used without asking the server.
+     * @return the entry, nullptr if there is none or its Vary headers don't match.
+     */
+    HttpCacheEntryPtr find(HttpRequest* request, bool* fresh);
+
+    /**
+     * Store the response of a request if it is cacheable, or drop the old one if it is not.
+     */
+    void store(HttpRequest* request, long responseCode, const std::vector<char>& header, const std::vector<char>& body);
+
+    /**
+     * Update the freshness of an entry from the headers of a 304 response.
+     */
+    void refresh(const HttpCacheEntryPtr& entry, const std::vector<char>& header);
+
+    /**
+     * Drop the entries of an url, called when an unsafe method on it succeeded.
+     */
+    void invalidate(const std::string& url);
+
+    void clear();
+
+    void addHit(size_t bytes);
+    void addRevalidated(size_t bytes);
+    void addMiss();
+
+    HttpCacheStats getStats();
+
+    /**
+     * Parse the last header block of a response.
+     *
+     * @return header values keyed by lower case name, repeated headers are joined by ", ".
+     */
+    static std::map<std::string, std::string> parseHeaders(const std::vector<char>& header);
+
+private:
+    struct DiskRecord
+    {
+        std::string key;
+        std::string file;
+        size_t size;
+    };
+
+    HttpCacheEntryPtr findEntry(const std::string& key);
+    void putMemory(const HttpCacheEntryPtr& entry);
+    void putDisk(const HttpCacheEntryPtr& entry);
+    void removeEntry(const std::string& key);
+    void evict();
+
+    std::string getFileName(const std::string& key) const;
+    bool writeEntry(const HttpCacheEntry& entry, const std::string& file);
+    HttpCacheEntryPtr readEntry(const std::string& file);
+    void loadIndex();
+    void loadJournal(const std::string& file);
+    void saveIndex();
+    void appendJournal(char op, const DiskRecord& record);
+
+    std::string _directory;
+    size_t _memoryLimit;
+    size_t _diskLimit;
+
+    std::list<HttpCacheEntryPtr> _memoryList;   /// most recently used first
+    std::unordered_map<std::string, std::list<HttpCacheEntryPtr>::iterator> _memoryIndex;
+    size_t _memoryBytes;
+
+    std::list<DiskRecord> _diskList;            /// most recently used first
+    std::unordered_map<std::string, std::list<DiskRecord>::iterator> _diskIndex;
+    size_t _diskBytes;
+
+    FILE* _journal;                             /// "+" and "-" records since the index was saved
+    size_t _journalLines;
+
+    HttpCacheStats _stats;
+    std::mutex _mutex;
+};
+
+} // namespace network
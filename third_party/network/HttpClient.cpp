@@ -3,6 +3,10 @@
 #include <errno.h>
 #include <curl/curl.h>
 #include <stdio.h>
+#include <string.h>
+#include "CurlShare.h"
+#include "HttpCache.h"
+#include "AssetCache.h"
 
 namespace network {
 
@@ -12,19 +16,6 @@ namespace network {
     
 typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
 
-// Callback function used by libcurl for collect response data
-static size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream)
-{
-    auto recvBuffer = (std::vector<char>*)stream;
-    size_t sizes = size * nmemb;
-
-    // add data to the end of recvBuffer
-    // write data maybe called more than once in a single request
-    recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+sizes);
-
-    return sizes;
-}
-
 // Callback function used by libcurl for collect header data
 static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream)
 {
@@ -39,98 +30,6 @@ static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream
 }
 
 
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream,
-    long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream,
-    long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPutTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream,
-    long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processDeleteTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream,
-    long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
-
-// Worker thread
-void HttpClient::networkThread()
-{
-    increaseThreadCount();
-
-    while (true)
-    {
-        HttpRequestPtr request;
-
-        // step 1: send http request if the requestQueue isn't empty
-        {
-            std::lock_guard<std::mutex> lock(_requestQueueMutex);
-            while (_requestQueue.empty())
-            {
-                _sleepCondition.wait(_requestQueueMutex);
-            }
-            request = _requestQueue.front();
-            _requestQueue.pop_front();
-        }
-
-        if (request == _requestSentinel) {
-            break;
-        }
-
-        // step 2: libcurl sync access
-
-        // Create a HttpResponse object, the default setting is http access failed
-        HttpResponsePtr response = new (std::nothrow) HttpResponse(request);
-
-        processResponse(response, _responseMessage);
-
-
-        // add response packet into queue
-        _responseQueueMutex.lock();
-        _responseQueue.push_back(response);
-        _responseQueueMutex.unlock();
-
-        _schedulerMutex.lock();
-        if (nullptr != _scheduler)
-        {
-            _scheduler(std::bind(&HttpClient::dispatchResponseCallbacks, this));
-        }
-        _schedulerMutex.unlock();
-    }
-
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    _requestQueueMutex.lock();
-    _requestQueue.clear();
-    _requestQueueMutex.unlock();
-
-    _responseQueueMutex.lock();
-    _responseQueue.clear();
-    _responseQueueMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
-}
-
-// Worker thread
-void HttpClient::networkThreadAlone(HttpRequestPtr request, HttpResponsePtr response)
-{
-    increaseThreadCount();
-
-    char responseMessage[RESPONSE_BUFFER_SIZE] = { 0 };
-    processResponse(response, responseMessage);
-
-    _schedulerMutex.lock();
-    if (nullptr != _scheduler)
-    {
-        _scheduler([this, response, request]{
-            const ccHttpRequestCallback& callback = request->getCallback();
-
-            if (callback != nullptr)
-            {
-                callback(this, response);
-            }
-        });
-    }
-    _schedulerMutex.unlock();
-
-    decreaseThreadCountAndMayDeleteThis();
-}
-
 //Configure curl's timeout property
 static bool configureCURL(HttpClient* client, CURL* handle, char* errorBuffer)
 {
@@ -168,6 +67,12 @@ static bool configureCURL(HttpClient* client, CURL* handle, char* errorBuffer)
     curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
     curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
 
+    // reuse DNS entries, connections and TLS sessions of earlier requests
+    CURLSH* share = getCurlShareHandle();
+    if (share) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, share);
+    }
+
     return true;
 }
 
@@ -241,65 +146,120 @@ public:
 
     }
 
-    /// @param responseCode Null not allowed
-    bool perform(long *responseCode)
+    /// Append a header after init, e.g. the validators of a cached response
+    bool addHeader(const std::string& header)
     {
-        if (CURLE_OK != curl_easy_perform(_curl))
-            return false;
-        CURLcode code = curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, responseCode);
-        if (code != CURLE_OK || !(*responseCode >= 200 && *responseCode < 300)) {
-            CCLOGERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
-            return false;
-        }
-        // Get some mor data.
+        _headers = curl_slist_append(_headers, header.c_str());
+        return setOption(CURLOPT_HTTPHEADER, _headers);
+    }
 
-        return true;
+    CURL* handle() const
+    {
+        return _curl;
     }
 };
 
 //Process Get Request
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+static bool processGetTask(HttpClient* client, HttpRequest* request, CURLRaii& curl, write_callback callback, void* stream, HttpResponse* response, char* errorBuffer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    return curl.init(client, request, callback, stream, writeHeaderData, response->getResponseHeader(), errorBuffer)
+            && curl.setOption(CURLOPT_FOLLOWLOCATION, true);
 }
 
 //Process POST Request
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+static bool processPostTask(HttpClient* client, HttpRequest* request, CURLRaii& curl, write_callback callback, void* stream, HttpResponse* response, char* errorBuffer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
+    return curl.init(client, request, callback, stream, writeHeaderData, response->getResponseHeader(), errorBuffer)
             && curl.setOption(CURLOPT_POST, 1)
             && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
 }
 
 //Process PUT Request
-static int processPutTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+static bool processPutTask(HttpClient* client, HttpRequest* request, CURLRaii& curl, write_callback callback, void* stream, HttpResponse* response, char* errorBuffer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
+    return curl.init(client, request, callback, stream, writeHeaderData, response->getResponseHeader(), errorBuffer)
             && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
             && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
 }
 
 //Process DELETE Request
-static int processDeleteTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+static bool processDeleteTask(HttpClient* client, HttpRequest* request, CURLRaii& curl, write_callback callback, void* stream, HttpResponse* response, char* errorBuffer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
+    return curl.init(client, request, callback, stream, writeHeaderData, response->getResponseHeader(), errorBuffer)
             && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+            && curl.setOption(CURLOPT_FOLLOWLOCATION, true);
+}
+
+// Transfer state of one request in the multi handle
+struct HttpClient::Transfer
+{
+    HttpClient* client;
+    HttpResponsePtr response;
+    std::string host;
+    bool immediate;
+    bool streaming;                 /// first body chunk handed to the data callback
+    std::shared_ptr<HttpCache> cache;
+    HttpCacheEntryPtr cached;       /// stale entry being revalidated
+    CURLRaii curl;
+    char errorBuffer[RESPONSE_BUFFER_SIZE];
+};
+
+// Worker thread
+void HttpClient::networkThread()
+{
+    increaseThreadCount();
+
+    while (true)
+    {
+        // step 1: pick up new requests and start as many as the limits allow
+        if (takeRequests()) {
+            break;
+        }
+        startTransfers();
+
+        // step 2: let libcurl drive every transfer, then handle all finished ones
+        int runningCount = 0;
+        curl_multi_perform(_multiHandle, &runningCount);
+
+        bool finished = false;
+        int messagesInQueue = 0;
+        while (CURLMsg* msg = curl_multi_info_read(_multiHandle, &messagesInQueue))
+        {
+            if (msg->msg == CURLMSG_DONE) {
+                finishTransfer(msg->easy_handle, msg->data.result);
+                finished = true;
+            }
+        }
+
+        // finished transfers free slots for pending requests, start them before sleeping
+        if (finished) {
+            continue;
+        }
+
+        // step 3: sleep until a socket is ready, curl needs a timeout or send() wakes us up
+        curl_multi_poll(_multiHandle, nullptr, 0, 1000, nullptr);
+    }
+
+    // cleanup: if worker thread received quit signal, clean up un-completed requests
+    for (auto& item : _transfers) {
+        curl_multi_remove_handle(_multiHandle, item.first);
+    }
+    _transfers.clear();
+    _pendingQueue.clear();
+    _hostCount.clear();
+
+    _requestQueueMutex.lock();
+    _requestQueue.clear();
+    _immediateQueue.clear();
+    _requestQueueMutex.unlock();
+
+    _responseQueueMutex.lock();
+    _responseQueue.clear();
+    _responseQueueMutex.unlock();
+
+    decreaseThreadCountAndMayDeleteThis();
 }
 
 // HttpClient implementation
@@ -322,7 +282,7 @@ void HttpClient::Destroy(HttpClient* client)
     thiz->_requestQueue.push_back(thiz->_requestSentinel);
     thiz->_requestQueueMutex.unlock();
 
-    thiz->_sleepCondition.notify_one();
+    curl_multi_wakeup(thiz->_multiHandle);
     thiz->decreaseThreadCountAndMayDeleteThis();
 
     CCLOG("HttpClient::destroyInstance() finished!");
@@ -344,22 +304,27 @@ void HttpClient::setSSLVerification(const std::string& caFile)
 }
 
 HttpClient::HttpClient(scheduler_t scheduler)
-: _timeoutForConnect(30)
+: _isInited(false)
+, _timeoutForConnect(30)
 , _timeoutForRead(60)
-, _isInited(false)
+, _maxConcurrency(16)
+, _maxPerHost(6)
 , _threadCount(0)
 , _scheduler(scheduler)
-, _requestSentinel(new HttpRequest())
+, _multiHandle(nullptr)
 , _cookie(nullptr)
+, _requestSentinel(new HttpRequest())
 {
     CCLOG("In the constructor of HttpClient!");
-    memset(_responseMessage, 0, RESPONSE_BUFFER_SIZE * sizeof(char));
+    getCurlShareHandle();
+    _multiHandle = curl_multi_init();
     increaseThreadCount();
 }
 
 HttpClient::~HttpClient()
 {
     CCLOG("HttpClient destructor");
+    curl_multi_cleanup(_multiHandle);
 }
 
 //Lazy create semaphore & mutex & thread
@@ -369,6 +334,10 @@ bool HttpClient::lazyInitThreadSemphore()
     {
         return true;
     }
+    else if (!_multiHandle)
+    {
+        return false;
+    }
     else
     {
         auto t = std::thread(std::bind(&HttpClient::networkThread, this));
@@ -392,26 +361,76 @@ void HttpClient::send(HttpRequestPtr request)
         return;
     }
 
+    if (sendAsset(request, false))
+    {
+        return;
+    }
+
     _requestQueueMutex.lock();
     _requestQueue.push_back(request);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
-    _sleepCondition.notify_one();
+    curl_multi_wakeup(_multiHandle);
 }
 
 void HttpClient::sendImmediate(HttpRequestPtr request)
 {
+    if (false == lazyInitThreadSemphore())
+    {
+        return;
+    }
+
     if(!request)
     {
         return;
     }
 
-    // Create a HttpResponse object, the default setting is http access failed
-    HttpResponse *response = new (std::nothrow) HttpResponse(request);
+    if (sendAsset(request, true))
+    {
+        return;
+    }
+
+    _requestQueueMutex.lock();
+    _immediateQueue.push_back(request);
+    _requestQueueMutex.unlock();
+
+    curl_multi_wakeup(_multiHandle);
+}
+
+// Answer the request from the asset cache, return false if it must go to the network
+bool HttpClient::sendAsset(HttpRequestPtr request, bool immediate)
+{
+    if (!request->getUseAssetCache() || request->getRequestType() != HttpRequest::Type::kGET
+        || request->getDataCallback())
+    {
+        return false;
+    }
 
-    auto t = std::thread(&HttpClient::networkThreadAlone, this, request, response);
-    t.detach();
+    AssetCachePtr cache = AssetCache::getDefault();
+    if (!cache)
+    {
+        return false;
+    }
+
+    // keep the client alive until the asset arrives, like the network thread does
+    increaseThreadCount();
+    cache->fetch(request->getUrl(), [this, request, immediate](AssetPtr asset) {
+        HttpResponsePtr response = new (std::nothrow) HttpResponse(request);
+        if (asset && asset->read(response->getResponseData()))
+        {
+            response->setResponseCode(200);
+            response->setSucceed(true);
+        }
+        else
+        {
+            response->setSucceed(false);
+            response->setErrorBuffer("asset fetch failed");
+        }
+        postResponse(response, immediate);
+        decreaseThreadCountAndMayDeleteThis();
+    });
+    return true;
 }
 
 // Poll and notify main thread if responses exists in queue
@@ -441,71 +460,330 @@ void HttpClient::dispatchResponseCallbacks()
     }
 }
 
-// Process Response
-void HttpClient::processResponse(HttpResponsePtr response, char* responseMessage)
+// Callback function used by libcurl for collect response data
+size_t HttpClient::writeData(void* ptr, size_t size, size_t nmemb, void* stream)
 {
-    auto request = response->getHttpRequest();
-    long responseCode = -1;
-    int retValue = 0;
+    auto transfer = (Transfer*)stream;
+    size_t sizes = size * nmemb;
+    HttpResponse* response = transfer->response;
+
+    if (response->getHttpRequest()->getDataCallback())
+    {
+        // hand every chunk to the main thread in order, the response keeps nothing
+        if (!transfer->streaming) {
+            long responseCode = -1;
+            curl_easy_getinfo(transfer->curl.handle(), CURLINFO_RESPONSE_CODE, &responseCode);
+            response->setResponseCode(responseCode);
+            transfer->streaming = true;
+        }
+        std::shared_ptr<std::vector<char>> chunk(new std::vector<char>((char*)ptr, (char*)ptr + sizes));
+        transfer->client->postData(response, chunk);
+        return sizes;
+    }
 
-    // Process the request -> get response packet
+    std::vector<char>* recvBuffer = response->getResponseData();
+    if (recvBuffer->empty())
+    {
+        // reserve the announced length once instead of growing the buffer chunk by chunk,
+        // a compressed body is decoded and may still grow past it
+        curl_off_t length = -1;
+        if (curl_easy_getinfo(transfer->curl.handle(), CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length) == CURLE_OK
+            && length > 0 && length <= MAX_RESERVE_SIZE) {
+            recvBuffer->reserve((size_t)length);
+        }
+    }
+
+    // add data to the end of recvBuffer
+    // write data maybe called more than once in a single request
+    recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+sizes);
+
+    return sizes;
+}
+
+// Move queued requests to the network thread, return true if the quit signal is received
+bool HttpClient::takeRequests()
+{
+    std::deque<HttpRequestPtr> newQueue;
+    std::deque<HttpRequestPtr> immediateQueue;
+    bool quit = false;
+
+    _requestQueueMutex.lock();
+    while (!_requestQueue.empty())
+    {
+        HttpRequestPtr request = _requestQueue.front();
+        _requestQueue.pop_front();
+        if (request == _requestSentinel) {
+            quit = true;
+            break;
+        }
+        newQueue.push_back(request);
+    }
+    immediateQueue.swap(_immediateQueue);
+    _requestQueueMutex.unlock();
+
+    if (quit) {
+        return true;
+    }
+
+    // fresh cached responses don't need a slot
+    for (auto& request : newQueue) {
+        if (!respondFromCache(request, false))
+            _pendingQueue.push_back(request);
+    }
+
+    for (auto& request : immediateQueue) {
+        if (!respondFromCache(request, true))
+            startTransfer(request, getHostKey(request->getUrl()), true);
+    }
+    return false;
+}
+
+bool HttpClient::respondFromCache(HttpRequestPtr request, bool immediate)
+{
+    std::shared_ptr<HttpCache> cache = getCache();
+    if (!cache) {
+        return false;
+    }
+
+    bool fresh = false;
+    HttpCacheEntryPtr entry = cache->find(request, &fresh);
+    if (!entry || !fresh) {
+        return false;
+    }
+
+    HttpResponsePtr response = new (std::nothrow) HttpResponse(request);
+    response->setResponseCode(entry->responseCode);
+    response->setResponseHeader(&entry->header);
+    response->setResponseData(&entry->body);
+    response->setSucceed(true);
+    cache->addHit(entry->header.size() + entry->body.size());
+
+    postResponse(response, immediate);
+    return true;
+}
+
+// Start pending requests in order, skip the ones whose host is busy
+void HttpClient::startTransfers()
+{
+    int maxConcurrency = getMaxConcurrency();
+    int maxPerHost = getMaxPerHost();
+
+    auto it = _pendingQueue.begin();
+    while (it != _pendingQueue.end())
+    {
+        if (maxConcurrency > 0 && (int)_transfers.size() >= maxConcurrency) {
+            break;
+        }
+
+        std::string host = getHostKey((*it)->getUrl());
+        if (maxPerHost > 0 && _hostCount[host] >= maxPerHost) {
+            ++it;
+            continue;
+        }
+
+        HttpRequestPtr request = *it;
+        it = _pendingQueue.erase(it);
+        startTransfer(request, host, false);
+    }
+}
+
+void HttpClient::startTransfer(HttpRequestPtr request, const std::string& host, bool immediate)
+{
+    // Create a HttpResponse object, the default setting is http access failed
+    HttpResponsePtr response = new (std::nothrow) HttpResponse(request);
+
+    std::unique_ptr<Transfer> transfer(new Transfer());
+    transfer->client = this;
+    transfer->response = response;
+    transfer->host = host;
+    transfer->immediate = immediate;
+    transfer->streaming = false;
+    memset(transfer->errorBuffer, 0, sizeof(transfer->errorBuffer));
+
+    bool ok = false;
     switch (request->getRequestType())
     {
     case HttpRequest::Type::kGET: // HTTP GET
-        retValue = processGetTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
+        ok = processGetTask(this, request, transfer->curl, writeData, transfer.get(), response, transfer->errorBuffer);
         break;
 
     case HttpRequest::Type::kPOST: // HTTP POST
-        retValue = processPostTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
+        ok = processPostTask(this, request, transfer->curl, writeData, transfer.get(), response, transfer->errorBuffer);
         break;
 
     case HttpRequest::Type::kPUT:
-        retValue = processPutTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
+        ok = processPutTask(this, request, transfer->curl, writeData, transfer.get(), response, transfer->errorBuffer);
         break;
 
     case HttpRequest::Type::kDELETE:
-        retValue = processDeleteTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
+        ok = processDeleteTask(this, request, transfer->curl, writeData, transfer.get(), response, transfer->errorBuffer);
         break;
 
     default:
         break;
     }
 
+    // revalidate a stale cached response instead of downloading it again
+    transfer->cache = getCache();
+    if (ok && transfer->cache)
+    {
+        bool fresh = false;
+        HttpCacheEntryPtr entry = transfer->cache->find(request, &fresh);
+        if (entry && (!entry->etag.empty() || !entry->lastModified.empty()))
+        {
+            transfer->cached = entry;
+            if (!entry->etag.empty())
+                ok = transfer->curl.addHeader("If-None-Match: " + entry->etag);
+            if (ok && !entry->lastModified.empty())
+                ok = transfer->curl.addHeader("If-Modified-Since: " + entry->lastModified);
+        }
+    }
+
+    CURL* handle = transfer->curl.handle();
+    if (ok) {
+        ok = curl_multi_add_handle(_multiHandle, handle) == CURLM_OK;
+    }
+
+    if (!ok)
+    {
+        response->setResponseCode(-1);
+        response->setSucceed(false);
+        response->setErrorBuffer(transfer->errorBuffer[0] ? transfer->errorBuffer : "failed to start request");
+        postResponse(response, immediate);
+        return;
+    }
+
+    ++_hostCount[host];
+    _transfers[handle] = std::move(transfer);
+}
+
+void HttpClient::finishTransfer(CURL* handle, int result)
+{
+    auto find = _transfers.find(handle);
+    if (find == _transfers.end()) {
+        return;
+    }
+
+    std::unique_ptr<Transfer> transfer = std::move(find->second);
+    _transfers.erase(find);
+    curl_multi_remove_handle(_multiHandle, handle);
+
+    if (--_hostCount[transfer->host] <= 0) {
+        _hostCount.erase(transfer->host);
+    }
+
     // write data to HttpResponse
+    long responseCode = -1;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode);
+
+    HttpResponsePtr response = transfer->response;
+    if (result == CURLE_OK && transfer->cache) {
+        updateCache(transfer.get(), responseCode);
+        responseCode = response->getResponseCode();
+    }
+
     response->setResponseCode(responseCode);
-    if (retValue != 0)
+    if (result == CURLE_OK && responseCode >= 200 && responseCode < 300)
     {
-        response->setSucceed(false);
-        response->setErrorBuffer(responseMessage);
+        response->setSucceed(true);
     }
     else
     {
-        response->setSucceed(true);
+        if (result != CURLE_OK && !transfer->errorBuffer[0]) {
+            strncpy(transfer->errorBuffer, curl_easy_strerror((CURLcode)result), RESPONSE_BUFFER_SIZE - 1);
+        }
+        response->setSucceed(false);
+        response->setErrorBuffer(transfer->errorBuffer);
     }
+
+    postResponse(response, transfer->immediate);
+}
+
+// Called on network thread after a transfer completed.
+void HttpClient::updateCache(Transfer* transfer, long responseCode)
+{
+    HttpCache* cache = transfer->cache.get();
+    HttpResponse* response = transfer->response;
+    HttpRequest* request = response->getHttpRequest();
+    response->setResponseCode(responseCode);
+
+    if (request->getRequestType() != HttpRequest::Type::kGET)
+    {
+        // a successful unsafe method makes the stored GET response outdated
+        if (responseCode >= 200 && responseCode < 400)
+            cache->invalidate(request->getUrl());
+        return;
+    }
+
+    if (HttpCache::getKey(request).empty()) {
+        return;
+    }
+
+    if (responseCode == 304 && transfer->cached)
+    {
+        HttpCacheEntryPtr entry = transfer->cached;
+        cache->refresh(entry, *response->getResponseHeader());
+        cache->addRevalidated(entry->body.size());
+
+        response->setResponseCode(entry->responseCode);
+        response->setResponseHeader(&entry->header);
+        response->setResponseData(&entry->body);
+        return;
+    }
+
+    cache->addMiss();
+    cache->store(request, responseCode, *response->getResponseHeader(), *response->getResponseData());
+}
+
+void HttpClient::postResponse(HttpResponsePtr response, bool immediate)
+{
+    if (!immediate)
+    {
+        // add response packet into queue
+        _responseQueueMutex.lock();
+        _responseQueue.push_back(response);
+        _responseQueueMutex.unlock();
+    }
+
+    _schedulerMutex.lock();
+    if (nullptr != _scheduler)
+    {
+        if (immediate)
+        {
+            _scheduler([this, response]{
+                HttpRequest* request = response->getHttpRequest();
+                const ccHttpRequestCallback& callback = request->getCallback();
+
+                if (callback != nullptr)
+                {
+                    callback(this, response);
+                }
+            });
+        }
+        else
+        {
+            _scheduler(std::bind(&HttpClient::dispatchResponseCallbacks, this));
+        }
+    }
+    _schedulerMutex.unlock();
+}
+
+void HttpClient::postData(HttpResponsePtr response, std::shared_ptr<std::vector<char>> chunk)
+{
+    _schedulerMutex.lock();
+    if (nullptr != _scheduler)
+    {
+        _scheduler([this, response, chunk]{
+            HttpRequest* request = response->getHttpRequest();
+            const ccHttpDataCallback& callback = request->getDataCallback();
+
+            if (callback != nullptr)
+            {
+                callback(this, response, chunk.get());
+            }
+        });
+    }
+    _schedulerMutex.unlock();
 }
 
 void HttpClient::increaseThreadCount()
@@ -556,6 +834,77 @@ int HttpClient::getTimeoutForRead()
     return _timeoutForRead;
 }
 
+void HttpClient::setMaxConcurrency(int value)
+{
+    {
+        std::lock_guard<std::mutex> lock(_limitMutex);
+        _maxConcurrency = value;
+    }
+    // pending requests may fit in the new limit
+    curl_multi_wakeup(_multiHandle);
+}
+
+int HttpClient::getMaxConcurrency()
+{
+    std::lock_guard<std::mutex> lock(_limitMutex);
+    return _maxConcurrency;
+}
+
+void HttpClient::setMaxPerHost(int value)
+{
+    {
+        std::lock_guard<std::mutex> lock(_limitMutex);
+        _maxPerHost = value;
+    }
+    // pending requests may fit in the new limit
+    curl_multi_wakeup(_multiHandle);
+}
+
+int HttpClient::getMaxPerHost()
+{
+    std::lock_guard<std::mutex> lock(_limitMutex);
+    return _maxPerHost;
+}
+
+void HttpClient::enableCache(const std::string& directory, size_t memoryLimit, size_t diskLimit)
+{
+    std::shared_ptr<HttpCache> cache(new HttpCache(directory, memoryLimit, diskLimit));
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _cache = cache;
+}
+
+void HttpClient::disableCache()
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _cache = nullptr;
+}
+
+void HttpClient::clearCache()
+{
+    std::shared_ptr<HttpCache> cache = getCache();
+    if (cache) {
+        cache->clear();
+    }
+}
+
+HttpCacheStats HttpClient::getCacheStats()
+{
+    std::shared_ptr<HttpCache> cache = getCache();
+    if (cache) {
+        return cache->getStats();
+    }
+
+    HttpCacheStats stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+}
+
+std::shared_ptr<HttpCache> HttpClient::getCache()
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    return _cache;
+}
+
 const std::string& HttpClient::getCookieFilename()
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
@@ -1,12 +1,18 @@
 #pragma once
 #include <thread>
-#include <condition_variable>
+#include <mutex>
 #include <deque>
+#include <map>
+#include <memory>
 #include "HttpRequest.h"
 #include "HttpResponse.h"
 #include "HttpCookie.h"
+#include "HttpCache.h"
 #include <functional>
 
+typedef void CURLM;
+typedef void CURL;
+
 /**
  * @addtogroup network
  * @{
@@ -21,6 +27,8 @@ using scheduler_t = std::function<void(task_t)>;
 /** Singleton that handles asynchronous http requests.
  *
  * Once the request completed, a callback will issued in main thread when it provided during make request.
+ * All requests run concurrently on one network thread through a curl multi handle, and share DNS,
+ * connection and TLS session caches, so keep-alive connections are reused across requests.
  *
  * @lua NA
  */
@@ -28,10 +36,15 @@ class HttpClient
 {
 public:
     /**
-    * The buffer size of _responseMessage
+    * The buffer size of the error message of a request
     */
     static const int RESPONSE_BUFFER_SIZE = 256;
 
+    /**
+    * The largest Content-Length reserved up front for a response body
+    */
+    static const int MAX_RESERVE_SIZE = 256 * 1024 * 1024;
+
     /**
      * Get instance of HttpClient.
      *
@@ -81,13 +94,41 @@ public:
     void send(HttpRequestPtr request);
 
     /**
-     * Immediate send a request
+     * Immediate send a request, it is started at once and does not wait for the concurrency limits.
      *
      * @param request a HttpRequest object, which includes url, response callback etc.
                       please make sure request->_requestData is clear before calling "sendImmediate" here.
      */
     void sendImmediate(HttpRequestPtr request);
 
+    /**
+     * Set the maximum number of requests in flight at the same time.
+     *
+     * @param value the limit for all hosts, 0 means unlimited.
+     */
+    void setMaxConcurrency(int value);
+
+    /**
+     * Get the maximum number of requests in flight at the same time.
+     *
+     * @return int the limit for all hosts.
+     */
+    int getMaxConcurrency();
+
+    /**
+     * Set the maximum number of requests in flight to the same host.
+     *
+     * @param value the limit for one scheme://host:port, 0 means unlimited.
+     */
+    void setMaxPerHost(int value);
+
+    /**
+     * Get the maximum number of requests in flight to the same host.
+     *
+     * @return int the limit for one host.
+     */
+    int getMaxPerHost();
+
     /**
      * Set the timeout value for connecting.
      *
@@ -116,6 +157,35 @@ public:
      */
     int getTimeoutForRead();
 
+    /**
+     * Enable the response cache of GET requests.
+     *
+     * Fresh responses are answered without touching the network, stale ones with an ETag or
+     * Last-Modified are revalidated and answered from the cache on 304.
+     *
+     * @param directory where responses are persisted, empty to keep them in memory only.
+     * @param memoryLimit bytes of responses kept in memory.
+     * @param diskLimit bytes of responses kept on disk.
+     */
+    void enableCache(const std::string& directory, size_t memoryLimit, size_t diskLimit);
+
+    /**
+     * Disable the response cache, the persisted responses are kept.
+     */
+    void disableCache();
+
+    /**
+     * Drop every cached response.
+     */
+    void clearCache();
+
+    /**
+     * Get the hit/miss/bytes saved counters of the response cache.
+     *
+     * @return HttpCacheStats all zero if the cache is disabled.
+     */
+    HttpCacheStats getCacheStats();
+
     HttpCookie* getCookie() const {return _cookie; }
 
     std::mutex& getCookieFileMutex() {return _cookieFileMutex;}
@@ -125,17 +195,32 @@ private:
     HttpClient(scheduler_t scheduler);
     virtual ~HttpClient();
 
+    struct Transfer;
+
     /**
      * Init pthread mutex, semaphore, and create new thread for http requests
      * @return bool
      */
     bool lazyInitThreadSemphore();
     void networkThread();
-    void networkThreadAlone(HttpRequestPtr request, HttpResponsePtr response);
     /** Poll function called from main thread to dispatch callbacks when http requests finished **/
     void dispatchResponseCallbacks();
 
-    void processResponse(HttpResponsePtr response, char* responseMessage);
+    // Called by libcurl on network thread.
+    static size_t writeData(void* ptr, size_t size, size_t nmemb, void* stream);
+
+    // Called on network thread.
+    bool takeRequests();
+    bool respondFromCache(HttpRequestPtr request, bool immediate);
+    void startTransfers();
+    void startTransfer(HttpRequestPtr request, const std::string& host, bool immediate);
+    void finishTransfer(CURL* handle, int result);
+    void updateCache(Transfer* transfer, long responseCode);
+    bool sendAsset(HttpRequestPtr request, bool immediate);
+    void postResponse(HttpResponsePtr response, bool immediate);
+    void postData(HttpResponsePtr response, std::shared_ptr<std::vector<char>> chunk);
+    std::shared_ptr<HttpCache> getCache();
+
     void increaseThreadCount();
     void decreaseThreadCountAndMayDeleteThis();
 
@@ -148,6 +233,10 @@ private:
     int _timeoutForRead;
     std::mutex _timeoutForReadMutex;
 
+    int _maxConcurrency;
+    int _maxPerHost;
+    std::mutex _limitMutex;
+
     int  _threadCount;
     std::mutex _threadCountMutex;
 
@@ -155,8 +244,14 @@ private:
     std::mutex _schedulerMutex;
 
     std::deque<HttpRequestPtr>  _requestQueue;
+    std::deque<HttpRequestPtr>  _immediateQueue;
     std::mutex _requestQueueMutex;
 
+    CURLM* _multiHandle;
+    std::deque<HttpRequestPtr> _pendingQueue;   /// requests waiting for a free slot, network thread only
+    std::map<std::string, int> _hostCount;      /// transfers in flight per host, network thread only
+    std::map<CURL*, std::unique_ptr<Transfer>> _transfers;
+
     std::deque<HttpResponsePtr> _responseQueue;
     std::mutex _responseQueueMutex;
 
@@ -166,11 +261,10 @@ private:
     std::string _sslCaFilename;
     std::mutex _sslCaFileMutex;
 
-    HttpCookie* _cookie;
+    std::shared_ptr<HttpCache> _cache;
+    std::mutex _cacheMutex;
 
-    std::condition_variable_any _sleepCondition;
-
-    char _responseMessage[RESPONSE_BUFFER_SIZE];
+    HttpCookie* _cookie;
 
     RefCountedPtr<HttpRequest> _requestSentinel;
 };
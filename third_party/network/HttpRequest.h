@@ -15,6 +15,7 @@ class HttpClient;
 class HttpResponse;
 
 typedef std::function<void(HttpClient* client, HttpResponse* response)> ccHttpRequestCallback;
+typedef std::function<void(HttpClient* client, HttpResponse* response, std::vector<char>* chunk)> ccHttpDataCallback;
 
 
 /**
@@ -51,6 +52,7 @@ public:
     : _requestType(Type::kGET)
     , _pCallback(nullptr)
     , _pUserData(nullptr)
+    , _useAssetCache(false)
     {
     }
 
@@ -202,6 +204,29 @@ public:
         return _pCallback;
     }
 
+    /**
+     * Set the callback which receives the response body chunk by chunk, e.g. for incremental parsing.
+     * When it is set the body is not kept in HttpResponse and the response is not cached.
+     * Chunks are dispatched in order before the response callback, the response code and headers are
+     * already set when the first chunk arrives. The callback may take the chunk by swapping it out.
+     *
+     * @param callback the ccHttpDataCallback function.
+     */
+    inline void setDataCallback(const ccHttpDataCallback& callback)
+    {
+        _pDataCallback = callback;
+    }
+
+    /**
+     * Get ccHttpDataCallback callback function.
+     *
+     * @return const ccHttpDataCallback& ccHttpDataCallback callback function.
+     */
+    inline const ccHttpDataCallback& getDataCallback() const
+    {
+        return _pDataCallback;
+    }
+
     /**
      * Set custom-defined headers.
      *
@@ -222,6 +247,28 @@ public:
         return _headers;
     }
 
+    /**
+     * Answer a GET request from AssetCache::getDefault(), the body is downloaded once and shared
+     * with downloads and images of the same url. Meant for immutable resources such as avatars,
+     * the response carries no headers. Has no effect without a default cache or with a data callback.
+     *
+     * @param useAssetCache true to go through the asset cache.
+     */
+    inline void setUseAssetCache(bool useAssetCache)
+    {
+        _useAssetCache = useAssetCache;
+    }
+
+    /**
+     * Get whether the request goes through the asset cache.
+     *
+     * @return bool true if it does.
+     */
+    inline bool getUseAssetCache() const
+    {
+        return _useAssetCache;
+    }
+
     REF_IMPLEMENT_COUNTING(HttpRequest);
 protected:
     // properties
@@ -230,8 +277,10 @@ protected:
     std::vector<char>           _requestData;    /// used for POST
     std::string                 _tag;            /// user defined tag, to identify different requests in response callback
     ccHttpRequestCallback       _pCallback;      /// C++11 style callbacks
+    ccHttpDataCallback          _pDataCallback;  /// streaming body callback, optional
     void*                       _pUserData;      /// You can add your customed data here
     std::vector<std::string>    _headers;              /// custom http headers
+    bool                        _useAssetCache;  /// answer from the shared asset cache
 };
 
 typedef RefCountedPtr<HttpRequest> HttpRequestPtr;
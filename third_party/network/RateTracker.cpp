@@ -2,7 +2,7 @@
 #include <stddef.h>
 #include <algorithm>
 #include <assert.h>
-#include <ctime>
+#include <chrono>
 
 static const uint32_t HALF = 0x80000000;
 
@@ -127,7 +127,8 @@ void RateTracker::AddSamples(size_t sample_count) {
 }
 
 uint32_t RateTracker::Time() const {
-    return (uint32_t)(std::clock() * 1000 / CLOCKS_PER_SEC);
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 void RateTracker::EnsureInitialized() {
@@ -191,6 +191,9 @@ public:
 
 	Value NewArrayBuffer(const uint8_t* buf, size_t len);
 
+	//不复制数据，ArrayBuffer回收时调用free_func释放buf
+	Value NewArrayBuffer(uint8_t* buf, size_t len, JSFreeArrayBufferDataFunc* free_func, void* opaque);
+
 	Value NewUint8ArrayBuffer(const uint8_t* buf, size_t len);
 
 	/* Note: at least 'length' arguments will be readable in 'argv' */
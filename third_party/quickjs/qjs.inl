@@ -68,6 +68,10 @@ inline Value Context::NewArrayBuffer(const uint8_t* buf, size_t len) {
 	return Value(context_, JS_NewArrayBufferCopy(context_, buf, len));
 }
 
+inline Value Context::NewArrayBuffer(uint8_t* buf, size_t len, JSFreeArrayBufferDataFunc* free_func, void* opaque) {
+	return Value(context_, JS_NewArrayBuffer(context_, buf, len, free_func, opaque, false));
+}
+
 inline Value Context::NewCFunction(JSCFunction* func, const char* name, size_t length) {
 	return Value(context_, JS_NewCFunction(context_, func, name, length));
 }
@@ -276,6 +276,8 @@ typedef struct
 
    stbi_uc *img_buffer, *img_buffer_end;
    stbi_uc *img_buffer_original, *img_buffer_original_end;
+
+   int jpeg_scale_shift; // decode jpegs at 1/(1<<shift) of their size, see stbi_load_scaled
 } stbi__context;
 
 
@@ -286,6 +288,7 @@ static void stbi__start_mem(stbi__context *s, stbi_uc const *buffer, int len)
 {
    s->io.read = NULL;
    s->read_from_callbacks = 0;
+   s->jpeg_scale_shift = 0;
    s->callback_already_read = 0;
    s->img_buffer = s->img_buffer_original = (stbi_uc *) buffer;
    s->img_buffer_end = s->img_buffer_original_end = (stbi_uc *) buffer+len;
@@ -299,6 +302,7 @@ static void stbi__start_callbacks(stbi__context *s, stbi_io_callbacks *c, void *
    s->buflen = sizeof(s->buffer_start);
    s->read_from_callbacks = 1;
    s->callback_already_read = 0;
+   s->jpeg_scale_shift = 0;
    s->img_buffer = s->img_buffer_original = s->buffer_start;
    stbi__refill_buffer(s);
    s->img_buffer_original_end = s->img_buffer_end;
@@ -887,6 +891,37 @@ STBIDEF stbi_uc *stbi_load_from_callbacks(stbi_io_callbacks const *clbk, void *u
    return stbi__load_and_postprocess_8bit(&s,x,y,comp,req_comp);
 }
 
+static int stbi__scale_shift(int scale_denom)
+{
+   if (scale_denom >= 8) return 3;
+   if (scale_denom >= 4) return 2;
+   if (scale_denom >= 2) return 1;
+   return 0;
+}
+
+STBIDEF stbi_uc *stbi_load_from_memory_scaled(stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp, int scale_denom)
+{
+   stbi__context s;
+   stbi__start_mem(&s,buffer,len);
+   s.jpeg_scale_shift = stbi__scale_shift(scale_denom);
+   return stbi__load_and_postprocess_8bit(&s,x,y,comp,req_comp);
+}
+
+#ifndef STBI_NO_STDIO
+STBIDEF stbi_uc *stbi_load_scaled(char const *filename, int *x, int *y, int *comp, int req_comp, int scale_denom)
+{
+   FILE *f = stbi__fopen(filename, "rb");
+   unsigned char *result;
+   stbi__context s;
+   if (!f) return stbi__errpuc("can't fopen", "Unable to open file");
+   stbi__start_file(&s,f);
+   s.jpeg_scale_shift = stbi__scale_shift(scale_denom);
+   result = stbi__load_and_postprocess_8bit(&s,x,y,comp,req_comp);
+   fclose(f);
+   return result;
+}
+#endif
+
 #ifndef STBI_NO_GIF
 STBIDEF stbi_uc *stbi_load_gif_from_memory(stbi_uc const *buffer, int len, int **delays, int *x, int *y, int *z, int *comp, int req_comp)
 {
@@ -1437,6 +1472,7 @@ typedef struct
    int            jfif;
    int            app14_color_transform; // Adobe APP14 tag
    int            rgb;
+   int            scale_shift; // blocks are output as (8>>scale_shift)^2 pixels
 
    int scan_n, order[4];
    int restart_interval, todo;
@@ -2379,6 +2415,59 @@ static void stbi__jpeg_reset(stbi__jpeg *j)
    // since we don't even allow 1<<30 pixels
 }
 
+// 0.5 * C(u) * cos((2x+1)u*pi/2N) for the reduced N-point idct, indexed [x*N+u]
+static const int stbi__idct_scaled4[16] = {
+   stbi__f2f(0.35355339f), stbi__f2f( 0.46193977f), stbi__f2f( 0.35355339f), stbi__f2f( 0.19134172f),
+   stbi__f2f(0.35355339f), stbi__f2f( 0.19134172f), stbi__f2f(-0.35355339f), stbi__f2f(-0.46193977f),
+   stbi__f2f(0.35355339f), stbi__f2f(-0.19134172f), stbi__f2f(-0.35355339f), stbi__f2f( 0.46193977f),
+   stbi__f2f(0.35355339f), stbi__f2f(-0.46193977f), stbi__f2f( 0.35355339f), stbi__f2f(-0.19134172f),
+};
+static const int stbi__idct_scaled2[4] = {
+   stbi__f2f(0.35355339f), stbi__f2f( 0.35355339f),
+   stbi__f2f(0.35355339f), stbi__f2f(-0.35355339f),
+};
+
+// idct straight to a size x size block (4, 2 or 1) from the low frequency
+// coefficients, like libjpeg's scaled decoding: much cheaper than decoding
+// the full block and shrinking it afterwards
+static void stbi__idct_block_scaled(stbi_uc *out, int out_stride, short data[64], int size)
+{
+   int i,j,k,tmp[16];
+   const int *t = size == 4 ? stbi__idct_scaled4 : stbi__idct_scaled2;
+   if (size == 1) {
+      out[0] = stbi__clamp(((data[0] + 4) >> 3) + 128);
+      return;
+   }
+   // columns; keep one extra bit so the rows can't overflow
+   for (i=0; i < size; ++i)
+      for (j=0; j < size; ++j) {
+         int sum = 0;
+         for (k=0; k < size; ++k)
+            sum += t[j*size+k] * data[k*8+i];
+         tmp[j*size+i] = (sum + 1024) >> 11;
+      }
+   // rows
+   for (j=0; j < size; ++j, out += out_stride)
+      for (i=0; i < size; ++i) {
+         int sum = 0;
+         for (k=0; k < size; ++k)
+            sum += t[i*size+k] * tmp[j*size+k];
+         out[i] = stbi__clamp(((sum + 4096) >> 13) + 128);
+      }
+}
+
+// idct block (bx,by) of component n into its place in the (possibly scaled) plane
+static void stbi__jpeg_idct_put(stbi__jpeg *z, int n, int bx, int by, short data[64])
+{
+   int size = 8 >> z->scale_shift;
+   int stride = z->img_comp[n].w2 >> z->scale_shift;
+   stbi_uc *out = z->img_comp[n].data + stride*by*size + bx*size;
+   if (size == 8)
+      z->idct_block_kernel(out, stride, data);
+   else
+      stbi__idct_block_scaled(out, stride, data, size);
+}
+
 static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
 {
    stbi__jpeg_reset(z);
@@ -2397,7 +2486,7 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
             for (i=0; i < w; ++i) {
                int ha = z->img_comp[n].ha;
                if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
+               stbi__jpeg_idct_put(z, n, i, j, data);
                // every data block is an MCU, so countdown the restart interval
                if (--z->todo <= 0) {
                   if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
@@ -2421,11 +2510,11 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
                   // by the basic H and V specified for the component
                   for (y=0; y < z->img_comp[n].v; ++y) {
                      for (x=0; x < z->img_comp[n].h; ++x) {
-                        int x2 = (i*z->img_comp[n].h + x)*8;
-                        int y2 = (j*z->img_comp[n].v + y)*8;
+                        int x2 = i*z->img_comp[n].h + x;
+                        int y2 = j*z->img_comp[n].v + y;
                         int ha = z->img_comp[n].ha;
                         if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-                        z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data);
+                        stbi__jpeg_idct_put(z, n, x2, y2, data);
                      }
                   }
                }
@@ -2522,7 +2611,7 @@ static void stbi__jpeg_finish(stbi__jpeg *z)
             for (i=0; i < w; ++i) {
                short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
                stbi__jpeg_dequantize(data, z->dequant[z->img_comp[n].tq]);
-               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
+               stbi__jpeg_idct_put(z, n, i, j, data);
             }
          }
       }
@@ -2766,7 +2855,8 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
       z->img_comp[i].coeff = 0;
       z->img_comp[i].raw_coeff = 0;
       z->img_comp[i].linebuf = NULL;
-      z->img_comp[i].raw_data = stbi__malloc_mad2(z->img_comp[i].w2, z->img_comp[i].h2, 15);
+      // scaled decoding only needs the planes at the reduced size
+      z->img_comp[i].raw_data = stbi__malloc_mad2(z->img_comp[i].w2 >> z->scale_shift, z->img_comp[i].h2 >> z->scale_shift, 15);
       if (z->img_comp[i].raw_data == NULL)
          return stbi__free_jpeg_components(z, i+1, stbi__err("outofmem", "Out of memory"));
       // align blocks for idct using mmx/sse
@@ -3236,6 +3326,7 @@ static void stbi__setup_jpeg(stbi__jpeg *j)
    j->idct_block_kernel = stbi__idct_block;
    j->YCbCr_to_RGB_kernel = stbi__YCbCr_to_RGB_row;
    j->resample_row_hv_2_kernel = stbi__resample_row_hv_2;
+   j->scale_shift = 0;
 
 #ifdef STBI_SSE2
    if (stbi__sse2_available()) {
@@ -3286,6 +3377,19 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
    // load a jpeg image from whichever source, but leave in YCbCr format
    if (!stbi__decode_jpeg_image(z)) { stbi__cleanup_jpeg(z); return NULL; }
 
+   // from here on the planes and the output are at the scaled size
+   if (z->scale_shift) {
+      int round = (1 << z->scale_shift) - 1;
+      z->s->img_x = (z->s->img_x + round) >> z->scale_shift;
+      z->s->img_y = (z->s->img_y + round) >> z->scale_shift;
+      for (n=0; n < z->s->img_n; ++n) {
+         z->img_comp[n].x = (z->img_comp[n].x + round) >> z->scale_shift;
+         z->img_comp[n].y = (z->img_comp[n].y + round) >> z->scale_shift;
+         z->img_comp[n].w2 >>= z->scale_shift;
+         z->img_comp[n].h2 >>= z->scale_shift;
+      }
+   }
+
    // determine actual number of components to generate
    n = req_comp ? req_comp : z->s->img_n >= 3 ? 3 : 1;
 
@@ -3446,6 +3550,7 @@ static void *stbi__jpeg_load(stbi__context *s, int *x, int *y, int *comp, int re
    STBI_NOTUSED(ri);
    j->s = s;
    stbi__setup_jpeg(j);
+   j->scale_shift = s->jpeg_scale_shift;
    result = load_jpeg_image(j, x,y,comp,req_comp);
    STBI_FREE(j);
    return result;
@@ -426,6 +426,13 @@ STBIDEF stbi_uc *stbi_load_from_file  (FILE *f, int *x, int *y, int *channels_in
 // for stbi_load_from_file, file pointer is left pointing immediately after image
 #endif
 
+// scale_denom 2, 4 or 8 decodes jpegs at 1/2, 1/4 or 1/8 of their size (rounded up)
+// straight from the DCT coefficients; other formats are loaded at full size
+STBIDEF stbi_uc *stbi_load_from_memory_scaled(stbi_uc const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels, int scale_denom);
+#ifndef STBI_NO_STDIO
+STBIDEF stbi_uc *stbi_load_scaled      (char const *filename, int *x, int *y, int *channels_in_file, int desired_channels, int scale_denom);
+#endif
+
 #ifndef STBI_NO_GIF
 STBIDEF stbi_uc *stbi_load_gif_from_memory(stbi_uc const *buffer, int len, int **delays, int *x, int *y, int *z, int *comp, int req_comp);
 #endif